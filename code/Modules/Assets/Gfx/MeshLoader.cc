@@ -25,11 +25,14 @@ MeshLoaderBase(setup_, loadedFunc_) {
 //------------------------------------------------------------------------------
 MeshLoader::~MeshLoader() {
     o_assert_dbg(!this->ioRequest);
+    // the IO continuation references this object
+    this->ioFuture.Cancel();
 }
 
 //------------------------------------------------------------------------------
 void
 MeshLoader::Cancel() {
+    this->ioFuture.Cancel();
     if (this->ioRequest) {
         this->ioRequest->Cancelled = true;
         this->ioRequest = nullptr;
@@ -41,6 +44,12 @@ Id
 MeshLoader::Start() {
     this->resId = Gfx::resource()->prepareAsync(this->setup);
     this->ioRequest = IO::LoadFile(setup.Locator.Location());
+    // the loader is kept alive by the resource container until
+    // Continue() returns a non-pending state, or Cancel() is called
+    this->ioFuture = this->ioRequest->HandledFuture();
+    this->ioFuture.Then([this](IOStatus::Code /*status*/) {
+        this->resState = this->onIOHandled();
+    });
     return this->resId;
 }
 
@@ -48,43 +57,46 @@ MeshLoader::Start() {
 ResourceState::Code
 MeshLoader::Continue() {
     o_assert_dbg(this->resId.IsValid());
+    return this->resState;
+}
+
+//------------------------------------------------------------------------------
+ResourceState::Code
+MeshLoader::onIOHandled() {
     o_assert_dbg(this->ioRequest.isValid());
     
     ResourceState::Code result = ResourceState::Pending;
-    
-    if (this->ioRequest->Handled) {
-        if (IOStatus::OK == this->ioRequest->Status) {
-            // async loading has finished, use OmshParser to
-            // create a MeshSetup object from the loaded data
-            const void* data = this->ioRequest->Data.Data();
-            const int numBytes = this->ioRequest->Data.Size();
+    if (IOStatus::OK == this->ioRequest->Status) {
+        // async loading has finished, use OmshParser to
+        // create a MeshSetup object from the loaded data
+        const void* data = this->ioRequest->Data.Data();
+        const int numBytes = this->ioRequest->Data.Size();
 
-            MeshSetup meshSetup = MeshSetup::FromData(this->setup);
-            if (OmshParser::Parse(data, numBytes, meshSetup)) {
+        MeshSetup meshSetup = MeshSetup::FromData(this->setup);
+        if (OmshParser::Parse(data, numBytes, meshSetup)) {
 
-                // call the Loaded callback if defined, this
-                // gives the app a chance to look at the
-                // setup object, and possibly modify it
-                if (this->onLoaded) {
-                    this->onLoaded(meshSetup);
-                }
-
-                // NOTE: the prepared resource might have already been
-                // destroyed at this point, if this happens, initAsync will
-                // silently fail and return ResourceState::InvalidState
-                // (the same for failedAsync)
-                result = Gfx::resource()->initAsync(this->resId, meshSetup, data, numBytes);
-            }
-            else {
-                result = Gfx::resource()->failedAsync(this->resId);
+            // call the Loaded callback if defined, this
+            // gives the app a chance to look at the
+            // setup object, and possibly modify it
+            if (this->onLoaded) {
+                this->onLoaded(meshSetup);
             }
+
+            // NOTE: the prepared resource might have already been
+            // destroyed at this point, if this happens, initAsync will
+            // silently fail and return ResourceState::InvalidState
+            // (the same for failedAsync)
+            result = Gfx::resource()->initAsync(this->resId, meshSetup, data, numBytes);
         }
         else {
-            // IO had failed
             result = Gfx::resource()->failedAsync(this->resId);
         }
-        this->ioRequest = nullptr;
     }
+    else {
+        // IO had failed
+        result = Gfx::resource()->failedAsync(this->resId);
+    }
+    this->ioRequest = nullptr;
     return result;
 }
 
@@ -29,8 +29,13 @@ public:
     /// cancel the load process
     virtual void Cancel() override;
 private:
+    /// called on the main thread when the IO request has been handled
+    ResourceState::Code onIOHandled();
+
     Id resId;
     Ptr<IORead> ioRequest;
+    Future<IOStatus::Code> ioFuture;
+    ResourceState::Code resState = ResourceState::Pending;
 };
 
 } // namespace Oryol
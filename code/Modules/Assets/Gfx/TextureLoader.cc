@@ -26,11 +26,14 @@ TextureLoaderBase(setup_, loadedFunc_) {
 //------------------------------------------------------------------------------
 TextureLoader::~TextureLoader() {
     o_assert_dbg(!this->ioRequest);
+    // the IO continuation references this object
+    this->ioFuture.Cancel();
 }
 
 //------------------------------------------------------------------------------
 void
 TextureLoader::Cancel() {
+    this->ioFuture.Cancel();
     if (this->ioRequest) {
         this->ioRequest->Cancelled = true;
         this->ioRequest = nullptr;
@@ -42,6 +45,12 @@ Id
 TextureLoader::Start() {
     this->resId = Gfx::resource()->prepareAsync(this->setup);
     this->ioRequest = IO::LoadFile(setup.Locator.Location());
+    // the loader is kept alive by the resource container until
+    // Continue() returns a non-pending state, or Cancel() is called
+    this->ioFuture = this->ioRequest->HandledFuture();
+    this->ioFuture.Then([this](IOStatus::Code /*status*/) {
+        this->resState = this->onIOHandled();
+    });
     return this->resId;
 }
 
@@ -49,47 +58,50 @@ TextureLoader::Start() {
 ResourceState::Code
 TextureLoader::Continue() {
     o_assert_dbg(this->resId.IsValid());
+    return this->resState;
+}
+
+//------------------------------------------------------------------------------
+ResourceState::Code
+TextureLoader::onIOHandled() {
     o_assert_dbg(this->ioRequest.isValid());
     
     ResourceState::Code result = ResourceState::Pending;
-    
-    if (this->ioRequest->Handled) {
-        if (IOStatus::OK == this->ioRequest->Status) {
-            // yeah, IO is done, let gliml parse the texture data
-            // and create the texture resource
-            const uint8_t* data = this->ioRequest->Data.Data();
-            const int numBytes = this->ioRequest->Data.Size();
-            
-            gliml::context ctx;
-            ctx.enable_dxt(true);
-            ctx.enable_pvrtc(true);
-            ctx.enable_etc2(true);
-            if (ctx.load(data, numBytes)) {
-                TextureSetup texSetup = this->buildSetup(this->setup, &ctx, data);
+    if (IOStatus::OK == this->ioRequest->Status) {
+        // yeah, IO is done, let gliml parse the texture data
+        // and create the texture resource
+        const uint8_t* data = this->ioRequest->Data.Data();
+        const int numBytes = this->ioRequest->Data.Size();
+        
+        gliml::context ctx;
+        ctx.enable_dxt(true);
+        ctx.enable_pvrtc(true);
+        ctx.enable_etc2(true);
+        if (ctx.load(data, numBytes)) {
+            TextureSetup texSetup = this->buildSetup(this->setup, &ctx, data);
 
-                // call the Loaded callback if defined, this
-                // gives the app a chance to look at the
-                // setup object, and possibly modify it
-                if (this->onLoaded) {
-                  this->onLoaded(texSetup);
-                }
-
-                // NOTE: the prepared texture resource might have already been
-                // destroyed at this point, if this happens, initAsync will
-                // silently fail and return ResourceState::InvalidState
-                // (the same for failedAsync)
-                result = Gfx::resource()->initAsync(this->resId, texSetup, data, numBytes);
-            }
-            else {
-                result = Gfx::resource()->failedAsync(this->resId);
+            // call the Loaded callback if defined, this
+            // gives the app a chance to look at the
+            // setup object, and possibly modify it
+            if (this->onLoaded) {
+              this->onLoaded(texSetup);
             }
+
+            // NOTE: the prepared texture resource might have already been
+            // destroyed at this point, if this happens, initAsync will
+            // silently fail and return ResourceState::InvalidState
+            // (the same for failedAsync)
+            result = Gfx::resource()->initAsync(this->resId, texSetup, data, numBytes);
         }
         else {
-            // IO had failed
             result = Gfx::resource()->failedAsync(this->resId);
         }
-        this->ioRequest = nullptr;
     }
+    else {
+        // IO had failed
+        result = Gfx::resource()->failedAsync(this->resId);
+    }
+    this->ioRequest = nullptr;
     return result;
 }
 
@@ -33,9 +33,13 @@ public:
 private:
     /// convert gliml context attrs into a TextureSetup object
     TextureSetup buildSetup(const TextureSetup& blueprint, const gliml::context* ctx, const uint8_t* data);
+    /// called on the main thread when the IO request has been handled
+    ResourceState::Code onIOHandled();
     
     Id resId;
     Ptr<IORead> ioRequest;
+    Future<IOStatus::Code> ioFuture;
+    ResourceState::Code resState = ResourceState::Pending;
 };
 
 } // namespace Oryol
\ No newline at end of file
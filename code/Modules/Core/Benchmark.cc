@@ -0,0 +1,277 @@
+//------------------------------------------------------------------------------
+//  Benchmark.cc
+//------------------------------------------------------------------------------
+#include "Pre.h"
+#include "Benchmark.h"
+#include "Core/Assertion.h"
+#include "Core/Args.h"
+#include "Core/Log.h"
+#include "Core/Containers/Map.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+
+namespace Oryol {
+
+namespace {
+
+/// upper limit for the number of iterations of a repetition
+const int64_t MaxIterations = int64_t(1) << 40;
+
+//------------------------------------------------------------------------------
+Map<String, Benchmark::Func>&
+registry() {
+    static Map<String, Benchmark::Func> benchmarks;
+    return benchmarks;
+}
+
+//------------------------------------------------------------------------------
+/**
+ Clock only has microsecond resolution, which would add up to large
+ errors when timing is paused often.
+*/
+int64_t
+nanoSeconds() {
+    using namespace std::chrono;
+    return duration_cast<nanoseconds>(steady_clock::now().time_since_epoch()).count();
+}
+
+//------------------------------------------------------------------------------
+/**
+ Find a number of iterations which takes at least minTime, starting
+ with one iteration and growing from the measured time of the previous
+ attempt.
+*/
+int64_t
+calibrate(Benchmark::Func func, Duration minTime) {
+    const int64_t minNs = minTime.getRaw() * 1000;
+    int64_t numIterations = 1;
+    for (;;) {
+        const int64_t ns = Benchmark::RunRepetition(func, numIterations);
+        if ((ns >= minNs) || (numIterations >= MaxIterations)) {
+            return numIterations;
+        }
+        double factor = 100.0;
+        if (ns > 0) {
+            factor = 1.4 * double(minNs) / double(ns);
+            factor = factor < 2.0 ? 2.0 : (factor > 100.0 ? 100.0 : factor);
+        }
+        numIterations = int64_t(double(numIterations) * factor);
+        if (numIterations > MaxIterations) {
+            numIterations = MaxIterations;
+        }
+    }
+}
+
+//------------------------------------------------------------------------------
+void
+appendJsonString(StringBuilder& json, const char* str) {
+    json.Append('"');
+    for (const char* c = str; *c; c++) {
+        if (('"' == *c) || ('\\' == *c)) {
+            json.Append('\\');
+        }
+        json.Append(*c);
+    }
+    json.Append('"');
+}
+
+} // anonymous namespace
+
+//------------------------------------------------------------------------------
+void
+BenchmarkState::PauseTiming() {
+    o_assert_dbg(!this->paused);
+    this->paused = true;
+    this->pauseStart = nanoSeconds();
+}
+
+//------------------------------------------------------------------------------
+void
+BenchmarkState::ResumeTiming() {
+    o_assert_dbg(this->paused);
+    this->paused = false;
+    this->pausedTime += nanoSeconds() - this->pauseStart;
+}
+
+//------------------------------------------------------------------------------
+void
+Benchmark::Register(const char* name, Func func) {
+    o_assert_dbg(name && func);
+    o_assert2(!registry().Contains(name), "Benchmark: name registered twice!\n");
+    registry().Add(name, func);
+}
+
+//------------------------------------------------------------------------------
+Array<String>
+Benchmark::Names() {
+    Array<String> names;
+    const Map<String, Func>& benchmarks = registry();
+    names.Reserve(benchmarks.Size());
+    for (int i = 0; i < benchmarks.Size(); i++) {
+        names.Add(benchmarks.KeyAtIndex(i));
+    }
+    return names;
+}
+
+//------------------------------------------------------------------------------
+int64_t
+Benchmark::RunRepetition(Func func, int64_t numIterations) {
+    BenchmarkState state(numIterations);
+    const int64_t start = nanoSeconds();
+    func(state);
+    const int64_t end = nanoSeconds();
+    o_assert2(!state.paused, "Benchmark: timing still paused at end of benchmark!\n");
+    return (end - start) - state.pausedTime;
+}
+
+//------------------------------------------------------------------------------
+Array<BenchmarkResult>
+Benchmark::RunAll(const BenchmarkSetup& setup) {
+    Array<BenchmarkResult> results;
+    const Map<String, Func>& benchmarks = registry();
+    for (int i = 0; i < benchmarks.Size(); i++) {
+        const String& name = benchmarks.KeyAtIndex(i);
+        if (setup.Filter.Empty() || StringBuilder::Contains(name.AsCStr(), setup.Filter.AsCStr())) {
+            results.Add(Run(name.AsCStr(), benchmarks.ValueAtIndex(i), setup));
+        }
+    }
+    return results;
+}
+
+//------------------------------------------------------------------------------
+BenchmarkResult
+Benchmark::Run(const char* name, Func func, const BenchmarkSetup& setup) {
+    o_assert_dbg(name && func);
+    o_assert((setup.NumWarmups >= 0) && (setup.NumRepetitions > 0));
+    const int64_t numIterations = calibrate(func, setup.MinRepetitionTime);
+    for (int i = 0; i < setup.NumWarmups; i++) {
+        RunRepetition(func, numIterations);
+    }
+    Array<double> nsPerIteration;
+    nsPerIteration.Reserve(setup.NumRepetitions);
+    for (int i = 0; i < setup.NumRepetitions; i++) {
+        const int64_t ns = RunRepetition(func, numIterations);
+        nsPerIteration.Add(double(ns) / double(numIterations));
+    }
+    return Summarize(name, numIterations, nsPerIteration);
+}
+
+//------------------------------------------------------------------------------
+BenchmarkResult
+Benchmark::Summarize(const char* name, int64_t numIterations, const Array<double>& nsPerIteration) {
+    o_assert_dbg(name);
+    BenchmarkResult result;
+    result.Name = name;
+    result.NumIterations = numIterations;
+    result.NumRepetitions = nsPerIteration.Size();
+    const int num = nsPerIteration.Size();
+    if (0 == num) {
+        return result;
+    }
+    Array<double> sorted(nsPerIteration);
+    std::sort(sorted.begin(), sorted.end());
+    result.Min = sorted.Front();
+    result.Max = sorted.Back();
+    if (num & 1) {
+        result.Median = sorted[num / 2];
+    }
+    else {
+        result.Median = (sorted[num / 2 - 1] + sorted[num / 2]) * 0.5;
+    }
+    double sum = 0.0;
+    for (double val : sorted) {
+        sum += val;
+    }
+    result.Mean = sum / num;
+    if (num > 1) {
+        double sqSum = 0.0;
+        for (double val : sorted) {
+            sqSum += (val - result.Mean) * (val - result.Mean);
+        }
+        result.StdDev = std::sqrt(sqSum / (num - 1));
+    }
+    return result;
+}
+
+//------------------------------------------------------------------------------
+void
+Benchmark::WriteText(const Array<BenchmarkResult>& results, StringBuilder& str) {
+    str.AppendFormat(256, "%-32s %12s %12s %12s %12s %12s %12s\n",
+        "benchmark (ns/iteration)", "iterations", "min", "median", "mean", "stddev", "max");
+    for (const BenchmarkResult& res : results) {
+        str.AppendFormat(256, "%-32s %12lld %12.2f %12.2f %12.2f %12.2f %12.2f\n",
+            res.Name.AsCStr(), (long long) res.NumIterations,
+            res.Min, res.Median, res.Mean, res.StdDev, res.Max);
+    }
+}
+
+//------------------------------------------------------------------------------
+void
+Benchmark::WriteJson(const Array<BenchmarkResult>& results, StringBuilder& json) {
+    json.Append("{\"benchmarks\":[");
+    for (int i = 0; i < results.Size(); i++) {
+        const BenchmarkResult& res = results[i];
+        json.Append(i > 0 ? ",\n" : "\n");
+        json.Append("{\"name\":");
+        appendJsonString(json, res.Name.AsCStr());
+        json.AppendFormat(256, ",\"iterations\":%lld,\"repetitions\":%d,\"unit\":\"ns\","
+            "\"min\":%.3f,\"median\":%.3f,\"mean\":%.3f,\"stddev\":%.3f,\"max\":%.3f}",
+            (long long) res.NumIterations, res.NumRepetitions,
+            res.Min, res.Median, res.Mean, res.StdDev, res.Max);
+    }
+    json.Append("\n]}\n");
+}
+
+//------------------------------------------------------------------------------
+bool
+Benchmark::WriteJson(const Array<BenchmarkResult>& results, const char* path) {
+    o_assert_dbg(path);
+    std::FILE* fp = std::fopen(path, "wb");
+    if (nullptr == fp) {
+        return false;
+    }
+    StringBuilder json;
+    WriteJson(results, json);
+    const bool success = 1 == std::fwrite(json.AsCStr(), json.Length(), 1, fp);
+    std::fclose(fp);
+    return success;
+}
+
+//------------------------------------------------------------------------------
+int
+Benchmark::Main(int argc, const char** argv) {
+    Args args(argc, argv);
+    if (args.HasArg("-list")) {
+        for (const String& name : Names()) {
+            Log::Info("%s\n", name.AsCStr());
+        }
+        return 0;
+    }
+    BenchmarkSetup setup;
+    setup.Filter = args.GetString("-filter");
+    setup.NumWarmups = args.GetInt("-warmup", setup.NumWarmups);
+    setup.NumRepetitions = args.GetInt("-reps", setup.NumRepetitions);
+    if (args.HasArg("-mintime")) {
+        setup.MinRepetitionTime = Duration::FromMilliSeconds(double(args.GetFloat("-mintime")));
+    }
+    if ((setup.NumWarmups < 0) || (setup.NumRepetitions < 1)) {
+        Log::Error("Invalid -warmup or -reps argument!\n");
+        return 10;
+    }
+    const Array<BenchmarkResult> results = RunAll(setup);
+    StringBuilder str;
+    WriteText(results, str);
+    Log::Info("%s", str.AsCStr());
+    if (args.HasArg("-json")) {
+        const String path = args.GetString("-json");
+        if (!WriteJson(results, path.AsCStr())) {
+            Log::Error("Failed to write '%s'!\n", path.AsCStr());
+            return 10;
+        }
+    }
+    return 0;
+}
+
+} // namespace Oryol
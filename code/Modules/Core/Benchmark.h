@@ -0,0 +1,160 @@
+#pragma once
+//------------------------------------------------------------------------------
+/**
+    @class Oryol::Benchmark
+    @ingroup Core
+    @brief microbenchmark harness
+
+    Benchmarks are defined with the o_benchmark() macro, the body
+    gets a BenchmarkState called 'state' and must run the measured
+    code state.NumIterations() times:
+
+    ```cpp
+    o_benchmark(ArrayAdd) {
+        for (int64_t i = 0; i < state.NumIterations(); i++) {
+            Array<int> array;
+            for (int j = 0; j < 1000; j++) {
+                array.Add(j);
+            }
+            Benchmark::DoNotOptimize(array);
+        }
+    }
+    ```
+
+    The harness first finds a number of iterations which takes at least
+    BenchmarkSetup::MinRepetitionTime, then runs some untimed warmup
+    repetitions and the timed repetitions, and summarizes the time per
+    iteration over the repetitions (min, median, mean, standard deviation
+    and max, in nanoseconds). Unlike Clock, the harness measures time
+    with nanosecond resolution. Results are printed as a table and can be
+    written as JSON for tracking them over time.
+
+    Each module has a benchmark app in its Benchmarks directory (built
+    with the cmake option ORYOL_BENCHMARKS), with a Main.cc which only
+    contains OryolBenchmarkMain(). The app accepts these arguments:
+
+    ```
+    -filter str     only run benchmarks whose name contains str
+    -reps n         number of timed repetitions (default 10)
+    -warmup n       number of warmup repetitions (default 1)
+    -mintime ms     minimum time of a repetition (default 20)
+    -json path      write the results to a JSON file
+    -list           list the benchmarks and exit
+    ```
+*/
+#include "Core/Types.h"
+#include "Core/Time/Duration.h"
+#include "Core/Containers/Array.h"
+#include "Core/String/String.h"
+#include "Core/String/StringBuilder.h"
+
+namespace Oryol {
+
+/// benchmark run params
+struct BenchmarkSetup {
+    /// only run benchmarks whose name contains this string
+    String Filter;
+    /// number of untimed repetitions before the timed repetitions
+    int NumWarmups = 1;
+    /// number of timed repetitions
+    int NumRepetitions = 10;
+    /// the number of iterations is chosen so that a repetition takes at least this long
+    Duration MinRepetitionTime = Duration::FromMilliSeconds(20.0);
+};
+
+/// the state of a running benchmark
+class BenchmarkState {
+public:
+    /// constructor
+    BenchmarkState(int64_t numIterations) : numIterations(numIterations) { };
+    /// number of iterations the benchmark must run
+    int64_t NumIterations() const {
+        return this->numIterations;
+    };
+    /// stop timing (e.g. for setting up data), expensive, don't call in tight loops
+    void PauseTiming();
+    /// resume timing
+    void ResumeTiming();
+private:
+    friend class Benchmark;
+    int64_t numIterations;
+    int64_t pauseStart = 0;
+    int64_t pausedTime = 0;
+    bool paused = false;
+};
+
+/// the summarized result of a benchmark, times are nanoseconds per iteration
+struct BenchmarkResult {
+    String Name;
+    int64_t NumIterations = 0;
+    int NumRepetitions = 0;
+    double Min = 0.0;
+    double Median = 0.0;
+    double Mean = 0.0;
+    double StdDev = 0.0;
+    double Max = 0.0;
+};
+
+class Benchmark {
+public:
+    /// a benchmark function
+    typedef void (*Func)(BenchmarkState& state);
+
+    /// register a benchmark (called by o_benchmark)
+    static void Register(const char* name, Func func);
+    /// get the names of all registered benchmarks, sorted by name
+    static Array<String> Names();
+    /// run all registered benchmarks which match the filter
+    static Array<BenchmarkResult> RunAll(const BenchmarkSetup& setup=BenchmarkSetup());
+    /// run a single benchmark function
+    static BenchmarkResult Run(const char* name, Func func, const BenchmarkSetup& setup=BenchmarkSetup());
+    /// run a benchmark function once, returns the measured time in nanoseconds
+    static int64_t RunRepetition(Func func, int64_t numIterations);
+    /// compute a result from the nanoseconds per iteration of each repetition
+    static BenchmarkResult Summarize(const char* name, int64_t numIterations, const Array<double>& nsPerIteration);
+
+    /// append a table of results
+    static void WriteText(const Array<BenchmarkResult>& results, StringBuilder& str);
+    /// append results as JSON
+    static void WriteJson(const Array<BenchmarkResult>& results, StringBuilder& json);
+    /// write results to a JSON file, returns false if the file couldn't be written
+    static bool WriteJson(const Array<BenchmarkResult>& results, const char* path);
+
+    /// the benchmark app main function (see OryolBenchmarkMain)
+    static int Main(int argc, const char** argv);
+
+    /// prevent the compiler from optimizing away the computation of a value
+    template<class TYPE> static void DoNotOptimize(const TYPE& value);
+
+    /// helper to register benchmarks during static initialization
+    struct Registrar {
+        Registrar(const char* name, Func func) {
+            Register(name, func);
+        };
+    };
+};
+
+//------------------------------------------------------------------------------
+template<class TYPE> inline void
+Benchmark::DoNotOptimize(const TYPE& value) {
+    #if defined(__GNUC__) || defined(__clang__)
+    asm volatile("" : : "r,m"(value) : "memory");
+    #else
+    const volatile char* ptr = (const volatile char*) &value;
+    (void) *ptr;
+    #endif
+}
+
+} // namespace Oryol
+
+/// define a benchmark, the body gets a BenchmarkState& called 'state'
+#define o_benchmark(name) \
+static void name##_benchmark(Oryol::BenchmarkState& state); \
+static Oryol::Benchmark::Registrar name##_registrar(#name, name##_benchmark); \
+static void name##_benchmark(Oryol::BenchmarkState& state)
+
+/// define main() of a benchmark app
+#define OryolBenchmarkMain() \
+int main(int argc, const char** argv) { \
+    return Oryol::Benchmark::Main(argc, argv); \
+}
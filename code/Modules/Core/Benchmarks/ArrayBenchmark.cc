@@ -0,0 +1,59 @@
+//------------------------------------------------------------------------------
+//  ArrayBenchmark.cc
+//------------------------------------------------------------------------------
+#include "Pre.h"
+#include "Core/Benchmark.h"
+#include "Core/Containers/Array.h"
+
+using namespace Oryol;
+
+static const int NumElements = 1000;
+
+o_benchmark(ArrayAdd) {
+    for (int64_t i = 0; i < state.NumIterations(); i++) {
+        Array<int> array;
+        for (int j = 0; j < NumElements; j++) {
+            array.Add(j);
+        }
+        Benchmark::DoNotOptimize(array[0]);
+    }
+}
+
+o_benchmark(ArrayAddReserved) {
+    for (int64_t i = 0; i < state.NumIterations(); i++) {
+        Array<int> array;
+        array.Reserve(NumElements);
+        for (int j = 0; j < NumElements; j++) {
+            array.Add(j);
+        }
+        Benchmark::DoNotOptimize(array[0]);
+    }
+}
+
+o_benchmark(ArrayIterate) {
+    Array<int> array;
+    for (int j = 0; j < NumElements; j++) {
+        array.Add(j);
+    }
+    for (int64_t i = 0; i < state.NumIterations(); i++) {
+        int sum = 0;
+        for (int val : array) {
+            sum += val;
+        }
+        Benchmark::DoNotOptimize(sum);
+    }
+}
+
+o_benchmark(ArrayEraseFront) {
+    Array<int> array;
+    for (int64_t i = 0; i < state.NumIterations(); i++) {
+        state.PauseTiming();
+        for (int j = 0; j < NumElements; j++) {
+            array.Add(j);
+        }
+        state.ResumeTiming();
+        while (!array.Empty()) {
+            array.Erase(0);
+        }
+    }
+}
@@ -0,0 +1,35 @@
+//------------------------------------------------------------------------------
+//  BufferBenchmark.cc
+//------------------------------------------------------------------------------
+#include "Pre.h"
+#include "Core/Benchmark.h"
+#include "Core/Containers/Buffer.h"
+
+using namespace Oryol;
+
+static const int ChunkSize = 256;
+static const int NumChunks = 256;
+
+o_benchmark(BufferAdd) {
+    uint8_t chunk[ChunkSize] = { };
+    for (int64_t i = 0; i < state.NumIterations(); i++) {
+        Buffer buffer;
+        for (int j = 0; j < NumChunks; j++) {
+            buffer.Add(chunk, ChunkSize);
+        }
+        Benchmark::DoNotOptimize(buffer.Size());
+    }
+}
+
+o_benchmark(BufferRemoveFront) {
+    uint8_t chunk[ChunkSize] = { };
+    Buffer buffer;
+    for (int64_t i = 0; i < state.NumIterations(); i++) {
+        for (int j = 0; j < NumChunks; j++) {
+            buffer.Add(chunk, ChunkSize);
+        }
+        while (!buffer.Empty()) {
+            buffer.Remove(0, ChunkSize);
+        }
+    }
+}
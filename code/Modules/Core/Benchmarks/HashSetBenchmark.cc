@@ -0,0 +1,40 @@
+//------------------------------------------------------------------------------
+//  HashSetBenchmark.cc
+//------------------------------------------------------------------------------
+#include "Pre.h"
+#include "Core/Benchmark.h"
+#include "Core/Containers/HashSet.h"
+
+using namespace Oryol;
+
+static const int NumElements = 1000;
+
+struct IntHasher {
+    uint32_t operator()(int val) {
+        return uint32_t(val) * 2654435761u;
+    };
+};
+
+o_benchmark(HashSetAdd) {
+    for (int64_t i = 0; i < state.NumIterations(); i++) {
+        HashSet<int, IntHasher, 16> set;
+        for (int j = 0; j < NumElements; j++) {
+            set.Add(j);
+        }
+        Benchmark::DoNotOptimize(set.Size());
+    }
+}
+
+o_benchmark(HashSetContains) {
+    HashSet<int, IntHasher, 16> set;
+    for (int j = 0; j < NumElements; j++) {
+        set.Add(j * 2);
+    }
+    for (int64_t i = 0; i < state.NumIterations(); i++) {
+        int num = 0;
+        for (int j = 0; j < NumElements; j++) {
+            num += set.Contains(j) ? 1 : 0;
+        }
+        Benchmark::DoNotOptimize(num);
+    }
+}
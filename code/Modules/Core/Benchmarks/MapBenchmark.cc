@@ -0,0 +1,51 @@
+//------------------------------------------------------------------------------
+//  MapBenchmark.cc
+//------------------------------------------------------------------------------
+#include "Pre.h"
+#include "Core/Benchmark.h"
+#include "Core/Containers/Map.h"
+
+using namespace Oryol;
+
+static const int NumElements = 1000;
+
+// keys in pseudo-random order
+static int key(int i) {
+    return (i * 7919) % NumElements;
+}
+
+o_benchmark(MapAdd) {
+    for (int64_t i = 0; i < state.NumIterations(); i++) {
+        Map<int, int> map;
+        for (int j = 0; j < NumElements; j++) {
+            map.Add(key(j), j);
+        }
+        Benchmark::DoNotOptimize(map.Size());
+    }
+}
+
+o_benchmark(MapAddBulk) {
+    for (int64_t i = 0; i < state.NumIterations(); i++) {
+        Map<int, int> map;
+        map.BeginBulk();
+        for (int j = 0; j < NumElements; j++) {
+            map.AddBulk(key(j), j);
+        }
+        map.EndBulk();
+        Benchmark::DoNotOptimize(map.Size());
+    }
+}
+
+o_benchmark(MapFind) {
+    Map<int, int> map;
+    for (int j = 0; j < NumElements; j++) {
+        map.Add(key(j), j);
+    }
+    for (int64_t i = 0; i < state.NumIterations(); i++) {
+        int sum = 0;
+        for (int j = 0; j < NumElements; j++) {
+            sum += map[j];
+        }
+        Benchmark::DoNotOptimize(sum);
+    }
+}
@@ -0,0 +1,37 @@
+//------------------------------------------------------------------------------
+//  QueueBenchmark.cc
+//------------------------------------------------------------------------------
+#include "Pre.h"
+#include "Core/Benchmark.h"
+#include "Core/Containers/Queue.h"
+
+using namespace Oryol;
+
+static const int NumElements = 1000;
+
+o_benchmark(QueueEnqueueDequeue) {
+    Queue<int> queue;
+    for (int64_t i = 0; i < state.NumIterations(); i++) {
+        for (int j = 0; j < NumElements; j++) {
+            queue.Enqueue(j);
+        }
+        int sum = 0;
+        while (!queue.Empty()) {
+            sum += queue.Dequeue();
+        }
+        Benchmark::DoNotOptimize(sum);
+    }
+}
+
+o_benchmark(QueueSteadyState) {
+    Queue<int> queue;
+    for (int j = 0; j < 16; j++) {
+        queue.Enqueue(j);
+    }
+    for (int64_t i = 0; i < state.NumIterations(); i++) {
+        for (int j = 0; j < NumElements; j++) {
+            queue.Enqueue(queue.Dequeue());
+        }
+        Benchmark::DoNotOptimize(queue.Front());
+    }
+}
@@ -0,0 +1,31 @@
+//------------------------------------------------------------------------------
+//  StringAtomBenchmark.cc
+//------------------------------------------------------------------------------
+#include "Pre.h"
+#include "Core/Benchmark.h"
+#include "Core/String/StringAtom.h"
+
+using namespace Oryol;
+
+o_benchmark(StringAtomCreate) {
+    for (int64_t i = 0; i < state.NumIterations(); i++) {
+        StringAtom atom("The quick brown fox jumps over the lazy dog");
+        Benchmark::DoNotOptimize(atom);
+    }
+}
+
+o_benchmark(StringAtomCopy) {
+    const StringAtom src("The quick brown fox jumps over the lazy dog");
+    for (int64_t i = 0; i < state.NumIterations(); i++) {
+        StringAtom atom(src);
+        Benchmark::DoNotOptimize(atom);
+    }
+}
+
+o_benchmark(StringAtomCompare) {
+    const StringAtom atom0("The quick brown fox jumps over the lazy dog");
+    const StringAtom atom1("The quick brown fox jumps over the lazy cat");
+    for (int64_t i = 0; i < state.NumIterations(); i++) {
+        Benchmark::DoNotOptimize(atom0 == atom1);
+    }
+}
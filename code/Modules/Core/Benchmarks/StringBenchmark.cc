@@ -0,0 +1,53 @@
+//------------------------------------------------------------------------------
+//  StringBenchmark.cc
+//------------------------------------------------------------------------------
+#include "Pre.h"
+#include "Core/Benchmark.h"
+#include "Core/String/String.h"
+#include "Core/String/StringBuilder.h"
+
+using namespace Oryol;
+
+o_benchmark(StringCreate) {
+    for (int64_t i = 0; i < state.NumIterations(); i++) {
+        String str("The quick brown fox jumps over the lazy dog");
+        Benchmark::DoNotOptimize(str);
+    }
+}
+
+o_benchmark(StringCopy) {
+    const String src("The quick brown fox jumps over the lazy dog");
+    for (int64_t i = 0; i < state.NumIterations(); i++) {
+        String str(src);
+        Benchmark::DoNotOptimize(str);
+    }
+}
+
+o_benchmark(StringCompare) {
+    const String str0("The quick brown fox jumps over the lazy dog");
+    const String str1("The quick brown fox jumps over the lazy cat");
+    for (int64_t i = 0; i < state.NumIterations(); i++) {
+        Benchmark::DoNotOptimize(str0 == str1);
+    }
+}
+
+o_benchmark(StringBuilderAppend) {
+    StringBuilder builder;
+    for (int64_t i = 0; i < state.NumIterations(); i++) {
+        builder.Clear();
+        for (int j = 0; j < 100; j++) {
+            builder.Append("Hello ");
+            builder.Append('!');
+        }
+        Benchmark::DoNotOptimize(builder.Length());
+    }
+}
+
+o_benchmark(StringBuilderFormat) {
+    StringBuilder builder;
+    for (int64_t i = 0; i < state.NumIterations(); i++) {
+        builder.Clear();
+        builder.AppendFormat(128, "%d: %s %.2f", int(i), "value", 1.5f);
+        Benchmark::DoNotOptimize(builder.Length());
+    }
+}
@@ -0,0 +1,622 @@
+//------------------------------------------------------------------------------
+//  BinaryLog.cc
+//------------------------------------------------------------------------------
+#include "Pre.h"
+#include "BinaryLog.h"
+#include "Core/Assertion.h"
+#include "Core/Time/Clock.h"
+#include <cstring>
+#include <cstddef>
+#include <cstdint>
+#include <cwchar>
+
+namespace Oryol {
+
+namespace {
+
+static const char Magic[8] = { 'O', 'R', 'Y', 'O', 'L', 'B', 'L', 'G' };
+
+/// printf length modifiers
+enum lengthMod {
+    lenNone,
+    lenChar,        // hh
+    lenShort,       // h
+    lenLong,        // l
+    lenLongLong,    // ll, q
+    lenIntMax,      // j
+    lenSize,        // z
+    lenPtrDiff,     // t
+    lenLongDouble,  // L
+};
+
+/// a parsed printf conversion spec
+struct convSpec {
+    const char* begin = nullptr;    // the '%'
+    const char* end = nullptr;      // one past the conversion char
+    const char* flagsBegin = nullptr;
+    const char* flagsEnd = nullptr;
+    bool widthStar = false;
+    const char* widthBegin = nullptr;
+    const char* widthEnd = nullptr;
+    bool hasPrecision = false;
+    bool precisionStar = false;
+    const char* precisionBegin = nullptr;
+    const char* precisionEnd = nullptr;
+    lengthMod len = lenNone;
+    char conv = 0;
+};
+
+//------------------------------------------------------------------------------
+bool
+isDigit(char c) {
+    return (c >= '0') && (c <= '9');
+}
+
+//------------------------------------------------------------------------------
+bool
+isFlag(char c) {
+    return ('-' == c) || ('+' == c) || (' ' == c) || ('#' == c) || ('0' == c) || ('\'' == c);
+}
+
+//------------------------------------------------------------------------------
+/**
+ Parse a conversion spec starting at the '%' character, a literal
+ '%%' is returned as conversion '%'. Returns false if the spec is
+ unknown, formatting must stop there since the argument types of
+ all following conversions are unknown.
+*/
+bool
+parseSpec(const char* p, convSpec& spec) {
+    o_assert_dbg('%' == *p);
+    spec = convSpec();
+    spec.begin = p++;
+    spec.flagsBegin = p;
+    while (isFlag(*p)) {
+        p++;
+    }
+    spec.flagsEnd = p;
+    if ('*' == *p) {
+        spec.widthStar = true;
+        p++;
+    }
+    else {
+        spec.widthBegin = p;
+        while (isDigit(*p)) {
+            p++;
+        }
+        spec.widthEnd = p;
+    }
+    if ('.' == *p) {
+        p++;
+        spec.hasPrecision = true;
+        if ('*' == *p) {
+            spec.precisionStar = true;
+            p++;
+        }
+        else {
+            spec.precisionBegin = p;
+            while (isDigit(*p)) {
+                p++;
+            }
+            spec.precisionEnd = p;
+        }
+    }
+    switch (*p) {
+        case 'h':
+            p++;
+            spec.len = lenShort;
+            if ('h' == *p) {
+                p++;
+                spec.len = lenChar;
+            }
+            break;
+        case 'l':
+            p++;
+            spec.len = lenLong;
+            if ('l' == *p) {
+                p++;
+                spec.len = lenLongLong;
+            }
+            break;
+        case 'q': p++; spec.len = lenLongLong; break;
+        case 'j': p++; spec.len = lenIntMax; break;
+        case 'z': p++; spec.len = lenSize; break;
+        case 't': p++; spec.len = lenPtrDiff; break;
+        case 'L': p++; spec.len = lenLongDouble; break;
+        default: break;
+    }
+    spec.conv = *p;
+    switch (spec.conv) {
+        case 'd': case 'i': case 'u': case 'o': case 'x': case 'X': case 'c':
+        case 'f': case 'F': case 'e': case 'E': case 'g': case 'G': case 'a': case 'A':
+        case 's': case 'p': case 'n': case '%':
+            spec.end = p + 1;
+            return true;
+        default:
+            return false;
+    }
+}
+
+//------------------------------------------------------------------------------
+bool
+isWideInt(const convSpec& spec) {
+    return (spec.len != lenNone) && (spec.len != lenChar) && (spec.len != lenShort) && (spec.len != lenLongDouble);
+}
+
+/// helper to append values to the encoding buffer
+class encoder {
+public:
+    encoder(uint8_t* dst_, int maxSize_) : dst(dst_), maxSize(maxSize_) { };
+    template<class TYPE> void put(TYPE val) {
+        if ((this->pos + int(sizeof(val))) <= this->maxSize) {
+            std::memcpy(this->dst + this->pos, &val, sizeof(val));
+        }
+        else {
+            this->overflow = true;
+        }
+        this->pos += int(sizeof(val));
+    };
+    void putString(const char* str) {
+        if (nullptr == str) {
+            str = "(null)";
+        }
+        // strings are truncated to fit into the buffer
+        int len = int(std::strlen(str));
+        const int avail = this->maxSize - this->pos - int(sizeof(uint32_t));
+        if (len > avail) {
+            len = avail > 0 ? avail : 0;
+        }
+        this->put(uint32_t(len));
+        if (!this->overflow) {
+            std::memcpy(this->dst + this->pos, str, len);
+            this->pos += len;
+        }
+    };
+    void putWideString(const wchar_t* str) {
+        // only ASCII characters are kept
+        if (nullptr == str) {
+            this->putString(nullptr);
+            return;
+        }
+        char buf[256];
+        int len = 0;
+        while (str[len] && (len < int(sizeof(buf)) - 1)) {
+            buf[len] = ((str[len] > 0) && (str[len] < 128)) ? char(str[len]) : '?';
+            len++;
+        }
+        buf[len] = 0;
+        this->putString(buf);
+    };
+    uint8_t* dst;
+    int maxSize;
+    int pos = 0;
+    bool overflow = false;
+};
+
+/// helper to read values from encoded data
+class decoder {
+public:
+    decoder(const uint8_t* src_, int size_) : src(src_), size(size_) { };
+    template<class TYPE> bool get(TYPE& val) {
+        if ((this->pos + int(sizeof(val))) > this->size) {
+            return false;
+        }
+        std::memcpy(&val, this->src + this->pos, sizeof(val));
+        this->pos += int(sizeof(val));
+        return true;
+    };
+    bool getBytes(const uint8_t*& ptr, int num) {
+        if ((num < 0) || ((this->pos + num) > this->size)) {
+            return false;
+        }
+        ptr = this->src + this->pos;
+        this->pos += num;
+        return true;
+    };
+    const uint8_t* src;
+    int size;
+    int pos = 0;
+};
+
+} // anonymous namespace
+
+//------------------------------------------------------------------------------
+int
+BinaryLog::EncodeArgs(const char* fmt, va_list args, uint8_t* dst, int maxSize) {
+    o_assert_dbg(fmt && dst);
+    encoder enc(dst, maxSize);
+    convSpec spec;
+    for (const char* p = std::strchr(fmt, '%'); p; p = std::strchr(p, '%')) {
+        if (!parseSpec(p, spec)) {
+            break;
+        }
+        p = spec.end;
+        if (spec.widthStar) {
+            enc.put(int32_t(va_arg(args, int)));
+        }
+        if (spec.precisionStar) {
+            enc.put(int32_t(va_arg(args, int)));
+        }
+        switch (spec.conv) {
+            case 'd': case 'i': case 'u': case 'o': case 'x': case 'X':
+                switch (spec.len) {
+                    case lenLong:       enc.put(int64_t(va_arg(args, long))); break;
+                    case lenLongLong:   enc.put(int64_t(va_arg(args, long long))); break;
+                    case lenIntMax:     enc.put(int64_t(va_arg(args, intmax_t))); break;
+                    case lenSize:       enc.put(int64_t(va_arg(args, size_t))); break;
+                    case lenPtrDiff:    enc.put(int64_t(va_arg(args, ptrdiff_t))); break;
+                    default:            enc.put(int32_t(va_arg(args, int))); break;
+                }
+                break;
+            case 'c':
+                enc.put(int32_t(va_arg(args, int)));
+                break;
+            case 'f': case 'F': case 'e': case 'E': case 'g': case 'G': case 'a': case 'A':
+                if (lenLongDouble == spec.len) {
+                    enc.put(double(va_arg(args, long double)));
+                }
+                else {
+                    enc.put(va_arg(args, double));
+                }
+                break;
+            case 's':
+                if (lenLong == spec.len) {
+                    enc.putWideString(va_arg(args, const wchar_t*));
+                }
+                else {
+                    enc.putString(va_arg(args, const char*));
+                }
+                break;
+            case 'p':
+                enc.put(uint64_t(uintptr_t(va_arg(args, void*))));
+                break;
+            case 'n':
+                // nothing is written back
+                va_arg(args, void*);
+                break;
+            default:
+                break;
+        }
+    }
+    return enc.overflow ? InvalidIndex : enc.pos;
+}
+
+//------------------------------------------------------------------------------
+int
+BinaryLog::EncodeMessage(const char* fmt, va_list args, uint8_t* dst, int maxSize) {
+    const int hdrSize = int(sizeof(uint64_t) + sizeof(int64_t));
+    if (maxSize < hdrSize) {
+        return InvalidIndex;
+    }
+    const uint64_t fmtAddr = uint64_t(uintptr_t(fmt));
+    const int64_t time = Clock::Now().getRaw();
+    std::memcpy(dst, &fmtAddr, sizeof(fmtAddr));
+    std::memcpy(dst + sizeof(fmtAddr), &time, sizeof(time));
+    const int argsSize = EncodeArgs(fmt, args, dst + hdrSize, maxSize - hdrSize);
+    return (InvalidIndex == argsSize) ? InvalidIndex : hdrSize + argsSize;
+}
+
+//------------------------------------------------------------------------------
+bool
+BinaryLog::FormatArgs(const char* fmt, const uint8_t* args, int size, StringBuilder& str) {
+    o_assert_dbg(fmt);
+    decoder dec(args, size);
+    convSpec spec;
+    const char* p = fmt;
+    for (const char* next = std::strchr(p, '%'); next; next = std::strchr(p, '%')) {
+        if (!parseSpec(next, spec)) {
+            break;
+        }
+        str.Append(p, 0, int(next - p));
+        p = spec.end;
+        if ('%' == spec.conv) {
+            str.Append('%');
+            continue;
+        }
+
+        // resolve '*' width and precision from the encoded args
+        int32_t width = 0;
+        int32_t precision = -1;
+        if (spec.widthStar && !dec.get(width)) {
+            return false;
+        }
+        if (spec.hasPrecision) {
+            if (spec.precisionStar) {
+                if (!dec.get(precision)) {
+                    return false;
+                }
+            }
+            else {
+                precision = 0;
+                for (const char* c = spec.precisionBegin; c < spec.precisionEnd; c++) {
+                    precision = precision * 10 + (*c - '0');
+                }
+            }
+        }
+
+        // AppendFormat() drops truncated output, so make sure there's enough room
+        int fieldWidth = width < 0 ? -width : width;
+        for (const char* c = spec.widthBegin; c && (c < spec.widthEnd); c++) {
+            fieldWidth = fieldWidth * 10 + (*c - '0');
+        }
+        const int maxLength = fieldWidth + (precision > 0 ? precision : 0) + 400;
+
+        // build a conversion spec with explicit width, precision, and a
+        // length modifier matching the decoded argument type
+        char specStr[64];
+        int specLen = 0;
+        specStr[specLen++] = '%';
+        for (const char* c = spec.flagsBegin; (c < spec.flagsEnd) && (specLen < 8); c++) {
+            specStr[specLen++] = *c;
+        }
+        if (spec.widthStar) {
+            specLen += std::snprintf(specStr + specLen, 16, "%d", int(width));
+        }
+        else {
+            for (const char* c = spec.widthBegin; (c < spec.widthEnd) && (specLen < 24); c++) {
+                specStr[specLen++] = *c;
+            }
+        }
+        if (('s' != spec.conv) && (precision >= 0)) {
+            specLen += std::snprintf(specStr + specLen, 16, ".%d", int(precision));
+        }
+        switch (spec.conv) {
+            case 'd': case 'i': case 'u': case 'o': case 'x': case 'X':
+                if (isWideInt(spec)) {
+                    int64_t val = 0;
+                    if (!dec.get(val)) {
+                        return false;
+                    }
+                    specStr[specLen++] = 'l';
+                    specStr[specLen++] = 'l';
+                    specStr[specLen++] = spec.conv;
+                    specStr[specLen] = 0;
+                    str.AppendFormat(maxLength, specStr, (long long) val);
+                }
+                else {
+                    int32_t val = 0;
+                    if (!dec.get(val)) {
+                        return false;
+                    }
+                    if (lenShort == spec.len) {
+                        specStr[specLen++] = 'h';
+                    }
+                    else if (lenChar == spec.len) {
+                        specStr[specLen++] = 'h';
+                        specStr[specLen++] = 'h';
+                    }
+                    specStr[specLen++] = spec.conv;
+                    specStr[specLen] = 0;
+                    str.AppendFormat(maxLength, specStr, int(val));
+                }
+                break;
+            case 'c':
+                {
+                    int32_t val = 0;
+                    if (!dec.get(val)) {
+                        return false;
+                    }
+                    specStr[specLen++] = 'c';
+                    specStr[specLen] = 0;
+                    str.AppendFormat(maxLength, specStr, int(val));
+                }
+                break;
+            case 'f': case 'F': case 'e': case 'E': case 'g': case 'G': case 'a': case 'A':
+                {
+                    double val = 0.0;
+                    if (!dec.get(val)) {
+                        return false;
+                    }
+                    specStr[specLen++] = spec.conv;
+                    specStr[specLen] = 0;
+                    str.AppendFormat(maxLength, specStr, val);
+                }
+                break;
+            case 's':
+                {
+                    uint32_t len = 0;
+                    const uint8_t* chars = nullptr;
+                    if (!dec.get(len) || !dec.getBytes(chars, int(len))) {
+                        return false;
+                    }
+                    // the encoded string isn't null-terminated, so the
+                    // precision is always used to limit its length
+                    int maxChars = int(len);
+                    if ((precision >= 0) && (precision < maxChars)) {
+                        maxChars = precision;
+                    }
+                    specStr[specLen++] = '.';
+                    specStr[specLen++] = '*';
+                    specStr[specLen++] = 's';
+                    specStr[specLen] = 0;
+                    str.AppendFormat(maxLength + maxChars, specStr, maxChars, (const char*) chars);
+                }
+                break;
+            case 'p':
+                {
+                    uint64_t val = 0;
+                    if (!dec.get(val)) {
+                        return false;
+                    }
+                    specStr[specLen++] = 'p';
+                    specStr[specLen] = 0;
+                    str.AppendFormat(maxLength, specStr, (void*) uintptr_t(val));
+                }
+                break;
+            default:
+                // %n
+                break;
+        }
+    }
+    str.Append(p);
+    return true;
+}
+
+//------------------------------------------------------------------------------
+bool
+BinaryLog::Decode(const uint8_t* data, int size, StringBuilder& str, bool withTime) {
+    decoder dec(data, size);
+    const uint8_t* magic = nullptr;
+    uint32_t version = 0;
+    if (!dec.getBytes(magic, sizeof(Magic)) || (0 != std::memcmp(magic, Magic, sizeof(Magic)))) {
+        return false;
+    }
+    if (!dec.get(version) || (version != Version)) {
+        return false;
+    }
+    Array<String> formats;
+    bool hasStartTime = false;
+    int64_t startTime = 0;
+    while (dec.pos < dec.size) {
+        uint8_t type = 0;
+        dec.get(type);
+        switch (type) {
+            case FormatRecord:
+                {
+                    uint32_t id = 0;
+                    uint32_t len = 0;
+                    const uint8_t* chars = nullptr;
+                    if (!dec.get(id) || !dec.get(len) || !dec.getBytes(chars, int(len))) {
+                        return false;
+                    }
+                    // format ids are assigned in order
+                    if (int(id) != formats.Size()) {
+                        return false;
+                    }
+                    formats.Add(String((const char*) chars, 0, int(len)));
+                }
+                break;
+            case MessageRecord:
+                {
+                    uint8_t level = 0;
+                    uint32_t id = 0;
+                    int64_t time = 0;
+                    uint32_t argsSize = 0;
+                    const uint8_t* args = nullptr;
+                    if (!dec.get(level) || !dec.get(id) || !dec.get(time) || !dec.get(argsSize) || !dec.getBytes(args, int(argsSize))) {
+                        return false;
+                    }
+                    if (int(id) >= formats.Size()) {
+                        return false;
+                    }
+                    if (withTime) {
+                        if (!hasStartTime) {
+                            startTime = time;
+                            hasStartTime = true;
+                        }
+                        str.AppendFormat(64, "[%12.6f] ", double(time - startTime) / 1000000.0);
+                    }
+                    if (!FormatArgs(formats[id].AsCStr(), args, int(argsSize), str)) {
+                        return false;
+                    }
+                }
+                break;
+            case DroppedRecord:
+                {
+                    uint32_t num = 0;
+                    if (!dec.get(num)) {
+                        return false;
+                    }
+                    str.AppendFormat(128, "Log: %d messages dropped, log buffer was full!\n", int(num));
+                }
+                break;
+            default:
+                return false;
+        }
+    }
+    return true;
+}
+
+//------------------------------------------------------------------------------
+BinaryLog::Writer::~Writer() {
+    this->Close();
+}
+
+//------------------------------------------------------------------------------
+bool
+BinaryLog::Writer::Open(const char* path) {
+    o_assert_dbg(!this->IsOpen());
+    this->file = std::fopen(path, "wb");
+    if (nullptr == this->file) {
+        return false;
+    }
+    this->formatIds.Clear();
+    const uint32_t version = Version;
+    std::fwrite(Magic, sizeof(Magic), 1, this->file);
+    std::fwrite(&version, sizeof(version), 1, this->file);
+    return true;
+}
+
+//------------------------------------------------------------------------------
+void
+BinaryLog::Writer::Close() {
+    if (this->file) {
+        std::fclose(this->file);
+        this->file = nullptr;
+    }
+}
+
+//------------------------------------------------------------------------------
+bool
+BinaryLog::Writer::IsOpen() const {
+    return nullptr != this->file;
+}
+
+//------------------------------------------------------------------------------
+void
+BinaryLog::Writer::Flush() {
+    if (this->file) {
+        std::fflush(this->file);
+    }
+}
+
+//------------------------------------------------------------------------------
+void
+BinaryLog::Writer::WriteMessage(Log::Level lvl, const uint8_t* msg, int size) {
+    o_assert_dbg(this->IsOpen());
+    uint64_t fmtAddr = 0;
+    int64_t time = 0;
+    o_assert_dbg(size >= int(sizeof(fmtAddr) + sizeof(time)));
+    std::memcpy(&fmtAddr, msg, sizeof(fmtAddr));
+    std::memcpy(&time, msg + sizeof(fmtAddr), sizeof(time));
+    const uint8_t* args = msg + sizeof(fmtAddr) + sizeof(time);
+    const uint32_t argsSize = uint32_t(size - int(sizeof(fmtAddr) + sizeof(time)));
+
+    // write the format string when it is used for the first time
+    uint32_t id;
+    const int index = this->formatIds.FindIndex(uintptr_t(fmtAddr));
+    if (InvalidIndex == index) {
+        id = uint32_t(this->formatIds.Size());
+        this->formatIds.Add(uintptr_t(fmtAddr), id);
+        const char* fmt = (const char*) uintptr_t(fmtAddr);
+        const uint8_t type = FormatRecord;
+        const uint32_t len = uint32_t(std::strlen(fmt));
+        std::fwrite(&type, sizeof(type), 1, this->file);
+        std::fwrite(&id, sizeof(id), 1, this->file);
+        std::fwrite(&len, sizeof(len), 1, this->file);
+        std::fwrite(fmt, len, 1, this->file);
+    }
+    else {
+        id = this->formatIds.ValueAtIndex(index);
+    }
+    uint8_t hdr[2 + sizeof(id) + sizeof(time) + sizeof(argsSize)];
+    hdr[0] = MessageRecord;
+    hdr[1] = uint8_t(lvl);
+    std::memcpy(hdr + 2, &id, sizeof(id));
+    std::memcpy(hdr + 2 + sizeof(id), &time, sizeof(time));
+    std::memcpy(hdr + 2 + sizeof(id) + sizeof(time), &argsSize, sizeof(argsSize));
+    std::fwrite(hdr, sizeof(hdr), 1, this->file);
+    std::fwrite(args, argsSize, 1, this->file);
+}
+
+//------------------------------------------------------------------------------
+void
+BinaryLog::Writer::WriteDropped(int numDropped) {
+    o_assert_dbg(this->IsOpen());
+    const uint8_t type = DroppedRecord;
+    const uint32_t num = uint32_t(numDropped);
+    std::fwrite(&type, sizeof(type), 1, this->file);
+    std::fwrite(&num, sizeof(num), 1, this->file);
+}
+
+} // namespace Oryol
@@ -0,0 +1,87 @@
+#pragma once
+//------------------------------------------------------------------------------
+/**
+    @class Oryol::BinaryLog
+    @ingroup Core
+    @brief binary log file format with deferred formatting
+
+    In binary logging mode (see AsyncLogSetup::BinaryLogPath), log calls
+    don't format their message. Instead, the address of the format string
+    and the raw printf arguments are copied into the asynchronous log
+    buffer, and the background logging thread writes them into a compact
+    binary log file, where each format string is only stored once. Binary
+    log files are turned into text with the blogdump tool (code/Tools/BlogDump)
+    or BinaryLog::Decode().
+
+    Format strings are referenced by address until the background thread
+    has written them to the file, so they must be string literals (or
+    otherwise stay valid until Log::StopAsync()).
+
+    File layout (all values in little endian byte order):
+
+        header:     char[8] "ORYOLBLG", uint32 version
+        records:    uint8 record type, followed by
+            Format:     uint32 format id, uint32 length, characters
+            Message:    uint8 level, uint32 format id, int64 timestamp (microseconds),
+                        uint32 args size, encoded args
+            Dropped:    uint32 number of dropped messages
+
+    Arguments are encoded in the order of the format string: ints of
+    int size or smaller (and chars) as int32, 'l', 'll', 'j', 'z' and 't'
+    ints as int64, floating point values as double, pointers as uint64,
+    and strings as uint32 length followed by the characters. Field width
+    or precision arguments ('*') are encoded as int32.
+*/
+#include "Core/Types.h"
+#include "Core/Log.h"
+#include "Core/Containers/Map.h"
+#include "Core/String/StringBuilder.h"
+#include <cstdarg>
+#include <cstdio>
+
+namespace Oryol {
+
+class BinaryLog {
+public:
+    /// file format version
+    static const uint32_t Version = 1;
+    /// record types
+    enum RecordType : uint8_t {
+        FormatRecord = 1,
+        MessageRecord,
+        DroppedRecord,
+    };
+
+    /// encode a message (format string address, timestamp and args), return size or InvalidIndex if it doesn't fit
+    static int EncodeMessage(const char* fmt, va_list args, uint8_t* dst, int maxSize);
+    /// encode printf arguments, return size or InvalidIndex if they don't fit
+    static int EncodeArgs(const char* fmt, va_list args, uint8_t* dst, int maxSize);
+    /// format encoded printf arguments and append to string builder, return false if args are malformed
+    static bool FormatArgs(const char* fmt, const uint8_t* args, int size, StringBuilder& str);
+    /// decode a binary log file into text, return false if data is malformed
+    static bool Decode(const uint8_t* data, int size, StringBuilder& str, bool withTime=false);
+
+    /// binary log file writer (used by the background logging thread)
+    class Writer {
+    public:
+        /// destructor
+        ~Writer();
+        /// open the file and write the file header
+        bool Open(const char* path);
+        /// close the file
+        void Close();
+        /// return true if the file is open
+        bool IsOpen() const;
+        /// write an encoded message (see EncodeMessage)
+        void WriteMessage(Log::Level lvl, const uint8_t* msg, int size);
+        /// write a dropped messages record
+        void WriteDropped(int numDropped);
+        /// flush buffered writes to the file (any thread)
+        void Flush();
+    private:
+        std::FILE* file = nullptr;
+        Map<uintptr_t, uint32_t> formatIds;
+    };
+};
+
+} // namespace Oryol
@@ -39,6 +39,28 @@
 #define ORYOL_MAX_PLATFORM_ALIGN (16)
 #endif
 
+/// cache line size, used to keep data written by different threads apart
+#define ORYOL_CACHELINE_SIZE (64)
+
+// does the compiler have __builtin_prefetch?
+#if defined(__GNUC__) || defined(__clang__)
+#define ORYOL_HAS_PREFETCH (1)
+#else
+#define ORYOL_HAS_PREFETCH (0)
+#endif
+
+// 128-bit SIMD instruction sets which are always available on the target CPU
+#if defined(__x86_64__) || defined(_M_X64)
+#define ORYOL_HAS_SSE2 (1)
+#else
+#define ORYOL_HAS_SSE2 (0)
+#endif
+#if defined(__aarch64__) || defined(_M_ARM64)
+#define ORYOL_HAS_NEON (1)
+#else
+#define ORYOL_HAS_NEON (0)
+#endif
+
 /// memory debug fill pattern (byte)
 #define ORYOL_MEMORY_DEBUG_BYTE (0xBB)
 /// memory debug fill pattern (short)
@@ -24,6 +24,9 @@
       needs to iterate over the keymap to find and replace the swapped-in index
     - Erase() and EraseIndex() need to do a sweep over the key map to
       fix-up indices, and are thus O(N)!!!
+
+    When adding large numbers of elements, use the bulk methods,
+    sorting of the keys then only happens once in EndBulk().
       
     @see Array, HashSet, Map, Set
 */
@@ -78,6 +81,15 @@ public:
     void Add(const KEY& key, const VALUE& value);
     /// add-move element
     void Add(KEY&& key, VALUE&& value);
+
+    /// begin bulk-mode
+    void BeginBulk();
+    /// add-copy element in bulk-mode
+    void AddBulk(const KEY& key, const VALUE& value);
+    /// add-move element in bulk-mode
+    void AddBulk(KEY&& key, VALUE&& value);
+    /// end bulk-mode (sorting of the keys happens here)
+    void EndBulk();
     
     /// find value index
     int FindValueIndex(const KEY& key);
@@ -235,6 +247,32 @@ ArrayMap<KEY, VALUE>::Add(KEY&& key, VALUE&& value) {
     this->indexMap.Add(std::move(key), this->valueArray.Size() - 1);
 }
     
+//------------------------------------------------------------------------------
+template<class KEY, class VALUE> void
+ArrayMap<KEY, VALUE>::BeginBulk() {
+    this->indexMap.BeginBulk();
+}
+
+//------------------------------------------------------------------------------
+template<class KEY, class VALUE> void
+ArrayMap<KEY, VALUE>::AddBulk(const KEY& key, const VALUE& value) {
+    this->valueArray.Add(value);
+    this->indexMap.AddBulk(KeyValuePair<KEY, int>(key, this->valueArray.Size() - 1));
+}
+
+//------------------------------------------------------------------------------
+template<class KEY, class VALUE> void
+ArrayMap<KEY, VALUE>::AddBulk(KEY&& key, VALUE&& value) {
+    this->valueArray.Add(std::move(value));
+    this->indexMap.AddBulk(KeyValuePair<KEY, int>(std::move(key), this->valueArray.Size() - 1));
+}
+
+//------------------------------------------------------------------------------
+template<class KEY, class VALUE> void
+ArrayMap<KEY, VALUE>::EndBulk() {
+    this->indexMap.EndBulk();
+}
+
 //------------------------------------------------------------------------------
 template<class KEY, class VALUE> int
 ArrayMap<KEY, VALUE>::FindValueIndex(const KEY& key) {
@@ -0,0 +1,506 @@
+#pragma once
+//------------------------------------------------------------------------------
+/**
+    @class Oryol::BitArray
+    @ingroup Core
+    @brief dynamically sized array of packed bits
+
+    The BitArray stores one bit per element in 64-bit words. Counting
+    bits and searching for the next set or cleared bit works on whole
+    words with the popcount and count-trailing-zeros CPU instructions,
+    so scanning a mostly empty or mostly full BitArray only costs
+    one operation per 64 bits.
+
+    Iterating over all set bits is O(number of words):
+
+    @code
+    for (int i = bits.FindFirstSet(); i != InvalidIndex; i = bits.FindFirstSet(i + 1)) {
+        ...
+    }
+    @endcode
+
+    ...or use ForEachSet() with a callback.
+
+    Bits beyond Size() in the last word are always kept cleared.
+*/
+#include "Core/Types.h"
+#include "Core/Assertion.h"
+#include "Core/Memory/Memory.h"
+#if defined(_MSC_VER) && defined(_M_X64)
+#include <intrin.h>
+#endif
+
+namespace Oryol {
+
+class BitArray {
+public:
+    /// default constructor
+    BitArray();
+    /// construct with number of bits (all cleared)
+    explicit BitArray(int numBits);
+    /// copy constructor
+    BitArray(const BitArray& rhs);
+    /// move constructor
+    BitArray(BitArray&& rhs);
+    /// destructor
+    ~BitArray();
+
+    /// copy-assignment
+    void operator=(const BitArray& rhs);
+    /// move-assignment
+    void operator=(BitArray&& rhs);
+
+    /// resize the array, new bits are cleared
+    void Resize(int numBits);
+    /// get number of bits
+    int Size() const;
+    /// return true if the array has no bits
+    bool Empty() const;
+
+    /// test a single bit
+    bool Test(int index) const;
+    /// test a single bit
+    bool operator[](int index) const;
+    /// set a single bit
+    void Set(int index);
+    /// clear a single bit
+    void Clear(int index);
+    /// flip a single bit
+    void Flip(int index);
+    /// set or clear a single bit
+    void Assign(int index, bool val);
+    /// set a range of bits
+    void SetRange(int index, int num);
+    /// clear a range of bits
+    void ClearRange(int index, int num);
+    /// set all bits
+    void SetAll();
+    /// clear all bits
+    void ClearAll();
+
+    /// count the set bits
+    int PopCount() const;
+    /// return true if any bit is set
+    bool Any() const;
+    /// return true if no bit is set
+    bool None() const;
+    /// return true if all bits are set
+    bool All() const;
+    /// find first set bit at or after index, or InvalidIndex
+    int FindFirstSet(int index=0) const;
+    /// find first cleared bit at or after index, or InvalidIndex
+    int FindFirstClear(int index=0) const;
+    /// find the last set bit, or InvalidIndex
+    int FindLastSet() const;
+    /// call func(int index) for each set bit in ascending order
+    template<class FUNC> void ForEachSet(FUNC func) const;
+
+private:
+    /// number of bits in a word
+    static const int WordBits = 64;
+    /// count set bits in a word
+    static int popCount(uint64_t w);
+    /// index of lowest set bit in a non-zero word
+    static int lowestBit(uint64_t w);
+    /// index of highest set bit in a non-zero word
+    static int highestBit(uint64_t w);
+    /// number of words for a number of bits
+    static int numWordsFor(int numBits);
+    /// mask of valid bits in the last word
+    uint64_t lastWordMask() const;
+    /// set or clear a range of bits
+    void assignRange(int index, int num, bool val);
+    /// free the words
+    void destroy();
+
+    uint64_t* words;
+    int numBits;
+    int numWords;
+};
+
+//------------------------------------------------------------------------------
+inline int
+BitArray::popCount(uint64_t w) {
+    #if defined(__GNUC__) || defined(__clang__)
+    return __builtin_popcountll(w);
+    #elif defined(_MSC_VER) && defined(_M_X64)
+    return int(__popcnt64(w));
+    #else
+    w = w - ((w >> 1) & 0x5555555555555555ull);
+    w = (w & 0x3333333333333333ull) + ((w >> 2) & 0x3333333333333333ull);
+    w = (w + (w >> 4)) & 0x0F0F0F0F0F0F0F0Full;
+    return int((w * 0x0101010101010101ull) >> 56);
+    #endif
+}
+
+//------------------------------------------------------------------------------
+inline int
+BitArray::lowestBit(uint64_t w) {
+    o_assert_dbg(w != 0);
+    #if defined(__GNUC__) || defined(__clang__)
+    return __builtin_ctzll(w);
+    #elif defined(_MSC_VER) && defined(_M_X64)
+    unsigned long index;
+    _BitScanForward64(&index, w);
+    return int(index);
+    #else
+    return popCount((w & (~w + 1)) - 1);
+    #endif
+}
+
+//------------------------------------------------------------------------------
+inline int
+BitArray::highestBit(uint64_t w) {
+    o_assert_dbg(w != 0);
+    #if defined(__GNUC__) || defined(__clang__)
+    return 63 - __builtin_clzll(w);
+    #elif defined(_MSC_VER) && defined(_M_X64)
+    unsigned long index;
+    _BitScanReverse64(&index, w);
+    return int(index);
+    #else
+    int index = 0;
+    while (w >>= 1) {
+        index++;
+    }
+    return index;
+    #endif
+}
+
+//------------------------------------------------------------------------------
+inline int
+BitArray::numWordsFor(int numBits) {
+    return (numBits + WordBits - 1) / WordBits;
+}
+
+//------------------------------------------------------------------------------
+inline uint64_t
+BitArray::lastWordMask() const {
+    const int rem = this->numBits & (WordBits - 1);
+    return rem ? ((uint64_t(1) << rem) - 1) : ~uint64_t(0);
+}
+
+//------------------------------------------------------------------------------
+inline
+BitArray::BitArray() :
+words(nullptr),
+numBits(0),
+numWords(0) {
+    // empty
+}
+
+//------------------------------------------------------------------------------
+inline
+BitArray::BitArray(int numBits_) :
+words(nullptr),
+numBits(0),
+numWords(0) {
+    this->Resize(numBits_);
+}
+
+//------------------------------------------------------------------------------
+inline
+BitArray::BitArray(const BitArray& rhs) :
+words(nullptr),
+numBits(0),
+numWords(0) {
+    *this = rhs;
+}
+
+//------------------------------------------------------------------------------
+inline
+BitArray::BitArray(BitArray&& rhs) :
+words(rhs.words),
+numBits(rhs.numBits),
+numWords(rhs.numWords) {
+    rhs.words = nullptr;
+    rhs.numBits = 0;
+    rhs.numWords = 0;
+}
+
+//------------------------------------------------------------------------------
+inline
+BitArray::~BitArray() {
+    this->destroy();
+}
+
+//------------------------------------------------------------------------------
+inline void
+BitArray::destroy() {
+    if (this->words) {
+        Memory::Free(this->words);
+    }
+    this->words = nullptr;
+    this->numBits = 0;
+    this->numWords = 0;
+}
+
+//------------------------------------------------------------------------------
+inline void
+BitArray::operator=(const BitArray& rhs) {
+    if (&rhs != this) {
+        this->destroy();
+        if (rhs.numWords > 0) {
+            this->words = (uint64_t*) Memory::Alloc(rhs.numWords * sizeof(uint64_t));
+            Memory::Copy(rhs.words, this->words, rhs.numWords * sizeof(uint64_t));
+        }
+        this->numBits = rhs.numBits;
+        this->numWords = rhs.numWords;
+    }
+}
+
+//------------------------------------------------------------------------------
+inline void
+BitArray::operator=(BitArray&& rhs) {
+    if (&rhs != this) {
+        this->destroy();
+        this->words = rhs.words;
+        this->numBits = rhs.numBits;
+        this->numWords = rhs.numWords;
+        rhs.words = nullptr;
+        rhs.numBits = 0;
+        rhs.numWords = 0;
+    }
+}
+
+//------------------------------------------------------------------------------
+inline void
+BitArray::Resize(int newNumBits) {
+    o_assert_dbg(newNumBits >= 0);
+    const int newNumWords = numWordsFor(newNumBits);
+    if (newNumWords != this->numWords) {
+        uint64_t* newWords = nullptr;
+        if (newNumWords > 0) {
+            newWords = (uint64_t*) Memory::Alloc(newNumWords * sizeof(uint64_t));
+            const int numKeep = newNumWords < this->numWords ? newNumWords : this->numWords;
+            if (numKeep > 0) {
+                Memory::Copy(this->words, newWords, numKeep * sizeof(uint64_t));
+            }
+            if (newNumWords > numKeep) {
+                Memory::Clear(newWords + numKeep, (newNumWords - numKeep) * sizeof(uint64_t));
+            }
+        }
+        if (this->words) {
+            Memory::Free(this->words);
+        }
+        this->words = newWords;
+        this->numWords = newNumWords;
+    }
+    this->numBits = newNumBits;
+    if (this->numWords > 0) {
+        // clear the bits beyond the end when shrinking
+        this->words[this->numWords - 1] &= this->lastWordMask();
+    }
+}
+
+//------------------------------------------------------------------------------
+inline int
+BitArray::Size() const {
+    return this->numBits;
+}
+
+//------------------------------------------------------------------------------
+inline bool
+BitArray::Empty() const {
+    return 0 == this->numBits;
+}
+
+//------------------------------------------------------------------------------
+inline bool
+BitArray::Test(int index) const {
+    o_assert_range_dbg(index, this->numBits);
+    return 0 != (this->words[index / WordBits] & (uint64_t(1) << (index & (WordBits - 1))));
+}
+
+//------------------------------------------------------------------------------
+inline bool
+BitArray::operator[](int index) const {
+    return this->Test(index);
+}
+
+//------------------------------------------------------------------------------
+inline void
+BitArray::Set(int index) {
+    o_assert_range_dbg(index, this->numBits);
+    this->words[index / WordBits] |= uint64_t(1) << (index & (WordBits - 1));
+}
+
+//------------------------------------------------------------------------------
+inline void
+BitArray::Clear(int index) {
+    o_assert_range_dbg(index, this->numBits);
+    this->words[index / WordBits] &= ~(uint64_t(1) << (index & (WordBits - 1)));
+}
+
+//------------------------------------------------------------------------------
+inline void
+BitArray::Flip(int index) {
+    o_assert_range_dbg(index, this->numBits);
+    this->words[index / WordBits] ^= uint64_t(1) << (index & (WordBits - 1));
+}
+
+//------------------------------------------------------------------------------
+inline void
+BitArray::Assign(int index, bool val) {
+    if (val) {
+        this->Set(index);
+    }
+    else {
+        this->Clear(index);
+    }
+}
+
+//------------------------------------------------------------------------------
+inline void
+BitArray::assignRange(int index, int num, bool val) {
+    o_assert_dbg((index >= 0) && (num >= 0) && ((index + num) <= this->numBits));
+    if (0 == num) {
+        return;
+    }
+    const int firstWord = index / WordBits;
+    const int lastWord = (index + num - 1) / WordBits;
+    const uint64_t firstMask = ~uint64_t(0) << (index & (WordBits - 1));
+    const int endBit = (index + num) & (WordBits - 1);
+    const uint64_t lastMask = endBit ? ((uint64_t(1) << endBit) - 1) : ~uint64_t(0);
+    for (int i = firstWord; i <= lastWord; i++) {
+        uint64_t mask = ~uint64_t(0);
+        if (i == firstWord) {
+            mask &= firstMask;
+        }
+        if (i == lastWord) {
+            mask &= lastMask;
+        }
+        if (val) {
+            this->words[i] |= mask;
+        }
+        else {
+            this->words[i] &= ~mask;
+        }
+    }
+}
+
+//------------------------------------------------------------------------------
+inline void
+BitArray::SetRange(int index, int num) {
+    this->assignRange(index, num, true);
+}
+
+//------------------------------------------------------------------------------
+inline void
+BitArray::ClearRange(int index, int num) {
+    this->assignRange(index, num, false);
+}
+
+//------------------------------------------------------------------------------
+inline void
+BitArray::SetAll() {
+    if (this->numWords > 0) {
+        Memory::Fill(this->words, this->numWords * sizeof(uint64_t), 0xFF);
+        this->words[this->numWords - 1] &= this->lastWordMask();
+    }
+}
+
+//------------------------------------------------------------------------------
+inline void
+BitArray::ClearAll() {
+    if (this->numWords > 0) {
+        Memory::Clear(this->words, this->numWords * sizeof(uint64_t));
+    }
+}
+
+//------------------------------------------------------------------------------
+inline int
+BitArray::PopCount() const {
+    int count = 0;
+    for (int i = 0; i < this->numWords; i++) {
+        count += popCount(this->words[i]);
+    }
+    return count;
+}
+
+//------------------------------------------------------------------------------
+inline bool
+BitArray::Any() const {
+    for (int i = 0; i < this->numWords; i++) {
+        if (this->words[i]) {
+            return true;
+        }
+    }
+    return false;
+}
+
+//------------------------------------------------------------------------------
+inline bool
+BitArray::None() const {
+    return !this->Any();
+}
+
+//------------------------------------------------------------------------------
+inline bool
+BitArray::All() const {
+    return InvalidIndex == this->FindFirstClear();
+}
+
+//------------------------------------------------------------------------------
+inline int
+BitArray::FindFirstSet(int index) const {
+    o_assert_dbg(index >= 0);
+    if (index >= this->numBits) {
+        return InvalidIndex;
+    }
+    int wordIndex = index / WordBits;
+    uint64_t w = this->words[wordIndex] & (~uint64_t(0) << (index & (WordBits - 1)));
+    while (0 == w) {
+        if (++wordIndex >= this->numWords) {
+            return InvalidIndex;
+        }
+        w = this->words[wordIndex];
+    }
+    return wordIndex * WordBits + lowestBit(w);
+}
+
+//------------------------------------------------------------------------------
+inline int
+BitArray::FindFirstClear(int index) const {
+    o_assert_dbg(index >= 0);
+    if (index >= this->numBits) {
+        return InvalidIndex;
+    }
+    int wordIndex = index / WordBits;
+    uint64_t w = ~this->words[wordIndex] & (~uint64_t(0) << (index & (WordBits - 1)));
+    while (0 == w) {
+        if (++wordIndex >= this->numWords) {
+            return InvalidIndex;
+        }
+        w = ~this->words[wordIndex];
+    }
+    // the cleared bits beyond the end would be found in the last word
+    const int result = wordIndex * WordBits + lowestBit(w);
+    return result < this->numBits ? result : InvalidIndex;
+}
+
+//------------------------------------------------------------------------------
+inline int
+BitArray::FindLastSet() const {
+    for (int i = this->numWords - 1; i >= 0; i--) {
+        if (this->words[i]) {
+            return i * WordBits + highestBit(this->words[i]);
+        }
+    }
+    return InvalidIndex;
+}
+
+//------------------------------------------------------------------------------
+template<class FUNC> void
+BitArray::ForEachSet(FUNC func) const {
+    for (int i = 0; i < this->numWords; i++) {
+        uint64_t w = this->words[i];
+        while (w) {
+            func(i * WordBits + lowestBit(w));
+            // clear the lowest set bit
+            w &= w - 1;
+        }
+    }
+}
+
+} // namespace Oryol
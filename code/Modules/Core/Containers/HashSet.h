@@ -4,19 +4,34 @@
     @class Oryol::HashSet
     @ingroup Core
     @brief a Set using hashing for fast access
-    
-    Implements a hash set with a fixed number of buckets, each
-    bucket is a binary-sorted set.
-    
+
+    Implements a hash set with a dynamic number of buckets, each
+    bucket is a binary-sorted set. NUMBUCKETS is the initial number
+    of buckets, the bucket table doubles in size when the average
+    number of elements per bucket exceeds MaxLoad.
+
+    Rehashing happens incrementally to avoid long stalls: when the
+    table grows, a new bucket table is allocated, and each following
+    Add() or Erase() migrates a few buckets from the old table into
+    the new table. Lookups check both tables while a rehash is in
+    progress. Call Reserve() to setup the right number of buckets
+    upfront if the final size is known.
+
     @see Array, ArrayMap, Map, Set
 */
 #include "Core/Config.h"
+#include "Core/Containers/Array.h"
 #include "Core/Containers/Set.h"
 
 namespace Oryol {
 
 template<class VALUETYPE, class HASHER, int NUMBUCKETS> class HashSet {
 public:
+    /// max average number of elements per bucket before growing
+    static const int MaxLoad = 4;
+    /// number of old buckets migrated per Add() or Erase() during a rehash
+    static const int RehashStep = 2;
+
     /// default constructor
     HashSet();
     /// copy constructor
@@ -27,7 +42,7 @@ public:
     void operator=(const HashSet& rhs);
     /// move-assignment operator (same capacity and size)
     void operator=(HashSet&& rhs);
-    
+
     /// set allocation strategy
     void SetAllocStrategy(int minGrow, int maxGrow=ORYOL_CONTAINER_DEFAULT_MAX_GROW);
     /// get min grow value
@@ -38,7 +53,15 @@ public:
     int Size() const;
     /// return true if empty
     bool Empty() const;
-    
+    /// get current number of buckets
+    int NumBuckets() const;
+    /// return true while an incremental rehash is in progress
+    bool IsRehashing() const;
+    /// make sure that numElements can be held without growing
+    void Reserve(int numElements);
+    /// remove all elements (keeps current bucket table)
+    void Clear();
+
     /// test if an element exists
     bool Contains(const VALUETYPE& val) const;
     /// find element
@@ -47,41 +70,64 @@ public:
     void Add(const VALUETYPE& val);
     /// erase element
     void Erase(const VALUETYPE& val);
-    
+
 private:
-    /// get the bucket for a value
-    const Set<VALUETYPE>& findBucket(const VALUETYPE& val) const;
-    /// get the bucket for a value
-    Set<VALUETYPE>& findBucket(const VALUETYPE& val);
+    /// compute hash value
+    static uint32_t hash(const VALUETYPE& val);
+    /// allocate bucket table with number of buckets
+    void allocBuckets(Array<Set<VALUETYPE>>& dst, int numBuckets) const;
+    /// start an incremental rehash into a bigger bucket table
+    void beginRehash(int newNumBuckets);
+    /// migrate num buckets from old to new table
+    void rehashStep(int num);
+    /// finish a pending rehash
+    void finishRehash();
+    /// get the old bucket of a value if not migrated yet, or nullptr
+    const Set<VALUETYPE>* findOldBucket(uint32_t h) const;
+    /// get the old bucket of a value if not migrated yet, or nullptr
+    Set<VALUETYPE>* findOldBucket(uint32_t h);
 
     int size;
-    Set<VALUETYPE> buckets[NUMBUCKETS];
+    int minGrow;
+    int maxGrow;
+    int rehashIndex;
+    Array<Set<VALUETYPE>> buckets;
+    Array<Set<VALUETYPE>> oldBuckets;
 };
 
 //------------------------------------------------------------------------------
 template<class VALUETYPE, class HASHER, int NUMBUCKETS>
 HashSet<VALUETYPE, HASHER, NUMBUCKETS>::HashSet() :
-size(0) {
-    // empty
+size(0),
+minGrow(ORYOL_CONTAINER_DEFAULT_MIN_GROW),
+maxGrow(ORYOL_CONTAINER_DEFAULT_MAX_GROW),
+rehashIndex(0) {
+    static_assert(NUMBUCKETS > 0, "HashSet: NUMBUCKETS must be > 0");
 };
 
 //------------------------------------------------------------------------------
 template<class VALUETYPE, class HASHER, int NUMBUCKETS>
 HashSet<VALUETYPE, HASHER, NUMBUCKETS>::HashSet(const HashSet& rhs) :
-size(rhs.size) {
-    for (int i = 0; i < NUMBUCKETS; i++) {
-        this->buckets[i] = rhs.buckets[i];
-    };
+size(rhs.size),
+minGrow(rhs.minGrow),
+maxGrow(rhs.maxGrow),
+rehashIndex(rhs.rehashIndex),
+buckets(rhs.buckets),
+oldBuckets(rhs.oldBuckets) {
+    // empty
 }
 
 //------------------------------------------------------------------------------
 template<class VALUETYPE, class HASHER, int NUMBUCKETS>
 HashSet<VALUETYPE, HASHER, NUMBUCKETS>::HashSet(HashSet&& rhs) :
-size(rhs.size) {
-    for (int i = 0; i < NUMBUCKETS; i++) {
-        this->buckets[i] = std::move(rhs.buckets[i]);
-    }
+size(rhs.size),
+minGrow(rhs.minGrow),
+maxGrow(rhs.maxGrow),
+rehashIndex(rhs.rehashIndex),
+buckets(std::move(rhs.buckets)),
+oldBuckets(std::move(rhs.oldBuckets)) {
     rhs.size = 0;
+    rhs.rehashIndex = 0;
 }
 
 //------------------------------------------------------------------------------
@@ -89,9 +135,11 @@ template<class VALUETYPE, class HASHER, int NUMBUCKETS> void
 HashSet<VALUETYPE, HASHER, NUMBUCKETS>::operator=(const HashSet& rhs) {
     if (&rhs != this) {
         this->size = rhs.size;
-        for (int i = 0; i < NUMBUCKETS; i++) {
-            this->buckets[i] = rhs.buckets[i];
-        }
+        this->minGrow = rhs.minGrow;
+        this->maxGrow = rhs.maxGrow;
+        this->rehashIndex = rhs.rehashIndex;
+        this->buckets = rhs.buckets;
+        this->oldBuckets = rhs.oldBuckets;
     }
 }
 
@@ -100,31 +148,39 @@ template<class VALUETYPE, class HASHER, int NUMBUCKETS> void
 HashSet<VALUETYPE, HASHER, NUMBUCKETS>::operator=(HashSet&& rhs) {
     if (&rhs != this) {
         this->size = rhs.size;
-        for (int i = 0; i < NUMBUCKETS; i++) {
-            this->buckets[i] = std::move(rhs.buckets[i]);
-        }
+        this->minGrow = rhs.minGrow;
+        this->maxGrow = rhs.maxGrow;
+        this->rehashIndex = rhs.rehashIndex;
+        this->buckets = std::move(rhs.buckets);
+        this->oldBuckets = std::move(rhs.oldBuckets);
         rhs.size = 0;
+        rhs.rehashIndex = 0;
     }
 }
-    
+
 //------------------------------------------------------------------------------
 template<class VALUETYPE, class HASHER, int NUMBUCKETS> void
-HashSet<VALUETYPE, HASHER, NUMBUCKETS>::SetAllocStrategy(int minGrow, int maxGrow) {
-    for (int i = 0; i < NUMBUCKETS; i++) {
-        this->buckets[i].SetAllocStrategy(minGrow, maxGrow);
+HashSet<VALUETYPE, HASHER, NUMBUCKETS>::SetAllocStrategy(int minGrow_, int maxGrow_) {
+    this->minGrow = minGrow_;
+    this->maxGrow = maxGrow_;
+    for (auto& bucket : this->buckets) {
+        bucket.SetAllocStrategy(minGrow_, maxGrow_);
+    }
+    for (auto& bucket : this->oldBuckets) {
+        bucket.SetAllocStrategy(minGrow_, maxGrow_);
     }
 }
 
 //------------------------------------------------------------------------------
 template<class VALUETYPE, class HASHER, int NUMBUCKETS> int
 HashSet<VALUETYPE, HASHER, NUMBUCKETS>::GetMinGrow() const {
-    return this->buckets[0].GetMinGrow();
+    return this->minGrow;
 }
 
 //------------------------------------------------------------------------------
 template<class VALUETYPE, class HASHER, int NUMBUCKETS> int
 HashSet<VALUETYPE, HASHER, NUMBUCKETS>::GetMaxGrow() const {
-    return this->buckets[0].GetMaxGrow();
+    return this->maxGrow;
 }
 
 //------------------------------------------------------------------------------
@@ -138,48 +194,188 @@ template<class VALUETYPE, class HASHER, int NUMBUCKETS> bool
 HashSet<VALUETYPE, HASHER, NUMBUCKETS>::Empty() const {
     return (0 == this->size);
 }
-    
+
+//------------------------------------------------------------------------------
+template<class VALUETYPE, class HASHER, int NUMBUCKETS> int
+HashSet<VALUETYPE, HASHER, NUMBUCKETS>::NumBuckets() const {
+    return this->buckets.Empty() ? NUMBUCKETS : this->buckets.Size();
+}
+
+//------------------------------------------------------------------------------
+template<class VALUETYPE, class HASHER, int NUMBUCKETS> bool
+HashSet<VALUETYPE, HASHER, NUMBUCKETS>::IsRehashing() const {
+    return !this->oldBuckets.Empty();
+}
+
+//------------------------------------------------------------------------------
+template<class VALUETYPE, class HASHER, int NUMBUCKETS> void
+HashSet<VALUETYPE, HASHER, NUMBUCKETS>::Reserve(int numElements) {
+    int numBuckets = this->NumBuckets();
+    while ((numBuckets * MaxLoad) < numElements) {
+        numBuckets *= 2;
+    }
+    if (this->buckets.Empty()) {
+        this->allocBuckets(this->buckets, numBuckets);
+    }
+    else if (numBuckets > this->buckets.Size()) {
+        this->finishRehash();
+        this->beginRehash(numBuckets);
+        this->finishRehash();
+    }
+}
+
+//------------------------------------------------------------------------------
+template<class VALUETYPE, class HASHER, int NUMBUCKETS> void
+HashSet<VALUETYPE, HASHER, NUMBUCKETS>::Clear() {
+    this->oldBuckets = Array<Set<VALUETYPE>>();
+    this->rehashIndex = 0;
+    for (auto& bucket : this->buckets) {
+        bucket.Clear();
+    }
+    this->size = 0;
+}
+
 //------------------------------------------------------------------------------
 template<class VALUETYPE, class HASHER, int NUMBUCKETS> bool
 HashSet<VALUETYPE, HASHER, NUMBUCKETS>::Contains(const VALUETYPE& val) const {
-    const auto& bucket = this->findBucket(val);
-    return bucket.Contains(val);
+    return nullptr != this->Find(val);
 }
-    
+
 //------------------------------------------------------------------------------
 template<class VALUETYPE, class HASHER, int NUMBUCKETS> const VALUETYPE*
 HashSet<VALUETYPE, HASHER, NUMBUCKETS>::Find(const VALUETYPE& val) const {
-    const auto& bucket = this->findBucket(val);
-    return bucket.Find(val);
+    if (this->buckets.Empty()) {
+        return nullptr;
+    }
+    const uint32_t h = hash(val);
+    const VALUETYPE* ptr = this->buckets[h % this->buckets.Size()].Find(val);
+    if (nullptr == ptr) {
+        const Set<VALUETYPE>* oldBucket = this->findOldBucket(h);
+        if (oldBucket) {
+            ptr = oldBucket->Find(val);
+        }
+    }
+    return ptr;
 }
-    
+
 //------------------------------------------------------------------------------
 template<class VALUETYPE, class HASHER, int NUMBUCKETS> void
 HashSet<VALUETYPE, HASHER, NUMBUCKETS>::Add(const VALUETYPE& val) {
+    if (this->buckets.Empty()) {
+        this->allocBuckets(this->buckets, NUMBUCKETS);
+    }
+    else if (this->IsRehashing()) {
+        this->rehashStep(RehashStep);
+    }
+    else if (this->size >= (this->buckets.Size() * MaxLoad)) {
+        this->beginRehash(this->buckets.Size() * 2);
+    }
+    const uint32_t h = hash(val);
+    #if ORYOL_DEBUG
+    const Set<VALUETYPE>* oldBucket = this->findOldBucket(h);
+    o_assert2(!(oldBucket && oldBucket->Contains(val)), "Trying to insert duplicate element!\n");
+    #endif
+    this->buckets[h % this->buckets.Size()].Add(val);
     this->size++;
-    auto& bucket = this->findBucket(val);
-    bucket.Add(val);
 }
-    
+
 //------------------------------------------------------------------------------
 template<class VALUETYPE, class HASHER, int NUMBUCKETS> void
 HashSet<VALUETYPE, HASHER, NUMBUCKETS>::Erase(const VALUETYPE& val) {
+    if (this->buckets.Empty()) {
+        return;
+    }
+    if (this->IsRehashing()) {
+        this->rehashStep(RehashStep);
+    }
+    const uint32_t h = hash(val);
+    Set<VALUETYPE>* bucket = &this->buckets[h % this->buckets.Size()];
+    if (!bucket->Contains(val)) {
+        bucket = this->findOldBucket(h);
+        if (!(bucket && bucket->Contains(val))) {
+            return;
+        }
+    }
     o_assert_dbg(this->size > 0);
+    bucket->Erase(val);
     this->size--;
-    auto& bucket = this->findBucket(val);
-    bucket.Erase(val);
 };
-    
+
+//------------------------------------------------------------------------------
+template<class VALUETYPE, class HASHER, int NUMBUCKETS> uint32_t
+HashSet<VALUETYPE, HASHER, NUMBUCKETS>::hash(const VALUETYPE& val) {
+    return uint32_t(HASHER()(val));
+}
+
+//------------------------------------------------------------------------------
+template<class VALUETYPE, class HASHER, int NUMBUCKETS> void
+HashSet<VALUETYPE, HASHER, NUMBUCKETS>::allocBuckets(Array<Set<VALUETYPE>>& dst, int numBuckets) const {
+    o_assert_dbg(dst.Empty() && (numBuckets > 0));
+    dst.Reserve(numBuckets);
+    for (int i = 0; i < numBuckets; i++) {
+        dst.Add().SetAllocStrategy(this->minGrow, this->maxGrow);
+    }
+}
+
+//------------------------------------------------------------------------------
+template<class VALUETYPE, class HASHER, int NUMBUCKETS> void
+HashSet<VALUETYPE, HASHER, NUMBUCKETS>::beginRehash(int newNumBuckets) {
+    o_assert_dbg(!this->IsRehashing());
+    this->oldBuckets = std::move(this->buckets);
+    this->rehashIndex = 0;
+    this->allocBuckets(this->buckets, newNumBuckets);
+}
+
 //------------------------------------------------------------------------------
-template<class VALUETYPE, class HASHER, int NUMBUCKETS> const Set<VALUETYPE>&
-HashSet<VALUETYPE, HASHER, NUMBUCKETS>::findBucket(const VALUETYPE& val) const {
-    return this->buckets[uint32_t(HASHER()(val)) % NUMBUCKETS];
+template<class VALUETYPE, class HASHER, int NUMBUCKETS> void
+HashSet<VALUETYPE, HASHER, NUMBUCKETS>::rehashStep(int num) {
+    o_assert_dbg(this->IsRehashing());
+    const int numNewBuckets = this->buckets.Size();
+    const int numOldBuckets = this->oldBuckets.Size();
+    for (int i = 0; (i < num) && (this->rehashIndex < numOldBuckets); i++) {
+        Set<VALUETYPE>& src = this->oldBuckets[this->rehashIndex++];
+        for (const VALUETYPE& val : src) {
+            this->buckets[hash(val) % numNewBuckets].Add(val);
+        }
+        // drop the old bucket's memory right away
+        src = Set<VALUETYPE>();
+    }
+    if (this->rehashIndex >= numOldBuckets) {
+        this->oldBuckets = Array<Set<VALUETYPE>>();
+        this->rehashIndex = 0;
+    }
 }
 
 //------------------------------------------------------------------------------
-template<class VALUETYPE, class HASHER, int NUMBUCKETS> Set<VALUETYPE>&
-HashSet<VALUETYPE, HASHER, NUMBUCKETS>::findBucket(const VALUETYPE& val) {
-    return this->buckets[uint32_t(HASHER()(val)) % NUMBUCKETS];
+template<class VALUETYPE, class HASHER, int NUMBUCKETS> void
+HashSet<VALUETYPE, HASHER, NUMBUCKETS>::finishRehash() {
+    if (this->IsRehashing()) {
+        this->rehashStep(this->oldBuckets.Size());
+    }
+}
+
+//------------------------------------------------------------------------------
+template<class VALUETYPE, class HASHER, int NUMBUCKETS> const Set<VALUETYPE>*
+HashSet<VALUETYPE, HASHER, NUMBUCKETS>::findOldBucket(uint32_t h) const {
+    if (this->IsRehashing()) {
+        const int index = int(h % this->oldBuckets.Size());
+        if (index >= this->rehashIndex) {
+            return &this->oldBuckets[index];
+        }
+    }
+    return nullptr;
+}
+
+//------------------------------------------------------------------------------
+template<class VALUETYPE, class HASHER, int NUMBUCKETS> Set<VALUETYPE>*
+HashSet<VALUETYPE, HASHER, NUMBUCKETS>::findOldBucket(uint32_t h) {
+    if (this->IsRehashing()) {
+        const int index = int(h % this->oldBuckets.Size());
+        if (index >= this->rehashIndex) {
+            return &this->oldBuckets[index];
+        }
+    }
+    return nullptr;
 }
 
 } // namespace Oryol
\ No newline at end of file
@@ -11,6 +11,7 @@
     @see Map
 */
 #include "Core/Config.h"
+#include "Core/Types.h"
 
 namespace Oryol {
 
@@ -226,4 +227,9 @@ template<class KEY, class VALUE> inline bool operator<=(const KEY& key, const Ke
     return key <= kvp.key;
 };
 
+//------------------------------------------------------------------------------
+template<class KEY, class VALUE> struct IsTriviallyRelocatable<KeyValuePair<KEY, VALUE>> {
+    static const bool value = IsTriviallyRelocatable<KEY>::value && IsTriviallyRelocatable<VALUE>::value;
+};
+
 } // namespace Oryol
\ No newline at end of file
@@ -0,0 +1,205 @@
+#pragma once
+//------------------------------------------------------------------------------
+/**
+    @class Oryol::MPMCQueue
+    @ingroup Core
+    @brief bounded lock-free multi-producer/multi-consumer queue
+
+    A fixed-capacity ring buffer which any number of threads can
+    enqueue into and dequeue from without locking. Enqueue() returns
+    false when the queue is full, Dequeue() returns false when the
+    queue is empty. Elements are moved in and out, so move-only types
+    are fine.
+
+    Each slot carries a sequence number which tells producers and
+    consumers whether the slot is ready for them (this is Dmitry
+    Vyukov's bounded MPMC queue). The capacity is rounded up to the
+    next power of 2, the enqueue- and dequeue-positions live on
+    separate cache lines.
+
+    @see SPSCQueue, Queue
+*/
+#include "Core/Config.h"
+#include "Core/Assertion.h"
+#include "Core/Memory/Memory.h"
+#include <atomic>
+#include <type_traits>
+
+namespace Oryol {
+
+template<class TYPE> class MPMCQueue {
+public:
+    /// constructor with minimum capacity
+    explicit MPMCQueue(int capacity);
+    /// destructor
+    ~MPMCQueue();
+
+    /// not copyable
+    MPMCQueue(const MPMCQueue& rhs) = delete;
+    /// not copyable
+    void operator=(const MPMCQueue& rhs) = delete;
+
+    /// get capacity
+    int Capacity() const;
+    /// get number of elements (only a snapshot if other threads are active)
+    int Size() const;
+    /// return true if empty (only a snapshot if other threads are active)
+    bool Empty() const;
+
+    /// copy-enqueue an element, return false if full
+    bool Enqueue(const TYPE& elm);
+    /// move-enqueue an element, return false if full
+    bool Enqueue(TYPE&& elm);
+    /// dequeue an element, return false if empty
+    bool Dequeue(TYPE& outElm);
+
+private:
+    struct cell {
+        std::atomic<uint32_t> sequence;
+        typename std::aligned_storage<sizeof(TYPE), std::alignment_of<TYPE>::value>::type storage;
+    };
+    /// claim a slot for enqueueing, or nullptr if full
+    cell* claimEnqueue();
+
+    cell* cells;
+    uint32_t mask;
+    uint8_t pad0[ORYOL_CACHELINE_SIZE];
+    std::atomic<uint32_t> enqueuePos;
+    uint8_t pad1[ORYOL_CACHELINE_SIZE];
+    std::atomic<uint32_t> dequeuePos;
+    uint8_t pad2[ORYOL_CACHELINE_SIZE];
+};
+
+//------------------------------------------------------------------------------
+template<class TYPE>
+MPMCQueue<TYPE>::MPMCQueue(int capacity) :
+enqueuePos(0),
+dequeuePos(0) {
+    o_assert((capacity > 0) && (capacity <= (1<<30)));
+    uint32_t cap = 2;
+    while (cap < uint32_t(capacity)) {
+        cap <<= 1;
+    }
+    this->mask = cap - 1;
+    this->cells = (cell*) Memory::Alloc(int(cap * sizeof(cell)));
+    for (uint32_t i = 0; i < cap; i++) {
+        new(&this->cells[i].sequence) std::atomic<uint32_t>(i);
+    }
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE>
+MPMCQueue<TYPE>::~MPMCQueue() {
+    // destroy remaining elements
+    const uint32_t end = this->enqueuePos.load(std::memory_order_acquire);
+    for (uint32_t i = this->dequeuePos.load(std::memory_order_relaxed); i != end; i++) {
+        ((TYPE*)&this->cells[i & this->mask].storage)->~TYPE();
+    }
+    Memory::Free(this->cells);
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE> int
+MPMCQueue<TYPE>::Capacity() const {
+    return int(this->mask + 1);
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE> int
+MPMCQueue<TYPE>::Size() const {
+    const uint32_t d = this->dequeuePos.load(std::memory_order_acquire);
+    const uint32_t e = this->enqueuePos.load(std::memory_order_acquire);
+    const int size = int(e - d);
+    return size < 0 ? 0 : size;
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE> bool
+MPMCQueue<TYPE>::Empty() const {
+    return 0 == this->Size();
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE> typename MPMCQueue<TYPE>::cell*
+MPMCQueue<TYPE>::claimEnqueue() {
+    uint32_t pos = this->enqueuePos.load(std::memory_order_relaxed);
+    for (;;) {
+        cell* c = &this->cells[pos & this->mask];
+        const uint32_t seq = c->sequence.load(std::memory_order_acquire);
+        const int32_t diff = int32_t(seq - pos);
+        if (0 == diff) {
+            // slot is free, try to claim it
+            if (this->enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                return c;
+            }
+        }
+        else if (diff < 0) {
+            // slot still holds an element from the previous round: full
+            return nullptr;
+        }
+        else {
+            // another producer was faster
+            pos = this->enqueuePos.load(std::memory_order_relaxed);
+        }
+    }
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE> bool
+MPMCQueue<TYPE>::Enqueue(const TYPE& elm) {
+    cell* c = this->claimEnqueue();
+    if (nullptr == c) {
+        return false;
+    }
+    const uint32_t seq = c->sequence.load(std::memory_order_relaxed);
+    new(&c->storage) TYPE(elm);
+    c->sequence.store(seq + 1, std::memory_order_release);
+    return true;
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE> bool
+MPMCQueue<TYPE>::Enqueue(TYPE&& elm) {
+    cell* c = this->claimEnqueue();
+    if (nullptr == c) {
+        return false;
+    }
+    const uint32_t seq = c->sequence.load(std::memory_order_relaxed);
+    new(&c->storage) TYPE(std::move(elm));
+    c->sequence.store(seq + 1, std::memory_order_release);
+    return true;
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE> bool
+MPMCQueue<TYPE>::Dequeue(TYPE& outElm) {
+    uint32_t pos = this->dequeuePos.load(std::memory_order_relaxed);
+    cell* c = nullptr;
+    for (;;) {
+        c = &this->cells[pos & this->mask];
+        const uint32_t seq = c->sequence.load(std::memory_order_acquire);
+        const int32_t diff = int32_t(seq - (pos + 1));
+        if (0 == diff) {
+            // slot has an element, try to claim it
+            if (this->dequeuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                break;
+            }
+        }
+        else if (diff < 0) {
+            // slot not written yet: empty
+            return false;
+        }
+        else {
+            // another consumer was faster
+            pos = this->dequeuePos.load(std::memory_order_relaxed);
+        }
+    }
+    TYPE* ptr = (TYPE*) &c->storage;
+    outElm = std::move(*ptr);
+    ptr->~TYPE();
+    // mark the slot as free for the producer of the next round
+    c->sequence.store(pos + this->mask + 1, std::memory_order_release);
+    return true;
+}
+
+} // namespace Oryol
@@ -23,7 +23,13 @@
       
     When adding large numbers of elements, consider using the 
     bulk methods, these destroy the sorted order when inserting,
-    and sorting will happen inside EndBulk().
+    and sorting will happen inside EndBulk(). If the key is an integer
+    or float and the key-value-pair is trivially relocatable, EndBulk()
+    uses a radix sort (see RadixSort.h).
+
+    Lookups use a branchless binary search (see lowerBound.h), which
+    is noticeably faster than std::lower_bound for big maps since
+    there are no mispredicted branches.
     
     The Map uses a double-ended element buffer internally which
     initially has spare room at the front and end. When inserting elements,
@@ -36,6 +42,8 @@
 #include "Core/Config.h"
 #include "Core/Containers/elementBuffer.h"
 #include "Core/Containers/KeyValuePair.h"
+#include "Core/Containers/lowerBound.h"
+#include "Core/Containers/RadixSort.h"
 
 namespace Oryol {
 
@@ -235,7 +243,8 @@ Map<KEY, VALUE>::Capacity() const {
 template<class KEY, class VALUE> bool
 Map<KEY, VALUE>::Contains(const KEY& key) const {
     o_assert_dbg(!this->inBulkMode);
-    return std::binary_search(this->buffer._begin(), this->buffer._end(), key);
+    auto ptr = _priv::lowerBound(this->buffer._begin(), this->buffer.size(), key);
+    return (ptr != this->buffer._end()) && (key == ptr->key);
 }
     
 //------------------------------------------------------------------------------
@@ -243,7 +252,7 @@ template<class KEY, class VALUE> VALUE&
 Map<KEY, VALUE>::operator[](const KEY& key) {
     o_assert_dbg(!this->inBulkMode);
     o_assert_dbg(this->buffer.buf);
-    auto kvp = std::lower_bound(this->buffer._begin(), this->buffer._end(), key);
+    auto kvp = _priv::lowerBound(this->buffer._begin(), this->buffer.size(), key);
     o_assert((kvp != this->buffer._end()) && (key == kvp->key));    // not found if this triggers
     return kvp->value;
 }
@@ -253,7 +262,7 @@ template<class KEY, class VALUE> const VALUE&
 Map<KEY, VALUE>::operator[](const KEY& key) const {
     o_assert_dbg(!this->inBulkMode);
     o_assert_dbg(this->buffer.buf);
-    auto kvp = std::lower_bound(this->buffer._begin(), this->buffer._end(), key);
+    auto kvp = _priv::lowerBound(this->buffer._begin(), this->buffer.size(), key);
     o_assert_dbg((kvp != this->buffer._end()) && (key == kvp->key));    // not found if this triggers
     return kvp->value;
 }
@@ -289,7 +298,7 @@ Map<KEY, VALUE>::Add(const KeyValuePair<KEY, VALUE>& kvp) {
     if (this->buffer.spare() == 0) {
         this->grow();
     }
-    auto ptr = std::lower_bound(this->buffer._begin(), this->buffer._end(), kvp.key);
+    auto ptr = _priv::lowerBound(this->buffer._begin(), this->buffer.size(), kvp.key);
     int index = int(ptr - this->buffer._begin());
     this->buffer.insert(index, kvp);
 }
@@ -301,7 +310,7 @@ Map<KEY, VALUE>::Add(KeyValuePair<KEY, VALUE>&& kvp) {
     if (this->buffer.spare() == 0) {
         this->grow();
     }
-    auto ptr = std::lower_bound(this->buffer._begin(), this->buffer._end(), kvp.key);
+    auto ptr = _priv::lowerBound(this->buffer._begin(), this->buffer.size(), kvp.key);
     int index = int(ptr - this->buffer._begin());
     this->buffer.insert(index, std::move(kvp));
 }
@@ -319,7 +328,7 @@ Map<KEY, VALUE>::AddUnique(const KeyValuePair<KEY, VALUE>& kvp) {
     if (this->buffer.spare() == 0) {
         this->grow();
     }
-    auto ptr = std::lower_bound(this->buffer._begin(), this->buffer._end(), kvp.key);
+    auto ptr = _priv::lowerBound(this->buffer._begin(), this->buffer.size(), kvp.key);
     if ((ptr != this->buffer._end()) && (ptr->key == kvp.key)) {
         return false;
     }
@@ -337,7 +346,7 @@ Map<KEY, VALUE>::AddUnique(KeyValuePair<KEY, VALUE>&& kvp) {
     if (this->buffer.spare() == 0) {
         this->grow();
     }
-    auto ptr = std::lower_bound(this->buffer._begin(), this->buffer._end(), kvp.key);
+    auto ptr = _priv::lowerBound(this->buffer._begin(), this->buffer.size(), kvp.key);
     if ((ptr != this->buffer._end()) && (ptr->key == kvp.key)) {
         return false;
     }
@@ -357,7 +366,7 @@ Map<KEY, VALUE>::AddUnique(const KEY& key, const VALUE& value) {
 //------------------------------------------------------------------------------
 template<class KEY, class VALUE> void
 Map<KEY, VALUE>::Erase(const KEY& key) {
-    auto ptr = std::lower_bound(this->buffer._begin(), this->buffer._end(), key);
+    auto ptr = _priv::lowerBound(this->buffer._begin(), this->buffer.size(), key);
     if (ptr != this->buffer._end()) {
         const int index = int(ptr - this->buffer._begin());
         while ((index < this->buffer.size()) && (this->buffer[index].key == key)) {
@@ -412,7 +421,7 @@ Map<KEY, VALUE>::AddBulk(KeyValuePair<KEY, VALUE>&& kvp) {
 //------------------------------------------------------------------------------
 template<class KEY, class VALUE> void
 Map<KEY, VALUE>::AddBulk(const KEY& key, const VALUE& value) {
-    this->Insert(KeyValuePair<KEY, VALUE>(key, value));
+    this->AddBulk(KeyValuePair<KEY, VALUE>(key, value));
 }
 
 //------------------------------------------------------------------------------
@@ -420,7 +429,7 @@ template<class KEY, class VALUE> void
 Map<KEY, VALUE>::EndBulk() {
     o_assert(this->inBulkMode);
     this->inBulkMode = false;
-    std::sort(this->buffer._begin(), this->buffer._end());
+    RadixSort::SortAuto(this->buffer._begin(), this->buffer.size());
 }
 
 //------------------------------------------------------------------------------
@@ -442,7 +451,7 @@ Map<KEY, VALUE>::FindDuplicate(int startIndex) const {
 template<class KEY, class VALUE> int
 Map<KEY, VALUE>::FindIndex(const KEY& key) const {
     o_assert(!this->inBulkMode);
-    auto ptr = std::lower_bound(this->buffer._begin(), this->buffer._end(), key);
+    auto ptr = _priv::lowerBound(this->buffer._begin(), this->buffer.size(), key);
     if ((ptr != this->buffer._end()) && (key == ptr->key)) {
         return int(ptr - this->buffer._begin());
     }
@@ -147,11 +147,16 @@ Queue<TYPE>::moveToFront() {
         o_assert_dbg(this->buffer.buf);
         const TYPE* from = this->buffer._begin();
         TYPE* to = this->buffer.buf;
-        for (int i = 0; i < num; i++) {
-            new(to) TYPE(std::move(*from));
-            from->~TYPE();
-            to++;
-            from++;
+        if (IsTriviallyRelocatable<TYPE>::value) {
+            std::memmove((void*)to, (const void*)from, num * sizeof(TYPE));
+        }
+        else {
+            for (int i = 0; i < num; i++) {
+                new(to) TYPE(std::move(*from));
+                from->~TYPE();
+                to++;
+                from++;
+            }
         }
     }
     this->buffer.start = 0;
@@ -0,0 +1,338 @@
+#pragma once
+//------------------------------------------------------------------------------
+/**
+    @class Oryol::RadixSort
+    @ingroup Core
+    @brief LSD radix sort for integer and float keys
+
+    Sorts arrays of integers, floats or KeyValuePairs with integer or
+    float keys in O(N) with a least-significant-digit radix sort (8 bit
+    per pass). The sort is stable, so key-value pairs with identical
+    keys keep their order. Passes where all elements have the same
+    digit are skipped, so sorting e.g. 64-bit keys which only use the
+    lower 32 bits only needs 4 passes.
+
+    The caller provides a scratch buffer with room for the same number of
+    elements. The scratch buffer is used as raw memory, elements are
+    moved around with memcpy, so the element type must be trivially
+    relocatable (see IsTriviallyRelocatable in Core/Types.h). After
+    sorting, the elements are back in the original buffer, and the
+    content of the scratch buffer must be treated as uninitialized.
+
+    SortParallel() splits the array into numThreads chunks which are
+    counted and scattered on separate threads, the threads are started
+    once per sort and synchronize with a barrier between the count
+    and scatter phases of each pass, this only pays off for big arrays
+    (hundreds of thousands of elements).
+
+    SortAuto() uses a radix sort with a temporary scratch buffer
+    for radix-sortable types and falls back to std::sort otherwise,
+    and for small arrays where std::sort is faster.
+
+    To sort 64-bit ids or sort-keys together with a payload, put them
+    into a KeyValuePair<uint64_t, PAYLOAD>.
+*/
+#include "Core/Config.h"
+#include "Core/Assertion.h"
+#include "Core/Memory/Memory.h"
+#include "Core/Containers/KeyValuePair.h"
+#include <algorithm>
+#include <cstring>
+#include <type_traits>
+#if ORYOL_HAS_THREADS
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#endif
+
+namespace Oryol {
+
+namespace _priv {
+
+/// maps a sortable value to an unsigned integer key with the same order
+template<class TYPE, class=void> struct radixKey {
+    static const bool IsValid = false;
+};
+template<class TYPE> struct radixKey<TYPE, typename std::enable_if<std::is_integral<TYPE>::value>::type> {
+    static const bool IsValid = true;
+    typedef typename std::make_unsigned<TYPE>::type Type;
+    static Type Get(TYPE val) {
+        // flip the sign bit so that negative values are sorted before positive
+        const Type signBit = std::is_signed<TYPE>::value ? (Type(1) << (sizeof(Type) * 8 - 1)) : 0;
+        return Type(val) ^ signBit;
+    };
+};
+template<> struct radixKey<float> {
+    static const bool IsValid = true;
+    typedef uint32_t Type;
+    static Type Get(float val) {
+        uint32_t bits;
+        std::memcpy(&bits, &val, sizeof(bits));
+        // flip all bits of negative values, and the sign bit of positive values
+        const uint32_t mask = (bits & 0x80000000) ? 0xFFFFFFFF : 0x80000000;
+        return bits ^ mask;
+    };
+};
+template<> struct radixKey<double> {
+    static const bool IsValid = true;
+    typedef uint64_t Type;
+    static Type Get(double val) {
+        uint64_t bits;
+        std::memcpy(&bits, &val, sizeof(bits));
+        const uint64_t mask = (bits & 0x8000000000000000ull) ? 0xFFFFFFFFFFFFFFFFull : 0x8000000000000000ull;
+        return bits ^ mask;
+    };
+};
+template<class KEY, class VALUE> struct radixKey<KeyValuePair<KEY, VALUE>, typename std::enable_if<radixKey<KEY>::IsValid>::type> {
+    static const bool IsValid = true;
+    typedef typename radixKey<KEY>::Type Type;
+    static Type Get(const KeyValuePair<KEY, VALUE>& kvp) {
+        return radixKey<KEY>::Get(kvp.key);
+    };
+};
+
+#if ORYOL_HAS_THREADS
+/// a reusable barrier for a fixed number of threads
+class radixBarrier {
+public:
+    /// constructor
+    radixBarrier(int numThreads) : numThreads(numThreads) { };
+    /// wait until all threads have arrived
+    void wait() {
+        std::unique_lock<std::mutex> lock(this->mutex);
+        const int gen = this->generation;
+        if (++this->numWaiting == this->numThreads) {
+            this->numWaiting = 0;
+            this->generation++;
+            this->cond.notify_all();
+        }
+        else {
+            this->cond.wait(lock, [this, gen] { return gen != this->generation; });
+        }
+    };
+private:
+    std::mutex mutex;
+    std::condition_variable cond;
+    const int numThreads;
+    int numWaiting = 0;
+    int generation = 0;
+};
+#endif
+
+} // namespace _priv
+
+class RadixSort {
+public:
+    /// true if TYPE can be sorted with RadixSort
+    template<class TYPE> struct IsSortable {
+        static const bool value = _priv::radixKey<TYPE>::IsValid && IsTriviallyRelocatable<TYPE>::value;
+    };
+
+    /// sort values, scratch must have room for num elements
+    template<class TYPE> static void Sort(TYPE* values, TYPE* scratch, int num);
+    /// sort values with multiple threads, scratch must have room for num elements
+    template<class TYPE> static void SortParallel(TYPE* values, TYPE* scratch, int num, int numThreads);
+    /// radix sort with temporary scratch buffer if possible, otherwise std::sort
+    template<class TYPE> static void SortAuto(TYPE* values, int num);
+
+private:
+    static const int NumBuckets = 256;
+    static const int MinAutoSize = 2048;
+    static const int MinParallelSize = 1<<16;
+    static const int MaxThreads = 16;
+
+    /// compute histograms for all passes of a chunk
+    template<class TYPE> static void countAll(const TYPE* values, int num, int* hist);
+    /// compute histogram of one pass for a chunk
+    template<class TYPE> static void count(const TYPE* values, int num, int shift, int* hist);
+    /// scatter a chunk into the destination buffer by the offsets in hist
+    template<class TYPE> static void scatter(const TYPE* src, TYPE* dst, int num, int shift, int* offsets);
+    /// check if a pass can be skipped since all elements have the same digit
+    static bool trivialPass(const int* hist, int num);
+    /// tag-dispatched helpers for SortAuto
+    template<class TYPE> static void sortAuto(TYPE* values, int num, std::true_type);
+    template<class TYPE> static void sortAuto(TYPE* values, int num, std::false_type);
+};
+
+//------------------------------------------------------------------------------
+inline bool
+RadixSort::trivialPass(const int* hist, int num) {
+    for (int i = 0; i < NumBuckets; i++) {
+        if (hist[i] != 0) {
+            return hist[i] == num;
+        }
+    }
+    return true;
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE> void
+RadixSort::countAll(const TYPE* values, int num, int* hist) {
+    typedef typename _priv::radixKey<TYPE>::Type keyType;
+    const int numPasses = sizeof(keyType);
+    std::memset(hist, 0, numPasses * NumBuckets * sizeof(int));
+    for (int i = 0; i < num; i++) {
+        keyType key = _priv::radixKey<TYPE>::Get(values[i]);
+        for (int pass = 0; pass < numPasses; pass++) {
+            hist[pass * NumBuckets + (key & 0xFF)]++;
+            key >>= 8;
+        }
+    }
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE> void
+RadixSort::count(const TYPE* values, int num, int shift, int* hist) {
+    std::memset(hist, 0, NumBuckets * sizeof(int));
+    for (int i = 0; i < num; i++) {
+        hist[(_priv::radixKey<TYPE>::Get(values[i]) >> shift) & 0xFF]++;
+    }
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE> void
+RadixSort::scatter(const TYPE* src, TYPE* dst, int num, int shift, int* offsets) {
+    for (int i = 0; i < num; i++) {
+        const int digit = int((_priv::radixKey<TYPE>::Get(src[i]) >> shift) & 0xFF);
+        std::memcpy((void*)&dst[offsets[digit]++], (const void*)&src[i], sizeof(TYPE));
+    }
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE> void
+RadixSort::Sort(TYPE* values, TYPE* scratch, int num) {
+    static_assert(IsSortable<TYPE>::value, "RadixSort: type not sortable (needs integer or float key and must be trivially relocatable)");
+    o_assert_dbg(values && scratch && (num >= 0));
+    typedef typename _priv::radixKey<TYPE>::Type keyType;
+    const int numPasses = sizeof(keyType);
+
+    int hist[numPasses * NumBuckets];
+    countAll(values, num, hist);
+
+    TYPE* src = values;
+    TYPE* dst = scratch;
+    for (int pass = 0; pass < numPasses; pass++) {
+        int* passHist = &hist[pass * NumBuckets];
+        if (trivialPass(passHist, num)) {
+            continue;
+        }
+        // convert counts to start offsets
+        int offset = 0;
+        for (int i = 0; i < NumBuckets; i++) {
+            const int c = passHist[i];
+            passHist[i] = offset;
+            offset += c;
+        }
+        scatter(src, dst, num, pass * 8, passHist);
+        std::swap(src, dst);
+    }
+    if (src != values) {
+        std::memcpy((void*)values, (const void*)src, num * sizeof(TYPE));
+    }
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE> void
+RadixSort::SortParallel(TYPE* values, TYPE* scratch, int num, int numThreads) {
+    static_assert(IsSortable<TYPE>::value, "RadixSort: type not sortable (needs integer or float key and must be trivially relocatable)");
+    o_assert_dbg(values && scratch && (num >= 0));
+    #if ORYOL_HAS_THREADS
+    if (numThreads > MaxThreads) {
+        numThreads = MaxThreads;
+    }
+    if ((numThreads < 2) || (num < MinParallelSize)) {
+        Sort(values, scratch, num);
+        return;
+    }
+    typedef typename _priv::radixKey<TYPE>::Type keyType;
+    const int numPasses = sizeof(keyType);
+    const int chunkSize = (num + numThreads - 1) / numThreads;
+    int hist[MaxThreads][NumBuckets];
+    bool trivial = false;
+    _priv::radixBarrier barrier(numThreads);
+
+    // sorts the chunk of thread t, returns the buffer with the result
+    auto sortChunk = [&](int t) -> TYPE* {
+        const int start = t * chunkSize;
+        const int chunkNum = std::min(chunkSize, num - start);
+        TYPE* src = values;
+        TYPE* dst = scratch;
+        for (int pass = 0; pass < numPasses; pass++) {
+            const int shift = pass * 8;
+            count(src + start, chunkNum, shift, hist[t]);
+            barrier.wait();
+
+            // compute the start offset of each digit in each chunk, this
+            // keeps the order of elements across chunks (stable sort)
+            if (0 == t) {
+                int offset = 0;
+                trivial = false;
+                for (int i = 0; i < NumBuckets; i++) {
+                    int digitNum = 0;
+                    for (int ct = 0; ct < numThreads; ct++) {
+                        const int c = hist[ct][i];
+                        hist[ct][i] = offset;
+                        offset += c;
+                        digitNum += c;
+                    }
+                    if (digitNum == num) {
+                        trivial = true;
+                        break;
+                    }
+                }
+            }
+            barrier.wait();
+            if (trivial) {
+                continue;
+            }
+            scatter(src + start, dst, chunkNum, shift, hist[t]);
+            // all chunks must be scattered before the next pass counts them
+            barrier.wait();
+            std::swap(src, dst);
+        }
+        return src;
+    };
+
+    // the calling thread sorts the first chunk
+    std::thread threads[MaxThreads];
+    for (int t = 1; t < numThreads; t++) {
+        threads[t] = std::thread(sortChunk, t);
+    }
+    TYPE* src = sortChunk(0);
+    for (int t = 1; t < numThreads; t++) {
+        threads[t].join();
+    }
+    if (src != values) {
+        std::memcpy((void*)values, (const void*)src, num * sizeof(TYPE));
+    }
+    #else
+    Sort(values, scratch, num);
+    #endif
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE> void
+RadixSort::sortAuto(TYPE* values, int num, std::true_type) {
+    if (num < MinAutoSize) {
+        std::sort(values, values + num);
+    }
+    else {
+        TYPE* scratch = (TYPE*) Memory::Alloc(num * sizeof(TYPE));
+        Sort(values, scratch, num);
+        Memory::Free(scratch);
+    }
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE> void
+RadixSort::sortAuto(TYPE* values, int num, std::false_type) {
+    std::sort(values, values + num);
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE> void
+RadixSort::SortAuto(TYPE* values, int num) {
+    sortAuto(values, num, std::integral_constant<bool, IsSortable<TYPE>::value>());
+}
+
+} // namespace Oryol
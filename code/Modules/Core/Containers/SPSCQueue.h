@@ -0,0 +1,175 @@
+#pragma once
+//------------------------------------------------------------------------------
+/**
+    @class Oryol::SPSCQueue
+    @ingroup Core
+    @brief bounded lock-free single-producer/single-consumer queue
+
+    A fixed-capacity ring buffer for handing elements from exactly
+    one producer thread to exactly one consumer thread without
+    locking. Enqueue() returns false when the queue is full,
+    Dequeue() returns false when the queue is empty. Elements
+    are moved in and out, so move-only types are fine.
+
+    The capacity is rounded up to the next power of 2. The read- and
+    write-index live on separate cache lines, and each side keeps a
+    cached copy of the other side's index so that the shared index
+    is only touched when the cached value indicates a full or empty
+    queue.
+
+    @see MPMCQueue, Queue
+*/
+#include "Core/Config.h"
+#include "Core/Assertion.h"
+#include "Core/Memory/Memory.h"
+#include <atomic>
+
+namespace Oryol {
+
+template<class TYPE> class SPSCQueue {
+public:
+    /// constructor with minimum capacity
+    explicit SPSCQueue(int capacity);
+    /// destructor
+    ~SPSCQueue();
+
+    /// not copyable
+    SPSCQueue(const SPSCQueue& rhs) = delete;
+    /// not copyable
+    void operator=(const SPSCQueue& rhs) = delete;
+
+    /// get capacity
+    int Capacity() const;
+    /// get number of elements (only a snapshot if other threads are active)
+    int Size() const;
+    /// return true if empty (only a snapshot if other threads are active)
+    bool Empty() const;
+
+    /// copy-enqueue an element (producer thread), return false if full
+    bool Enqueue(const TYPE& elm);
+    /// move-enqueue an element (producer thread), return false if full
+    bool Enqueue(TYPE&& elm);
+    /// dequeue an element (consumer thread), return false if empty
+    bool Dequeue(TYPE& outElm);
+
+private:
+    /// get pointer to a free slot, or nullptr if full
+    TYPE* prepareEnqueue();
+
+    TYPE* buf;
+    uint32_t mask;
+    uint8_t pad0[ORYOL_CACHELINE_SIZE];
+    // written by the producer
+    std::atomic<uint32_t> writeIndex;
+    uint32_t cachedReadIndex;
+    uint8_t pad1[ORYOL_CACHELINE_SIZE];
+    // written by the consumer
+    std::atomic<uint32_t> readIndex;
+    uint32_t cachedWriteIndex;
+    uint8_t pad2[ORYOL_CACHELINE_SIZE];
+};
+
+//------------------------------------------------------------------------------
+template<class TYPE>
+SPSCQueue<TYPE>::SPSCQueue(int capacity) :
+writeIndex(0),
+cachedReadIndex(0),
+readIndex(0),
+cachedWriteIndex(0) {
+    o_assert((capacity > 0) && (capacity <= (1<<30)));
+    uint32_t cap = 1;
+    while (cap < uint32_t(capacity)) {
+        cap <<= 1;
+    }
+    this->mask = cap - 1;
+    this->buf = (TYPE*) Memory::Alloc(int(cap * sizeof(TYPE)));
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE>
+SPSCQueue<TYPE>::~SPSCQueue() {
+    // destroy remaining elements
+    const uint32_t end = this->writeIndex.load(std::memory_order_acquire);
+    for (uint32_t i = this->readIndex.load(std::memory_order_relaxed); i != end; i++) {
+        this->buf[i & this->mask].~TYPE();
+    }
+    Memory::Free(this->buf);
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE> int
+SPSCQueue<TYPE>::Capacity() const {
+    return int(this->mask + 1);
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE> int
+SPSCQueue<TYPE>::Size() const {
+    const uint32_t r = this->readIndex.load(std::memory_order_acquire);
+    const uint32_t w = this->writeIndex.load(std::memory_order_acquire);
+    return int(w - r);
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE> bool
+SPSCQueue<TYPE>::Empty() const {
+    return 0 == this->Size();
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE> TYPE*
+SPSCQueue<TYPE>::prepareEnqueue() {
+    const uint32_t w = this->writeIndex.load(std::memory_order_relaxed);
+    if ((w - this->cachedReadIndex) > this->mask) {
+        // looks full, refresh the consumer's read index
+        this->cachedReadIndex = this->readIndex.load(std::memory_order_acquire);
+        if ((w - this->cachedReadIndex) > this->mask) {
+            return nullptr;
+        }
+    }
+    return &this->buf[w & this->mask];
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE> bool
+SPSCQueue<TYPE>::Enqueue(const TYPE& elm) {
+    TYPE* slot = this->prepareEnqueue();
+    if (nullptr == slot) {
+        return false;
+    }
+    new(slot) TYPE(elm);
+    this->writeIndex.store(this->writeIndex.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+    return true;
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE> bool
+SPSCQueue<TYPE>::Enqueue(TYPE&& elm) {
+    TYPE* slot = this->prepareEnqueue();
+    if (nullptr == slot) {
+        return false;
+    }
+    new(slot) TYPE(std::move(elm));
+    this->writeIndex.store(this->writeIndex.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+    return true;
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE> bool
+SPSCQueue<TYPE>::Dequeue(TYPE& outElm) {
+    const uint32_t r = this->readIndex.load(std::memory_order_relaxed);
+    if (r == this->cachedWriteIndex) {
+        // looks empty, refresh the producer's write index
+        this->cachedWriteIndex = this->writeIndex.load(std::memory_order_acquire);
+        if (r == this->cachedWriteIndex) {
+            return false;
+        }
+    }
+    TYPE* slot = &this->buf[r & this->mask];
+    outElm = std::move(*slot);
+    slot->~TYPE();
+    this->readIndex.store(r + 1, std::memory_order_release);
+    return true;
+}
+
+} // namespace Oryol
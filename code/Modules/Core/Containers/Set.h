@@ -7,11 +7,17 @@
 
     The Set class provides a dynamic array of binary-sorted values similar
     to the std::set class. 
+
+    When adding large numbers of elements, use the bulk methods,
+    AddBulk() only appends the element, sorting and the check
+    for duplicates happens once in EndBulk().
      
     @see Array, ArrayMap, Map
 */
 #include <algorithm>
 #include "Core/Containers/Array.h"
+#include "Core/Containers/lowerBound.h"
+#include "Core/Containers/RadixSort.h"
 
 namespace Oryol {
 
@@ -51,6 +57,14 @@ public:
     void Add(const VALUE& val);
     /// erase element
     void Erase(const VALUE& val);
+    /// begin bulk-mode
+    void BeginBulk();
+    /// add element in bulk-mode (destroys sorting order)
+    void AddBulk(const VALUE& val);
+    /// add element in bulk-mode (destroys sorting order)
+    void AddBulk(VALUE&& val);
+    /// end bulk-mode (sorting happens here, duplicates are a fatal error)
+    void EndBulk();
     /// get value at index
     const VALUE& ValueAtIndex(int index) const;
     
@@ -65,26 +79,30 @@ public:
     
 private:
     Array<VALUE> valueArray;
+    bool inBulkMode;
 };
 
 //------------------------------------------------------------------------------
 template<class VALUE>
-Set<VALUE>::Set() {
+Set<VALUE>::Set() :
+inBulkMode(false) {
     // empty
 }
 
 //------------------------------------------------------------------------------
 template<class VALUE>
 Set<VALUE>::Set(const Set& rhs) :
-valueArray(rhs.valueArray) {
+valueArray(rhs.valueArray),
+inBulkMode(rhs.inBulkMode) {
     // empty
 }
 
 //------------------------------------------------------------------------------
 template<class VALUE>
 Set<VALUE>::Set(Set&& rhs) :
-valueArray(std::move(rhs.valueArray)) {
-    // empty
+valueArray(std::move(rhs.valueArray)),
+inBulkMode(false) {
+    o_assert_dbg(!rhs.inBulkMode);
 }
     
 //------------------------------------------------------------------------------
@@ -92,6 +110,7 @@ template<class VALUE> void
 Set<VALUE>::operator=(const Set& rhs) {
     if (&rhs != this) {
         this->valueArray = rhs.valueArray;
+        this->inBulkMode = rhs.inBulkMode;
     }
 }
 
@@ -99,7 +118,9 @@ Set<VALUE>::operator=(const Set& rhs) {
 template<class VALUE> void
 Set<VALUE>::operator=(Set&& rhs) {
     if (&rhs != this) {
+        o_assert_dbg(!rhs.inBulkMode);
         this->valueArray = std::move(rhs.valueArray);
+        this->inBulkMode = false;
     }
 }
     
@@ -148,13 +169,14 @@ Set<VALUE>::Clear() {
 //------------------------------------------------------------------------------
 template<class VALUE> bool
 Set<VALUE>::Contains(const VALUE& val) const {
-    return std::binary_search(this->valueArray.begin(), this->valueArray.end(), val);
+    return nullptr != this->Find(val);
 }
 
 //------------------------------------------------------------------------------
 template<class VALUE> const VALUE*
 Set<VALUE>::Find(const VALUE& val) const {
-    const VALUE* ptr = std::lower_bound(this->valueArray.begin(), this->valueArray.end(), val);
+    o_assert_dbg(!this->inBulkMode);
+    const VALUE* ptr = _priv::lowerBound(this->valueArray.begin(), this->valueArray.Size(), val);
     if (ptr != this->valueArray.end() && val == *ptr) {
         return ptr;
     }
@@ -166,9 +188,10 @@ Set<VALUE>::Find(const VALUE& val) const {
 //------------------------------------------------------------------------------
 template<class VALUE> void
 Set<VALUE>::Add(const VALUE& val) {
+    o_assert_dbg(!this->inBulkMode);
     const VALUE* begin = this->valueArray.begin();
     const VALUE* end = this->valueArray.end();
-    const VALUE* ptr = std::lower_bound(begin, end, val);
+    const VALUE* ptr = _priv::lowerBound(begin, this->valueArray.Size(), val);
     if ((ptr != end) && (*ptr == val)) {
         o_error("Trying to insert duplicate element!\n");
     }
@@ -181,15 +204,51 @@ Set<VALUE>::Add(const VALUE& val) {
 //------------------------------------------------------------------------------
 template<class VALUE> void
 Set<VALUE>::Erase(const VALUE& val) {
+    o_assert_dbg(!this->inBulkMode);
     const VALUE* begin = this->valueArray.begin();
     const VALUE* end = this->valueArray.end();
-    const VALUE* ptr = std::lower_bound(begin, end, val);
+    const VALUE* ptr = _priv::lowerBound(begin, this->valueArray.Size(), val);
     if (ptr != end) {
         int index = int(ptr - begin);
         this->valueArray.Erase(index);
     }
 }
 
+//------------------------------------------------------------------------------
+template<class VALUE> void
+Set<VALUE>::BeginBulk() {
+    o_assert(!this->inBulkMode);
+    this->inBulkMode = true;
+}
+
+//------------------------------------------------------------------------------
+template<class VALUE> void
+Set<VALUE>::AddBulk(const VALUE& val) {
+    o_assert(this->inBulkMode);
+    this->valueArray.Add(val);
+}
+
+//------------------------------------------------------------------------------
+template<class VALUE> void
+Set<VALUE>::AddBulk(VALUE&& val) {
+    o_assert(this->inBulkMode);
+    this->valueArray.Add(std::move(val));
+}
+
+//------------------------------------------------------------------------------
+template<class VALUE> void
+Set<VALUE>::EndBulk() {
+    o_assert(this->inBulkMode);
+    this->inBulkMode = false;
+    RadixSort::SortAuto(this->valueArray.begin(), this->valueArray.Size());
+    const int size = this->valueArray.Size();
+    for (int i = 1; i < size; i++) {
+        if (this->valueArray[i-1] == this->valueArray[i]) {
+            o_error("Trying to insert duplicate element!\n");
+        }
+    }
+}
+
 //------------------------------------------------------------------------------
 template<class VALUE> const VALUE&
 Set<VALUE>::ValueAtIndex(int index) const {
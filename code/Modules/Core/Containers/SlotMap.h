@@ -0,0 +1,440 @@
+#pragma once
+//------------------------------------------------------------------------------
+/**
+    @class Oryol::SlotMap
+    @ingroup Core
+    @brief unordered container with stable, generation-checked handles
+
+    A SlotMap stores values in a dense array and hands out Handles
+    which stay valid until the value is erased. Adding, erasing and
+    looking up values is O(1), iterating with begin()/end() only
+    touches live values.
+
+    A Handle consists of a slot index and a generation counter. When
+    a value is erased, the generation counter of its slot is bumped,
+    so that stale handles are detected in Contains() and Find()
+    (and trigger an assertion in operator[]). Freed slots are recycled
+    in FIFO order, this delays the reuse of a slot index as long as
+    possible.
+
+    NOTE: Erase() swaps the last value into the gap, so the order of
+    values during iteration is not stable, and pointers to values
+    are invalidated by Add() and Erase().
+
+    @see Array, Map
+*/
+#include "Core/Config.h"
+#include "Core/Containers/Array.h"
+
+namespace Oryol {
+
+template<class TYPE> class SlotMap {
+public:
+    /// a generation-checked handle to a value in the SlotMap
+    struct Handle {
+        /// invalid slot index
+        static const uint32_t InvalidIndex = 0xFFFFFFFF;
+        /// default constructor, constructs an invalid handle
+        Handle() : index(InvalidIndex), generation(0) { };
+        /// construct from index and generation
+        Handle(uint32_t index_, uint32_t generation_) : index(index_), generation(generation_) { };
+        /// equality operator
+        bool operator==(const Handle& rhs) const {
+            return (this->index == rhs.index) && (this->generation == rhs.generation);
+        };
+        /// inequality operator
+        bool operator!=(const Handle& rhs) const {
+            return !operator==(rhs);
+        };
+        /// return true if the handle has been created by a SlotMap (may still be stale!)
+        bool IsValid() const {
+            return InvalidIndex != this->index;
+        };
+        /// invalidate the handle
+        void Invalidate() {
+            this->index = InvalidIndex;
+            this->generation = 0;
+        };
+
+        uint32_t index;
+        uint32_t generation;
+    };
+
+    /// default constructor
+    SlotMap();
+    /// copy constructor
+    SlotMap(const SlotMap& rhs);
+    /// move constructor
+    SlotMap(SlotMap&& rhs);
+
+    /// copy-assignment operator
+    void operator=(const SlotMap& rhs);
+    /// move-assignment operator
+    void operator=(SlotMap&& rhs);
+
+    /// set allocation strategy
+    void SetAllocStrategy(int minGrow, int maxGrow=ORYOL_CONTAINER_DEFAULT_MAX_GROW);
+    /// get min grow value
+    int GetMinGrow() const;
+    /// get max grow value
+    int GetMaxGrow() const;
+    /// get number of live values
+    int Size() const;
+    /// return true if empty
+    bool Empty() const;
+    /// get number of allocated slots (live and free)
+    int NumSlots() const;
+
+    /// increase capacity to hold at least numElements more elements
+    void Reserve(int numElements);
+    /// erase all values (invalidates all handles)
+    void Clear();
+
+    /// copy-add a value, return handle
+    Handle Add(const TYPE& val);
+    /// move-add a value, return handle
+    Handle Add(TYPE&& val);
+    /// construct-add a value, return handle
+    template<class... ARGS> Handle Add(ARGS&&... args);
+    /// erase value by handle, returns false if the handle was stale
+    bool Erase(const Handle& handle);
+
+    /// test if handle refers to a live value
+    bool Contains(const Handle& handle) const;
+    /// get pointer to value, or nullptr if handle is stale
+    TYPE* Find(const Handle& handle);
+    /// get pointer to value, or nullptr if handle is stale
+    const TYPE* Find(const Handle& handle) const;
+    /// read/write access to value (handle must not be stale)
+    TYPE& operator[](const Handle& handle);
+    /// read-only access to value (handle must not be stale)
+    const TYPE& operator[](const Handle& handle) const;
+
+    /// get value at dense index (0..Size()-1)
+    TYPE& ValueAtIndex(int index);
+    /// get value at dense index (0..Size()-1)
+    const TYPE& ValueAtIndex(int index) const;
+    /// get handle of value at dense index (0..Size()-1)
+    Handle HandleAtIndex(int index) const;
+
+    /// C++ conform begin (iterates over live values)
+    TYPE* begin();
+    /// C++ conform begin (iterates over live values)
+    const TYPE* begin() const;
+    /// C++ conform end
+    TYPE* end();
+    /// C++ conform end
+    const TYPE* end() const;
+
+private:
+    /// a slot in the indirection table
+    struct slot {
+        /// index into dense arrays if used, or next free slot if unused
+        uint32_t index;
+        /// generation counter, bumped when slot is freed
+        uint32_t generation;
+    };
+    /// allocate a slot for the next dense index
+    Handle allocSlot();
+    /// lookup dense index of handle, or InvalidIndex
+    int denseIndex(const Handle& handle) const;
+
+    static const uint32_t noSlot = 0xFFFFFFFF;
+
+    Array<TYPE> values;
+    Array<uint32_t> valueSlots;
+    Array<slot> slots;
+    uint32_t freeHead;
+    uint32_t freeTail;
+};
+
+//------------------------------------------------------------------------------
+template<class TYPE>
+SlotMap<TYPE>::SlotMap() :
+freeHead(noSlot),
+freeTail(noSlot) {
+    // empty
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE>
+SlotMap<TYPE>::SlotMap(const SlotMap& rhs) :
+values(rhs.values),
+valueSlots(rhs.valueSlots),
+slots(rhs.slots),
+freeHead(rhs.freeHead),
+freeTail(rhs.freeTail) {
+    // empty
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE>
+SlotMap<TYPE>::SlotMap(SlotMap&& rhs) :
+values(std::move(rhs.values)),
+valueSlots(std::move(rhs.valueSlots)),
+slots(std::move(rhs.slots)),
+freeHead(rhs.freeHead),
+freeTail(rhs.freeTail) {
+    rhs.freeHead = noSlot;
+    rhs.freeTail = noSlot;
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE> void
+SlotMap<TYPE>::operator=(const SlotMap& rhs) {
+    if (&rhs != this) {
+        this->values = rhs.values;
+        this->valueSlots = rhs.valueSlots;
+        this->slots = rhs.slots;
+        this->freeHead = rhs.freeHead;
+        this->freeTail = rhs.freeTail;
+    }
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE> void
+SlotMap<TYPE>::operator=(SlotMap&& rhs) {
+    if (&rhs != this) {
+        this->values = std::move(rhs.values);
+        this->valueSlots = std::move(rhs.valueSlots);
+        this->slots = std::move(rhs.slots);
+        this->freeHead = rhs.freeHead;
+        this->freeTail = rhs.freeTail;
+        rhs.freeHead = noSlot;
+        rhs.freeTail = noSlot;
+    }
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE> void
+SlotMap<TYPE>::SetAllocStrategy(int minGrow, int maxGrow) {
+    this->values.SetAllocStrategy(minGrow, maxGrow);
+    this->valueSlots.SetAllocStrategy(minGrow, maxGrow);
+    this->slots.SetAllocStrategy(minGrow, maxGrow);
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE> int
+SlotMap<TYPE>::GetMinGrow() const {
+    return this->values.GetMinGrow();
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE> int
+SlotMap<TYPE>::GetMaxGrow() const {
+    return this->values.GetMaxGrow();
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE> int
+SlotMap<TYPE>::Size() const {
+    return this->values.Size();
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE> bool
+SlotMap<TYPE>::Empty() const {
+    return this->values.Empty();
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE> int
+SlotMap<TYPE>::NumSlots() const {
+    return this->slots.Size();
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE> void
+SlotMap<TYPE>::Reserve(int numElements) {
+    this->values.Reserve(numElements);
+    this->valueSlots.Reserve(numElements);
+    const int numFree = this->slots.Size() - this->values.Size();
+    if (numElements > numFree) {
+        this->slots.Reserve(numElements - numFree);
+    }
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE> void
+SlotMap<TYPE>::Clear() {
+    // free all used slots, this bumps their generation counter
+    while (!this->values.Empty()) {
+        this->Erase(this->HandleAtIndex(this->values.Size() - 1));
+    }
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE> typename SlotMap<TYPE>::Handle
+SlotMap<TYPE>::allocSlot() {
+    const uint32_t dense = uint32_t(this->values.Size());
+    uint32_t slotIndex;
+    if (noSlot != this->freeHead) {
+        // recycle the oldest free slot
+        slotIndex = this->freeHead;
+        this->freeHead = this->slots[slotIndex].index;
+        if (noSlot == this->freeHead) {
+            this->freeTail = noSlot;
+        }
+    }
+    else {
+        slotIndex = uint32_t(this->slots.Size());
+        slot& newSlot = this->slots.Add();
+        newSlot.generation = 1;
+    }
+    slot& s = this->slots[slotIndex];
+    s.index = dense;
+    this->valueSlots.Add(slotIndex);
+    return Handle(slotIndex, s.generation);
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE> typename SlotMap<TYPE>::Handle
+SlotMap<TYPE>::Add(const TYPE& val) {
+    Handle handle = this->allocSlot();
+    this->values.Add(val);
+    return handle;
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE> typename SlotMap<TYPE>::Handle
+SlotMap<TYPE>::Add(TYPE&& val) {
+    Handle handle = this->allocSlot();
+    this->values.Add(std::move(val));
+    return handle;
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE> template<class... ARGS> typename SlotMap<TYPE>::Handle
+SlotMap<TYPE>::Add(ARGS&&... args) {
+    Handle handle = this->allocSlot();
+    this->values.Add(std::forward<ARGS>(args)...);
+    return handle;
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE> bool
+SlotMap<TYPE>::Erase(const Handle& handle) {
+    const int dense = this->denseIndex(handle);
+    if (InvalidIndex == dense) {
+        return false;
+    }
+
+    // swap the last value into the gap and fix its slot
+    const int last = this->values.Size() - 1;
+    if (dense != last) {
+        const uint32_t lastSlot = this->valueSlots[last];
+        this->slots[lastSlot].index = uint32_t(dense);
+        this->valueSlots[dense] = lastSlot;
+    }
+    this->values.EraseSwapBack(dense);
+    this->valueSlots.PopBack();
+
+    // bump generation (skip 0, so that a default handle never matches)
+    // and append the slot to the free list
+    slot& s = this->slots[handle.index];
+    if (0 == ++s.generation) {
+        s.generation = 1;
+    }
+    s.index = noSlot;
+    if (noSlot == this->freeTail) {
+        this->freeHead = handle.index;
+    }
+    else {
+        this->slots[this->freeTail].index = handle.index;
+    }
+    this->freeTail = handle.index;
+    return true;
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE> int
+SlotMap<TYPE>::denseIndex(const Handle& handle) const {
+    if (handle.index < uint32_t(this->slots.Size())) {
+        const slot& s = this->slots[handle.index];
+        if (s.generation == handle.generation) {
+            return int(s.index);
+        }
+    }
+    return InvalidIndex;
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE> bool
+SlotMap<TYPE>::Contains(const Handle& handle) const {
+    return InvalidIndex != this->denseIndex(handle);
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE> TYPE*
+SlotMap<TYPE>::Find(const Handle& handle) {
+    const int dense = this->denseIndex(handle);
+    return (InvalidIndex != dense) ? &this->values[dense] : nullptr;
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE> const TYPE*
+SlotMap<TYPE>::Find(const Handle& handle) const {
+    const int dense = this->denseIndex(handle);
+    return (InvalidIndex != dense) ? &this->values[dense] : nullptr;
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE> TYPE&
+SlotMap<TYPE>::operator[](const Handle& handle) {
+    const int dense = this->denseIndex(handle);
+    o_assert2(InvalidIndex != dense, "SlotMap: stale handle!\n");
+    return this->values[dense];
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE> const TYPE&
+SlotMap<TYPE>::operator[](const Handle& handle) const {
+    const int dense = this->denseIndex(handle);
+    o_assert2(InvalidIndex != dense, "SlotMap: stale handle!\n");
+    return this->values[dense];
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE> TYPE&
+SlotMap<TYPE>::ValueAtIndex(int index) {
+    return this->values[index];
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE> const TYPE&
+SlotMap<TYPE>::ValueAtIndex(int index) const {
+    return this->values[index];
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE> typename SlotMap<TYPE>::Handle
+SlotMap<TYPE>::HandleAtIndex(int index) const {
+    const uint32_t slotIndex = this->valueSlots[index];
+    return Handle(slotIndex, this->slots[slotIndex].generation);
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE> TYPE*
+SlotMap<TYPE>::begin() {
+    return this->values.begin();
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE> const TYPE*
+SlotMap<TYPE>::begin() const {
+    return this->values.begin();
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE> TYPE*
+SlotMap<TYPE>::end() {
+    return this->values.end();
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE> const TYPE*
+SlotMap<TYPE>::end() const {
+    return this->values.end();
+}
+
+} // namespace Oryol
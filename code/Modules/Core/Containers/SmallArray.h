@@ -0,0 +1,603 @@
+#pragma once
+//------------------------------------------------------------------------------
+/**
+    @class Oryol::SmallArray
+    @ingroup Core
+    @brief dynamic array with inline storage for a small number of elements
+
+    The SmallArray has the same interface as Array, but stores up to
+    NUMINLINE elements inside the object itself, so that small arrays
+    don't need to allocate heap memory. When more elements are added,
+    the elements are moved into a heap buffer and the array continues
+    to work like a normal Array.
+
+    NOTE: the inline capacity is part of the type, thus you can only
+    copy or move from other SmallArrays with the same inline capacity.
+
+    NOTE: moving a SmallArray which still has its elements in the
+    inline storage must move the elements one by one (there is no
+    heap buffer which could be handed over).
+
+    NOTE: like InlineArray, an object with a big NUMINLINE is big,
+    be careful when putting it on the stack.
+
+    @see Array, InlineArray
+*/
+#include "Core/Config.h"
+#include "Core/Containers/elementBuffer.h"
+#include "Core/Containers/Slice.h"
+#include <initializer_list>
+#include <type_traits>
+
+namespace Oryol {
+
+template<class TYPE, int NUMINLINE> class SmallArray {
+    static_assert(NUMINLINE > 0, "SmallArray: NUMINLINE must be > 0");
+public:
+    /// default constructor
+    SmallArray();
+    /// copy constructor (truncates to actual size)
+    SmallArray(const SmallArray& rhs);
+    /// move constructor
+    SmallArray(SmallArray&& rhs);
+    /// initialize from initializer list
+    SmallArray(std::initializer_list<TYPE> l);
+    /// destructor
+    ~SmallArray();
+
+    /// copy-assignment operator (truncates to actual size)
+    void operator=(const SmallArray& rhs);
+    /// move-assignment operator
+    void operator=(SmallArray&& rhs);
+
+    /// set allocation strategy
+    void SetAllocStrategy(int minGrow_, int maxGrow_=ORYOL_CONTAINER_DEFAULT_MAX_GROW);
+    /// initialize the array to a fixed capacity (guarantees that no re-allocs happen)
+    void SetFixedCapacity(int fixedCapacity);
+    /// get min grow value
+    int GetMinGrow() const;
+    /// get max grow value
+    int GetMaxGrow() const;
+    /// get number of elements in array
+    int Size() const;
+    /// return true if empty
+    bool Empty() const;
+    /// get capacity of array
+    int Capacity() const;
+    /// get number of free slots at back of array
+    int Spare() const;
+    /// return true if elements are in the inline storage
+    bool IsInline() const;
+
+    /// read/write access an existing element
+    TYPE& operator[](int index);
+    /// read-only access to existing element
+    const TYPE& operator[](int index) const;
+    /// read/write access to first element (must exists)
+    TYPE& Front();
+    /// read-only access to first element (must exist)
+    const TYPE& Front() const;
+    /// read/write access to last element (must exist)
+    TYPE& Back();
+    /// read-only access to last element (must exist)
+    const TYPE& Back() const;
+    /// get a slice into the array (beware of iterator-invalidation!)
+    Slice<TYPE> MakeSlice(int offset=0, int numItems=EndOfRange);
+
+    /// increase capacity to hold at least numElements more elements
+    void Reserve(int numElements);
+    /// trim capacity to size (moves back into inline storage if possible)
+    void Trim();
+    /// clear the array (deletes elements, keeps capacity)
+    void Clear();
+
+    /// copy-add element to back of array
+    TYPE& Add(const TYPE& elm);
+    /// move-add element to back of array
+    TYPE& Add(TYPE&& elm);
+    /// construct-add new element at back of array
+    template<class... ARGS> TYPE& Add(ARGS&&... args);
+    /// copy-insert element at index, keep array order
+    void Insert(int index, const TYPE& elm);
+    /// move-insert element at index, keep array order
+    void Insert(int index, TYPE&& elm);
+
+    /// pop the last element
+    TYPE PopBack();
+    /// pop the first element
+    TYPE PopFront();
+    /// erase element at index, keep element order
+    void Erase(int index);
+    /// erase element at index, swap-in front or back element (destroys element ordering)
+    void EraseSwap(int index);
+    /// erase element at index, always swap-in from back (destroys element ordering)
+    void EraseSwapBack(int index);
+    /// erase element at index, always swap-in from front (destroys element ordering)
+    void EraseSwapFront(int index);
+    /// erase a range of elements, keep element order
+    void EraseRange(int index, int num);
+
+    /// find element index with slow linear search, return InvalidIndex if not found
+    int FindIndexLinear(const TYPE& elm, int startIndex=0, int endIndex=InvalidIndex) const;
+
+    /// C++ conform begin
+    TYPE* begin();
+    /// C++ conform begin
+    const TYPE* begin() const;
+    /// C++ conform end
+    TYPE* end();
+    /// C++ conform end
+    const TYPE* end() const;
+
+private:
+    /// pointer to inline storage
+    TYPE* inlineBuf();
+    /// point the (empty) element buffer to the inline storage
+    void resetInline();
+    /// destroy array resources
+    void destroy();
+    /// copy from other array
+    void copy(const SmallArray& rhs);
+    /// move from other array
+    void move(SmallArray&& rhs);
+    /// move elements into a new buffer with new capacity
+    void adjustCapacity(int newCapacity);
+    /// grow to make room
+    void grow();
+
+    _priv::elementBuffer<TYPE> buffer;
+    int minGrow;
+    int maxGrow;
+    typename std::aligned_storage<sizeof(TYPE), std::alignment_of<TYPE>::value>::type storage[NUMINLINE];
+};
+
+//------------------------------------------------------------------------------
+template<class TYPE, int NUMINLINE>
+SmallArray<TYPE, NUMINLINE>::SmallArray() :
+minGrow(ORYOL_CONTAINER_DEFAULT_MIN_GROW),
+maxGrow(ORYOL_CONTAINER_DEFAULT_MAX_GROW) {
+    this->resetInline();
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE, int NUMINLINE>
+SmallArray<TYPE, NUMINLINE>::SmallArray(const SmallArray& rhs) {
+    this->resetInline();
+    this->copy(rhs);
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE, int NUMINLINE>
+SmallArray<TYPE, NUMINLINE>::SmallArray(SmallArray&& rhs) {
+    this->resetInline();
+    this->move(std::move(rhs));
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE, int NUMINLINE>
+SmallArray<TYPE, NUMINLINE>::SmallArray(std::initializer_list<TYPE> l) :
+minGrow(ORYOL_CONTAINER_DEFAULT_MIN_GROW),
+maxGrow(ORYOL_CONTAINER_DEFAULT_MAX_GROW) {
+    this->resetInline();
+    this->Reserve(int(l.size()));
+    for (const auto& elm : l) {
+        this->Add(elm);
+    }
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE, int NUMINLINE>
+SmallArray<TYPE, NUMINLINE>::~SmallArray() {
+    this->destroy();
+    // prevent the elementBuffer destructor from freeing the inline storage
+    this->buffer.buf = nullptr;
+    this->buffer.cap = 0;
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE, int NUMINLINE> void
+SmallArray<TYPE, NUMINLINE>::operator=(const SmallArray& rhs) {
+    if (&rhs != this) {
+        this->destroy();
+        this->copy(rhs);
+    }
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE, int NUMINLINE> void
+SmallArray<TYPE, NUMINLINE>::operator=(SmallArray&& rhs) {
+    if (&rhs != this) {
+        this->destroy();
+        this->move(std::move(rhs));
+    }
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE, int NUMINLINE> TYPE*
+SmallArray<TYPE, NUMINLINE>::inlineBuf() {
+    return (TYPE*) &this->storage[0];
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE, int NUMINLINE> void
+SmallArray<TYPE, NUMINLINE>::resetInline() {
+    this->buffer.buf = this->inlineBuf();
+    this->buffer.cap = NUMINLINE;
+    this->buffer.start = 0;
+    this->buffer.end = 0;
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE, int NUMINLINE> void
+SmallArray<TYPE, NUMINLINE>::SetAllocStrategy(int minGrow_, int maxGrow_) {
+    this->minGrow = minGrow_;
+    this->maxGrow = maxGrow_;
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE, int NUMINLINE> void
+SmallArray<TYPE, NUMINLINE>::SetFixedCapacity(int fixedCapacity) {
+    this->minGrow = 0;
+    this->maxGrow = 0;
+    if (fixedCapacity > this->buffer.capacity()) {
+        this->adjustCapacity(fixedCapacity);
+    }
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE, int NUMINLINE> int
+SmallArray<TYPE, NUMINLINE>::GetMinGrow() const {
+    return this->minGrow;
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE, int NUMINLINE> int
+SmallArray<TYPE, NUMINLINE>::GetMaxGrow() const {
+    return this->maxGrow;
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE, int NUMINLINE> int
+SmallArray<TYPE, NUMINLINE>::Size() const {
+    return this->buffer.size();
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE, int NUMINLINE> bool
+SmallArray<TYPE, NUMINLINE>::Empty() const {
+    return this->buffer.size() == 0;
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE, int NUMINLINE> int
+SmallArray<TYPE, NUMINLINE>::Capacity() const {
+    return this->buffer.capacity();
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE, int NUMINLINE> int
+SmallArray<TYPE, NUMINLINE>::Spare() const {
+    return this->buffer.backSpare();
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE, int NUMINLINE> bool
+SmallArray<TYPE, NUMINLINE>::IsInline() const {
+    return this->buffer.buf == (const TYPE*) &this->storage[0];
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE, int NUMINLINE> TYPE&
+SmallArray<TYPE, NUMINLINE>::operator[](int index) {
+    return this->buffer[index];
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE, int NUMINLINE> const TYPE&
+SmallArray<TYPE, NUMINLINE>::operator[](int index) const {
+    return this->buffer[index];
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE, int NUMINLINE> TYPE&
+SmallArray<TYPE, NUMINLINE>::Front() {
+    return this->buffer.front();
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE, int NUMINLINE> const TYPE&
+SmallArray<TYPE, NUMINLINE>::Front() const {
+    return this->buffer.front();
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE, int NUMINLINE> TYPE&
+SmallArray<TYPE, NUMINLINE>::Back() {
+    return this->buffer.back();
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE, int NUMINLINE> const TYPE&
+SmallArray<TYPE, NUMINLINE>::Back() const {
+    return this->buffer.back();
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE, int NUMINLINE> Slice<TYPE>
+SmallArray<TYPE, NUMINLINE>::MakeSlice(int offset, int numItems) {
+    if (numItems == EndOfRange) {
+        numItems = this->buffer.size() - offset;
+    }
+    return Slice<TYPE>(this->buffer._begin(), this->buffer.size(), offset, numItems);
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE, int NUMINLINE> void
+SmallArray<TYPE, NUMINLINE>::Reserve(int numElements) {
+    int newCapacity = this->buffer.size() + numElements;
+    if (newCapacity > this->buffer.capacity()) {
+        this->adjustCapacity(newCapacity);
+    }
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE, int NUMINLINE> void
+SmallArray<TYPE, NUMINLINE>::Trim() {
+    const int curSize = this->buffer.size();
+    if (!this->IsInline() && (curSize < this->buffer.capacity())) {
+        this->adjustCapacity(curSize);
+    }
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE, int NUMINLINE> void
+SmallArray<TYPE, NUMINLINE>::Clear() {
+    this->buffer.clear();
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE, int NUMINLINE> TYPE&
+SmallArray<TYPE, NUMINLINE>::Add(const TYPE& elm) {
+    if (this->buffer.backSpare() == 0) {
+        this->grow();
+    }
+    this->buffer.pushBack(elm);
+    return this->buffer.back();
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE, int NUMINLINE> TYPE&
+SmallArray<TYPE, NUMINLINE>::Add(TYPE&& elm) {
+    if (this->buffer.backSpare() == 0) {
+        this->grow();
+    }
+    this->buffer.pushBack(std::move(elm));
+    return this->buffer.back();
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE, int NUMINLINE> template<class... ARGS> TYPE&
+SmallArray<TYPE, NUMINLINE>::Add(ARGS&&... args) {
+    if (this->buffer.backSpare() == 0) {
+        this->grow();
+    }
+    this->buffer.emplaceBack(std::forward<ARGS>(args)...);
+    return this->buffer.back();
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE, int NUMINLINE> void
+SmallArray<TYPE, NUMINLINE>::Insert(int index, const TYPE& elm) {
+    if (this->buffer.spare() == 0) {
+        this->grow();
+    }
+    this->buffer.insert(index, elm);
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE, int NUMINLINE> void
+SmallArray<TYPE, NUMINLINE>::Insert(int index, TYPE&& elm) {
+    if (this->buffer.spare() == 0) {
+        this->grow();
+    }
+    this->buffer.insert(index, std::move(elm));
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE, int NUMINLINE> TYPE
+SmallArray<TYPE, NUMINLINE>::PopBack() {
+    return this->buffer.popBack();
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE, int NUMINLINE> TYPE
+SmallArray<TYPE, NUMINLINE>::PopFront() {
+    return this->buffer.popFront();
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE, int NUMINLINE> void
+SmallArray<TYPE, NUMINLINE>::Erase(int index) {
+    this->buffer.erase(index);
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE, int NUMINLINE> void
+SmallArray<TYPE, NUMINLINE>::EraseSwap(int index) {
+    this->buffer.eraseSwap(index);
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE, int NUMINLINE> void
+SmallArray<TYPE, NUMINLINE>::EraseSwapBack(int index) {
+    this->buffer.eraseSwapBack(index);
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE, int NUMINLINE> void
+SmallArray<TYPE, NUMINLINE>::EraseSwapFront(int index) {
+    this->buffer.eraseSwapFront(index);
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE, int NUMINLINE> void
+SmallArray<TYPE, NUMINLINE>::EraseRange(int index, int num) {
+    this->buffer.eraseRange(index, num);
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE, int NUMINLINE> int
+SmallArray<TYPE, NUMINLINE>::FindIndexLinear(const TYPE& elm, int startIndex, int endIndex) const {
+    const int size = this->buffer.size();
+    if (size > 0) {
+        o_assert_dbg(startIndex < size);
+        if (InvalidIndex == endIndex) {
+            endIndex = size;
+        }
+        else {
+            o_assert_dbg(endIndex <= size);
+        }
+        o_assert_dbg(startIndex <= endIndex);
+        for (int i = startIndex; i < endIndex; i++) {
+            if (elm == this->buffer[i]) {
+                return i;
+            }
+        }
+    }
+    // fallthrough: not found
+    return InvalidIndex;
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE, int NUMINLINE> TYPE*
+SmallArray<TYPE, NUMINLINE>::begin() {
+    return this->buffer._begin();
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE, int NUMINLINE> const TYPE*
+SmallArray<TYPE, NUMINLINE>::begin() const {
+    return this->buffer._begin();
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE, int NUMINLINE> TYPE*
+SmallArray<TYPE, NUMINLINE>::end() {
+    return this->buffer._end();
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE, int NUMINLINE> const TYPE*
+SmallArray<TYPE, NUMINLINE>::end() const {
+    return this->buffer._end();
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE, int NUMINLINE> void
+SmallArray<TYPE, NUMINLINE>::destroy() {
+    this->minGrow = 0;
+    this->maxGrow = 0;
+    if (this->IsInline()) {
+        this->buffer.clear();
+    }
+    else {
+        this->buffer.destroy();
+    }
+    this->resetInline();
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE, int NUMINLINE> void
+SmallArray<TYPE, NUMINLINE>::copy(const SmallArray& rhs) {
+    o_assert_dbg(this->IsInline() && this->Empty());
+    this->minGrow = rhs.minGrow;
+    this->maxGrow = rhs.maxGrow;
+    const int num = rhs.Size();
+    if (num > NUMINLINE) {
+        this->buffer.buf = nullptr;
+        this->buffer.cap = 0;
+        this->buffer.alloc(num, 0);
+    }
+    _priv::elementBuffer<TYPE>::copyConstruct(rhs.buffer._begin(), this->buffer.buf, num);
+    this->buffer.end = num;
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE, int NUMINLINE> void
+SmallArray<TYPE, NUMINLINE>::move(SmallArray&& rhs) {
+    o_assert_dbg(this->IsInline() && this->Empty());
+    this->minGrow = rhs.minGrow;
+    this->maxGrow = rhs.maxGrow;
+    if (rhs.IsInline()) {
+        // need to move the elements one by one
+        for (TYPE& elm : rhs) {
+            this->buffer.pushBack(std::move(elm));
+        }
+        rhs.buffer.clear();
+    }
+    else {
+        // take over the heap buffer, rhs reverts to the inline storage
+        this->buffer.buf   = rhs.buffer.buf;
+        this->buffer.cap   = rhs.buffer.cap;
+        this->buffer.start = rhs.buffer.start;
+        this->buffer.end   = rhs.buffer.end;
+    }
+    rhs.resetInline();
+    // NOTE: don't reset minGrow/maxGrow, rhs is empty, but still a valid object!
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE, int NUMINLINE> void
+SmallArray<TYPE, NUMINLINE>::adjustCapacity(int newCapacity) {
+    const bool toInline = newCapacity <= NUMINLINE;
+    if (toInline && this->IsInline()) {
+        return;
+    }
+    if (!toInline && !this->IsInline()) {
+        // heap to heap, let the elementBuffer do the work
+        this->buffer.alloc(newCapacity, 0);
+        return;
+    }
+    // move between the inline storage and a heap buffer
+    _priv::elementBuffer<TYPE> newBuffer;
+    if (toInline) {
+        newBuffer.buf = this->inlineBuf();
+        newBuffer.cap = NUMINLINE;
+    }
+    else {
+        newBuffer.alloc(newCapacity, 0);
+    }
+    for (TYPE& elm : *this) {
+        newBuffer.pushBack(std::move(elm));
+    }
+    if (toInline) {
+        this->buffer.destroy();
+    }
+    else {
+        this->buffer.clear();
+    }
+    this->buffer.buf   = newBuffer.buf;
+    this->buffer.cap   = newBuffer.cap;
+    this->buffer.start = newBuffer.start;
+    this->buffer.end   = newBuffer.end;
+    newBuffer.buf = nullptr;
+    newBuffer.cap = newBuffer.start = newBuffer.end = 0;
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE, int NUMINLINE> void
+SmallArray<TYPE, NUMINLINE>::grow() {
+    const int curCapacity = this->buffer.capacity();
+    int growBy = curCapacity >> 1;
+    if (growBy < minGrow) {
+        growBy = minGrow;
+    }
+    else if (growBy > maxGrow) {
+        growBy = maxGrow;
+    }
+    o_assert_dbg(growBy > 0);
+    int newCapacity = curCapacity + growBy;
+    this->adjustCapacity(newCapacity);
+}
+
+} // namespace Oryol
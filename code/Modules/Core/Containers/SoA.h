@@ -0,0 +1,512 @@
+#pragma once
+//------------------------------------------------------------------------------
+/**
+    @class Oryol::SoA
+    @ingroup Core
+    @brief dynamic structure-of-arrays container
+
+    A SoA<TYPES...> stores each field type in its own contiguous
+    column, so that code which only updates a few fields per element
+    (e.g. particle positions) only touches the memory of those
+    fields. All columns live in a single heap allocation, and
+    each column starts at an Alignment-byte boundary so that
+    it can be processed with SIMD instructions.
+
+    Fields are addressed by their index in the template argument list:
+
+    @code
+    SoA<glm::vec4, glm::vec4, float> particles;
+    int i = particles.Add(pos, vel, 0.0f);
+    particles.Get<0>(i) += particles.Get<1>(i) * dt;
+    for (float& age : particles.MakeSlice<2>()) {
+        age += dt;
+    }
+    @endcode
+
+    Growing the container and Erase() keep the order of elements,
+    EraseSwap() moves the last element into the gap.
+
+    NOTE: Slices and pointers into the columns are invalidated by
+    operations which add or remove elements!
+
+    @see Array, Slice
+*/
+#include "Core/Config.h"
+#include "Core/Assertion.h"
+#include "Core/Memory/Memory.h"
+#include "Core/Containers/Slice.h"
+#include <tuple>
+#include <type_traits>
+
+namespace Oryol {
+
+template<class... TYPES> class SoA {
+public:
+    /// number of fields (columns)
+    static const int NumFields = sizeof...(TYPES);
+    /// byte alignment of each column
+    static const int Alignment = 16;
+    /// the type of field I
+    template<int I> using FieldType = typename std::tuple_element<I, std::tuple<TYPES...>>::type;
+
+    /// default constructor
+    SoA();
+    /// copy constructor (truncates to actual size)
+    SoA(const SoA& rhs);
+    /// move constructor
+    SoA(SoA&& rhs);
+    /// destructor
+    ~SoA();
+
+    /// copy-assignment operator (truncates to actual size)
+    void operator=(const SoA& rhs);
+    /// move-assignment operator
+    void operator=(SoA&& rhs);
+
+    /// set allocation strategy
+    void SetAllocStrategy(int minGrow_, int maxGrow_=ORYOL_CONTAINER_DEFAULT_MAX_GROW);
+    /// get min grow value
+    int GetMinGrow() const;
+    /// get max grow value
+    int GetMaxGrow() const;
+    /// get number of elements
+    int Size() const;
+    /// return true if empty
+    bool Empty() const;
+    /// get capacity
+    int Capacity() const;
+
+    /// increase capacity to hold at least numElements more elements
+    void Reserve(int numElements);
+    /// clear the container (destroys elements, keeps capacity)
+    void Clear();
+
+    /// add a default-constructed element, return its index
+    int Add();
+    /// add an element from its field values, return its index
+    int Add(const TYPES&... values);
+    /// erase element at index, keep element order
+    void Erase(int index);
+    /// erase element at index, move last element into the gap
+    void EraseSwap(int index);
+
+    /// read/write access to field I of element at index
+    template<int I> FieldType<I>& Get(int index);
+    /// read-only access to field I of element at index
+    template<int I> const FieldType<I>& Get(int index) const;
+    /// get pointer to start of column I (may be nullptr!)
+    template<int I> FieldType<I>* Data();
+    /// get pointer to start of column I (may be nullptr!)
+    template<int I> const FieldType<I>* Data() const;
+    /// get a slice into column I (beware of iterator-invalidation!)
+    template<int I> Slice<FieldType<I>> MakeSlice(int offset=0, int numItems=EndOfRange);
+
+private:
+    template<int I> using fieldIndex = std::integral_constant<int, I>;
+    typedef fieldIndex<NumFields> endIndex;
+
+    /// compute the byte offset of column I for a capacity
+    static int columnOffset(int capacity, int column);
+    /// compute the byte size of the whole buffer for a capacity
+    static int bufferSize(int capacity);
+    /// reallocate with new capacity
+    void adjustCapacity(int newCapacity);
+    /// grow to make room
+    void grow();
+    /// destroy elements and free buffer
+    void destroy();
+    /// copy from other SoA
+    void copy(const SoA& rhs);
+    /// move from other SoA
+    void move(SoA&& rhs);
+
+    /// move-construct num elements of all columns into other column pointers, destroy source
+    template<int I> void relocate(void** dstColumns, int num, fieldIndex<I>);
+    void relocate(void**, int, endIndex) { };
+    /// copy-construct num elements of all columns from rhs
+    template<int I> void copyConstruct(const SoA& rhs, int num, fieldIndex<I>);
+    void copyConstruct(const SoA&, int, endIndex) { };
+    /// destroy elements [from, to[ of all columns
+    template<int I> void destroyRange(int from, int to, fieldIndex<I>);
+    void destroyRange(int, int, endIndex) { };
+    /// default-construct element at index in all columns
+    template<int I> void defaultConstruct(int index, fieldIndex<I>);
+    void defaultConstruct(int, endIndex) { };
+    /// copy-construct element at index from field values
+    template<int I, class T, class... REST> void constructFields(int index, fieldIndex<I>, const T& value, const REST&... rest);
+    void constructFields(int, endIndex) { };
+    /// move elements [index+1, size[ one slot towards front, destroy last
+    template<int I> void moveErase(int index, fieldIndex<I>);
+    void moveErase(int, endIndex) { };
+    /// move last element into index, destroy last
+    template<int I> void swapErase(int index, fieldIndex<I>);
+    void swapErase(int, endIndex) { };
+
+    uint8_t* buf;
+    void* columns[NumFields];
+    int size;
+    int capacity;
+    int minGrow;
+    int maxGrow;
+};
+
+//------------------------------------------------------------------------------
+template<class... TYPES>
+SoA<TYPES...>::SoA() :
+buf(nullptr),
+size(0),
+capacity(0),
+minGrow(ORYOL_CONTAINER_DEFAULT_MIN_GROW),
+maxGrow(ORYOL_CONTAINER_DEFAULT_MAX_GROW) {
+    static_assert(NumFields > 0, "SoA needs at least one field type");
+    for (int i = 0; i < NumFields; i++) {
+        this->columns[i] = nullptr;
+    }
+}
+
+//------------------------------------------------------------------------------
+template<class... TYPES>
+SoA<TYPES...>::SoA(const SoA& rhs) : SoA() {
+    this->copy(rhs);
+}
+
+//------------------------------------------------------------------------------
+template<class... TYPES>
+SoA<TYPES...>::SoA(SoA&& rhs) : SoA() {
+    this->move(std::move(rhs));
+}
+
+//------------------------------------------------------------------------------
+template<class... TYPES>
+SoA<TYPES...>::~SoA() {
+    this->destroy();
+}
+
+//------------------------------------------------------------------------------
+template<class... TYPES> void
+SoA<TYPES...>::operator=(const SoA& rhs) {
+    if (&rhs != this) {
+        this->destroy();
+        this->copy(rhs);
+    }
+}
+
+//------------------------------------------------------------------------------
+template<class... TYPES> void
+SoA<TYPES...>::operator=(SoA&& rhs) {
+    if (&rhs != this) {
+        this->destroy();
+        this->move(std::move(rhs));
+    }
+}
+
+//------------------------------------------------------------------------------
+template<class... TYPES> void
+SoA<TYPES...>::SetAllocStrategy(int minGrow_, int maxGrow_) {
+    this->minGrow = minGrow_;
+    this->maxGrow = maxGrow_;
+}
+
+//------------------------------------------------------------------------------
+template<class... TYPES> int
+SoA<TYPES...>::GetMinGrow() const {
+    return this->minGrow;
+}
+
+//------------------------------------------------------------------------------
+template<class... TYPES> int
+SoA<TYPES...>::GetMaxGrow() const {
+    return this->maxGrow;
+}
+
+//------------------------------------------------------------------------------
+template<class... TYPES> int
+SoA<TYPES...>::Size() const {
+    return this->size;
+}
+
+//------------------------------------------------------------------------------
+template<class... TYPES> bool
+SoA<TYPES...>::Empty() const {
+    return 0 == this->size;
+}
+
+//------------------------------------------------------------------------------
+template<class... TYPES> int
+SoA<TYPES...>::Capacity() const {
+    return this->capacity;
+}
+
+//------------------------------------------------------------------------------
+template<class... TYPES> void
+SoA<TYPES...>::Reserve(int numElements) {
+    const int newCapacity = this->size + numElements;
+    if (newCapacity > this->capacity) {
+        this->adjustCapacity(newCapacity);
+    }
+}
+
+//------------------------------------------------------------------------------
+template<class... TYPES> void
+SoA<TYPES...>::Clear() {
+    this->destroyRange(0, this->size, fieldIndex<0>());
+    this->size = 0;
+}
+
+//------------------------------------------------------------------------------
+template<class... TYPES> int
+SoA<TYPES...>::Add() {
+    if (this->size == this->capacity) {
+        this->grow();
+    }
+    this->defaultConstruct(this->size, fieldIndex<0>());
+    return this->size++;
+}
+
+//------------------------------------------------------------------------------
+template<class... TYPES> int
+SoA<TYPES...>::Add(const TYPES&... values) {
+    if (this->size == this->capacity) {
+        this->grow();
+    }
+    this->constructFields(this->size, fieldIndex<0>(), values...);
+    return this->size++;
+}
+
+//------------------------------------------------------------------------------
+template<class... TYPES> void
+SoA<TYPES...>::Erase(int index) {
+    o_assert_range_dbg(index, this->size);
+    this->moveErase(index, fieldIndex<0>());
+    this->size--;
+}
+
+//------------------------------------------------------------------------------
+template<class... TYPES> void
+SoA<TYPES...>::EraseSwap(int index) {
+    o_assert_range_dbg(index, this->size);
+    this->swapErase(index, fieldIndex<0>());
+    this->size--;
+}
+
+//------------------------------------------------------------------------------
+template<class... TYPES> template<int I> typename SoA<TYPES...>::template FieldType<I>&
+SoA<TYPES...>::Get(int index) {
+    o_assert_range_dbg(index, this->size);
+    return this->template Data<I>()[index];
+}
+
+//------------------------------------------------------------------------------
+template<class... TYPES> template<int I> const typename SoA<TYPES...>::template FieldType<I>&
+SoA<TYPES...>::Get(int index) const {
+    o_assert_range_dbg(index, this->size);
+    return this->template Data<I>()[index];
+}
+
+//------------------------------------------------------------------------------
+template<class... TYPES> template<int I> typename SoA<TYPES...>::template FieldType<I>*
+SoA<TYPES...>::Data() {
+    static_assert((I >= 0) && (I < NumFields), "SoA: invalid field index");
+    return (FieldType<I>*) this->columns[I];
+}
+
+//------------------------------------------------------------------------------
+template<class... TYPES> template<int I> const typename SoA<TYPES...>::template FieldType<I>*
+SoA<TYPES...>::Data() const {
+    static_assert((I >= 0) && (I < NumFields), "SoA: invalid field index");
+    return (const FieldType<I>*) this->columns[I];
+}
+
+//------------------------------------------------------------------------------
+template<class... TYPES> template<int I> Slice<typename SoA<TYPES...>::template FieldType<I>>
+SoA<TYPES...>::MakeSlice(int offset, int numItems) {
+    if (nullptr == this->buf) {
+        return Slice<FieldType<I>>();
+    }
+    if (numItems == EndOfRange) {
+        numItems = this->size - offset;
+    }
+    return Slice<FieldType<I>>(this->template Data<I>(), this->size, offset, numItems);
+}
+
+//------------------------------------------------------------------------------
+template<class... TYPES> int
+SoA<TYPES...>::columnOffset(int capacity, int column) {
+    static const int fieldSizes[NumFields] = { int(sizeof(TYPES))... };
+    int offset = 0;
+    for (int i = 0; i < column; i++) {
+        offset += Memory::RoundUp(capacity * fieldSizes[i], Alignment);
+    }
+    return offset;
+}
+
+//------------------------------------------------------------------------------
+template<class... TYPES> int
+SoA<TYPES...>::bufferSize(int capacity) {
+    // extra room to align the start of the buffer
+    return columnOffset(capacity, NumFields) + Alignment;
+}
+
+//------------------------------------------------------------------------------
+template<class... TYPES> void
+SoA<TYPES...>::adjustCapacity(int newCapacity) {
+    o_assert_dbg(newCapacity >= this->size);
+    if (newCapacity == this->capacity) {
+        return;
+    }
+    uint8_t* newBuffer = nullptr;
+    void* newColumns[NumFields] = { };
+    if (newCapacity > 0) {
+        newBuffer = (uint8_t*) Memory::Alloc(bufferSize(newCapacity));
+        uint8_t* alignedBuffer = (uint8_t*) (((intptr_t)newBuffer + (Alignment - 1)) & ~intptr_t(Alignment - 1));
+        for (int i = 0; i < NumFields; i++) {
+            newColumns[i] = alignedBuffer + columnOffset(newCapacity, i);
+        }
+    }
+    if (this->size > 0) {
+        this->relocate(newColumns, this->size, fieldIndex<0>());
+    }
+    if (this->buf) {
+        Memory::Free(this->buf);
+    }
+    this->buf = newBuffer;
+    this->capacity = newCapacity;
+    for (int i = 0; i < NumFields; i++) {
+        this->columns[i] = newColumns[i];
+    }
+}
+
+//------------------------------------------------------------------------------
+template<class... TYPES> void
+SoA<TYPES...>::grow() {
+    int growBy = this->capacity >> 1;
+    if (growBy < this->minGrow) {
+        growBy = this->minGrow;
+    }
+    else if (growBy > this->maxGrow) {
+        growBy = this->maxGrow;
+    }
+    o_assert_dbg(growBy > 0);
+    this->adjustCapacity(this->capacity + growBy);
+}
+
+//------------------------------------------------------------------------------
+template<class... TYPES> void
+SoA<TYPES...>::destroy() {
+    this->Clear();
+    if (this->buf) {
+        Memory::Free(this->buf);
+        this->buf = nullptr;
+    }
+    for (int i = 0; i < NumFields; i++) {
+        this->columns[i] = nullptr;
+    }
+    this->capacity = 0;
+}
+
+//------------------------------------------------------------------------------
+template<class... TYPES> void
+SoA<TYPES...>::copy(const SoA& rhs) {
+    this->minGrow = rhs.minGrow;
+    this->maxGrow = rhs.maxGrow;
+    if (rhs.size > 0) {
+        this->adjustCapacity(rhs.size);
+        this->copyConstruct(rhs, rhs.size, fieldIndex<0>());
+        this->size = rhs.size;
+    }
+}
+
+//------------------------------------------------------------------------------
+template<class... TYPES> void
+SoA<TYPES...>::move(SoA&& rhs) {
+    this->buf = rhs.buf;
+    this->size = rhs.size;
+    this->capacity = rhs.capacity;
+    this->minGrow = rhs.minGrow;
+    this->maxGrow = rhs.maxGrow;
+    for (int i = 0; i < NumFields; i++) {
+        this->columns[i] = rhs.columns[i];
+        rhs.columns[i] = nullptr;
+    }
+    rhs.buf = nullptr;
+    rhs.size = 0;
+    rhs.capacity = 0;
+}
+
+//------------------------------------------------------------------------------
+template<class... TYPES> template<int I> void
+SoA<TYPES...>::relocate(void** dstColumns, int num, fieldIndex<I>) {
+    typedef FieldType<I> T;
+    T* src = (T*) this->columns[I];
+    T* dst = (T*) dstColumns[I];
+    for (int i = 0; i < num; i++) {
+        new(dst + i) T(std::move(src[i]));
+        src[i].~T();
+    }
+    this->relocate(dstColumns, num, fieldIndex<I+1>());
+}
+
+//------------------------------------------------------------------------------
+template<class... TYPES> template<int I> void
+SoA<TYPES...>::copyConstruct(const SoA& rhs, int num, fieldIndex<I>) {
+    typedef FieldType<I> T;
+    const T* src = (const T*) rhs.columns[I];
+    T* dst = (T*) this->columns[I];
+    for (int i = 0; i < num; i++) {
+        new(dst + i) T(src[i]);
+    }
+    this->copyConstruct(rhs, num, fieldIndex<I+1>());
+}
+
+//------------------------------------------------------------------------------
+template<class... TYPES> template<int I> void
+SoA<TYPES...>::destroyRange(int from, int to, fieldIndex<I>) {
+    typedef FieldType<I> T;
+    T* ptr = (T*) this->columns[I];
+    for (int i = from; i < to; i++) {
+        ptr[i].~T();
+    }
+    this->destroyRange(from, to, fieldIndex<I+1>());
+}
+
+//------------------------------------------------------------------------------
+template<class... TYPES> template<int I> void
+SoA<TYPES...>::defaultConstruct(int index, fieldIndex<I>) {
+    typedef FieldType<I> T;
+    new(((T*)this->columns[I]) + index) T();
+    this->defaultConstruct(index, fieldIndex<I+1>());
+}
+
+//------------------------------------------------------------------------------
+template<class... TYPES> template<int I, class T, class... REST> void
+SoA<TYPES...>::constructFields(int index, fieldIndex<I>, const T& value, const REST&... rest) {
+    new(((T*)this->columns[I]) + index) T(value);
+    this->constructFields(index, fieldIndex<I+1>(), rest...);
+}
+
+//------------------------------------------------------------------------------
+template<class... TYPES> template<int I> void
+SoA<TYPES...>::moveErase(int index, fieldIndex<I>) {
+    typedef FieldType<I> T;
+    T* ptr = (T*) this->columns[I];
+    for (int i = index; i < (this->size - 1); i++) {
+        ptr[i] = std::move(ptr[i + 1]);
+    }
+    ptr[this->size - 1].~T();
+    this->moveErase(index, fieldIndex<I+1>());
+}
+
+//------------------------------------------------------------------------------
+template<class... TYPES> template<int I> void
+SoA<TYPES...>::swapErase(int index, fieldIndex<I>) {
+    typedef FieldType<I> T;
+    T* ptr = (T*) this->columns[I];
+    const int last = this->size - 1;
+    if (index != last) {
+        ptr[index] = std::move(ptr[last]);
+    }
+    ptr[last].~T();
+    this->swapErase(index, fieldIndex<I+1>());
+}
+
+} // namespace Oryol
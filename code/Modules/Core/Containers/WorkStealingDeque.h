@@ -0,0 +1,168 @@
+#pragma once
+//------------------------------------------------------------------------------
+/**
+    @class Oryol::WorkStealingDeque
+    @ingroup Core
+    @brief bounded lock-free work-stealing deque
+
+    A fixed-capacity deque which is owned by one thread, the owner
+    pushes and pops elements at the bottom end (LIFO), while any number
+    of other threads can steal elements from the top end (FIFO). Push()
+    returns false when the deque is full, Pop() and Steal() return false
+    when the deque is empty or (in Steal()'s case) when another thread
+    won the race for the last element.
+
+    This is the Chase-Lev deque with the memory orderings from
+    "Correct and Efficient Work-Stealing for Weak Memory Models"
+    (Lê, Pop, Cohen, Zappa Nardelli, 2013). Elements must be trivially
+    copyable (usually pointers), since they are stored in atomics.
+    The capacity is rounded up to the next power of 2, the top and
+    bottom index live on separate cache lines.
+
+    @see MPMCQueue, SPSCQueue
+*/
+#include "Core/Config.h"
+#include "Core/Assertion.h"
+#include "Core/Memory/Memory.h"
+#include <atomic>
+#include <type_traits>
+
+namespace Oryol {
+
+template<class TYPE> class WorkStealingDeque {
+    static_assert(std::is_trivially_copyable<TYPE>::value, "WorkStealingDeque: TYPE must be trivially copyable");
+public:
+    /// constructor with minimum capacity
+    explicit WorkStealingDeque(int capacity);
+    /// destructor
+    ~WorkStealingDeque();
+
+    /// not copyable
+    WorkStealingDeque(const WorkStealingDeque& rhs) = delete;
+    /// not copyable
+    void operator=(const WorkStealingDeque& rhs) = delete;
+
+    /// get capacity
+    int Capacity() const;
+    /// get number of elements (only a snapshot if other threads are active)
+    int Size() const;
+    /// return true if empty (only a snapshot if other threads are active)
+    bool Empty() const;
+
+    /// push an element at the bottom (owner thread), return false if full
+    bool Push(TYPE elm);
+    /// pop an element from the bottom (owner thread), return false if empty
+    bool Pop(TYPE& outElm);
+    /// steal an element from the top (any thread), return false if empty or lost a race
+    bool Steal(TYPE& outElm);
+
+private:
+    std::atomic<TYPE>* buf;
+    int64_t mask;
+    uint8_t pad0[ORYOL_CACHELINE_SIZE];
+    // written by thieves
+    std::atomic<int64_t> top;
+    uint8_t pad1[ORYOL_CACHELINE_SIZE];
+    // written by the owner
+    std::atomic<int64_t> bottom;
+    uint8_t pad2[ORYOL_CACHELINE_SIZE];
+};
+
+//------------------------------------------------------------------------------
+template<class TYPE>
+WorkStealingDeque<TYPE>::WorkStealingDeque(int capacity) :
+top(0),
+bottom(0) {
+    o_assert((capacity > 0) && (capacity <= (1<<30)));
+    int64_t cap = 1;
+    while (cap < capacity) {
+        cap <<= 1;
+    }
+    this->mask = cap - 1;
+    this->buf = (std::atomic<TYPE>*) Memory::Alloc(int(cap * sizeof(std::atomic<TYPE>)));
+    for (int64_t i = 0; i < cap; i++) {
+        new(&this->buf[i]) std::atomic<TYPE>();
+    }
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE>
+WorkStealingDeque<TYPE>::~WorkStealingDeque() {
+    Memory::Free(this->buf);
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE> int
+WorkStealingDeque<TYPE>::Capacity() const {
+    return int(this->mask + 1);
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE> int
+WorkStealingDeque<TYPE>::Size() const {
+    const int64_t b = this->bottom.load(std::memory_order_acquire);
+    const int64_t t = this->top.load(std::memory_order_acquire);
+    return (b > t) ? int(b - t) : 0;
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE> bool
+WorkStealingDeque<TYPE>::Empty() const {
+    return 0 == this->Size();
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE> bool
+WorkStealingDeque<TYPE>::Push(TYPE elm) {
+    const int64_t b = this->bottom.load(std::memory_order_relaxed);
+    const int64_t t = this->top.load(std::memory_order_acquire);
+    if ((b - t) > this->mask) {
+        return false;
+    }
+    this->buf[b & this->mask].store(elm, std::memory_order_relaxed);
+    this->bottom.store(b + 1, std::memory_order_release);
+    return true;
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE> bool
+WorkStealingDeque<TYPE>::Pop(TYPE& outElm) {
+    const int64_t b = this->bottom.load(std::memory_order_relaxed) - 1;
+    this->bottom.store(b, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    int64_t t = this->top.load(std::memory_order_relaxed);
+    if (t > b) {
+        // was empty
+        this->bottom.store(b + 1, std::memory_order_relaxed);
+        return false;
+    }
+    outElm = this->buf[b & this->mask].load(std::memory_order_relaxed);
+    if (t == b) {
+        // last element, race against thieves
+        const bool won = this->top.compare_exchange_strong(t, t + 1,
+            std::memory_order_seq_cst, std::memory_order_relaxed);
+        this->bottom.store(b + 1, std::memory_order_relaxed);
+        return won;
+    }
+    return true;
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE> bool
+WorkStealingDeque<TYPE>::Steal(TYPE& outElm) {
+    int64_t t = this->top.load(std::memory_order_acquire);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    const int64_t b = this->bottom.load(std::memory_order_acquire);
+    if (t >= b) {
+        return false;
+    }
+    const TYPE elm = this->buf[t & this->mask].load(std::memory_order_relaxed);
+    if (!this->top.compare_exchange_strong(t, t + 1,
+        std::memory_order_seq_cst, std::memory_order_relaxed)) {
+        return false;
+    }
+    outElm = elm;
+    return true;
+}
+
+} // namespace Oryol
@@ -18,10 +18,15 @@
     
     '----' - empty memory slot (guaranteed to be destructed)
     'XXXX' - valid element (guaranteed to be constructed)
+
+    Elements of types where IsTriviallyRelocatable<TYPE> is true
+    (see Core/Types.h) are moved around with memcpy/memmove instead
+    of move-constructing/assigning and destroying them one by one.
 */
 #include "Core/Types.h"
 #include "Core/Assertion.h"
 #include "Core/Memory/Memory.h"
+#include <cstring>
 
 //------------------------------------------------------------------------------
 namespace Oryol {
@@ -82,6 +87,8 @@ public:
     static void copyConstruct(const TYPE* from, TYPE* to, int num);
     /// copy-assign element range UNTESTED
     static void copyAssign(const TYPE* from, TYPE* to, int num);
+    /// move element into a constructed slot, the source slot is destructed after
+    static void relocateAssign(TYPE* from, TYPE* to);
     
     /// push element at back (backSpare must be > 0!)
     void pushBack(const TYPE& elm);
@@ -333,10 +340,15 @@ elementBuffer<TYPE>::alloc(int newCapacity, int newStart) {
         o_assert_range_dbg(this->start, this->cap);
         TYPE* src = &this->buf[this->start];
         TYPE* dst = newElmStart;
-        for (int i = 0; i < curSize; i++) {
-            new(dst++) TYPE(std::move(*src));
-            // must still call destructor on move-source
-            src++->~TYPE();
+        if (IsTriviallyRelocatable<TYPE>::value) {
+            std::memcpy((void*)dst, (const void*)src, curSize * sizeof(TYPE));
+        }
+        else {
+            for (int i = 0; i < curSize; i++) {
+                new(dst++) TYPE(std::move(*src));
+                // must still call destructor on move-source
+                src++->~TYPE();
+            }
         }
     }
     
@@ -411,6 +423,20 @@ elementBuffer<TYPE>::copyAssign(const TYPE* from, TYPE* to, int num) {
     }
 }
 
+//------------------------------------------------------------------------------
+template<class TYPE> void
+elementBuffer<TYPE>::relocateAssign(TYPE* from, TYPE* to) {
+    o_assert_dbg(from != to);
+    if (IsTriviallyRelocatable<TYPE>::value) {
+        to->~TYPE();
+        std::memcpy((void*)to, (const void*)from, sizeof(TYPE));
+    }
+    else {
+        *to = std::move(*from);
+        from->~TYPE();
+    }
+}
+
 //------------------------------------------------------------------------------
 template<class TYPE> void
 elementBuffer<TYPE>::pushBack(const TYPE& elm) {
@@ -473,11 +499,17 @@ template<class TYPE> TYPE*
 elementBuffer<TYPE>::moveInsertFront(int index) {
     // free a slot for insertion by moving the elements
     // at and before it towards the front
-    // the freed slot will NOT be deconstructed!
+    // the freed slot will NOT be deconstructed, except for trivially
+    // relocatable types, where the slot is left as raw memory!
     o_assert_dbg(this->buf);
     o_assert_dbg((index >= 0) && (index <= this->size()));
     
     o_assert_dbg((this->start > 0) && (this->start < this->cap));
+    if (IsTriviallyRelocatable<TYPE>::value) {
+        std::memmove((void*)&this->buf[this->start-1], (const void*)&this->buf[this->start], index * sizeof(TYPE));
+        this->start--;
+        return &this->buf[this->start + index];
+    }
     new(&this->buf[this->start-1]) TYPE(std::move(this->buf[start]));
     for (int i = this->start; i < (this->start + index - 1); i++) {
         o_assert_dbg((i >= 0) && ((i+1) < this->cap));
@@ -493,11 +525,18 @@ template<class TYPE> TYPE*
 elementBuffer<TYPE>::moveInsertBack(int index) {
     // free a slot for insertion by moving the elements
     // after it towards the back
-    // the freed slot will NOT be deconstructed!
+    // the freed slot will NOT be deconstructed, except for trivially
+    // relocatable types, where the slot is left as raw memory!
     o_assert_dbg(this->buf);
     o_assert_dbg((index >= 0) && (index < this->size()));
 
     o_assert_dbg((this->end > 0) && (this->end < this->cap));
+    if (IsTriviallyRelocatable<TYPE>::value) {
+        TYPE* ptr = &this->buf[this->start + index];
+        std::memmove((void*)(ptr + 1), (const void*)ptr, (this->size() - index) * sizeof(TYPE));
+        this->end++;
+        return ptr;
+    }
     new(&this->buf[this->end]) TYPE(std::move(this->buf[this->end-1]));
     for (int i = this->end - 1; i > (this->start + index); i--) {
         o_assert_dbg(((i-1) >= 0) && (i < this->cap));
@@ -513,6 +552,12 @@ template<class TYPE> void
 elementBuffer<TYPE>::moveEraseFront(int index) {
     // erase a slot by moving elements from the front
     o_assert_dbg(this->buf && (index >= 0) && (index < this->size()));
+    if (IsTriviallyRelocatable<TYPE>::value) {
+        this->buf[this->start + index].~TYPE();
+        std::memmove((void*)&this->buf[this->start + 1], (const void*)&this->buf[this->start], index * sizeof(TYPE));
+        this->start++;
+        return;
+    }
     for (int i = this->start + index; i > this->start; i--) {
         o_assert_dbg(((i-1) >= 0) && (i < this->cap));
         this->buf[i] = std::move(this->buf[i - 1]);
@@ -527,6 +572,13 @@ template<class TYPE> void
 elementBuffer<TYPE>::moveEraseBack(int index) {
     // erase a slot by moving elements from the back
     o_assert_dbg(this->buf && (index >= 0) && (index < this->size()));
+    if (IsTriviallyRelocatable<TYPE>::value) {
+        TYPE* ptr = &this->buf[this->start + index];
+        ptr->~TYPE();
+        std::memmove((void*)ptr, (const void*)(ptr + 1), (this->size() - index - 1) * sizeof(TYPE));
+        this->end--;
+        return;
+    }
     for (int i = this->start + index; i < (this->end - 1); i++) {
         o_assert_dbg((i >= 0) && ((i+1) < this->cap));
         this->buf[i] = std::move(this->buf[i + 1]);
@@ -540,9 +592,10 @@ elementBuffer<TYPE>::moveEraseBack(int index) {
 template<class TYPE> TYPE*
 elementBuffer<TYPE>::prepareInsert(int index, bool& outSlotConstructed) {
 
-    // this method will return a pointer to an empty, destructed slot!
+    // this method will return a pointer to an empty slot, outSlotConstructed
+    // tells whether the slot still contains a (moved-from) element
 
-    outSlotConstructed = true;
+    outSlotConstructed = !IsTriviallyRelocatable<TYPE>::value;
     const int size = this->size();
     if (index == size) {
         // special case insert at end of array
@@ -691,15 +744,14 @@ elementBuffer<TYPE>::eraseSwap(int index) {
             // swap-in element from back
             o_assert_range_dbg(this->start+index, this->cap);
             o_assert_dbg((this->end > 0) && (this->end <= this->cap));
-            this->buf[this->start + index] = std::move(this->buf[--this->end]);
-            this->buf[this->end].~TYPE();
+            this->relocateAssign(&this->buf[--this->end], &this->buf[this->start + index]);
         }
         else {
             // swap-in element from front
             o_assert_range_dbg(this->start+index, this->cap);
             o_assert_range_dbg(this->start, this->cap);
-            this->buf[this->start + index] = std::move(this->buf[this->start]);
-            this->buf[this->start++].~TYPE();
+            this->relocateAssign(&this->buf[this->start], &this->buf[this->start + index]);
+            this->start++;
         }
     }
 }
@@ -718,8 +770,7 @@ elementBuffer<TYPE>::eraseSwapBack(int index) {
         // swap-in element from back
         o_assert_range_dbg(this->start+index, this->cap);
         o_assert_dbg((this->end > 0) && (this->end <= this->cap));
-        this->buf[this->start + index] = std::move(this->buf[--this->end]);
-        this->buf[this->end].~TYPE();
+        this->relocateAssign(&this->buf[--this->end], &this->buf[this->start + index]);
     }
 }
 
@@ -736,8 +787,8 @@ elementBuffer<TYPE>::eraseSwapFront(int index) {
         // swap-in element from front
         o_assert_range_dbg(this->start+index, this->cap);
         o_assert_range_dbg(this->start, this->cap);
-        this->buf[this->start + index] = std::move(this->buf[this->start]);
-        this->buf[this->start++].~TYPE();
+        this->relocateAssign(&this->buf[this->start], &this->buf[this->start + index]);
+        this->start++;
     }
 }
 
@@ -748,6 +799,15 @@ elementBuffer<TYPE>::eraseRange(int index, int num) {
     if (0 == num) {
         return;
     }
+    if (IsTriviallyRelocatable<TYPE>::value) {
+        TYPE* ptr = &this->buf[this->start + index];
+        for (int i = 0; i < num; i++) {
+            ptr[i].~TYPE();
+        }
+        std::memmove((void*)ptr, (const void*)(ptr + num), (this->size() - index - num) * sizeof(TYPE));
+        this->end -= num;
+        return;
+    }
     int i = this->start + index;
     for (; i < (this->end - num); i++) {
         o_assert_range_dbg(i, this->cap);
@@ -0,0 +1,50 @@
+#pragma once
+//------------------------------------------------------------------------------
+/*
+    @fn Oryol::_priv::lowerBound
+    @ingroup _priv
+
+    Branchless binary search in a sorted array, returns a pointer to the
+    first element which is not less than key (same as std::lower_bound).
+
+    The search loop only advances a base pointer by a conditional move,
+    so there are no hard-to-predict branches, and the loop count only
+    depends on the number of elements. For scalar keys the last few
+    elements are checked with a linear compare-and-count which the
+    compiler can vectorize.
+*/
+#include "Core/Config.h"
+#include <type_traits>
+
+namespace Oryol {
+namespace _priv {
+
+template<class TYPE, class KEY> inline const TYPE*
+lowerBound(const TYPE* first, int num, const KEY& key) {
+    const int linearNum = std::is_scalar<KEY>::value ? 8 : 1;
+    const TYPE* base = first;
+    while (num > linearNum) {
+        const int half = num >> 1;
+        #if ORYOL_HAS_PREFETCH
+        // fetch both possible positions of the next iteration
+        __builtin_prefetch(base + (half >> 1));
+        __builtin_prefetch(base + half + (half >> 1));
+        #endif
+        base = (base[half] < key) ? base + half : base;
+        num -= half;
+    }
+    int n = 0;
+    for (int i = 0; i < num; i++) {
+        n += (base[i] < key) ? 1 : 0;
+    }
+    return base + n;
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE, class KEY> inline TYPE*
+lowerBound(TYPE* first, int num, const KEY& key) {
+    return const_cast<TYPE*>(lowerBound((const TYPE*)first, num, key));
+}
+
+} // namespace _priv
+} // namespace Oryol
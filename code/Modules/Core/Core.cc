@@ -4,6 +4,8 @@
 #include "Pre.h"
 #include "Core.h"
 #include "Core/RunLoop.h"
+#include "Core/Time/Clock.h"
+#include "Core/Time/TimerWheel.h"
 #include "Core/Threading/ThreadLocalPtr.h"
 #include "Core/Trace.h"
 #include <thread>
@@ -13,6 +15,7 @@ namespace Oryol {
 namespace {
     ORYOL_THREADLOCAL_PTR(RunLoop) threadPreRunLoop = nullptr;
     ORYOL_THREADLOCAL_PTR(RunLoop) threadPostRunLoop = nullptr;
+    ORYOL_THREADLOCAL_PTR(TimerWheel) threadTimers = nullptr;
     struct _state {
         std::thread::id mainThreadId;
         #if ORYOL_PROFILING
@@ -20,6 +23,26 @@ namespace {
         #endif
     };
     _state* state = nullptr;
+
+    //--------------------------------------------------------------------------
+    void createThreadObjects() {
+        threadPreRunLoop = Memory::New<RunLoop>();
+        threadPostRunLoop = Memory::New<RunLoop>();
+        threadTimers = Memory::New<TimerWheel>();
+        threadPreRunLoop->Add([] {
+            threadTimers->Update(Clock::Now());
+        }, RunLoop::Critical, "TimerWheel");
+    }
+
+    //--------------------------------------------------------------------------
+    void destroyThreadObjects() {
+        Memory::Delete<RunLoop>(threadPreRunLoop);
+        Memory::Delete<RunLoop>(threadPostRunLoop);
+        Memory::Delete<TimerWheel>(threadTimers);
+        threadPreRunLoop = nullptr;
+        threadPostRunLoop = nullptr;
+        threadTimers = nullptr;
+    }
 }
 
 //------------------------------------------------------------------------------
@@ -28,10 +51,10 @@ Core::Setup() {
     o_assert_dbg(!IsValid());
     o_assert_dbg(nullptr == threadPreRunLoop);
     o_assert_dbg(nullptr == threadPostRunLoop);
+    o_assert_dbg(nullptr == threadTimers);
     state = Memory::New<_state>();
     state->mainThreadId = std::this_thread::get_id();
-    threadPreRunLoop = Memory::New<RunLoop>();
-    threadPostRunLoop = Memory::New<RunLoop>();
+    createThreadObjects();
 }
 
 //------------------------------------------------------------------------------
@@ -40,15 +63,9 @@ Core::Discard() {
     o_assert(IsValid());
     o_assert(threadPreRunLoop);
     o_assert(threadPostRunLoop);
-    Memory::Delete<RunLoop>(threadPreRunLoop);
-    Memory::Delete<RunLoop>(threadPostRunLoop);
+    destroyThreadObjects();
     Memory::Delete(state);
-    threadPreRunLoop = nullptr;
-    threadPostRunLoop = nullptr;
     state = nullptr;
-
-    // do NOT destroy the thread-local string atom table to
-    // ensure that string atom data pointers still point to valid data!!!    
 }
 
 //------------------------------------------------------------------------------
@@ -71,6 +88,13 @@ Core::PostRunLoop() {
     return threadPostRunLoop;
 }
 
+//------------------------------------------------------------------------------
+TimerWheel*
+Core::Timers() {
+    o_assert(threadTimers);
+    return threadTimers;
+}
+
 //------------------------------------------------------------------------------
 bool
 Core::IsMainThread() {
@@ -88,8 +112,7 @@ Core::EnterThread() {
     #if ORYOL_HAS_THREADS
     o_assert(nullptr == threadPreRunLoop);
     o_assert(nullptr == threadPostRunLoop);
-    threadPreRunLoop = Memory::New<RunLoop>();
-    threadPostRunLoop = Memory::New<RunLoop>();
+    createThreadObjects();
     #endif
 }
 
@@ -99,13 +122,7 @@ Core::LeaveThread() {
     #if ORYOL_HAS_THREADS
     o_assert(threadPreRunLoop);
     o_assert(threadPostRunLoop);
-    Memory::Delete<RunLoop>(threadPreRunLoop);
-    Memory::Delete<RunLoop>(threadPostRunLoop);
-    threadPreRunLoop = nullptr;
-    threadPostRunLoop = nullptr;
-
-    // do NOT destroy the thread-local string atom table to
-    // ensure that string atom data pointers still point to valid data
+    destroyThreadObjects();
     #endif
 }
 
@@ -10,6 +10,7 @@
 */
 #include "Core/Types.h"
 #include "Core/RunLoop.h"
+#include "Core/Time/TimerWheel.h"
 
 namespace Oryol {
 
@@ -26,6 +27,8 @@ public:
     static class RunLoop* PreRunLoop();
     /// get pointer to the per-thread 'after-frame' runloop
     static class RunLoop* PostRunLoop();
+    /// get pointer to the per-thread timer wheel (driven by the 'before-frame' runloop)
+    static class TimerWheel* Timers();
 
     /// called when a thread is entered
     static void EnterThread();
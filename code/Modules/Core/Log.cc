@@ -8,6 +8,9 @@
 #include "Core/Logger.h"
 #include "Core/StackTrace.h"
 #include "Core/Containers/Array.h"
+#include "Core/Memory/Memory.h"
+#include "Core/BinaryLog.h"
+#include "Core/private/logQueue.h"
 #if ORYOL_WINDOWS
 #include <Windows.h>
 #endif
@@ -17,15 +20,14 @@
 
 #if ORYOL_HAS_THREADS
 #include <mutex>
+#include <atomic>
 static std::mutex lockMutex;
 #define SCOPED_LOCK std::lock_guard<std::mutex> lock(lockMutex)
 #else
 #define SCOPED_LOCK
 #endif
 
-#if ORYOL_WINDOWS
 static const int LogBufSize = 4 * 1024;
-#endif
 
 namespace Oryol {
 
@@ -34,6 +36,102 @@ using namespace std;
 
 static Log::Level curLogLevel = Log::Level::Dbg;
 static Array<Ptr<Logger>> loggers;
+#if ORYOL_HAS_THREADS
+static logQueue* asyncQueue = nullptr;
+static BinaryLog::Writer binaryWriter;
+static std::atomic<bool> binaryMode{false};
+#endif
+
+//------------------------------------------------------------------------------
+/**
+ Writes a message to the loggers, or to stdout if no loggers have
+ been added, the lock must be held by the caller.
+*/
+static void
+vwrite(Log::Level lvl, const char* msg, va_list args) {
+    if (loggers.Empty()) {
+        #if ORYOL_ANDROID
+            android_LogPriority pri = ANDROID_LOG_DEFAULT;
+            switch (lvl) {
+                case Log::Level::Error: pri = ANDROID_LOG_ERROR; break;
+                case Log::Level::Warn:  pri = ANDROID_LOG_WARN; break;
+                case Log::Level::Info:  pri = ANDROID_LOG_INFO; break;
+                case Log::Level::Dbg:   pri = ANDROID_LOG_DEBUG; break;
+                default:                pri = ANDROID_LOG_DEFAULT; break;
+            }
+            __android_log_vprint(pri, "oryol", msg, args);
+        #else
+            #if ORYOL_WINDOWS
+            va_list argsCopy;
+            va_copy(argsCopy, args);
+            #endif
+
+            // do the vprintf, this will destroy the original
+            // va_list, so we made a copy before if necessary
+            std::vprintf(msg, args);
+
+            #if ORYOL_WINDOWS
+                char buf[LogBufSize];
+                std::vsnprintf(buf, sizeof(buf), msg, argsCopy);
+                #if ORYOL_WINDOWS
+                    buf[LogBufSize - 1] = 0;
+                    OutputDebugStringA(buf);
+                #endif
+            #endif
+        #endif
+    }
+    else {
+        for (auto l : loggers) {
+            l->VPrint(lvl, msg, args);
+        }
+    }
+}
+
+//------------------------------------------------------------------------------
+/**
+ Writes an already formatted message, the lock must be held by the caller.
+*/
+static void
+writef(Log::Level lvl, const char* fmt, ...) {
+    va_list args;
+    va_start(args, fmt);
+    vwrite(lvl, fmt, args);
+    va_end(args);
+}
+
+#if ORYOL_HAS_THREADS
+//------------------------------------------------------------------------------
+/**
+ Called on the asynchronous logging thread with a formatted message.
+*/
+static void
+writeText(Log::Level lvl, const void* data, int /*size*/) {
+    SCOPED_LOCK;
+    writef(lvl, "%s", (const char*) data);
+}
+
+//------------------------------------------------------------------------------
+static void
+writeDroppedText(int numDropped) {
+    SCOPED_LOCK;
+    writef(Log::Level::Warn, "Log: %d messages dropped, log buffer was full!\n", numDropped);
+}
+
+//------------------------------------------------------------------------------
+/**
+ Called on the asynchronous logging thread with an encoded binary message.
+*/
+static void
+writeBinary(Log::Level lvl, const void* data, int size) {
+    binaryWriter.WriteMessage(lvl, (const uint8_t*) data, size);
+}
+
+//------------------------------------------------------------------------------
+static void
+writeDroppedBinary(int numDropped) {
+    binaryWriter.WriteDropped(numDropped);
+}
+#endif
 
 //------------------------------------------------------------------------------
 void
@@ -44,6 +142,16 @@ Log::AddLogger(const Ptr<Logger>& l) {
     }
 }
 
+//------------------------------------------------------------------------------
+void
+Log::RemoveLogger(const Ptr<Logger>& l) {
+    SCOPED_LOCK;
+    const int index = loggers.FindIndexLinear(l);
+    if (InvalidIndex != index) {
+        loggers.Erase(index);
+    }
+}
+
 //------------------------------------------------------------------------------
 int
 Log::GetNumLoggers() {
@@ -68,6 +176,83 @@ Log::GetLogLevel() {
     return curLogLevel;
 }
 
+//------------------------------------------------------------------------------
+/**
+ NOTE: the logQueue is created once and never destroyed, since threads
+ keep pointers to their message buffers. Switching between text and
+ binary mode while other threads are logging isn't supported.
+*/
+void
+Log::StartAsync(const AsyncLogSetup& setup) {
+    #if ORYOL_HAS_THREADS
+    o_assert(!IsAsync());
+    if (nullptr == asyncQueue) {
+        asyncQueue = Memory::New<logQueue>();
+    }
+    bool binary = false;
+    if (setup.BinaryLogPath) {
+        binary = binaryWriter.Open(setup.BinaryLogPath);
+        if (!binary) {
+            Log::Warn("Log::StartAsync(): failed to open binary log file '%s', logging text!\n", setup.BinaryLogPath);
+        }
+    }
+    binaryMode.store(binary, std::memory_order_release);
+    if (binary) {
+        asyncQueue->start(setup, writeBinary, writeDroppedBinary);
+    }
+    else {
+        asyncQueue->start(setup, writeText, writeDroppedText);
+    }
+    #endif
+}
+
+//------------------------------------------------------------------------------
+void
+Log::StopAsync() {
+    #if ORYOL_HAS_THREADS
+    o_assert(IsAsync());
+    asyncQueue->stop();
+    if (binaryMode) {
+        binaryWriter.Close();
+        binaryMode = false;
+    }
+    #endif
+}
+
+//------------------------------------------------------------------------------
+bool
+Log::IsAsync() {
+    #if ORYOL_HAS_THREADS
+    return asyncQueue && asyncQueue->isActive();
+    #else
+    return false;
+    #endif
+}
+
+//------------------------------------------------------------------------------
+void
+Log::Flush() {
+    #if ORYOL_HAS_THREADS
+    if (asyncQueue) {
+        asyncQueue->flush();
+        if (binaryMode) {
+            binaryWriter.Flush();
+        }
+    }
+    #endif
+}
+
+//------------------------------------------------------------------------------
+int64_t
+Log::NumDropped() {
+    #if ORYOL_HAS_THREADS
+    if (asyncQueue) {
+        return asyncQueue->numDropped();
+    }
+    #endif
+    return 0;
+}
+
 //------------------------------------------------------------------------------
 void
 Log::Dbg(const char* msg, ...) {
@@ -147,48 +332,56 @@ Log::VError(const char* msg, va_list args) {
 //------------------------------------------------------------------------------
 void
 Log::vprint(Level lvl, const char* msg, va_list args) {
-    SCOPED_LOCK;
-    if (loggers.Empty()) {
-        #if ORYOL_ANDROID
-            android_LogPriority pri = ANDROID_LOG_DEFAULT;
-            switch (lvl) {
-                case Level::Error: pri = ANDROID_LOG_ERROR; break;
-                case Level::Warn:  pri = ANDROID_LOG_WARN; break;
-                case Level::Info:  pri = ANDROID_LOG_INFO; break;
-                case Level::Dbg:   pri = ANDROID_LOG_DEBUG; break;
-                default:           pri = ANDROID_LOG_DEFAULT; break;
-            }
-            __android_log_vprint(pri, "oryol", msg, args);
-        #else
-            #if ORYOL_WINDOWS
+    #if ORYOL_HAS_THREADS
+    if (asyncQueue && asyncQueue->isActive()) {
+        const int maxSize = asyncQueue->maxSize() < LogBufSize ? asyncQueue->maxSize() : LogBufSize;
+        if (binaryMode.load(std::memory_order_acquire)) {
+            // only encode the arguments, messages which can't be pushed
+            // are written as text, errors go into the binary log too, but
+            // are also written immediately as text (see below)
+            uint8_t buf[LogBufSize];
             va_list argsCopy;
             va_copy(argsCopy, args);
-            #endif
-
-            // do the vprintf, this will destroy the original
-            // va_list, so we made a copy before if necessary
-            std::vprintf(msg, args);
-
-            #if ORYOL_WINDOWS
-                char buf[LogBufSize];
-                std::vsnprintf(buf, sizeof(buf), msg, argsCopy);
-                #if ORYOL_WINDOWS
-                    buf[LogBufSize - 1] = 0;
-                    OutputDebugStringA(buf);
-                #endif
-            #endif
-        #endif
-    }
-    else {
-        for (auto l : loggers) {
-            l->VPrint(lvl, msg, args);
+            const int size = BinaryLog::EncodeMessage(msg, argsCopy, buf, maxSize);
+            va_end(argsCopy);
+            if ((InvalidIndex != size) && asyncQueue->push(lvl, buf, size)) {
+                if (Level::Error != lvl) {
+                    return;
+                }
+                Log::Flush();
+            }
+        }
+        else if (Level::Error == lvl) {
+            // errors are written immediately since o_error() stops
+            // the program right after, but pending messages go first
+            asyncQueue->flush();
+        }
+        else {
+            char buf[LogBufSize];
+            int len = std::vsnprintf(buf, maxSize, msg, args);
+            if (len < 0) {
+                return;
+            }
+            if (len >= maxSize) {
+                len = maxSize - 1;
+            }
+            // push the terminating zero too
+            if (!asyncQueue->push(lvl, buf, len + 1)) {
+                SCOPED_LOCK;
+                writef(lvl, "%s", buf);
+            }
+            return;
         }
     }
+    #endif
+    SCOPED_LOCK;
+    vwrite(lvl, msg, args);
 }
 
 //------------------------------------------------------------------------------
 void
 Log::AssertMsg(const char* cond, const char* msg, const char* file, int line, const char* func) {
+    Log::Flush();
     SCOPED_LOCK;
     if (loggers.Empty()) {
         char callstack[4096];
@@ -214,6 +407,6 @@ Log::AssertMsg(const char* cond, const char* msg, const char* file, int line, co
             l->AssertMsg(cond, msg, file, line, func);
         }
     }
-} 
+}
 
 } // namespace Oryol
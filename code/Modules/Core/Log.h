@@ -9,6 +9,24 @@
     output is logged to stdout and stderr, but custom Logger objects
     can be attached to handle log output differently.
 
+    By default, messages are written synchronously on the calling
+    thread. After Log::StartAsync(), log calls only format the message
+    and copy it into a lock-free per-thread buffer, and a background
+    thread writes the messages to the Loggers. Errors and assert messages
+    are still written synchronously (after all pending messages), since
+    the program is usually stopped right after them. If a thread's
+    buffer is full, new messages are either dropped (counted, and
+    reported with a warning), or the thread waits until there's space
+    again, see AsyncLogSetup. Asynchronous logging is only available on
+    platforms with threads, on other platforms StartAsync() does nothing.
+
+    With AsyncLogSetup::BinaryLogPath, the background thread writes
+    a binary log file instead of calling the Loggers, and log calls
+    don't even format the message, they only copy the format string
+    address and the arguments (see BinaryLog). In this mode, format
+    strings must be string literals. Errors are also written as text
+    to the Loggers.
+
     @see Logger
 */
 #include <cstdarg>
@@ -20,6 +38,24 @@ namespace Oryol {
 class Logger;
 template<class TYPE> class Ptr;
 
+/// what to do with a message when the asynchronous log buffer is full
+enum class AsyncLogOverflow {
+    Drop,       ///< drop the message
+    Block,      ///< wait until the background thread has made space
+};
+
+/// asynchronous logging setup params
+struct AsyncLogSetup {
+    /// size of the per-thread message buffer in bytes (rounded up to a power of 2)
+    int BufferSize = 64 * 1024;
+    /// what to do when a buffer is full
+    AsyncLogOverflow Overflow = AsyncLogOverflow::Drop;
+    /// max time between writes of the background thread in milliseconds
+    int FlushIntervalMs = 10;
+    /// if set, write a binary log file instead of text (see BinaryLog)
+    const char* BinaryLogPath = nullptr;
+};
+
 class Log {
 public:
     /// log levels
@@ -36,6 +72,8 @@ public:
 
     /// add a logger object
     static void AddLogger(const Ptr<Logger>& p);
+    /// remove a logger object
+    static void RemoveLogger(const Ptr<Logger>& p);
     /// get number of loggers
     static int GetNumLoggers();
     /// get logger at index
@@ -45,6 +83,18 @@ public:
     static void SetLogLevel(Level l);
     /// get current log level
     static Level GetLogLevel();
+
+    /// start writing log messages on a background thread
+    static void StartAsync(const AsyncLogSetup& setup=AsyncLogSetup());
+    /// write pending messages and switch back to synchronous logging
+    static void StopAsync();
+    /// return true if asynchronous logging is active
+    static bool IsAsync();
+    /// write pending asynchronous messages on the calling thread
+    static void Flush();
+    /// get number of dropped asynchronous messages since StartAsync()
+    static int64_t NumDropped();
+
     /// print a debug message
     static void Dbg(const char* msg, ...) __attribute__((format(printf, 1, 2)));
     /// print a debug message (with va_list)
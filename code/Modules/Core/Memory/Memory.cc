@@ -8,14 +8,28 @@
 #if ORYOL_USE_VLD
 #include "vld.h"
 #endif
+#if ORYOL_ALLOCATOR_DEBUG || ORYOL_UNITTESTS
+#include <atomic>
+#endif
 
 namespace Oryol {
+
+#if ORYOL_ALLOCATOR_DEBUG || ORYOL_UNITTESTS
+static std::atomic<int> numAllocs{0};
+
+//------------------------------------------------------------------------------
+int
+Memory::NumAllocs() {
+    return numAllocs.load(std::memory_order_relaxed);
+}
+#endif
     
 //------------------------------------------------------------------------------
 void*
 Memory::Alloc(int numBytes) {
     void* ptr = std::malloc(numBytes);
 #if ORYOL_ALLOCATOR_DEBUG || ORYOL_UNITTESTS
+    numAllocs.fetch_add(1, std::memory_order_relaxed);
     Memory::Fill(ptr, numBytes, ORYOL_MEMORY_DEBUG_BYTE);
 #endif
     return ptr;
@@ -39,6 +39,10 @@ public:
     static void* Align(void* ptr, int byteSize);
     /// round-up a value to the next multiple of byteSize
     static int RoundUp(int val, int byteSize);
+    #if ORYOL_ALLOCATOR_DEBUG || ORYOL_UNITTESTS
+    /// get number of Alloc() calls so far (for tests and benchmarks)
+    static int NumAllocs();
+    #endif
     /// replacement for new() going through Memory::Alloc without overriding new
     template<class TYPE, typename... ARGS> static TYPE* New(ARGS&&... args) {
         TYPE* ptr = (TYPE*) Memory::Alloc(sizeof(TYPE));
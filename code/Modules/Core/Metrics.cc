@@ -0,0 +1,328 @@
+//------------------------------------------------------------------------------
+//  Metrics.cc
+//------------------------------------------------------------------------------
+#include "Pre.h"
+#include "Metrics.h"
+#include "Core/Assertion.h"
+#include "Core/Memory/Memory.h"
+#include "Core/Containers/Map.h"
+#include <cstdio>
+#include <limits>
+#if ORYOL_HAS_THREADS
+#include <mutex>
+#define SCOPED_LOCK std::lock_guard<std::mutex> lock(registry().mutex)
+#else
+#define SCOPED_LOCK
+#endif
+
+namespace Oryol {
+
+namespace {
+
+struct metric {
+    MetricsSnapshot::Type type = MetricsSnapshot::CounterType;
+    void* ptr = nullptr;
+};
+
+struct metricsRegistry {
+    #if ORYOL_HAS_THREADS
+    std::mutex mutex;
+    #endif
+    Map<String, metric> metrics;
+};
+
+//------------------------------------------------------------------------------
+/**
+ NOTE: the registry and the metrics are never destroyed since
+ modules keep pointers to the metrics.
+*/
+metricsRegistry&
+registry() {
+    static metricsRegistry* reg = Memory::New<metricsRegistry>();
+    return *reg;
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE> TYPE*
+lookup(const char* name, MetricsSnapshot::Type type) {
+    o_assert_dbg(name);
+    SCOPED_LOCK;
+    Map<String, metric>& metrics = registry().metrics;
+    const String key(name);
+    const int index = metrics.FindIndex(key);
+    if (InvalidIndex != index) {
+        const metric& m = metrics.ValueAtIndex(index);
+        o_assert2(m.type == type, "Metrics: metric registered with a different type!\n");
+        return (TYPE*) m.ptr;
+    }
+    metric m;
+    m.type = type;
+    m.ptr = Memory::New<TYPE>();
+    metrics.Add(key, m);
+    return (TYPE*) m.ptr;
+}
+
+//------------------------------------------------------------------------------
+int
+highestBit(uint64_t val) {
+    o_assert_dbg(val > 0);
+    int bit = 0;
+    while (val >>= 1) {
+        bit++;
+    }
+    return bit;
+}
+
+} // anonymous namespace
+
+//------------------------------------------------------------------------------
+MetricHistogram::MetricHistogram() {
+    this->Reset();
+}
+
+//------------------------------------------------------------------------------
+int
+MetricHistogram::BucketIndex(int64_t value) {
+    const int64_t maxValue = (int64_t(1) << MaxValueBits) - 1;
+    if (value < 0) {
+        value = 0;
+    }
+    else if (value > maxValue) {
+        value = maxValue;
+    }
+    if (value < (2 << SubBucketBits)) {
+        return int(value);
+    }
+    // group of buckets by power of 2, and the top bits of the value
+    const int shift = highestBit(uint64_t(value)) - SubBucketBits;
+    return (shift << SubBucketBits) + int(value >> shift);
+}
+
+//------------------------------------------------------------------------------
+int64_t
+MetricHistogram::BucketMin(int index) {
+    o_assert_dbg((index >= 0) && (index < NumBuckets));
+    const int subBuckets = 1 << SubBucketBits;
+    if (index < (2 * subBuckets)) {
+        return index;
+    }
+    const int shift = (index >> SubBucketBits) - 1;
+    const int64_t top = (index & (subBuckets - 1)) + subBuckets;
+    return top << shift;
+}
+
+//------------------------------------------------------------------------------
+int64_t
+MetricHistogram::BucketMax(int index) {
+    const int subBuckets = 1 << SubBucketBits;
+    if (index < (2 * subBuckets)) {
+        return index;
+    }
+    const int shift = (index >> SubBucketBits) - 1;
+    return BucketMin(index) + (int64_t(1) << shift) - 1;
+}
+
+//------------------------------------------------------------------------------
+void
+MetricHistogram::Record(int64_t value) {
+    if (value < 0) {
+        value = 0;
+    }
+    this->buckets[BucketIndex(value)].fetch_add(1, std::memory_order_relaxed);
+    this->sum.fetch_add(value, std::memory_order_relaxed);
+    int64_t cur = this->min.load(std::memory_order_relaxed);
+    while ((value < cur) && !this->min.compare_exchange_weak(cur, value, std::memory_order_relaxed)) { }
+    cur = this->max.load(std::memory_order_relaxed);
+    while ((value > cur) && !this->max.compare_exchange_weak(cur, value, std::memory_order_relaxed)) { }
+}
+
+//------------------------------------------------------------------------------
+/**
+ Percentiles are the largest value of the bucket which contains the
+ percentile (clamped to the min and max value), like in HDR histograms.
+ Values which are recorded while the summary is computed may be only
+ partially counted.
+*/
+MetricHistogram::Summary
+MetricHistogram::Summarize() const {
+    Summary s;
+    uint64_t counts[NumBuckets];
+    uint64_t total = 0;
+    for (int i = 0; i < NumBuckets; i++) {
+        counts[i] = this->buckets[i].load(std::memory_order_relaxed);
+        total += counts[i];
+    }
+    if (0 == total) {
+        return s;
+    }
+    s.Count = int64_t(total);
+    s.Sum = this->sum.load(std::memory_order_relaxed);
+    s.Min = this->min.load(std::memory_order_relaxed);
+    s.Max = this->max.load(std::memory_order_relaxed);
+    s.Mean = double(s.Sum) / double(s.Count);
+    const double percentiles[] = { 0.5, 0.9, 0.99, 0.999 };
+    int64_t* results[] = { &s.P50, &s.P90, &s.P99, &s.P999 };
+    uint64_t accum = 0;
+    int bucket = 0;
+    for (int p = 0; p < 4; p++) {
+        uint64_t rank = uint64_t(percentiles[p] * double(total) + 0.5);
+        if (rank < 1) {
+            rank = 1;
+        }
+        while ((accum + counts[bucket]) < rank) {
+            accum += counts[bucket++];
+        }
+        int64_t val = BucketMax(bucket);
+        if (val > s.Max) {
+            val = s.Max;
+        }
+        if (val < s.Min) {
+            val = s.Min;
+        }
+        *results[p] = val;
+    }
+    return s;
+}
+
+//------------------------------------------------------------------------------
+void
+MetricHistogram::Reset() {
+    for (int i = 0; i < NumBuckets; i++) {
+        this->buckets[i].store(0, std::memory_order_relaxed);
+    }
+    this->sum.store(0, std::memory_order_relaxed);
+    this->min.store(std::numeric_limits<int64_t>::max(), std::memory_order_relaxed);
+    this->max.store(0, std::memory_order_relaxed);
+}
+
+//------------------------------------------------------------------------------
+const MetricsSnapshot::Entry*
+MetricsSnapshot::Find(const char* name) const {
+    for (const Entry& entry : this->Entries) {
+        if (entry.Name == name) {
+            return &entry;
+        }
+    }
+    return nullptr;
+}
+
+//------------------------------------------------------------------------------
+void
+MetricsSnapshot::ToText(StringBuilder& str) const {
+    for (const Entry& entry : this->Entries) {
+        switch (entry.MetricType) {
+            case CounterType:
+                str.AppendFormat(256, "counter   %-32s %lld\n", entry.Name.AsCStr(), (long long) entry.Value);
+                break;
+            case GaugeType:
+                str.AppendFormat(256, "gauge     %-32s %lld\n", entry.Name.AsCStr(), (long long) entry.Value);
+                break;
+            case HistogramType:
+                {
+                    const MetricHistogram::Summary& h = entry.Histogram;
+                    str.AppendFormat(512, "histogram %-32s count=%lld min=%lld p50=%lld p90=%lld p99=%lld p99.9=%lld max=%lld mean=%.1f\n",
+                        entry.Name.AsCStr(), (long long) h.Count, (long long) h.Min, (long long) h.P50, (long long) h.P90,
+                        (long long) h.P99, (long long) h.P999, (long long) h.Max, h.Mean);
+                }
+                break;
+        }
+    }
+}
+
+//------------------------------------------------------------------------------
+MetricCounter*
+Metrics::Counter(const char* name) {
+    return lookup<MetricCounter>(name, MetricsSnapshot::CounterType);
+}
+
+//------------------------------------------------------------------------------
+MetricGauge*
+Metrics::Gauge(const char* name) {
+    return lookup<MetricGauge>(name, MetricsSnapshot::GaugeType);
+}
+
+//------------------------------------------------------------------------------
+MetricHistogram*
+Metrics::Histogram(const char* name) {
+    return lookup<MetricHistogram>(name, MetricsSnapshot::HistogramType);
+}
+
+//------------------------------------------------------------------------------
+MetricsSnapshot
+Metrics::Snapshot() {
+    MetricsSnapshot snapshot;
+    SCOPED_LOCK;
+    const Map<String, metric>& metrics = registry().metrics;
+    snapshot.Entries.Reserve(metrics.Size());
+    for (int i = 0; i < metrics.Size(); i++) {
+        const metric& m = metrics.ValueAtIndex(i);
+        MetricsSnapshot::Entry entry;
+        entry.Name = metrics.KeyAtIndex(i);
+        entry.MetricType = m.type;
+        switch (m.type) {
+            case MetricsSnapshot::CounterType:
+                entry.Value = ((const MetricCounter*) m.ptr)->Value();
+                break;
+            case MetricsSnapshot::GaugeType:
+                entry.Value = ((const MetricGauge*) m.ptr)->Value();
+                break;
+            case MetricsSnapshot::HistogramType:
+                entry.Histogram = ((const MetricHistogram*) m.ptr)->Summarize();
+                break;
+        }
+        snapshot.Entries.Add(entry);
+    }
+    return snapshot;
+}
+
+//------------------------------------------------------------------------------
+void
+Metrics::Reset() {
+    SCOPED_LOCK;
+    const Map<String, metric>& metrics = registry().metrics;
+    for (int i = 0; i < metrics.Size(); i++) {
+        const metric& m = metrics.ValueAtIndex(i);
+        switch (m.type) {
+            case MetricsSnapshot::CounterType:
+                ((MetricCounter*) m.ptr)->Reset();
+                break;
+            case MetricsSnapshot::GaugeType:
+                ((MetricGauge*) m.ptr)->Reset();
+                break;
+            case MetricsSnapshot::HistogramType:
+                ((MetricHistogram*) m.ptr)->Reset();
+                break;
+        }
+    }
+}
+
+//------------------------------------------------------------------------------
+void
+Metrics::LogSnapshot(Log::Level lvl) {
+    StringBuilder str;
+    Snapshot().ToText(str);
+    switch (lvl) {
+        case Log::Level::Error: Log::Error("%s", str.AsCStr()); break;
+        case Log::Level::Warn:  Log::Warn("%s", str.AsCStr()); break;
+        case Log::Level::Info:  Log::Info("%s", str.AsCStr()); break;
+        case Log::Level::Dbg:   Log::Dbg("%s", str.AsCStr()); break;
+        default: break;
+    }
+}
+
+//------------------------------------------------------------------------------
+bool
+Metrics::WriteSnapshot(const char* path) {
+    o_assert_dbg(path);
+    std::FILE* fp = std::fopen(path, "wb");
+    if (nullptr == fp) {
+        return false;
+    }
+    StringBuilder str;
+    Snapshot().ToText(str);
+    const bool success = (0 == str.Length()) || (1 == std::fwrite(str.AsCStr(), str.Length(), 1, fp));
+    std::fclose(fp);
+    return success;
+}
+
+} // namespace Oryol
@@ -0,0 +1,200 @@
+#pragma once
+//------------------------------------------------------------------------------
+/**
+    @class Oryol::Metrics
+    @ingroup Core
+    @brief registry of named counters, gauges and latency histograms
+
+    Metrics are looked up (and created on first use) by name, the
+    returned pointers stay valid until the end of the program, so
+    look them up once and keep the pointer, for instance when a
+    module is setup. Updating metrics is lock-free and can be done
+    from any thread:
+
+    ```cpp
+    static MetricCounter* numLoaded = Metrics::Counter("IO.NumLoaded");
+    static MetricHistogram* loadTime = Metrics::Histogram("IO.LoadTime");
+    numLoaded->Add();
+    loadTime->RecordDuration(Clock::Since(startTime));
+    ```
+
+    Metrics::Snapshot() captures the current values of all metrics,
+    which can be logged or written to a file, for instance periodically
+    from a timer:
+
+    ```cpp
+    Core::Timers()->AddPeriodic(Duration::FromSeconds(10.0), [] {
+        Metrics::LogSnapshot();
+    });
+    ```
+*/
+#include "Core/Types.h"
+#include "Core/Log.h"
+#include "Core/Time/Clock.h"
+#include "Core/Containers/Array.h"
+#include "Core/String/String.h"
+#include "Core/String/StringBuilder.h"
+#include <atomic>
+
+namespace Oryol {
+
+/// a monotonic event counter
+class MetricCounter {
+public:
+    /// add to the counter
+    void Add(int64_t n=1) {
+        this->value.fetch_add(n, std::memory_order_relaxed);
+    };
+    /// get current value
+    int64_t Value() const {
+        return this->value.load(std::memory_order_relaxed);
+    };
+    /// set to zero
+    void Reset() {
+        this->value.store(0, std::memory_order_relaxed);
+    };
+private:
+    std::atomic<int64_t> value{0};
+};
+
+/// a value which can go up and down (e.g. number of pending requests)
+class MetricGauge {
+public:
+    /// set the value
+    void Set(int64_t v) {
+        this->value.store(v, std::memory_order_relaxed);
+    };
+    /// add to the value (may be negative)
+    void Add(int64_t n) {
+        this->value.fetch_add(n, std::memory_order_relaxed);
+    };
+    /// get current value
+    int64_t Value() const {
+        return this->value.load(std::memory_order_relaxed);
+    };
+    /// set to zero
+    void Reset() {
+        this->value.store(0, std::memory_order_relaxed);
+    };
+private:
+    std::atomic<int64_t> value{0};
+};
+
+/**
+    A histogram of non-negative integer values (usually microseconds)
+    with logarithmic buckets which are linearly subdivided (like HDR
+    histograms): values below 64 are counted exactly, larger values
+    with a relative error of less than 1/32. Values above 2^43 are
+    counted as 2^43-1.
+*/
+class MetricHistogram {
+public:
+    /// number of linear sub-buckets per power of 2 (log2)
+    static const int SubBucketBits = 5;
+    /// values must fit into this number of bits
+    static const int MaxValueBits = 43;
+    /// number of buckets
+    static const int NumBuckets = (MaxValueBits - SubBucketBits + 1) << SubBucketBits;
+
+    /// histogram statistics at a point in time
+    struct Summary {
+        int64_t Count = 0;
+        int64_t Sum = 0;
+        int64_t Min = 0;
+        int64_t Max = 0;
+        double Mean = 0.0;
+        int64_t P50 = 0;
+        int64_t P90 = 0;
+        int64_t P99 = 0;
+        int64_t P999 = 0;
+    };
+
+    /// constructor
+    MetricHistogram();
+    /// record a value
+    void Record(int64_t value);
+    /// record a duration in microseconds
+    void RecordDuration(Duration d) {
+        this->Record(d.getRaw());
+    };
+    /// compute statistics
+    Summary Summarize() const;
+    /// remove all values
+    void Reset();
+
+    /// get bucket index of a value
+    static int BucketIndex(int64_t value);
+    /// get smallest value of a bucket
+    static int64_t BucketMin(int index);
+    /// get largest value of a bucket
+    static int64_t BucketMax(int index);
+
+private:
+    std::atomic<int64_t> sum;
+    std::atomic<int64_t> min;
+    std::atomic<int64_t> max;
+    std::atomic<uint64_t> buckets[NumBuckets];
+};
+
+/// records the lifetime of a scope into a histogram (in microseconds)
+class MetricTimer {
+public:
+    /// constructor, histogram may be nullptr
+    MetricTimer(MetricHistogram* h) : histogram(h), start(Clock::Now()) { };
+    /// destructor, records the time since construction
+    ~MetricTimer() {
+        if (this->histogram) {
+            this->histogram->RecordDuration(Clock::Since(this->start));
+        }
+    };
+private:
+    MetricHistogram* histogram;
+    TimePoint start;
+};
+
+/// the values of all metrics at a point in time
+struct MetricsSnapshot {
+    /// metric types
+    enum Type {
+        CounterType,
+        GaugeType,
+        HistogramType,
+    };
+    /// the value of one metric
+    struct Entry {
+        String Name;
+        Type MetricType = CounterType;
+        /// counter or gauge value
+        int64_t Value = 0;
+        /// histogram statistics
+        MetricHistogram::Summary Histogram;
+    };
+    /// all metrics, sorted by name
+    Array<Entry> Entries;
+
+    /// find a metric by name, returns nullptr if not found
+    const Entry* Find(const char* name) const;
+    /// append a human-readable table of all metrics
+    void ToText(StringBuilder& str) const;
+};
+
+class Metrics {
+public:
+    /// get or create a counter
+    static MetricCounter* Counter(const char* name);
+    /// get or create a gauge
+    static MetricGauge* Gauge(const char* name);
+    /// get or create a histogram
+    static MetricHistogram* Histogram(const char* name);
+
+    /// capture the current values of all metrics
+    static MetricsSnapshot Snapshot();
+    /// reset all metrics
+    static void Reset();
+    /// write a snapshot to the log
+    static void LogSnapshot(Log::Level lvl=Log::Level::Info);
+    /// write a snapshot to a text file, returns false if the file couldn't be written
+    static bool WriteSnapshot(const char* path);
+};
+
+} // namespace Oryol
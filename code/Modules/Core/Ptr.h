@@ -194,4 +194,9 @@ private:
     };
 };
 
+/// Ptr only holds a pointer to the object, so it can be moved with memcpy
+template<class T> struct IsTriviallyRelocatable<Ptr<T>> {
+    static const bool value = true;
+};
+
 } // namespace oryol
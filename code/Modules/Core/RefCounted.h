@@ -55,7 +55,7 @@ RefCounted::addRef() {
 inline void
 RefCounted::release() {
     #if ORYOL_HAS_ATOMIC
-    if (1 == this->refCount.fetch_sub(1, std::memory_order_relaxed)) {
+    if (1 == this->refCount.fetch_sub(1, std::memory_order_acq_rel)) {
     #else
     if (1 == this->refCount--) {
     #endif
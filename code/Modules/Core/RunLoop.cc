@@ -3,12 +3,23 @@
 //------------------------------------------------------------------------------
 #include "Pre.h"
 #include "RunLoop.h"
+#include "Core/Time/Clock.h"
+#include "Core/Metrics.h"
+
+#if ORYOL_HAS_THREADS
+#define SCOPED_LOCK std::lock_guard<std::mutex> lock(this->postedMutex)
+#else
+#define SCOPED_LOCK
+#endif
 
 namespace Oryol {
 
 //------------------------------------------------------------------------------
 RunLoop::RunLoop() :
-curId(InvalidId)
+curId(InvalidId),
+maxDeferredFrames(10),
+needsSort(false),
+lastNumDeferred(0)
 {
     // empty
 }
@@ -23,19 +34,73 @@ void
 RunLoop::Run() {
     this->remCallbacks();
     this->addCallbacks();
-    for (const auto& entry : this->callbacks) {
-        if (entry.Value().valid) {
-            entry.Value().func();
+    if (this->needsSort) {
+        this->sortCallbacks();
+    }
+    // metrics are shared by all RunLoops
+    static MetricHistogram* callbackTimeMetric = Metrics::Histogram("RunLoop.CallbackTime");
+    static MetricHistogram* runTimeMetric = Metrics::Histogram("RunLoop.RunTime");
+    static MetricCounter* numDeferredMetric = Metrics::Counter("RunLoop.NumDeferred");
+    const bool hasBudget = this->budget > Duration();
+    const TimePoint startTime = Clock::Now();
+    TimePoint curTime = startTime;
+    if (this->numPosted > 0) {
+        this->callPosted();
+        curTime = Clock::Now();
+    }
+    int numDeferred = 0;
+    for (item& item : this->callbacks) {
+        if (hasBudget && (Critical != item.stats.Pri)) {
+            // defer the callback if the budget has been used up
+            if (((curTime - startTime) >= this->budget) && (item.numDeferredFrames < this->maxDeferredFrames)) {
+                item.numDeferredFrames++;
+                item.stats.NumDeferred++;
+                numDeferred++;
+                this->needsSort = true;
+                continue;
+            }
+            if (item.numDeferredFrames > 0) {
+                item.numDeferredFrames = 0;
+                this->needsSort = true;
+            }
         }
+        item.func();
+        const TimePoint endTime = Clock::Now();
+        const Duration dur = endTime - curTime;
+        curTime = endTime;
+        item.stats.NumCalls++;
+        item.stats.LastTime = dur;
+        item.stats.TotalTime += dur;
+        if (dur > item.stats.MaxTime) {
+            item.stats.MaxTime = dur;
+        }
+        callbackTimeMetric->RecordDuration(dur);
+    }
+    this->lastRunTime = curTime - startTime;
+    this->lastNumDeferred = numDeferred;
+    runTimeMetric->RecordDuration(this->lastRunTime);
+    if (numDeferred > 0) {
+        numDeferredMetric->Add(numDeferred);
     }
     this->remCallbacks();
     this->addCallbacks();
 }
 
+//------------------------------------------------------------------------------
+int
+RunLoop::findItem(const Array<item>& items, Id id) {
+    for (int i = 0; i < items.Size(); i++) {
+        if (items[i].id == id) {
+            return i;
+        }
+    }
+    return InvalidIndex;
+}
+
 //------------------------------------------------------------------------------
 bool
 RunLoop::HasCallback(Id id) const {
-    return this->callbacks.Contains(id) || this->toAdd.Contains(id);
+    return (InvalidIndex != findItem(this->callbacks, id)) || (InvalidIndex != findItem(this->toAdd, id));
 }
 
 //------------------------------------------------------------------------------
@@ -44,47 +109,185 @@ RunLoop::HasCallback(Id id) const {
  start or end of the Run function.
 */
 RunLoop::Id
-RunLoop::Add(Func func) {
+RunLoop::Add(Func func, Priority pri, const StringAtom& name) {
     Id newId = ++this->curId;
-    this->toAdd.Add(newId, item{func, false});
+    item newItem;
+    newItem.id = newId;
+    newItem.func = std::move(func);
+    newItem.numDeferredFrames = 0;
+    newItem.stats.Name = name;
+    newItem.stats.Pri = pri;
+    this->toAdd.Add(std::move(newItem));
     return newId;
 }
 
 //------------------------------------------------------------------------------
 /**
- NOTE: the callback function not be removed immediately, but at the 
+ NOTE: the callback function not be removed immediately, but at the
  start or end of the Run function.
 */
 void
 RunLoop::Remove(Id id) {
-    o_assert_dbg(!this->toRemove.Contains(id));
-    o_assert_dbg(this->callbacks.Contains(id) || this->toAdd.Contains(id));
+    o_assert_dbg(InvalidIndex == this->toRemove.FindIndexLinear(id));
+    o_assert_dbg(this->HasCallback(id));
     this->toRemove.Add(id);
 }
 
+//------------------------------------------------------------------------------
+void
+RunLoop::Post(Func func) {
+    o_assert_dbg(func);
+    SCOPED_LOCK;
+    this->posted.Add(std::move(func));
+    this->numPosted++;
+}
+
+//------------------------------------------------------------------------------
+/**
+ NOTE: functions which are posted while the posted functions are called
+ will be called in the next Run().
+*/
+void
+RunLoop::callPosted() {
+    Array<Func> funcs;
+    {
+        SCOPED_LOCK;
+        funcs = std::move(this->posted);
+        this->numPosted = 0;
+    }
+    for (const Func& func : funcs) {
+        func();
+    }
+}
+
+//------------------------------------------------------------------------------
+void
+RunLoop::SetBudget(Duration d) {
+    this->budget = d;
+}
+
+//------------------------------------------------------------------------------
+Duration
+RunLoop::Budget() const {
+    return this->budget;
+}
+
+//------------------------------------------------------------------------------
+void
+RunLoop::SetMaxDeferredFrames(int numFrames) {
+    o_assert_dbg(numFrames >= 0);
+    this->maxDeferredFrames = numFrames;
+}
+
+//------------------------------------------------------------------------------
+int
+RunLoop::MaxDeferredFrames() const {
+    return this->maxDeferredFrames;
+}
+
+//------------------------------------------------------------------------------
+int
+RunLoop::NumCallbacks() const {
+    return this->callbacks.Size();
+}
+
+//------------------------------------------------------------------------------
+RunLoop::Id
+RunLoop::CallbackIdAt(int index) const {
+    return this->callbacks[index].id;
+}
+
+//------------------------------------------------------------------------------
+const RunLoop::Stats&
+RunLoop::CallbackStats(Id id) const {
+    int index = findItem(this->callbacks, id);
+    if (InvalidIndex != index) {
+        return this->callbacks[index].stats;
+    }
+    index = findItem(this->toAdd, id);
+    o_assert(InvalidIndex != index);
+    return this->toAdd[index].stats;
+}
+
+//------------------------------------------------------------------------------
+void
+RunLoop::ResetStats() {
+    for (item& item : this->callbacks) {
+        const StringAtom name = item.stats.Name;
+        const Priority pri = item.stats.Pri;
+        item.stats = Stats();
+        item.stats.Name = name;
+        item.stats.Pri = pri;
+    }
+}
+
+//------------------------------------------------------------------------------
+Duration
+RunLoop::LastRunTime() const {
+    return this->lastRunTime;
+}
+
+//------------------------------------------------------------------------------
+int
+RunLoop::LastNumDeferred() const {
+    return this->lastNumDeferred;
+}
+
 //------------------------------------------------------------------------------
 void
 RunLoop::addCallbacks() {
-    for (auto& entry : this->toAdd) {
-        item& item = entry.Value();
-        item.valid = true;
-        this->callbacks.Add(entry.Key(), item);
+    if (!this->toAdd.Empty()) {
+        for (item& item : this->toAdd) {
+            this->callbacks.Add(std::move(item));
+        }
+        this->toAdd.Clear();
+        this->needsSort = true;
     }
-    this->toAdd.Clear();
 }
 
 //------------------------------------------------------------------------------
 void
 RunLoop::remCallbacks() {
     for (Id id : this->toRemove) {
-        if (this->callbacks.Contains(id)) {
-            this->callbacks.Erase(id);
+        int index = findItem(this->callbacks, id);
+        if (InvalidIndex != index) {
+            this->callbacks.Erase(index);
         }
-        else if (this->toAdd.Contains(id)) {
-            this->toAdd.Erase(id);
+        else {
+            index = findItem(this->toAdd, id);
+            if (InvalidIndex != index) {
+                this->toAdd.Erase(index);
+            }
         }
     }
     this->toRemove.Clear();
 }
 
+//------------------------------------------------------------------------------
+/**
+ Call order is by priority, then by number of frames a callback
+ has been deferred (longest first), then by order of adding.
+ There are only a handful of callbacks, so this is an insertion sort.
+*/
+void
+RunLoop::sortCallbacks() {
+    auto before = [](const item& a, const item& b) -> bool {
+        if (a.stats.Pri != b.stats.Pri) {
+            return a.stats.Pri < b.stats.Pri;
+        }
+        if (a.numDeferredFrames != b.numDeferredFrames) {
+            return a.numDeferredFrames > b.numDeferredFrames;
+        }
+        return a.id < b.id;
+    };
+    for (int i = 1; i < this->callbacks.Size(); i++) {
+        for (int j = i; (j > 0) && before(this->callbacks[j], this->callbacks[j - 1]); j--) {
+            item tmp = std::move(this->callbacks[j]);
+            this->callbacks[j] = std::move(this->callbacks[j - 1]);
+            this->callbacks[j - 1] = std::move(tmp);
+        }
+    }
+    this->needsSort = false;
+}
+
 } // namespace Oryol
@@ -4,28 +4,50 @@
     @class Oryol::RunLoop
     @ingroup Core
     @brief universal run-loop object for on-frame callbacks
-    
-    A runloop object manages a priority-sorted array of callback 
+
+    A runloop object manages a priority-sorted array of callback
     functions which are called per-frame. By default, each thread
     has a RunLoop object which can be configured through the Core facade
     singleton. Runloops can be nested by adding the Run() function
-    of one runloop to another runloop. NOTE that priority values are
-    inverted, lower values are called first).
-    
+    of one runloop to another runloop.
+
+    Each callback has a priority. Critical callbacks (the default) are
+    called every frame. The other callbacks are called in priority order
+    (High, Normal, Low) after the critical callbacks, but only as long as
+    the time budget of the Run() call hasn't been used up. Callbacks that
+    didn't fit into the budget are deferred to the next frame, where they
+    are called before other callbacks of the same priority. A callback is
+    never deferred more than MaxDeferredFrames() frames in a row.
+    Without a budget (the default) all callbacks are called every frame.
+
+    The RunLoop keeps timing statistics for each callback, which can
+    be inspected for profiling.
+
+    Post() queues a function which is called once at the start of the
+    next Run(). Unlike the other methods, Post() can be called from any
+    thread, this is how results of other threads are handed to the
+    thread which owns the RunLoop (see Future).
+
     Examples for constructing callbacks:
-    
+
     1. from C function myFunc():
 
-        Callback("name", pri, std::function<void()>(&myFunc);
+        runLoop->Add(&myFunc);
     2. from an object's method (careful, object must not go out-of-scope
        as long as the callback is added to the RunLoop!
 
         MyClass myObj;<br>
-        Callback("name", pri, std::function<void()>(&MyClass::MyMethod, &myObj));
+        runLoop->Add([&myObj] { myObj.MyMethod(); }, RunLoop::Low, "MyMethod");
 */
 #include <functional>
-#include "Core/Containers/Map.h"
-#include "Core/Containers/Set.h"
+#include "Core/Config.h"
+#include "Core/Containers/Array.h"
+#include "Core/String/StringAtom.h"
+#include "Core/Time/Duration.h"
+#if ORYOL_HAS_THREADS
+#include <atomic>
+#include <mutex>
+#endif
 
 namespace Oryol {
 
@@ -37,37 +59,104 @@ public:
     static const Id InvalidId = 0;
     /// runloop function typedef
     typedef std::function<void()> Func;
+    /// callback priorities, lower values are called first
+    enum Priority {
+        Critical = 0,   ///< called every frame
+        High,           ///< deferrable, called first
+        Normal,         ///< deferrable
+        Low,            ///< deferrable, called last
+    };
+    /// per-callback timing statistics
+    struct Stats {
+        /// the optional callback name
+        StringAtom Name;
+        /// the callback priority
+        Priority Pri = Critical;
+        /// number of calls
+        int NumCalls = 0;
+        /// number of frames the callback has been deferred
+        int NumDeferred = 0;
+        /// duration of the last call
+        Duration LastTime;
+        /// duration of the slowest call
+        Duration MaxTime;
+        /// sum of all call durations
+        Duration TotalTime;
+    };
 
     /// constructor
     RunLoop();
     /// destructor
     ~RunLoop();
-    
+
     /// run one frame
     void Run();
-    
-    /// add a callback to the run loop, higher priorities run earlier, slow!
-    Id Add(Func func);
-    /// remove a callback, slow!
+
+    /// add a callback to the run loop
+    Id Add(Func func, Priority pri=Critical, const StringAtom& name=StringAtom());
+    /// remove a callback
     void Remove(Id);
-    /// test if a callback has been attached, slow!
+    /// test if a callback has been attached
     bool HasCallback(Id) const;
-    
+    /// call a function once at the start of the next Run() (thread-safe)
+    void Post(Func func);
+
+    /// set the time budget for deferrable callbacks per Run() (0 means no budget)
+    void SetBudget(Duration budget);
+    /// get the time budget
+    Duration Budget() const;
+    /// set max number of frames in a row a callback can be deferred
+    void SetMaxDeferredFrames(int numFrames);
+    /// get max number of frames in a row a callback can be deferred
+    int MaxDeferredFrames() const;
+
+    /// get number of attached callbacks
+    int NumCallbacks() const;
+    /// get callback id by index (in call order)
+    Id CallbackIdAt(int index) const;
+    /// get timing statistics of a callback
+    const Stats& CallbackStats(Id id) const;
+    /// reset timing statistics of all callbacks
+    void ResetStats();
+    /// get the duration of the last Run() call
+    Duration LastRunTime() const;
+    /// get number of callbacks which have been deferred in the last Run() call
+    int LastNumDeferred() const;
+
 private:
+    struct item {
+        Id id;
+        Func func;
+        int numDeferredFrames;
+        Stats stats;
+    };
     /// add new callbacks that have been added (called at beginning of Run())
     void addCallbacks();
     /// remove callbacks that have been removed (called at end of Run())
     void remCallbacks();
-    
-    struct item {
-        Func func;
-        bool valid;
-    };
-    
+    /// sort callbacks into call order
+    void sortCallbacks();
+    /// call posted functions (called at beginning of Run())
+    void callPosted();
+    /// find index of callback by id, or InvalidIndex
+    static int findItem(const Array<item>& items, Id id);
+
     Id curId;
-    Map<Id, item> callbacks;
-    Map<Id, item> toAdd;
-    Set<Id> toRemove;
+    Duration budget;
+    int maxDeferredFrames;
+    bool needsSort;
+    Duration lastRunTime;
+    int lastNumDeferred;
+    Array<item> callbacks;
+    Array<item> toAdd;
+    Array<Id> toRemove;
+    #if ORYOL_HAS_THREADS
+    std::mutex postedMutex;
+    std::atomic<int> numPosted{0};
+    #else
+    int numPosted = 0;
+    #endif
+    Array<Func> posted;
 };
-    
+
 } // namespace Oryol
@@ -8,8 +8,6 @@
 
 namespace Oryol {
 
-const char* String::emptyString = "";
-
 //------------------------------------------------------------------------------
 String::String(const StringAtom& str) {
     const char* cstr = str.AsCStr();
@@ -22,16 +20,13 @@ String::String(const char* str) {
         this->create(str, int(std::strlen(str)));
     }
     else {
-        this->data = nullptr;
-        this->strPtr = nullptr;
+        this->setEmpty();
     }
 }
 
 //------------------------------------------------------------------------------
-String::String() :
-data(nullptr),
-strPtr(nullptr) {
-    // empty
+String::String() {
+    this->setEmpty();
 }
 
 //------------------------------------------------------------------------------
@@ -66,13 +61,9 @@ String::String(const char* ptr, int startIndex, int endIndex) {
 //------------------------------------------------------------------------------
 void
 String::Assign(const char* ptr, int startIndex, int endIndex) {
-    o_assert(nullptr != ptr);
-    this->release();
-    if (EndOfString == endIndex) {
-        endIndex = int(std::strlen(ptr));
-    }
-    o_assert(startIndex < endIndex);
-    this->create(ptr + startIndex, endIndex - startIndex);
+    // ptr may point into our own inline buffer, so create the new
+    // string before releasing the old content
+    *this = String(ptr, startIndex, endIndex);
 }
 
 //------------------------------------------------------------------------------
@@ -89,15 +80,21 @@ String::AsStringAtom() const {
     return StringAtom(this->AsCStr());;
 }
 
+//------------------------------------------------------------------------------
+void
+String::setEmpty() {
+    this->inlineBuf[0] = 0;
+    this->inlineLength = 0;
+}
+
 //------------------------------------------------------------------------------
 void
 String::destroy() {
-    o_assert(0 != this->data);
+    o_assert(HeapString == this->inlineLength);
     o_assert(0 == this->data->refCount);
     this->data->~StringData();
     Memory::Free(this->data);
-    this->data = nullptr;
-    this->strPtr = nullptr;
+    this->setEmpty();
 }
 
 //------------------------------------------------------------------------------
@@ -106,9 +103,9 @@ String::alloc(int len) {
     o_assert(len > 0);
     this->data = (StringData*) Memory::Alloc(sizeof(StringData) + len + 1);
     new(this->data) StringData();
+    this->inlineLength = HeapString;
     this->addRef();
     this->data->length = len;
-    this->strPtr = (const char*) &(this->data[1]);
 }
 
 //------------------------------------------------------------------------------
@@ -116,21 +113,63 @@ void
 String::create(const char* ptr, int len) {
     o_assert(0 != ptr);
     if ((ptr[0] != 0) && (len > 0)) {
-        this->alloc(len);
-        Memory::Copy(ptr, (void*)this->strPtr, len);
-        ((char*)this->strPtr)[len] = 0;
+        char* dst;
+        if (len <= MaxInlineLength) {
+            // short string, no allocation needed
+            this->inlineLength = uint8_t(len);
+            dst = this->inlineBuf;
+        }
+        else {
+            this->alloc(len);
+            dst = (char*) &(this->data[1]);
+        }
+        Memory::Copy(ptr, dst, len);
+        dst[len] = 0;
+    }
+    else {
+        // empty string
+        this->setEmpty();
+    }
+}
+
+//------------------------------------------------------------------------------
+void
+String::copy(const String& rhs) {
+    if (HeapString == rhs.inlineLength) {
+        this->data = rhs.data;
+        this->inlineLength = HeapString;
+        this->addRef();
     }
     else {
-        // empty string, don't bother to allocate storage for this
-        this->data = nullptr;
-        this->strPtr = nullptr;
+        Memory::Copy(rhs.inlineBuf, this->inlineBuf, rhs.inlineLength + 1);
+        this->inlineLength = rhs.inlineLength;
     }
 }
 
+//------------------------------------------------------------------------------
+void
+String::move(String&& rhs) {
+    if (HeapString == rhs.inlineLength) {
+        this->data = rhs.data;
+        this->inlineLength = HeapString;
+    }
+    else {
+        Memory::Copy(rhs.inlineBuf, this->inlineBuf, rhs.inlineLength + 1);
+        this->inlineLength = rhs.inlineLength;
+    }
+    rhs.setEmpty();
+}
+
+//------------------------------------------------------------------------------
+bool
+String::sameData(const String& rhs) const {
+    return (HeapString == this->inlineLength) && (HeapString == rhs.inlineLength) && (this->data == rhs.data);
+}
+
 //------------------------------------------------------------------------------
 void
 String::addRef() {
-    o_assert(nullptr != this->data);
+    o_assert(HeapString == this->inlineLength);
     #if ORYOL_HAS_ATOMIC
     this->data->refCount.fetch_add(1, std::memory_order_relaxed);
     #else
@@ -141,7 +180,7 @@ String::addRef() {
 //------------------------------------------------------------------------------
 void
 String::release() {
-    if (nullptr != this->data) {
+    if (HeapString == this->inlineLength) {
         #if ORYOL_HAS_ATOMIC
         if (1 == this->data->refCount.fetch_sub(1, std::memory_order_relaxed)) {
         #else
@@ -150,9 +189,8 @@ String::release() {
             // no more owners, destroy the shared string data
             this->destroy();
         }
-        this->data = nullptr;
-        this->strPtr = nullptr;
     }
+    this->setEmpty();
 }
 
 //------------------------------------------------------------------------------
@@ -162,30 +200,18 @@ String::release() {
  */
 void
 String::Assign(const String& rhs, int startIndex, int endIndex) {
-    this->release();
-    if (EndOfString == endIndex) {
-        endIndex = rhs.Length();
-    }
-    o_assert((startIndex >= 0) && (startIndex < endIndex));
-    o_assert(endIndex <= rhs.Length());
-    this->create(rhs.AsCStr() + startIndex, endIndex - startIndex);
+    // rhs may be this string
+    *this = String(rhs, startIndex, endIndex);
 }
     
 //------------------------------------------------------------------------------
 String::String(const String& rhs) {
-    this->data = rhs.data;
-    this->strPtr = rhs.strPtr;
-    if (nullptr != this->data) {
-        this->addRef();
-    }
+    this->copy(rhs);
 }
 
 //------------------------------------------------------------------------------
 String::String(String&& rhs) {
-    this->data = rhs.data;
-    this->strPtr = rhs.strPtr;
-    rhs.data = 0;
-    rhs.strPtr = 0;
+    this->move(std::move(rhs));
 }
 
 //------------------------------------------------------------------------------
@@ -196,10 +222,8 @@ String::~String() {
 //------------------------------------------------------------------------------
 void
 String::operator=(const char* str) {
-    this->release();
-    if (nullptr != str) {
-        this->create(str, int(std::strlen(str)));
-    }
+    // str may point into our own inline buffer
+    *this = String(str);
 }
 
 //------------------------------------------------------------------------------
@@ -207,11 +231,7 @@ void
 String::operator=(const String& rhs) {
     if (this != &rhs) {
         this->release();
-        this->data = rhs.data;
-        this->strPtr = rhs.strPtr;
-        if (nullptr != this->data) {
-            this->addRef();
-        }
+        this->copy(rhs);
     }
 }
 
@@ -220,22 +240,16 @@ void
 String::operator=(String&& rhs) {
     if (this != &rhs) {
         this->release();
-        this->data = rhs.data;
-        this->strPtr = rhs.strPtr;
-        rhs.data = 0;
-        rhs.strPtr = 0;
+        this->move(std::move(rhs));
     }
 }
 
 //------------------------------------------------------------------------------
 bool
 String::operator==(const String& rhs) const {
-    if (this->data == rhs.data) {
+    if (this->sameData(rhs)) {
         return true;
     }
-    else if ((nullptr == this->data) || (nullptr == rhs.data)) {
-        return false;
-    }
     else {
         return std::strcmp(this->AsCStr(), rhs.AsCStr()) == 0;
     }
@@ -250,7 +264,7 @@ String::operator!=(const String& rhs) const {
 //------------------------------------------------------------------------------
 bool
 String::operator<(const String& rhs) const {
-    if (this->data == rhs.data) {
+    if (this->sameData(rhs)) {
         return false;
     }
     else {
@@ -261,7 +275,7 @@ String::operator<(const String& rhs) const {
 //------------------------------------------------------------------------------
 bool
 String::operator>(const String& rhs) const {
-    if (this->data == rhs.data) {
+    if (this->sameData(rhs)) {
         return false;
     }
     else {
@@ -272,7 +286,7 @@ String::operator>(const String& rhs) const {
 //------------------------------------------------------------------------------
 bool
 String::operator<=(const String& rhs) const {
-    if (this->data == rhs.data) {
+    if (this->sameData(rhs)) {
         return true;
     }
     else {
@@ -283,7 +297,7 @@ String::operator<=(const String& rhs) const {
 //------------------------------------------------------------------------------
 bool
 String::operator>=(const String& rhs) const {
-    if (this->data == rhs.data) {
+    if (this->sameData(rhs)) {
         return true;
     }
     else {
@@ -294,22 +308,22 @@ String::operator>=(const String& rhs) const {
 //------------------------------------------------------------------------------
 int
 String::Length() const {
-    if (nullptr == this->data) {
-        return 0;
+    if (HeapString == this->inlineLength) {
+        return this->data->length;
     }
     else {
-        return this->data->length;
+        return this->inlineLength;
     }
 }
 
 //------------------------------------------------------------------------------
 const char*
 String::AsCStr() const {
-    if (nullptr == this->strPtr) {
-        return emptyString;
+    if (HeapString == this->inlineLength) {
+        return (const char*) &(this->data[1]);
     }
     else {
-        return this->strPtr;
+        return this->inlineBuf;
     }
 }
 
@@ -334,19 +348,26 @@ String::Clear() {
 //------------------------------------------------------------------------------
 int
 String::RefCount() const {
-    if (nullptr == this->data) {
-        return 0;
+    if (HeapString == this->inlineLength) {
+        return this->data->refCount;
     }
     else {
-        return this->data->refCount;
+        return this->inlineLength > 0 ? 1 : 0;
     }
 }
 
+//------------------------------------------------------------------------------
+bool
+String::IsInline() const {
+    return HeapString != this->inlineLength;
+}
+
 //------------------------------------------------------------------------------
 char
 String::Back() const {
-    if (this->strPtr) {
-        return this->strPtr[this->data->length - 1];
+    const int len = this->Length();
+    if (len > 0) {
+        return this->AsCStr()[len - 1];
     }
     else {
         return 0;
@@ -356,12 +377,7 @@ String::Back() const {
 //------------------------------------------------------------------------------
 char
 String::Front() const {
-    if (this->strPtr) {
-        return this->strPtr[0];
-    }
-    else {
-        return 0;
-    }
+    return this->AsCStr()[0];
 }
 
 //------------------------------------------------------------------------------
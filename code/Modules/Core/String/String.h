@@ -5,12 +5,18 @@
     @ingroup Core
     @brief immutable, reference counted, shared strings
     
-    An immutable, shared UTF-8 String class. Memory is only allocated
-    when creating or assigning from non-String objects (const char*,
-    StringAtoms). When assigning from another string,
-    only a pointer to the original string data is copied, and a 
-    refcount is maintained. The last String pointing to the string
-    data frees the string data.
+    An immutable, shared UTF-8 String class. Short strings (up to
+    MaxInlineLength bytes) are stored inside the String object itself,
+    creating and copying them neither allocates nor touches a refcount.
+    For longer strings, memory is only allocated when creating or
+    assigning from non-String objects (const char*, StringAtoms). When
+    assigning from another string, only a pointer to the original
+    string data is copied, and a refcount is maintained. The last
+    String pointing to the string data frees the string data.
+
+    NOTE: the pointer returned by AsCStr() of a short string points
+    into the String object, so it is only valid as long as the String
+    object isn't destroyed or changed.
     
     To manipulate string data, use the StringUtil class.
     
@@ -99,11 +105,16 @@ public:
     bool Empty() const;
     /// clear content
     void Clear();
-    /// get the refcount of this string
+    /// get the refcount of this string (1 for short, inline strings)
     int RefCount() const;
+    /// return true if the string is stored inside the String object
+    bool IsInline() const;
+
+    /// max number of bytes stored inside the String object
+    static const int MaxInlineLength = 22;
     
 private:
-    /// shared string data header, this is followed by the actual string
+    /// shared string data header for long strings, followed by the actual string
     struct StringData {
         #if ORYOL_HAS_ATOMIC
         std::atomic<int> refCount{0};
@@ -113,8 +124,16 @@ private:
         int length;
     };
     
-    /// create new string data block, numBytes does not include the terminating 0
+    /// create inline string or new string data block, len does not include the terminating 0
     void create(const char* ptr, int len);
+    /// set to the empty inline string
+    void setEmpty();
+    /// copy or share the content of another string
+    void copy(const String& rhs);
+    /// take over the content of another string
+    void move(String&& rhs);
+    /// return true if both strings point to the same shared string data
+    bool sameData(const String& rhs) const;
     /// private alloc function for len
     void alloc(int len);
     /// destroy shared string data block
@@ -124,9 +143,15 @@ private:
     /// decrement refcount, call destroy if 0
     void release();
     
-    StringData* data;
-    const char* strPtr;     // direct pointer to string data, necessary to see something in the debugger
-    static const char* emptyString;
+    /// marks a String with shared string data in inlineLength
+    static const uint8_t HeapString = 0xFF;
+
+    union {
+        StringData* data;
+        char inlineBuf[MaxInlineLength + 1];
+    };
+    /// length of inline string, or HeapString
+    uint8_t inlineLength;
 };
 
 //------------------------------------------------------------------------------
@@ -155,5 +180,11 @@ bool operator>(const StringAtom& s0, const String& s1);
 bool operator<=(const StringAtom& s0, const String& s1);
 bool operator>=(const StringAtom& s0, const String& s1);
 
+/// String holds either the string bytes or a pointer to the shared
+/// string data, but never a pointer to itself
+template<> struct IsTriviallyRelocatable<String> {
+    static const bool value = true;
+};
+
 } // namespace Oryol
 
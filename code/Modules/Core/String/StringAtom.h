@@ -6,8 +6,10 @@
     @brief immutable, unique strings for fast comparison
     
     A unique string, relatively slow on creation, but fast for comparison.
-    String atoms are stored in thread-local stringAtomTables and comparison
-    is fastest in the creator thread.
+    String atoms are stored in a global, sharded stringAtomTable, looking
+    up an existing string doesn't take a lock, and atoms are unique
+    across all threads, so comparing and copying is always a pointer
+    operation.
     
     @see String
 */
@@ -28,7 +30,7 @@ public:
     StringAtom(const char* str);
     /// construct from raw string (slow)
     StringAtom(const unsigned char* str);
-    /// copy-constructor (fast if rhs was created in same thread)
+    /// copy-constructor
     StringAtom(const StringAtom& rhs);
     /// move-constructor
     StringAtom(StringAtom&& rhs);
@@ -50,7 +52,7 @@ public:
     bool operator==(const StringAtom& rhs) const;
     /// inequality operator (FAST)
     bool operator!=(const StringAtom& rhs) const;
-    /// less-than operator (for storing in sets and maps)
+    /// less-than operator (for storing in sets and maps, not alphabetical!)
     bool operator<(const StringAtom& rhs) const;
     
     /// equality operator with raw string (SLOW!)
@@ -166,6 +168,18 @@ StringAtom::operator=(const unsigned char* rhs) {
     this->setupFromCString((const char*)rhs);
 }
 
+//------------------------------------------------------------------------------
+inline void
+StringAtom::copy(const StringAtom& rhs) {
+    this->data = rhs.data;
+}
+
+//------------------------------------------------------------------------------
+inline bool
+StringAtom::operator==(const StringAtom& rhs) const {
+    return this->data == rhs.data;
+}
+
 //------------------------------------------------------------------------------
 inline bool
 StringAtom::operator!=(const StringAtom& rhs) const {
@@ -175,10 +189,6 @@ StringAtom::operator!=(const StringAtom& rhs) const {
 //------------------------------------------------------------------------------
 inline bool
 StringAtom::operator<(const StringAtom& rhs) const {
-    if (rhs.data && this->data) {
-        // it is forbidden to compare string from different threads!
-        o_assert(this->data->table == rhs.data->table);
-    }
     return this->data < rhs.data;
 }
 
@@ -228,4 +238,9 @@ StringAtom::AsCStr() const {
     }
 }
 
+//------------------------------------------------------------------------------
+template<> struct IsTriviallyRelocatable<StringAtom> {
+    static const bool value = true;
+};
+
 } // namespace Oryol
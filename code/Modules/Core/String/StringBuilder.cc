@@ -6,6 +6,14 @@
 #include <cstdio>
 #include "StringBuilder.h"
 #include "Core/Memory/Memory.h"
+#if ORYOL_HAS_SSE2
+#include <emmintrin.h>
+#elif ORYOL_HAS_NEON
+#include <arm_neon.h>
+#endif
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
 
 #if ORYOL_WINDOWS
 #define o_strtok strtok_s
@@ -14,6 +22,235 @@
 #endif
 
 namespace Oryol {
+
+//------------------------------------------------------------------------------
+//  Search helpers. Delimiter sets are a 256-bit bitmap for the scalar
+//  code path, and a list of unique characters which are compared against
+//  16 string bytes at a time in the SIMD code path. Substring search
+//  compares the first and last character of the substring against 16
+//  positions at a time, and only calls memcmp for those candidates.
+//------------------------------------------------------------------------------
+#if ORYOL_HAS_SSE2 || ORYOL_HAS_NEON
+#define ORYOL_STRINGBUILDER_SIMD (1)
+#endif
+
+#if ORYOL_HAS_SSE2
+typedef __m128i vec8;
+/// number of mask bits per string byte in searchMask()
+static const int maskBitsPerByte = 1;
+static inline vec8 load16(const char* ptr) { return _mm_loadu_si128((const __m128i*)ptr); }
+static inline vec8 splat(char c) { return _mm_set1_epi8(c); }
+static inline vec8 zero() { return _mm_setzero_si128(); }
+static inline vec8 cmpEq(vec8 a, vec8 b) { return _mm_cmpeq_epi8(a, b); }
+static inline vec8 vecOr(vec8 a, vec8 b) { return _mm_or_si128(a, b); }
+static inline vec8 vecAnd(vec8 a, vec8 b) { return _mm_and_si128(a, b); }
+static inline vec8 vecNot(vec8 a) { return _mm_xor_si128(a, _mm_set1_epi8(-1)); }
+static inline uint64_t searchMask(vec8 a) { return uint64_t(_mm_movemask_epi8(a)); }
+#elif ORYOL_HAS_NEON
+typedef uint8x16_t vec8;
+static const int maskBitsPerByte = 4;
+static inline vec8 load16(const char* ptr) { return vld1q_u8((const uint8_t*)ptr); }
+static inline vec8 splat(char c) { return vdupq_n_u8(uint8_t(c)); }
+static inline vec8 zero() { return vdupq_n_u8(0); }
+static inline vec8 cmpEq(vec8 a, vec8 b) { return vceqq_u8(a, b); }
+static inline vec8 vecOr(vec8 a, vec8 b) { return vorrq_u8(a, b); }
+static inline vec8 vecAnd(vec8 a, vec8 b) { return vandq_u8(a, b); }
+static inline vec8 vecNot(vec8 a) { return vmvnq_u8(a); }
+static inline uint64_t searchMask(vec8 a) {
+    // NEON has no movemask, narrow each byte to 4 bits instead
+    return vget_lane_u64(vreinterpret_u64_u8(vshrn_n_u16(vreinterpretq_u16_u8(a), 4)), 0);
+}
+#endif
+
+#if ORYOL_STRINGBUILDER_SIMD
+//------------------------------------------------------------------------------
+static inline int
+lowestBit(uint64_t w) {
+    #if defined(__GNUC__) || defined(__clang__)
+    return __builtin_ctzll(w);
+    #elif defined(_MSC_VER) && (defined(_M_X64) || defined(_M_ARM64))
+    unsigned long index;
+    _BitScanForward64(&index, w);
+    return int(index);
+    #else
+    int index = 0;
+    while (0 == (w & 1)) {
+        w >>= 1;
+        index++;
+    }
+    return index;
+    #endif
+}
+
+//------------------------------------------------------------------------------
+static inline int
+highestBit(uint64_t w) {
+    #if defined(__GNUC__) || defined(__clang__)
+    return 63 - __builtin_clzll(w);
+    #elif defined(_MSC_VER) && (defined(_M_X64) || defined(_M_ARM64))
+    unsigned long index;
+    _BitScanReverse64(&index, w);
+    return int(index);
+    #else
+    int index = 0;
+    while (w >>= 1) {
+        index++;
+    }
+    return index;
+    #endif
+}
+#endif
+
+//------------------------------------------------------------------------------
+struct delimSet {
+    /// max number of unique delimiter characters for the SIMD code path
+    static const int MaxSimdChars = 16;
+
+    delimSet(const char* delims) {
+        std::memset(this->bits, 0, sizeof(this->bits));
+        for (const char* ptr = delims; 0 != *ptr; ptr++) {
+            const unsigned char c = (unsigned char) *ptr;
+            if (!this->Contains(c)) {
+                this->bits[c >> 5] |= 1u << (c & 31);
+                if (this->numChars < MaxSimdChars) {
+                    this->chars[this->numChars] = char(c);
+                }
+                this->numChars++;
+            }
+        }
+    }
+    bool Contains(unsigned char c) const {
+        return 0 != (this->bits[c >> 5] & (1u << (c & 31)));
+    }
+
+    uint32_t bits[8];
+    char chars[MaxSimdChars];
+    int numChars = 0;
+};
+
+#if ORYOL_STRINGBUILDER_SIMD
+//------------------------------------------------------------------------------
+/// compare 16 bytes against all chars in a delimiter set
+struct delimSetVec {
+    delimSetVec(const delimSet& set) :
+    numChars(set.numChars) {
+        o_assert_dbg(set.numChars <= delimSet::MaxSimdChars);
+        for (int i = 0; i < set.numChars; i++) {
+            this->chars[i] = splat(set.chars[i]);
+        }
+    }
+    vec8 Match(vec8 v) const {
+        vec8 res = zero();
+        for (int i = 0; i < this->numChars; i++) {
+            res = vecOr(res, cmpEq(v, this->chars[i]));
+        }
+        return res;
+    }
+
+    vec8 chars[delimSet::MaxSimdChars];
+    int numChars;
+};
+#endif
+
+//------------------------------------------------------------------------------
+/// find first char in range which is (or is not) in a delimiter set, return end if not found
+static const char*
+scanFirst(const char* ptr, const char* end, const delimSet& set, bool inSet) {
+    #if ORYOL_STRINGBUILDER_SIMD
+    if (((end - ptr) >= 16) && (set.numChars <= delimSet::MaxSimdChars)) {
+        const delimSetVec setVec(set);
+        for (; (ptr + 16) <= end; ptr += 16) {
+            vec8 match = setVec.Match(load16(ptr));
+            if (!inSet) {
+                match = vecNot(match);
+            }
+            const uint64_t mask = searchMask(match);
+            if (0 != mask) {
+                return ptr + (lowestBit(mask) / maskBitsPerByte);
+            }
+        }
+    }
+    #endif
+    for (; ptr < end; ptr++) {
+        if (set.Contains((unsigned char)*ptr) == inSet) {
+            return ptr;
+        }
+    }
+    return end;
+}
+
+//------------------------------------------------------------------------------
+/// find last char in range which is (or is not) in a delimiter set, return nullptr if not found
+static const char*
+scanLast(const char* begin, const char* end, const delimSet& set, bool inSet) {
+    #if ORYOL_STRINGBUILDER_SIMD
+    if (((end - begin) >= 16) && (set.numChars <= delimSet::MaxSimdChars)) {
+        const delimSetVec setVec(set);
+        for (; (end - 16) >= begin; end -= 16) {
+            vec8 match = setVec.Match(load16(end - 16));
+            if (!inSet) {
+                match = vecNot(match);
+            }
+            const uint64_t mask = searchMask(match);
+            if (0 != mask) {
+                return end - 16 + (highestBit(mask) / maskBitsPerByte);
+            }
+        }
+    }
+    #endif
+    while (end > begin) {
+        if (set.Contains((unsigned char)*--end) == inSet) {
+            return end;
+        }
+    }
+    return nullptr;
+}
+
+//------------------------------------------------------------------------------
+/**
+ Find the first occurrence of a substring which starts at one of the first
+ numPos positions of a string, the string must have at least
+ (numPos + subStrLen - 1) valid bytes. Returns nullptr if not found.
+*/
+static const char*
+searchSubString(const char* str, int numPos, const char* subStr, int subStrLen) {
+    o_assert_dbg(subStrLen > 0);
+    if (numPos <= 0) {
+        return nullptr;
+    }
+    if (1 == subStrLen) {
+        return (const char*) std::memchr(str, subStr[0], numPos);
+    }
+    int pos = 0;
+    #if ORYOL_STRINGBUILDER_SIMD
+    const vec8 first = splat(subStr[0]);
+    const vec8 last = splat(subStr[subStrLen - 1]);
+    for (; (pos + 16) <= numPos; pos += 16) {
+        const char* ptr = str + pos;
+        uint64_t mask = searchMask(vecAnd(cmpEq(load16(ptr), first), cmpEq(load16(ptr + subStrLen - 1), last)));
+        while (0 != mask) {
+            const int bit = lowestBit(mask);
+            const char* candidate = ptr + (bit / maskBitsPerByte);
+            if (0 == std::memcmp(candidate + 1, subStr + 1, subStrLen - 2)) {
+                return candidate;
+            }
+            // clear all mask bits of this byte
+            mask &= ~(((uint64_t(1) << maskBitsPerByte) - 1) << bit);
+        }
+    }
+    #endif
+    while (pos < numPos) {
+        const char* candidate = (const char*) std::memchr(str + pos, subStr[0], numPos - pos);
+        if (nullptr == candidate) {
+            return nullptr;
+        }
+        if (0 == std::memcmp(candidate + 1, subStr + 1, subStrLen - 1)) {
+            return candidate;
+        }
+        pos = int(candidate - str) + 1;
+    }
+    return nullptr;
+}
     
 //------------------------------------------------------------------------------
 StringBuilder::StringBuilder() :
@@ -357,21 +594,65 @@ StringBuilder::SubstituteRange(int startIndex, int endIndex, const char* subst)
 }
 
 //------------------------------------------------------------------------------
+/**
+ Substitutes all non-overlapping occurrences from left to right. The first
+ pass counts the matches to compute the resulting size, the second pass
+ substitutes in place if the result isn't longer, or builds the result in
+ a new buffer with a single allocation.
+*/
 int
 StringBuilder::SubstituteAll(const char* match, const char* subst) {
     o_assert(match && subst);
     o_assert(match[0] != 0);
 
+    if (nullptr == this->buffer) {
+        return 0;
+    }
+    const int matchLen = int(std::strlen(match));
+    const int substLen = int(std::strlen(subst));
+    const char* end = this->buffer + this->size;
     int numSubst = 0;
-    if (nullptr != this->buffer) {
-        char* ptr = this->buffer;
-        const int matchLen = int(std::strlen(match));
-        const int substLen = int(std::strlen(subst));
-        while (nullptr != (ptr = std::strstr(ptr, match))) {
-            this->substituteCommon(ptr, matchLen, substLen, subst);
-            numSubst++;
+    for (const char* ptr = this->buffer; nullptr != (ptr = std::strstr(ptr, match)); ptr += matchLen) {
+        numSubst++;
+    }
+    if (0 == numSubst) {
+        return 0;
+    }
+    const int newSize = this->size + numSubst * (substLen - matchLen);
+    const char* src = this->buffer;
+    char* dst;
+    char* newBuffer = nullptr;
+    if (newSize <= this->size) {
+        // result isn't longer, can substitute in place from front to back
+        dst = this->buffer;
+    }
+    else {
+        // need to grow, same growth policy as ensureRoom()
+        const int numBytes = (newSize - this->size) + 1;
+        int newCapacity = this->capacity;
+        if ((this->size + numBytes) >= this->capacity) {
+            newCapacity += (numBytes < minGrowSize) ? minGrowSize : numBytes;
         }
+        newBuffer = (char*) Memory::Alloc(newCapacity);
+        this->capacity = newCapacity;
+        dst = newBuffer;
     }
+    const char* occur;
+    while (nullptr != (occur = std::strstr(src, match))) {
+        const int numBytes = int(occur - src);
+        std::memmove(dst, src, numBytes);
+        dst += numBytes;
+        std::memcpy(dst, subst, substLen);
+        dst += substLen;
+        src = occur + matchLen;
+    }
+    std::memmove(dst, src, end - src);
+    if (newBuffer) {
+        Memory::Free(this->buffer);
+        this->buffer = newBuffer;
+    }
+    this->size = newSize;
+    this->buffer[this->size] = 0;
     return numSubst;
 }
 
@@ -415,14 +696,20 @@ StringBuilder::SubstituteFirst(const String& match, const String& subst) {
 //------------------------------------------------------------------------------
 int
 StringBuilder::findFirstOf(const char* str, int strLen, int startIndex, int endIndex, const char* delims) {
-    const char* ptr = str + startIndex;
-    const int index = (const int)std::strcspn(ptr, delims) + startIndex;
-    if (((endIndex != EndOfString) && (index >= endIndex)) || (index >= strLen)) {
+    if ((EndOfString == endIndex) || (endIndex > strLen)) {
+        endIndex = strLen;
+    }
+    if (startIndex >= endIndex) {
         return InvalidIndex;
     }
-    else {
-        return index;
+    if (endIndex == strLen) {
+        // search runs to the end of the string, libc is faster here
+        const int index = startIndex + int(std::strcspn(str + startIndex, delims));
+        return ((index < endIndex) && (0 != str[index])) ? index : InvalidIndex;
     }
+    const char* end = str + endIndex;
+    const char* ptr = scanFirst(str + startIndex, end, delimSet(delims), true);
+    return (ptr < end) ? int(ptr - str) : InvalidIndex;
 }
 
 //------------------------------------------------------------------------------
@@ -464,47 +751,38 @@ StringBuilder::FindFirstOf(int startIndex, int endIndex, const char* delims) con
 int
 StringBuilder::findLastOf(const char* str, int strLen, int startIndex, int endIndex, const char* delims) {
     const char* startPtr = str + startIndex;
-    const char* ptr;
+    const char* endPtr;
     if (EndOfString == endIndex) {
-        ptr = str + strLen;
+        endPtr = str + strLen;
     }
     else {
-        ptr = str + endIndex;
-    }
-    while (ptr > startPtr) {
-        const char c = *--ptr;
-        const char* delimPtr = delims;
-        char sc;
-        do {
-            if ((sc = *delimPtr++) == c) {
-                return int(ptr - startPtr);
-            }
-        }
-        while (sc != 0);
+        endPtr = str + endIndex;
     }
-    // not found
-    return InvalidIndex;
+    if (endPtr <= startPtr) {
+        return InvalidIndex;
+    }
+    const char* ptr = scanLast(startPtr, endPtr, delimSet(delims), true);
+    // NOTE: the returned index is relative to startIndex
+    return ptr ? int(ptr - startPtr) : InvalidIndex;
 }
 
 //------------------------------------------------------------------------------
 int
 StringBuilder::findLastNotOf(const char* str, int strLen, int startIndex, int endIndex, const char* delims) {
     const char* startPtr = str + startIndex;
-    const char* ptr;
+    const char* endPtr;
     if (EndOfString == endIndex) {
-        ptr = str + strLen;
+        endPtr = str + strLen;
     }
     else {
-        ptr = str + endIndex;
+        endPtr = str + endIndex;
     }
-    while (ptr > startPtr) {
-        const char c = *--ptr;
-        if (nullptr == strchr(delims, c)) {
-            return int(ptr - startPtr);
-        }
+    if (endPtr <= startPtr) {
+        return InvalidIndex;
     }
-    // not found
-    return InvalidIndex;
+    const char* ptr = scanLast(startPtr, endPtr, delimSet(delims), false);
+    // NOTE: the returned index is relative to startIndex
+    return ptr ? int(ptr - startPtr) : InvalidIndex;
 }
 
 //------------------------------------------------------------------------------
@@ -560,14 +838,20 @@ StringBuilder::FindLastNotOf(int startIndex, int endIndex, const char* delims) c
 //------------------------------------------------------------------------------
 int
 StringBuilder::findFirstNotOf(const char* str, int strLen, int startIndex, int endIndex, const char* delims) {
-    const char* ptr = str + startIndex;
-    int index = int(std::strspn(ptr, delims)) + startIndex;
-    if (((EndOfString != endIndex) && (index >= endIndex)) || (index >= strLen)) {
+    if ((EndOfString == endIndex) || (endIndex > strLen)) {
+        endIndex = strLen;
+    }
+    if (startIndex >= endIndex) {
         return InvalidIndex;
     }
-    else {
-        return index;
+    if (endIndex == strLen) {
+        // search runs to the end of the string, libc is faster here
+        const int index = startIndex + int(std::strspn(str + startIndex, delims));
+        return (index < endIndex) ? index : InvalidIndex;
     }
+    const char* end = str + endIndex;
+    const char* ptr = scanFirst(str + startIndex, end, delimSet(delims), false);
+    return (ptr < end) ? int(ptr - str) : InvalidIndex;
 }
 
 //------------------------------------------------------------------------------
@@ -607,21 +891,27 @@ StringBuilder::FindFirstNotOf(int startIndex, int endIndex, const char* delims)
 
 //------------------------------------------------------------------------------
 int
-StringBuilder::findSubString(const char* str, int startIndex, int endIndex, const char* subStr) {
-    const char* ptr = str + startIndex;
-    const char* occur = std::strstr(ptr, subStr);
-    if (nullptr == occur) {
+StringBuilder::findSubString(const char* str, int strLen, int startIndex, int endIndex, const char* subStr) {
+    // NOTE: a match must start before endIndex, but may extend beyond it
+    const int subStrLen = int(std::strlen(subStr));
+    int numPos = strLen - startIndex - subStrLen + 1;
+    const bool bounded = (EndOfString != endIndex) && ((endIndex - startIndex) < numPos);
+    if (bounded) {
+        numPos = endIndex - startIndex;
+    }
+    if (numPos <= 0) {
         return InvalidIndex;
     }
-    else {
-        int index = int(occur - ptr) + startIndex;
-        if ((EndOfString != endIndex) && (index >= endIndex)) {
-            return InvalidIndex;
-        }
-        else {
-            return index;
-        }
+    if (0 == subStrLen) {
+        return startIndex;
     }
+    if (!bounded) {
+        // search runs to the end of the string, libc is faster here
+        const char* occur = std::strstr(str + startIndex, subStr);
+        return occur ? int(occur - str) : InvalidIndex;
+    }
+    const char* occur = searchSubString(str + startIndex, numPos, subStr, subStrLen);
+    return occur ? int(occur - str) : InvalidIndex;
 }
 
 //------------------------------------------------------------------------------
@@ -633,8 +923,10 @@ StringBuilder::findSubString(const char* str, int startIndex, int endIndex, cons
 int
 StringBuilder::FindSubString(const char* str, int startIndex, int endIndex, const char* subStr) {
     o_assert(0 != subStr);
+    o_assert(str);
     o_assert((EndOfString == endIndex) || (endIndex >= startIndex));
-    return findSubString(str, startIndex, endIndex, subStr);
+    const int strLen = int(std::strlen(str));
+    return findSubString(str, strLen, startIndex, endIndex, subStr);
 }
     
 //------------------------------------------------------------------------------
@@ -649,7 +941,7 @@ StringBuilder::FindSubString(int startIndex, int endIndex, const char* subStr) c
     o_assert((EndOfString == endIndex) || (endIndex >= startIndex));
     if (nullptr != this->buffer) {
         o_assert(startIndex < this->size);
-        return findSubString(this->buffer, startIndex, endIndex, subStr);
+        return findSubString(this->buffer, this->size, startIndex, endIndex, subStr);
     }
     else {
         // no content
@@ -152,7 +152,7 @@ private:
     /// helper function for FindLastNotOf functions
     static int findLastNotOf(const char* str, int strLen, int startIndex, int endIndex, const char* delims);
     /// helper function for FindSubString functions
-    static int findSubString(const char* str, int startIndex, int endIndex, const char* subStr);
+    static int findSubString(const char* str, int strLen, int startIndex, int endIndex, const char* subStr);
     /// internal formatting method
     bool format(int maxLength, bool append, const char* fmt, va_list args);
     
@@ -4,98 +4,68 @@
 #include "Pre.h"
 #include "Core/Assertion.h"
 #include "StringConverter.h"
-#include "ConvertUTF.h"
+#include "utf8Codec.h"
+#include "ryuTables.h"
+#include <cfloat>
+#include <clocale>
 #include <cstdlib>
 #include <cstring>
 #include <cwchar>
+#include <limits>
+#include <type_traits>
 
 namespace Oryol {
 
 //------------------------------------------------------------------------------
 static void
-DumpWarning(ConversionResult convRes) {
+DumpWarning(int convRes) {
     const char* err = "";
-    if (sourceExhausted == convRes) err = "sourceExhausted";
-    else if (targetExhausted == convRes) err = "targetExhausted";
-    else if (sourceIllegal == convRes) err = "sourceIllegal";
+    if (utf8Codec::TargetExhausted == convRes) err = "targetExhausted";
+    else if (utf8Codec::InvalidSource == convRes) err = "sourceIllegal";
     o_warn("StringConverter: conversion failed with '%s'\n", err);
 }
 
+//------------------------------------------------------------------------------
+bool
+StringConverter::ValidateUTF8(const unsigned char* src, int srcNumBytes) {
+    o_assert((0 != src) || (0 == srcNumBytes));
+    return utf8Codec::Validate(src, srcNumBytes);
+}
+
 //------------------------------------------------------------------------------
 int
 StringConverter::UTF8ToWide(const unsigned char* src, int srcNumBytes, wchar_t* dst, int dstMaxBytes) {
     o_assert((0 != src) && (0 != dst));
-    int result = 0;
-    const UTF8* srcPtr = src;
 
     // need to keep 1 wchar_t for the terminating 0
-    ConversionResult convRes = conversionOK;
-    wchar_t* dstEndPtr = dst + ((dstMaxBytes / sizeof(wchar_t)) - 1);
-    o_assert(dstEndPtr > dst);
-    if (sizeof(wchar_t) == 4) {
-        UTF32* dstPtr = (UTF32*)dst;
-        convRes = ConvertUTF8toUTF32(&srcPtr, src + srcNumBytes, &dstPtr, (UTF32*) dstEndPtr, strictConversion);
-        o_assert(dstPtr < (UTF32*) (dst + (dstMaxBytes / sizeof(wchar_t))));
-        *dstPtr = 0;
-        if (conversionOK == convRes) {
-            result = int(dstPtr - (UTF32*)dst) + 1;
-        }
-    } 
-    else {
-        o_assert(2 == sizeof(wchar_t));
-        UTF16* dstPtr = (UTF16*) dst;
-        convRes = ConvertUTF8toUTF16(&srcPtr, src + srcNumBytes, &dstPtr, (UTF16*) dstEndPtr, strictConversion);
-        o_assert(dstPtr < (UTF16*) (dst + (dstMaxBytes / sizeof(wchar_t))));
-        *dstPtr = 0;
-        if (conversionOK == convRes) {
-            result = int(dstPtr - (UTF16*)dst) + 1;
-        }
-    }
-    if (conversionOK != convRes) {
+    const int dstMaxChars = int(dstMaxBytes / sizeof(wchar_t)) - 1;
+    o_assert(dstMaxChars > 0);
+    const int convRes = utf8Codec::UTF8ToWide(src, srcNumBytes, dst, dstMaxChars);
+    if (convRes < 0) {
+        dst[0] = 0;
         DumpWarning(convRes);
         return 0;
     }
-    return result;
+    dst[convRes] = 0;
+    return convRes + 1;
 }
 
 //------------------------------------------------------------------------------
 int
 StringConverter::WideToUTF8(const wchar_t* src, int srcNumChars, unsigned char* dst, int dstMaxBytes) {
     o_assert((0 != src) && (0 != dst));
-    int result = 0;
-    UTF8* dstPtr = dst;
 
     // need to keep 1 char free for 0-termination
-    ConversionResult convRes = conversionOK;
-    UTF8* dstEnd = (dst + dstMaxBytes) - 1;
-    o_assert(dstEnd > dst);
-    if (sizeof(wchar_t) == 4) {
-        o_assert(4 == sizeof(wchar_t));
-        const UTF32* srcPtr = (const UTF32*) src;
-        const UTF32* srcEndPtr = (UTF32*) src + srcNumChars;
-        convRes = ConvertUTF32toUTF8(&srcPtr, srcEndPtr, &dstPtr, dstEnd, strictConversion);
-        o_assert(dstPtr < (dst + dstMaxBytes));
-        *dstPtr = 0;
-        if (conversionOK == convRes) {
-            result = int(dstPtr - dst) + 1;
-        }
-    }
-    else {
-        o_assert(2 == sizeof(wchar_t));
-        const UTF16* srcPtr = (UTF16*) src;
-        const UTF16* srcEndPtr = (UTF16*) src + srcNumChars;
-        convRes = ConvertUTF16toUTF8(&srcPtr, srcEndPtr, &dstPtr, dstEnd, strictConversion);
-        o_assert(dstPtr < (dst + dstMaxBytes));
-        *dstPtr = 0;
-        if (conversionOK == convRes) {
-            result = int(dstPtr - dst) + 1;
-        }
-    }
-    if (conversionOK != convRes) {
+    const int dstMaxChars = dstMaxBytes - 1;
+    o_assert(dstMaxChars > 0);
+    const int convRes = utf8Codec::WideToUTF8(src, srcNumChars, dst, dstMaxChars);
+    if (convRes < 0) {
+        dst[0] = 0;
         DumpWarning(convRes);
         return 0;
     }
-    return result;
+    dst[convRes] = 0;
+    return convRes + 1;
 }
 
 //------------------------------------------------------------------------------
@@ -182,59 +152,863 @@ StringConverter::UTF8ToWide(const String& src) {
 }
 
 //------------------------------------------------------------------------------
-template<> int8_t
-StringConverter::FromString(const char* str) {
-    o_assert_dbg(str);
-    return (int8_t) std::atoi(str);
+//  number parsing
+//------------------------------------------------------------------------------
+static inline bool
+isDigit(char c) {
+    return (unsigned char)(c - '0') < 10;
+}
+
+//------------------------------------------------------------------------------
+/// load 8 chars as little-endian 64-bit value
+static inline uint64_t
+loadEightChars(const char* p) {
+    uint64_t val;
+    std::memcpy(&val, p, sizeof(val));
+    #if defined(__BYTE_ORDER__) && (__BYTE_ORDER__ == __ORDER_BIG_ENDIAN__)
+    val = __builtin_bswap64(val);
+    #endif
+    return val;
+}
+
+//------------------------------------------------------------------------------
+/// check if all 8 chars loaded with loadEightChars() are decimal digits
+static inline bool
+isEightDigits(uint64_t val) {
+    return 0 == (((val + 0x4646464646464646ull) | (val - 0x3030303030303030ull)) & 0x8080808080808080ull);
+}
+
+//------------------------------------------------------------------------------
+/// convert 8 decimal digits loaded with loadEightChars() to an integer
+static inline uint32_t
+parseEightDigits(uint64_t val) {
+    const uint64_t mask = 0x000000FF000000FFull;
+    const uint64_t mul1 = 0x000F424000000064ull;    // 100 + (1000000 << 32)
+    const uint64_t mul2 = 0x0000271000000001ull;    // 1 + (10000 << 32)
+    val -= 0x3030303030303030ull;
+    val = (val * 10) + (val >> 8);
+    val = (((val & mask) * mul1) + (((val >> 16) & mask) * mul2)) >> 32;
+    return uint32_t(val);
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE> static int
+parseInt(const char* str, int numBytes, TYPE& outValue) {
+    o_assert_dbg(str && (numBytes >= 0));
+    typedef std::numeric_limits<TYPE> limits;
+    const char* p = str;
+    const char* end = str + numBytes;
+    bool neg = false;
+    if ((p < end) && (('-' == *p) || ('+' == *p))) {
+        neg = ('-' == *p);
+        if (neg && !limits::is_signed) {
+            return 0;
+        }
+        p++;
+    }
+    const char* digits = p;
+    uint64_t val = 0;
+    // 8 digits at a time, 16 digits can't overflow
+    while (((end - p) >= 8) && ((p - digits) < 16)) {
+        const uint64_t chunk = loadEightChars(p);
+        if (!isEightDigits(chunk)) {
+            break;
+        }
+        val = (val * 100000000) + parseEightDigits(chunk);
+        p += 8;
+    }
+    bool overflow = false;
+    for (; (p < end) && isDigit(*p); p++) {
+        const uint64_t d = uint64_t(*p - '0');
+        if (val > ((UINT64_MAX - d) / 10)) {
+            overflow = true;
+        }
+        else {
+            val = (val * 10) + d;
+        }
+    }
+    if ((p == digits) || overflow) {
+        return 0;
+    }
+    if (neg) {
+        if (val > (uint64_t(limits::max()) + 1)) {
+            return 0;
+        }
+        outValue = TYPE(uint64_t(0) - val);
+    }
+    else {
+        if (val > uint64_t(limits::max())) {
+            return 0;
+        }
+        outValue = TYPE(val);
+    }
+    return int(p - str);
+}
+
+//------------------------------------------------------------------------------
+/// accumulate up to 19 significant digits into mantissa, count the others as dropped
+static const char*
+scanMantissa(const char* p, const char* end, uint64_t& mantissa, int& numDigits, int& numDropped, bool& truncated) {
+    while (((end - p) >= 8) && (numDigits <= 11)) {
+        const uint64_t chunk = loadEightChars(p);
+        if (!isEightDigits(chunk)) {
+            break;
+        }
+        mantissa = (mantissa * 100000000) + parseEightDigits(chunk);
+        numDigits += 8;
+        p += 8;
+    }
+    for (; (p < end) && isDigit(*p); p++) {
+        if (numDigits < 19) {
+            mantissa = (mantissa * 10) + uint64_t(*p - '0');
+            numDigits++;
+        }
+        else {
+            numDropped++;
+            truncated |= ('0' != *p);
+        }
+    }
+    return p;
+}
+
+//------------------------------------------------------------------------------
+/// case-insensitive match of a lower-case word
+static bool
+matchWord(const char* p, const char* end, const char* word) {
+    for (; *word; p++, word++) {
+        if ((p >= end) || ((*p | 0x20) != *word)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+//------------------------------------------------------------------------------
+/// exact conversion of mantissa * 10^exp10 if both are small enough
+static bool
+fastPathDouble(uint64_t mantissa, int exp10, double& outValue) {
+    // needs double arithmetic without excess precision (not x87)
+    #if defined(FLT_EVAL_METHOD) && (FLT_EVAL_METHOD != 0) && (FLT_EVAL_METHOD != 1)
+    return false;
+    #else
+    static const double pow10[] = {
+        1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+        1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+    };
+    const uint64_t maxMantissa = uint64_t(1) << 53;
+    if (0 == mantissa) {
+        outValue = 0.0;
+        return true;
+    }
+    if ((mantissa > maxMantissa) || (exp10 < -22)) {
+        return false;
+    }
+    // move excess powers of ten into the mantissa if it stays exact
+    for (; exp10 > 22; exp10--) {
+        if (mantissa > (maxMantissa / 10)) {
+            return false;
+        }
+        mantissa *= 10;
+    }
+    if (exp10 >= 0) {
+        outValue = double(mantissa) * pow10[exp10];
+    }
+    else {
+        outValue = double(mantissa) / pow10[-exp10];
+    }
+    return true;
+    #endif
+}
+
+//------------------------------------------------------------------------------
+/// slow path through the C runtime, which depends on the locale's decimal point
+template<class TYPE> static TYPE
+parseFloatCRuntime(const char* str, int len) {
+    char localBuf[128];
+    char* buf = (len < int(sizeof(localBuf))) ? localBuf : (char*) Memory::Alloc(len + 1);
+    std::memcpy(buf, str, len);
+    buf[len] = 0;
+    const char decimalPoint = std::localeconv()->decimal_point[0];
+    if ('.' != decimalPoint) {
+        for (int i = 0; i < len; i++) {
+            if ('.' == buf[i]) {
+                buf[i] = decimalPoint;
+            }
+        }
+    }
+    const double result = std::is_same<TYPE, float>::value ? std::strtof(buf, nullptr) : std::strtod(buf, nullptr);
+    if (buf != localBuf) {
+        Memory::Free(buf);
+    }
+    return TYPE(result);
+}
+
+//------------------------------------------------------------------------------
+/// convert correctly rounded double to float, false if double rounding could be off
+static bool
+narrowToFloat(double d, float& outValue) {
+    const double absD = d < 0.0 ? -d : d;
+    if ((0.0 != absD) && ((absD < FLT_MIN) || (absD > FLT_MAX))) {
+        return false;
+    }
+    // the double is the nearest to the exact value, so rounding it to float
+    // is only wrong if it sits exactly half-way between two floats
+    uint64_t bits;
+    std::memcpy(&bits, &d, sizeof(bits));
+    const uint64_t halfway = uint64_t(1) << 28;
+    if ((bits & ((halfway << 1) - 1)) == halfway) {
+        return false;
+    }
+    outValue = float(d);
+    return true;
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE> static int
+parseFloat(const char* str, int numBytes, TYPE& outValue) {
+    o_assert_dbg(str && (numBytes >= 0));
+    const char* p = str;
+    const char* end = str + numBytes;
+    bool neg = false;
+    if ((p < end) && (('-' == *p) || ('+' == *p))) {
+        neg = ('-' == *p);
+        p++;
+    }
+
+    // infinity and not-a-number
+    if ((p < end) && !isDigit(*p) && ('.' != *p)) {
+        if (matchWord(p, end, "inf")) {
+            p += matchWord(p, end, "infinity") ? 8 : 3;
+            outValue = neg ? -std::numeric_limits<TYPE>::infinity() : std::numeric_limits<TYPE>::infinity();
+            return int(p - str);
+        }
+        else if (matchWord(p, end, "nan")) {
+            outValue = std::numeric_limits<TYPE>::quiet_NaN();
+            return int(p - str + 3);
+        }
+        return 0;
+    }
+
+    // mantissa, leading zeros are not significant
+    uint64_t mantissa = 0;
+    int numDigits = 0;
+    int numDropped = 0;
+    bool truncated = false;
+    const char* digits = p;
+    while ((p < end) && ('0' == *p)) {
+        p++;
+    }
+    p = scanMantissa(p, end, mantissa, numDigits, numDropped, truncated);
+    bool hasDigits = (p != digits);
+    int exp10 = numDropped;
+    if ((p < end) && ('.' == *p)) {
+        p++;
+        const char* fraction = p;
+        if (0 == numDigits) {
+            for (; (p < end) && ('0' == *p); p++) {
+                exp10--;
+            }
+        }
+        const int numIntDigits = numDigits;
+        p = scanMantissa(p, end, mantissa, numDigits, numDropped, truncated);
+        exp10 -= numDigits - numIntDigits;
+        hasDigits |= (p != fraction);
+    }
+    if (!hasDigits) {
+        return 0;
+    }
+
+    // optional exponent, an 'e' without digits isn't part of the number
+    if ((p < end) && (('e' == *p) || ('E' == *p))) {
+        const char* e = p + 1;
+        bool expNeg = false;
+        if ((e < end) && (('-' == *e) || ('+' == *e))) {
+            expNeg = ('-' == *e);
+            e++;
+        }
+        if ((e < end) && isDigit(*e)) {
+            int expVal = 0;
+            for (; (e < end) && isDigit(*e); e++) {
+                if (expVal < 100000) {
+                    expVal = (expVal * 10) + (*e - '0');
+                }
+            }
+            exp10 += expNeg ? -expVal : expVal;
+            p = e;
+        }
+    }
+
+    const int len = int(p - str);
+    double d = 0.0;
+    if (!truncated && fastPathDouble(mantissa, exp10, d)) {
+        if (neg) {
+            d = -d;
+        }
+        if (std::is_same<TYPE, double>::value) {
+            outValue = TYPE(d);
+            return len;
+        }
+        float f = 0.0f;
+        if (narrowToFloat(d, f)) {
+            outValue = TYPE(f);
+            return len;
+        }
+    }
+    outValue = parseFloatCRuntime<TYPE>(str, len);
+    return len;
+}
+
+//------------------------------------------------------------------------------
+//  number formatting
+//------------------------------------------------------------------------------
+static const char digitPairs[] =
+    "00010203040506070809"
+    "10111213141516171819"
+    "20212223242526272829"
+    "30313233343536373839"
+    "40414243444546474849"
+    "50515253545556575859"
+    "60616263646566676869"
+    "70717273747576777879"
+    "80818283848586878889"
+    "90919293949596979899";
+
+//------------------------------------------------------------------------------
+/// write decimal digits of val backward, ending at end, returns pointer to first digit
+static char*
+writeDigitsBackward(uint64_t val, char* end) {
+    char* p = end;
+    while (val >= 100) {
+        const int i = int(val % 100) * 2;
+        val /= 100;
+        *--p = digitPairs[i + 1];
+        *--p = digitPairs[i];
+    }
+    if (val >= 10) {
+        const int i = int(val) * 2;
+        *--p = digitPairs[i + 1];
+        *--p = digitPairs[i];
+    }
+    else {
+        *--p = char('0' + val);
+    }
+    return p;
+}
+
+//------------------------------------------------------------------------------
+/// copy result into the caller's buffer, with terminating 0
+static int
+copyResult(const char* src, int len, char* buf, int bufSize) {
+    o_assert_dbg(buf && (bufSize > 0));
+    if (len >= bufSize) {
+        buf[0] = 0;
+        return 0;
+    }
+    std::memcpy(buf, src, len);
+    buf[len] = 0;
+    return len;
 }
 
 //------------------------------------------------------------------------------
-template<> uint8_t
-StringConverter::FromString(const char* str) {
-    o_assert_dbg(str);
-    return (uint8_t) std::atoi(str);
+template<class TYPE> static int
+intToChars(TYPE val, char* buf, int bufSize) {
+    char tmp[24];
+    char* end = tmp + sizeof(tmp);
+    const bool neg = std::numeric_limits<TYPE>::is_signed && (val < TYPE(0));
+    const uint64_t absVal = neg ? (uint64_t(0) - uint64_t(val)) : uint64_t(val);
+    char* p = writeDigitsBackward(absVal, end);
+    if (neg) {
+        *--p = '-';
+    }
+    return copyResult(p, int(end - p), buf, bufSize);
 }
 
 //------------------------------------------------------------------------------
-template<> int16_t
-StringConverter::FromString(const char* str) {
-    o_assert_dbg(str);
-    return (int16_t) std::atoi(str);
+/// format decimal digits * 10^exp10 the way JavaScript's Number.toString() does
+static int
+formatDecimal(bool neg, uint64_t decimal, int exp10, char* buf, int bufSize) {
+    char digitBuf[20];
+    char* digits = writeDigitsBackward(decimal, digitBuf + sizeof(digitBuf));
+    const int numDigits = int(digitBuf + sizeof(digitBuf) - digits);
+    const int pointPos = numDigits + exp10;
+
+    char tmp[40];
+    int len = 0;
+    if (neg) {
+        tmp[len++] = '-';
+    }
+    if ((numDigits <= pointPos) && (pointPos <= 21)) {
+        // integer, 1234e2 => 123400
+        std::memcpy(tmp + len, digits, numDigits);
+        len += numDigits;
+        for (int i = numDigits; i < pointPos; i++) {
+            tmp[len++] = '0';
+        }
+    }
+    else if ((0 < pointPos) && (pointPos <= 21)) {
+        // 1234e-2 => 12.34
+        std::memcpy(tmp + len, digits, pointPos);
+        len += pointPos;
+        tmp[len++] = '.';
+        std::memcpy(tmp + len, digits + pointPos, numDigits - pointPos);
+        len += numDigits - pointPos;
+    }
+    else if ((-6 < pointPos) && (pointPos <= 0)) {
+        // 1234e-6 => 0.001234
+        tmp[len++] = '0';
+        tmp[len++] = '.';
+        for (int i = pointPos; i < 0; i++) {
+            tmp[len++] = '0';
+        }
+        std::memcpy(tmp + len, digits, numDigits);
+        len += numDigits;
+    }
+    else {
+        // 1234e30 => 1.234e+33
+        tmp[len++] = digits[0];
+        if (numDigits > 1) {
+            tmp[len++] = '.';
+            std::memcpy(tmp + len, digits + 1, numDigits - 1);
+            len += numDigits - 1;
+        }
+        tmp[len++] = 'e';
+        const int exp = pointPos - 1;
+        tmp[len++] = exp < 0 ? '-' : '+';
+        char expBuf[8];
+        char* expDigits = writeDigitsBackward(uint64_t(exp < 0 ? -exp : exp), expBuf + sizeof(expBuf));
+        const int numExpDigits = int(expBuf + sizeof(expBuf) - expDigits);
+        std::memcpy(tmp + len, expDigits, numExpDigits);
+        len += numExpDigits;
+    }
+    return copyResult(tmp, len, buf, bufSize);
+}
+
+//------------------------------------------------------------------------------
+/// format zero, infinity and NaN, returns -1 if val is a regular number
+static int
+formatSpecial(bool neg, bool isZero, bool isNaN, char* buf, int bufSize) {
+    if (isNaN) {
+        return copyResult("nan", 3, buf, bufSize);
+    }
+    else if (isZero) {
+        return neg ? copyResult("-0", 2, buf, bufSize) : copyResult("0", 1, buf, bufSize);
+    }
+    else {
+        return neg ? copyResult("-inf", 4, buf, bufSize) : copyResult("inf", 3, buf, bufSize);
+    }
 }
 
 //------------------------------------------------------------------------------
-template<> uint16_t
-StringConverter::FromString(const char* str) {
-    o_assert_dbg(str);
-    return (uint16_t) std::atoi(str);
+//  Ryu helpers, see ryuTables.h
+//------------------------------------------------------------------------------
+/// returns e == 0 ? 1 : ceil(log2(5^e))
+static inline int
+pow5Bits(int e) {
+    return int((uint32_t(e) * 1217359) >> 19) + 1;
 }
 
 //------------------------------------------------------------------------------
-template<> int
-StringConverter::FromString(const char* str) {
-    o_assert_dbg(str);
-    return (int) std::atoi(str);
+/// returns floor(log10(2^e))
+static inline int
+log10Pow2(int e) {
+    return int((uint32_t(e) * 78913) >> 18);
 }
 
 //------------------------------------------------------------------------------
-template<> uint32_t
-StringConverter::FromString(const char* str) {
-    o_assert_dbg(str);
-    return (uint32_t) std::atoi(str);
+/// returns floor(log10(5^e))
+static inline int
+log10Pow5(int e) {
+    return int((uint32_t(e) * 732923) >> 20);
 }
 
 //------------------------------------------------------------------------------
-template<> float
-StringConverter::FromString(const char* str) {
-    o_assert_dbg(str);
-    return (float) std::atof(str);
+static inline int
+pow5Factor(uint64_t val) {
+    int count = 0;
+    while ((val % 5) == 0) {
+        val /= 5;
+        count++;
+    }
+    return count;
 }
 
 //------------------------------------------------------------------------------
-template<> double
-StringConverter::FromString(const char* str) {
-    o_assert_dbg(str);
-    return std::atof(str);
+static inline bool
+multipleOfPowerOf5(uint64_t val, int p) {
+    return pow5Factor(val) >= p;
 }
 
+//------------------------------------------------------------------------------
+static inline bool
+multipleOfPowerOf2(uint64_t val, int p) {
+    return (val & ((uint64_t(1) << p) - 1)) == 0;
+}
+
+//------------------------------------------------------------------------------
+/// 64x64 => 128 bit multiplication
+static inline uint64_t
+umul128(uint64_t a, uint64_t b, uint64_t* outHigh) {
+    #if defined(__SIZEOF_INT128__)
+    const unsigned __int128 r = (unsigned __int128)a * b;
+    *outHigh = uint64_t(r >> 64);
+    return uint64_t(r);
+    #else
+    const uint64_t aLo = uint32_t(a), aHi = a >> 32;
+    const uint64_t bLo = uint32_t(b), bHi = b >> 32;
+    const uint64_t b00 = aLo * bLo;
+    const uint64_t b01 = aLo * bHi;
+    const uint64_t b10 = aHi * bLo;
+    const uint64_t b11 = aHi * bHi;
+    const uint64_t mid1 = b10 + (b00 >> 32);
+    const uint64_t mid2 = b01 + uint32_t(mid1);
+    *outHigh = b11 + (mid1 >> 32) + (mid2 >> 32);
+    return (mid2 << 32) | uint32_t(b00);
+    #endif
+}
+
+//------------------------------------------------------------------------------
+/// (m * mul) >> j for a 128-bit mul, with 64 <= j < 128
+static inline uint64_t
+mulShift64(uint64_t m, const uint64_t* mul, int j) {
+    uint64_t high0;
+    umul128(m, mul[0], &high0);
+    uint64_t high1;
+    const uint64_t low1 = umul128(m, mul[1], &high1);
+    const uint64_t sum = high0 + low1;
+    if (sum < high0) {
+        high1++;
+    }
+    const int dist = j - 64;
+    o_assert_dbg((dist >= 0) && (dist < 64));
+    return (0 == dist) ? sum : ((high1 << (64 - dist)) | (sum >> dist));
+}
+
+//------------------------------------------------------------------------------
+/// (m * factor) >> shift for a 64-bit factor, with 32 <= shift
+static inline uint32_t
+mulShift32(uint32_t m, uint64_t factor, int shift) {
+    const uint64_t bits0 = uint64_t(m) * uint32_t(factor);
+    const uint64_t bits1 = uint64_t(m) * uint32_t(factor >> 32);
+    const uint64_t sum = (bits0 >> 32) + bits1;
+    o_assert_dbg(shift >= 32);
+    return uint32_t(sum >> (shift - 32));
+}
+
+//------------------------------------------------------------------------------
+/// find the shortest decimal which rounds to the given double (Ryu d2d)
+static void
+ryuDouble(uint64_t ieeeMantissa, uint32_t ieeeExponent, uint64_t& outDecimal, int& outExp10) {
+    const int mantissaBits = 52;
+    const int bias = 1023;
+
+    // subtract 2 so that the bounds computation has 2 additional bits
+    int e2;
+    uint64_t m2;
+    if (0 == ieeeExponent) {
+        e2 = 1 - bias - mantissaBits - 2;
+        m2 = ieeeMantissa;
+    }
+    else {
+        e2 = int(ieeeExponent) - bias - mantissaBits - 2;
+        m2 = (uint64_t(1) << mantissaBits) | ieeeMantissa;
+    }
+    const bool acceptBounds = (m2 & 1) == 0;
+
+    // the interval of valid decimal representations is [mm, mp] around mv
+    const uint64_t mv = 4 * m2;
+    const uint32_t mmShift = ((0 != ieeeMantissa) || (ieeeExponent <= 1)) ? 1 : 0;
+
+    // convert to a decimal power base
+    uint64_t vr, vp, vm;
+    int e10;
+    bool vmIsTrailingZeros = false;
+    bool vrIsTrailingZeros = false;
+    if (e2 >= 0) {
+        const int q = log10Pow2(e2) - (e2 > 3 ? 1 : 0);
+        e10 = q;
+        const int k = _priv::DoublePow5InvBitCount + pow5Bits(q) - 1;
+        const int i = -e2 + q + k;
+        o_assert_dbg(q < _priv::DoublePow5InvTableSize);
+        const uint64_t* mul = _priv::DoublePow5InvSplit[q];
+        vr = mulShift64(mv, mul, i);
+        vp = mulShift64(mv + 2, mul, i);
+        vm = mulShift64(mv - 1 - mmShift, mul, i);
+        if (q <= 21) {
+            // only one of mp, mv and mm can be a multiple of 5, if any
+            if ((mv % 5) == 0) {
+                vrIsTrailingZeros = multipleOfPowerOf5(mv, q);
+            }
+            else if (acceptBounds) {
+                vmIsTrailingZeros = multipleOfPowerOf5(mv - 1 - mmShift, q);
+            }
+            else {
+                vp -= multipleOfPowerOf5(mv + 2, q) ? 1 : 0;
+            }
+        }
+    }
+    else {
+        const int q = log10Pow5(-e2) - (-e2 > 1 ? 1 : 0);
+        e10 = q + e2;
+        const int i = -e2 - q;
+        const int k = pow5Bits(i) - _priv::DoublePow5BitCount;
+        const int j = q - k;
+        o_assert_dbg(i < _priv::DoublePow5TableSize);
+        const uint64_t* mul = _priv::DoublePow5Split[i];
+        vr = mulShift64(mv, mul, j);
+        vp = mulShift64(mv + 2, mul, j);
+        vm = mulShift64(mv - 1 - mmShift, mul, j);
+        if (q <= 1) {
+            // mv = 4 * m2 always has at least 2 trailing 0 bits
+            vrIsTrailingZeros = true;
+            if (acceptBounds) {
+                // mm = mv - 1 - mmShift has 1 trailing 0 bit iff mmShift == 1
+                vmIsTrailingZeros = (1 == mmShift);
+            }
+            else {
+                // mp = mv + 2 always has at least 1 trailing 0 bit
+                vp--;
+            }
+        }
+        else if (q < 63) {
+            vrIsTrailingZeros = multipleOfPowerOf2(mv, q);
+        }
+    }
+
+    // find the shortest representation in the interval
+    int removed = 0;
+    int lastRemovedDigit = 0;
+    uint64_t output;
+    if (vmIsTrailingZeros || vrIsTrailingZeros) {
+        // general case (rare)
+        while ((vp / 10) > (vm / 10)) {
+            vmIsTrailingZeros &= (vm % 10) == 0;
+            vrIsTrailingZeros &= (0 == lastRemovedDigit);
+            lastRemovedDigit = int(vr % 10);
+            vr /= 10;
+            vp /= 10;
+            vm /= 10;
+            removed++;
+        }
+        if (vmIsTrailingZeros) {
+            while ((vm % 10) == 0) {
+                vrIsTrailingZeros &= (0 == lastRemovedDigit);
+                lastRemovedDigit = int(vr % 10);
+                vr /= 10;
+                vp /= 10;
+                vm /= 10;
+                removed++;
+            }
+        }
+        if (vrIsTrailingZeros && (5 == lastRemovedDigit) && ((vr % 2) == 0)) {
+            // round to even if the exact number is .....50..0
+            lastRemovedDigit = 4;
+        }
+        // take vr + 1 if vr is outside bounds or we need to round up
+        output = vr + ((((vr == vm) && (!acceptBounds || !vmIsTrailingZeros)) || (lastRemovedDigit >= 5)) ? 1 : 0);
+    }
+    else {
+        // common case
+        bool roundUp = false;
+        if ((vp / 100) > (vm / 100)) {
+            // remove two digits at a time
+            roundUp = (vr % 100) >= 50;
+            vr /= 100;
+            vp /= 100;
+            vm /= 100;
+            removed += 2;
+        }
+        while ((vp / 10) > (vm / 10)) {
+            roundUp = (vr % 10) >= 5;
+            vr /= 10;
+            vp /= 10;
+            vm /= 10;
+            removed++;
+        }
+        output = vr + (((vr == vm) || roundUp) ? 1 : 0);
+    }
+    outDecimal = output;
+    outExp10 = e10 + removed;
+}
+
+//------------------------------------------------------------------------------
+/// find the shortest decimal which rounds to the given float (Ryu f2d)
+static void
+ryuFloat(uint32_t ieeeMantissa, uint32_t ieeeExponent, uint32_t& outDecimal, int& outExp10) {
+    const int mantissaBits = 23;
+    const int bias = 127;
+
+    int e2;
+    uint32_t m2;
+    if (0 == ieeeExponent) {
+        e2 = 1 - bias - mantissaBits - 2;
+        m2 = ieeeMantissa;
+    }
+    else {
+        e2 = int(ieeeExponent) - bias - mantissaBits - 2;
+        m2 = (uint32_t(1) << mantissaBits) | ieeeMantissa;
+    }
+    const bool acceptBounds = (m2 & 1) == 0;
+
+    const uint32_t mv = 4 * m2;
+    const uint32_t mp = (4 * m2) + 2;
+    const uint32_t mmShift = ((0 != ieeeMantissa) || (ieeeExponent <= 1)) ? 1 : 0;
+    const uint32_t mm = (4 * m2) - 1 - mmShift;
+
+    uint32_t vr, vp, vm;
+    int e10;
+    bool vmIsTrailingZeros = false;
+    bool vrIsTrailingZeros = false;
+    int lastRemovedDigit = 0;
+    if (e2 >= 0) {
+        const int q = log10Pow2(e2);
+        e10 = q;
+        const int k = _priv::FloatPow5InvBitCount + pow5Bits(q) - 1;
+        const int i = -e2 + q + k;
+        o_assert_dbg(q < _priv::FloatPow5InvTableSize);
+        vr = mulShift32(mv, _priv::FloatPow5InvSplit[q], i);
+        vp = mulShift32(mp, _priv::FloatPow5InvSplit[q], i);
+        vm = mulShift32(mm, _priv::FloatPow5InvSplit[q], i);
+        if ((0 != q) && (((vp - 1) / 10) <= (vm / 10))) {
+            // we need to know one removed digit even if we are not going to loop below
+            const int l = _priv::FloatPow5InvBitCount + pow5Bits(q - 1) - 1;
+            lastRemovedDigit = int(mulShift32(mv, _priv::FloatPow5InvSplit[q - 1], -e2 + q - 1 + l) % 10);
+        }
+        if (q <= 9) {
+            // only one of mp, mv and mm can be a multiple of 5, if any
+            if ((mv % 5) == 0) {
+                vrIsTrailingZeros = multipleOfPowerOf5(mv, q);
+            }
+            else if (acceptBounds) {
+                vmIsTrailingZeros = multipleOfPowerOf5(mm, q);
+            }
+            else {
+                vp -= multipleOfPowerOf5(mp, q) ? 1 : 0;
+            }
+        }
+    }
+    else {
+        const int q = log10Pow5(-e2);
+        e10 = q + e2;
+        const int i = -e2 - q;
+        const int k = pow5Bits(i) - _priv::FloatPow5BitCount;
+        int j = q - k;
+        o_assert_dbg(i < _priv::FloatPow5TableSize);
+        vr = mulShift32(mv, _priv::FloatPow5Split[i], j);
+        vp = mulShift32(mp, _priv::FloatPow5Split[i], j);
+        vm = mulShift32(mm, _priv::FloatPow5Split[i], j);
+        if ((0 != q) && (((vp - 1) / 10) <= (vm / 10))) {
+            j = q - 1 - (pow5Bits(i + 1) - _priv::FloatPow5BitCount);
+            lastRemovedDigit = int(mulShift32(mv, _priv::FloatPow5Split[i + 1], j) % 10);
+        }
+        if (q <= 1) {
+            vrIsTrailingZeros = true;
+            if (acceptBounds) {
+                vmIsTrailingZeros = (1 == mmShift);
+            }
+            else {
+                vp--;
+            }
+        }
+        else if (q < 31) {
+            vrIsTrailingZeros = multipleOfPowerOf2(mv, q - 1);
+        }
+    }
+
+    int removed = 0;
+    uint32_t output;
+    if (vmIsTrailingZeros || vrIsTrailingZeros) {
+        while ((vp / 10) > (vm / 10)) {
+            vmIsTrailingZeros &= (vm % 10) == 0;
+            vrIsTrailingZeros &= (0 == lastRemovedDigit);
+            lastRemovedDigit = int(vr % 10);
+            vr /= 10;
+            vp /= 10;
+            vm /= 10;
+            removed++;
+        }
+        if (vmIsTrailingZeros) {
+            while ((vm % 10) == 0) {
+                vrIsTrailingZeros &= (0 == lastRemovedDigit);
+                lastRemovedDigit = int(vr % 10);
+                vr /= 10;
+                vp /= 10;
+                vm /= 10;
+                removed++;
+            }
+        }
+        if (vrIsTrailingZeros && (5 == lastRemovedDigit) && ((vr % 2) == 0)) {
+            lastRemovedDigit = 4;
+        }
+        output = vr + ((((vr == vm) && (!acceptBounds || !vmIsTrailingZeros)) || (lastRemovedDigit >= 5)) ? 1 : 0);
+    }
+    else {
+        while ((vp / 10) > (vm / 10)) {
+            lastRemovedDigit = int(vr % 10);
+            vr /= 10;
+            vp /= 10;
+            vm /= 10;
+            removed++;
+        }
+        output = vr + (((vr == vm) || (lastRemovedDigit >= 5)) ? 1 : 0);
+    }
+    outDecimal = output;
+    outExp10 = e10 + removed;
+}
+
+//------------------------------------------------------------------------------
+static int
+doubleToChars(double val, char* buf, int bufSize) {
+    uint64_t bits;
+    std::memcpy(&bits, &val, sizeof(bits));
+    const bool neg = (bits >> 63) != 0;
+    const uint64_t ieeeMantissa = bits & ((uint64_t(1) << 52) - 1);
+    const uint32_t ieeeExponent = uint32_t((bits >> 52) & 0x7FF);
+    if ((0x7FF == ieeeExponent) || ((0 == ieeeExponent) && (0 == ieeeMantissa))) {
+        return formatSpecial(neg, 0 == ieeeExponent, 0 != ieeeMantissa, buf, bufSize);
+    }
+    uint64_t decimal;
+    int exp10;
+    ryuDouble(ieeeMantissa, ieeeExponent, decimal, exp10);
+    return formatDecimal(neg, decimal, exp10, buf, bufSize);
+}
+
+//------------------------------------------------------------------------------
+static int
+floatToChars(float val, char* buf, int bufSize) {
+    uint32_t bits;
+    std::memcpy(&bits, &val, sizeof(bits));
+    const bool neg = (bits >> 31) != 0;
+    const uint32_t ieeeMantissa = bits & ((uint32_t(1) << 23) - 1);
+    const uint32_t ieeeExponent = (bits >> 23) & 0xFF;
+    if ((0xFF == ieeeExponent) || ((0 == ieeeExponent) && (0 == ieeeMantissa))) {
+        return formatSpecial(neg, 0 == ieeeExponent, 0 != ieeeMantissa, buf, bufSize);
+    }
+    uint32_t decimal;
+    int exp10;
+    ryuFloat(ieeeMantissa, ieeeExponent, decimal, exp10);
+    return formatDecimal(neg, decimal, exp10, buf, bufSize);
+}
+
+//------------------------------------------------------------------------------
+#define _NUMBER_CONVERSION(TYPE, parseFunc, toCharsFunc) \
+template<> int \
+StringConverter::ParseNumber(const char* str, int numBytes, TYPE& outValue) { \
+    return parseFunc(str, numBytes, outValue); \
+} \
+template<> int \
+StringConverter::ToChars(TYPE val, char* buf, int bufSize) { \
+    return toCharsFunc(val, buf, bufSize); \
+}
+
+_NUMBER_CONVERSION(int8_t, parseInt, intToChars)
+_NUMBER_CONVERSION(uint8_t, parseInt, intToChars)
+_NUMBER_CONVERSION(int16_t, parseInt, intToChars)
+_NUMBER_CONVERSION(uint16_t, parseInt, intToChars)
+_NUMBER_CONVERSION(int, parseInt, intToChars)
+_NUMBER_CONVERSION(uint32_t, parseInt, intToChars)
+_NUMBER_CONVERSION(int64_t, parseInt, intToChars)
+_NUMBER_CONVERSION(uint64_t, parseInt, intToChars)
+_NUMBER_CONVERSION(float, parseFloat, floatToChars)
+_NUMBER_CONVERSION(double, parseFloat, doubleToChars)
+
 } // namespace Oryol
@@ -8,12 +8,29 @@
     and from and to simple types (int, float, ...). Please note that
     wchar_t is 2 bytes (UTF-16) on Windows, but 4 bytes (UTF-32) 
     on other UNIX-like platforms!
+
+    UTF-8 input is validated 16 bytes at a time with SSSE3 or NEON where
+    available (overlong forms, surrogates and code points above 0x10FFFF
+    are rejected), and runs of ASCII characters are converted 16 at a
+    time, which is the common case for file paths, URLs and text input.
+
+    Number conversion doesn't depend on the C locale (the decimal point
+    is always '.'). Parsing scans 8 digits at a time, and float/double
+    values are parsed with correct rounding (an exact fast path covers
+    the usual cases, only very long or very large/small numbers fall back
+    to the C runtime). Formatting float/double values produces the shortest
+    string which parses back to the identical value (Ryu algorithm), in the
+    same notation as JavaScript's Number.toString() (e.g. "0.1", "1e+21").
+
+    Supported number types are int8_t, uint8_t, int16_t, uint16_t, int,
+    uint32_t, int64_t, uint64_t, float and double.
 */
 #include "Core/Types.h"
 #include "Core/Containers/Array.h"
 #include "Core/String/String.h"
 #include "Core/String/StringAtom.h"
 #include "Core/String/WideString.h"
+#include <cstring>
 
 namespace Oryol {
     
@@ -25,8 +42,19 @@ public:
     template<class TYPE> static TYPE FromString(const String& str);
     /// convert a string to simple type
     template<class TYPE> static TYPE FromString(const StringAtom& str);
-    // (NOTE: 'ToString' methods should go into StringBuilder as Append<TYPE>()
+    /// convert a string to simple type with error check, the whole string (except whitespace) must be a number
+    template<class TYPE> static bool FromString(const char* str, TYPE& outValue);
+    /// parse a number from the start of a string range, return number of consumed chars, or 0 on error
+    template<class TYPE> static int ParseNumber(const char* str, int numBytes, TYPE& outValue);
+    /// write number as string into buffer (with terminating 0), return length without the 0, or 0 on error
+    template<class TYPE> static int ToChars(TYPE val, char* buf, int bufSize);
+    /// convert number to string object
+    template<class TYPE> static String ToString(TYPE val);
+    /// buffer size which is big enough for ToChars() with any number type
+    static const int MaxNumberChars = 32;
     
+    /// return true if a raw byte range is valid UTF-8
+    static bool ValidateUTF8(const unsigned char* src, int srcNumBytes);
     /// convert raw UTF8 string range to raw wide string
     static int UTF8ToWide(const unsigned char* src, int srcNumBytes, wchar_t* dst, int dstMaxBytes);
     /// convert raw wide string range to raw UTF8 string
@@ -45,10 +73,46 @@ public:
     static WideString UTF8ToWide(const String& src);
 
 private:
+    /// skip whitespace at start of string
+    static const char* skipWhitespace(const char* str);
+
     static const int MaxInternalBufferWChars = 128;
     static const int MaxUTF8Size = 6;
 };
 
+//------------------------------------------------------------------------------
+inline const char*
+StringConverter::skipWhitespace(const char* str) {
+    while ((' ' == *str) || (('\t' <= *str) && (*str <= '\r'))) {
+        str++;
+    }
+    return str;
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE> inline TYPE
+StringConverter::FromString(const char* str) {
+    o_assert_dbg(str);
+    str = skipWhitespace(str);
+    TYPE val = TYPE(0);
+    ParseNumber<TYPE>(str, int(std::strlen(str)), val);
+    return val;
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE> inline bool
+StringConverter::FromString(const char* str, TYPE& outValue) {
+    o_assert_dbg(str);
+    str = skipWhitespace(str);
+    TYPE val = TYPE(0);
+    const int len = ParseNumber<TYPE>(str, int(std::strlen(str)), val);
+    if ((0 == len) || (0 != *skipWhitespace(str + len))) {
+        return false;
+    }
+    outValue = val;
+    return true;
+}
+
 //------------------------------------------------------------------------------
 template<class TYPE> inline TYPE
 StringConverter::FromString(const String& str) {
@@ -61,4 +125,12 @@ StringConverter::FromString(const StringAtom& str) {
     return FromString<TYPE>(str.AsCStr());
 }
 
+//------------------------------------------------------------------------------
+template<class TYPE> inline String
+StringConverter::ToString(TYPE val) {
+    char buf[MaxNumberChars];
+    const int len = ToChars<TYPE>(val, buf, sizeof(buf));
+    return len > 0 ? String(buf, 0, len) : String();
+}
+
 } // namespace Oryol
@@ -0,0 +1,158 @@
+#pragma once
+//------------------------------------------------------------------------------
+/**
+    @class Oryol::StringView
+    @ingroup Core
+    @brief a non-owning reference to a range of characters
+
+    A StringView is a pointer and a length into string data which is owned
+    by someone else (for instance a StringAtom, which has static lifetime).
+    Creating, copying and comparing StringViews never allocates memory.
+    Note that the referenced characters are not zero-terminated, use
+    AsString() to get a zero-terminated copy.
+
+    @see String, StringAtom
+*/
+#include "Core/Types.h"
+#include "Core/Assertion.h"
+#include "Core/String/String.h"
+#include <cstring>
+
+namespace Oryol {
+
+class StringView {
+public:
+    /// default constructor, creates an empty view
+    StringView();
+    /// construct from pointer and length
+    StringView(const char* ptr, int len);
+    /// construct from zero-terminated string
+    StringView(const char* cstr);
+
+    /// equality with other view
+    bool operator==(const StringView& rhs) const;
+    /// inequality with other view
+    bool operator!=(const StringView& rhs) const;
+    /// equality with zero-terminated string
+    bool operator==(const char* rhs) const;
+    /// inequality with zero-terminated string
+    bool operator!=(const char* rhs) const;
+    /// read-only access to character at index
+    char operator[](int index) const;
+
+    /// return true if the view is empty
+    bool Empty() const;
+    /// get number of characters
+    int Length() const;
+    /// get pointer to first character (not zero-terminated!)
+    const char* Ptr() const;
+    /// create a String object from the view (may allocate)
+    String AsString() const;
+
+    /// C++ begin
+    const char* begin() const;
+    /// C++ end
+    const char* end() const;
+
+private:
+    const char* ptr = nullptr;
+    int len = 0;
+};
+
+//------------------------------------------------------------------------------
+inline
+StringView::StringView() {
+    // empty
+}
+
+//------------------------------------------------------------------------------
+inline
+StringView::StringView(const char* ptr_, int len_) :
+ptr(ptr_),
+len(len_) {
+    o_assert_dbg(len_ >= 0);
+    o_assert_dbg((nullptr != ptr_) || (0 == len_));
+}
+
+//------------------------------------------------------------------------------
+inline
+StringView::StringView(const char* cstr) :
+ptr(cstr),
+len(cstr ? int(std::strlen(cstr)) : 0) {
+    // empty
+}
+
+//------------------------------------------------------------------------------
+inline bool
+StringView::operator==(const StringView& rhs) const {
+    return (this->len == rhs.len) &&
+           ((this->ptr == rhs.ptr) || (0 == this->len) || (0 == std::memcmp(this->ptr, rhs.ptr, this->len)));
+}
+
+//------------------------------------------------------------------------------
+inline bool
+StringView::operator!=(const StringView& rhs) const {
+    return !this->operator==(rhs);
+}
+
+//------------------------------------------------------------------------------
+inline bool
+StringView::operator==(const char* rhs) const {
+    return this->operator==(StringView(rhs));
+}
+
+//------------------------------------------------------------------------------
+inline bool
+StringView::operator!=(const char* rhs) const {
+    return !this->operator==(rhs);
+}
+
+//------------------------------------------------------------------------------
+inline char
+StringView::operator[](int index) const {
+    o_assert_range_dbg(index, this->len);
+    return this->ptr[index];
+}
+
+//------------------------------------------------------------------------------
+inline bool
+StringView::Empty() const {
+    return 0 == this->len;
+}
+
+//------------------------------------------------------------------------------
+inline int
+StringView::Length() const {
+    return this->len;
+}
+
+//------------------------------------------------------------------------------
+inline const char*
+StringView::Ptr() const {
+    return this->ptr;
+}
+
+//------------------------------------------------------------------------------
+inline String
+StringView::AsString() const {
+    if (this->len > 0) {
+        return String(this->ptr, 0, this->len);
+    }
+    else {
+        return String();
+    }
+}
+
+//------------------------------------------------------------------------------
+inline const char*
+StringView::begin() const {
+    return this->ptr;
+}
+
+//------------------------------------------------------------------------------
+inline const char*
+StringView::end() const {
+    return this->ptr + this->len;
+}
+
+} // namespace Oryol
@@ -3,73 +3,160 @@
 //------------------------------------------------------------------------------
 #include "Pre.h"
 #include <cstring>
+#include <new>
 #include "stringAtomTable.h"
+#include "Core/Memory/Memory.h"
+#include "Core/Assertion.h"
 #if ORYOL_USE_VLD
 #include "vld.h"
 #endif
 
-namespace Oryol {
+#if ORYOL_HAS_THREADS
+#define SCOPED_LOCK(s) std::lock_guard<std::mutex> lock(s.lock)
+#else
+#define SCOPED_LOCK(s)
+#endif
 
-ORYOL_THREADLOCAL_PTR(stringAtomTable) stringAtomTable::ptr = nullptr;
+namespace Oryol {
 
 //------------------------------------------------------------------------------
 stringAtomTable*
-stringAtomTable::threadLocalPtr() {
-    // NOTE: this object can never be released, even if a thread is left
-    // since StringAtom object can move to other threads, thus memory
-    // leak detectors will complain about these allocations on program
-    // exit
-    if (!ptr) {
+stringAtomTable::globalPtr() {
+    // NOTE: this object is never released, since StringAtoms may still
+    // exist in static objects on program exit, thus memory leak
+    // detectors will complain about these allocations
+    // (initialization of function-local statics is thread-safe)
+    static stringAtomTable* ptr = [] {
         #if ORYOL_USE_VLD
         VLDDisable();
         #endif
-        ptr = Memory::New<stringAtomTable>();
+        stringAtomTable* table = Memory::New<stringAtomTable>();
         #if ORYOL_USE_VLD
         VLDEnable();
         #endif
-    }
+        return table;
+    }();
     return ptr;
 }
 
+//------------------------------------------------------------------------------
+int
+stringAtomTable::shardIndex(int32_t hash) {
+    return int(uint32_t(hash) & (NumShards - 1));
+}
+
+//------------------------------------------------------------------------------
+uint32_t
+stringAtomTable::slotIndex(int32_t hash, int numSlots) {
+    // the lower bits have been used to select the shard
+    return (uint32_t(hash) >> ShardBits) & uint32_t(numSlots - 1);
+}
+
+//------------------------------------------------------------------------------
+stringAtomTable::slotArray*
+stringAtomTable::allocSlots(int numSlots) {
+    o_assert_dbg((numSlots & (numSlots - 1)) == 0);
+    slotArray* array = Memory::New<slotArray>();
+    array->numSlots = numSlots;
+    array->slots = (std::atomic<const stringAtomBuffer::Header*>*)
+        Memory::Alloc(numSlots * sizeof(std::atomic<const stringAtomBuffer::Header*>));
+    for (int i = 0; i < numSlots; i++) {
+        new(&array->slots[i]) std::atomic<const stringAtomBuffer::Header*>(nullptr);
+    }
+    return array;
+}
+
+//------------------------------------------------------------------------------
+const stringAtomBuffer::Header*
+stringAtomTable::find(const slotArray* array, int32_t hash, const char* str) {
+    const uint32_t mask = uint32_t(array->numSlots - 1);
+    uint32_t i = slotIndex(hash, array->numSlots);
+    for (;;) {
+        const stringAtomBuffer::Header* head = array->slots[i].load(std::memory_order_acquire);
+        if (nullptr == head) {
+            return nullptr;
+        }
+        if ((head->hash == hash) && (0 == std::strcmp(head->str, str))) {
+            return head;
+        }
+        i = (i + 1) & mask;
+    }
+}
+
+//------------------------------------------------------------------------------
+void
+stringAtomTable::insert(slotArray* array, const stringAtomBuffer::Header* header) {
+    const uint32_t mask = uint32_t(array->numSlots - 1);
+    uint32_t i = slotIndex(header->hash, array->numSlots);
+    while (nullptr != array->slots[i].load(std::memory_order_relaxed)) {
+        i = (i + 1) & mask;
+    }
+    array->slots[i].store(header, std::memory_order_release);
+}
+
 //------------------------------------------------------------------------------
 const stringAtomBuffer::Header*
 stringAtomTable::Find(int32_t hash, const char* str) const {
-    
-    // need to create a temp object for searching in the set
-    stringAtomBuffer::Header dummyHead(this, hash, 0, str);
-    Entry dummyEntry(&dummyHead);
-    auto ptr = this->table.Find(dummyEntry);
-    if (nullptr == ptr) {
+    const shard& s = this->shards[shardIndex(hash)];
+    const slotArray* array = s.curSlots.load(std::memory_order_acquire);
+    if (nullptr == array) {
         return nullptr;
     }
-    else {
-        o_assert(nullptr != ptr->header);
-        return ptr->header;
-    }
+    return find(array, hash, str);
 }
 
 //------------------------------------------------------------------------------
 const stringAtomBuffer::Header*
-stringAtomTable::Add(int32_t hash, const char* str) {
-    
-    #if ORYOL_DEBUG
-    o_assert(nullptr == this->Find(hash, str));
-    #endif    
+stringAtomTable::FindOrAdd(int32_t hash, const char* str) {
+
+    // fast path without locking
+    const stringAtomBuffer::Header* head = this->Find(hash, str);
+    if (head) {
+        return head;
+    }
+
+    shard& s = this->shards[shardIndex(hash)];
+    SCOPED_LOCK(s);
+
+    // another thread might have added the string in the meantime
+    slotArray* array = s.curSlots.load(std::memory_order_relaxed);
+    if (array) {
+        head = find(array, hash, str);
+        if (head) {
+            return head;
+        }
+    }
     #if ORYOL_USE_VLD
     VLDDisable();
     #endif
 
-    // add new string to the string buffer
-    const stringAtomBuffer::Header* newHeader = this->buffer.AddString(this, hash, str);
-    o_assert(nullptr != newHeader);
-    
-    // add new entry to our lookup table
-    this->table.Add(Entry(newHeader));
+    // grow the slot array to keep the load factor at or below 1/2,
+    // the new array must be complete before it is published
+    if ((nullptr == array) || (((s.numEntries + 1) * 2) > array->numSlots)) {
+        slotArray* newArray = allocSlots(array ? array->numSlots * 2 : InitialNumSlots);
+        if (array) {
+            for (int i = 0; i < array->numSlots; i++) {
+                const stringAtomBuffer::Header* oldHead = array->slots[i].load(std::memory_order_relaxed);
+                if (oldHead) {
+                    insert(newArray, oldHead);
+                }
+            }
+            s.retiredSlots.Add(array);
+        }
+        s.curSlots.store(newArray, std::memory_order_release);
+        array = newArray;
+    }
+
+    // add new string to the shard's string buffer and publish it
+    head = s.buffer.AddString(hash, str);
+    o_assert(nullptr != head);
+    insert(array, head);
+    s.numEntries++;
 
     #if ORYOL_USE_VLD
     VLDEnable();
     #endif
-    return newHeader;
+    return head;
 }
 
 //------------------------------------------------------------------------------
@@ -92,38 +179,4 @@ stringAtomTable::HashForString(const char* str) {
     return h;
 }
 
-//------------------------------------------------------------------------------
-bool
-stringAtomTable::Entry::operator==(const Entry& rhs) const {
-
-    #if ORYOL_DEBUG
-    o_assert(this->header != 0 && rhs.header != 0);
-    o_assert(this->header->hash != 0 && rhs.header->hash != 0);
-    o_assert(this->header->str != 0 && rhs.header->str != 0);
-    #endif
-    
-    if (this->header->hash != rhs.header->hash) {
-        // if hashes differ, the entries are definitely not equal
-        return false;
-    }
-    else {
-        // if hashes are identical, need to do a strcmp
-        return (0 == std::strcmp(this->header->str, rhs.header->str));
-    }
-}
-
-//------------------------------------------------------------------------------
-bool
-stringAtomTable::Entry::operator<(const Entry& rhs) const {
-        
-    #if ORYOL_DEBUG
-    o_assert(this->header != 0 && rhs.header != 0);
-    o_assert(this->header->hash != 0 && rhs.header->hash != 0);
-    o_assert(this->header->str != 0 && rhs.header->str != 0);
-    #endif
-    return std::strcmp(this->header->str, rhs.header->str) < 0;
-}
-
 } // namespace Oryol
-
-
@@ -2,51 +2,76 @@
 //------------------------------------------------------------------------------
 /*
     private class, do not use
-    
-    A thread-local StringAtom table.
+
+    The global StringAtom table, shared by all threads.
+
+    The table is split into shards (selected by the lower bits of the
+    string hash). Each shard has its own string buffer and an open
+    addressing hash table of header pointers. Lookups don't take a lock:
+    the current slot array and the slots themselves are read with acquire
+    semantics, and a slot is only published with a release-store after
+    the string data has been written. Adding a new string locks only
+    the shard's mutex. When a shard's slot array grows, the new array is
+    filled completely before it is published, the old array is kept
+    alive since other threads may still be probing it.
 */
 #include "Core/Types.h"
 #include "Core/String/stringAtomBuffer.h"
-#include "Core/Containers/HashSet.h"
-#include "Core/Threading/ThreadLocalPtr.h"
+#include "Core/Containers/Array.h"
+#include <atomic>
+#if ORYOL_HAS_THREADS
+#include <mutex>
+#endif
 
 namespace Oryol {
 
 class stringAtomTable {
 public:
-    /// access to thread-local stringAtomTable (created on demand)
-    static stringAtomTable* threadLocalPtr();
+    /// access to the global stringAtomTable (created on demand)
+    static stringAtomTable* globalPtr();
     /// compute hash value for string
     static int32_t HashForString(const char* str);
-    /// find a matching buffer header in the table
+    /// find a matching buffer header in the table (lock-free)
     const stringAtomBuffer::Header* Find(int32_t hash, const char* str) const;
-    /// add a string to the atom table
-    const stringAtomBuffer::Header* Add(int32_t hash, const char* str);
-    
-    static ORYOL_THREADLOCAL_PTR(stringAtomTable) ptr;
-
-    /// a bucket entry
-    struct Entry {
-        /// default constructor
-        Entry() : header(0) { };
-        /// constructor with header ptr
-        Entry(const stringAtomBuffer::Header* h) : header(h) { };
-        /// equality operator
-        bool operator==(const Entry& rhs) const;
-        /// less-then operator
-        bool operator<(const Entry& rhs) const;
-        
-        const stringAtomBuffer::Header* header;
+    /// find a matching buffer header, or add the string to the table
+    const stringAtomBuffer::Header* FindOrAdd(int32_t hash, const char* str);
+
+    /// number of shards
+    static const int ShardBits = 4;
+    static const int NumShards = 1<<ShardBits;
+    /// initial number of slots per shard, must be 2^N
+    static const int InitialNumSlots = 64;
+
+    /// an open-addressing slot array
+    struct slotArray {
+        int numSlots = 0;
+        std::atomic<const stringAtomBuffer::Header*>* slots = nullptr;
     };
-    
-    /// hash function for bucket entry
-    struct Hasher {
-        int32_t operator()(const Entry& e) const {
-            return e.header->hash;
-        };
+    /// a table shard
+    struct shard {
+        #if ORYOL_HAS_THREADS
+        std::mutex lock;
+        #endif
+        std::atomic<slotArray*> curSlots{nullptr};
+        int numEntries = 0;
+        stringAtomBuffer buffer;
+        /// grown-out-of slot arrays which may still be read by other threads
+        Array<slotArray*> retiredSlots;
     };
-    stringAtomBuffer buffer;
-    HashSet<Entry, Hasher, 1024> table;
+
+private:
+    /// find header in a slot array
+    static const stringAtomBuffer::Header* find(const slotArray* array, int32_t hash, const char* str);
+    /// insert header into a slot array, the array must have a free slot
+    static void insert(slotArray* array, const stringAtomBuffer::Header* header);
+    /// allocate a new slot array
+    static slotArray* allocSlots(int numSlots);
+    /// get shard index from hash
+    static int shardIndex(int32_t hash);
+    /// get start slot index from hash
+    static uint32_t slotIndex(int32_t hash, int numSlots);
+
+    shard shards[NumShards];
 };
 
 } // namespace Oryol
@@ -0,0 +1,565 @@
+//------------------------------------------------------------------------------
+//  utf8Codec.cc
+//------------------------------------------------------------------------------
+#include "Pre.h"
+#include "utf8Codec.h"
+#include "Core/Assertion.h"
+#include <cstring>
+
+#if ORYOL_HAS_SSE2
+#include <emmintrin.h>
+#include <tmmintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#define ORYOL_UTF8_SSSE3_FUNC
+#else
+#define ORYOL_UTF8_SSSE3_FUNC __attribute__((target("ssse3")))
+#endif
+#elif ORYOL_HAS_NEON
+#include <arm_neon.h>
+#endif
+
+namespace Oryol {
+
+//------------------------------------------------------------------------------
+//  Lookup tables for the SIMD validator. Each table maps a nibble to the set
+//  of errors which are possible for that nibble, an error is detected if
+//  the same bit is set in all 3 lookups (high and low nibble of the
+//  previous byte, high nibble of the current byte).
+//------------------------------------------------------------------------------
+static const uint8_t TooShort = 1<<0;     // 11______ 0_______ / 11______ 11______
+static const uint8_t TooLong = 1<<1;      // 0_______ 10______
+static const uint8_t Overlong3 = 1<<2;    // 11100000 100_____
+static const uint8_t TooLarge = 1<<3;     // 11110100 1001____ and larger
+static const uint8_t Surrogate = 1<<4;    // 11101101 101_____
+static const uint8_t Overlong2 = 1<<5;    // 1100000_ 10______
+static const uint8_t TooLarge1000 = 1<<6; // 11110101 1000____ and larger
+static const uint8_t Overlong4 = 1<<6;    // 11110000 1000____
+static const uint8_t TwoConts = 1<<7;     // 10______ 10______
+static const uint8_t Carry = TooShort | TooLong | TwoConts;
+
+#if ORYOL_HAS_SSE2 || ORYOL_HAS_NEON
+static const uint8_t byte1HighTable[16] = {
+    // 0_______ ________ <ASCII in byte 1>
+    TooLong, TooLong, TooLong, TooLong, TooLong, TooLong, TooLong, TooLong,
+    // 10______ ________ <continuation in byte 1>
+    TwoConts, TwoConts, TwoConts, TwoConts,
+    // 1100____ ________ <two byte lead in byte 1>
+    TooShort | Overlong2,
+    // 1101____ ________ <two byte lead in byte 1>
+    TooShort,
+    // 1110____ ________ <three byte lead in byte 1>
+    TooShort | Overlong3 | Surrogate,
+    // 1111____ ________ <four+ byte lead in byte 1>
+    TooShort | TooLarge | TooLarge1000 | Overlong4
+};
+static const uint8_t byte1LowTable[16] = {
+    // ____0000 ________
+    Carry | Overlong3 | Overlong2 | Overlong4,
+    // ____0001 ________
+    Carry | Overlong2,
+    // ____001_ ________
+    Carry,
+    Carry,
+    // ____0100 ________
+    Carry | TooLarge,
+    // ____0101 ________
+    Carry | TooLarge | TooLarge1000,
+    // ____011_ ________
+    Carry | TooLarge | TooLarge1000,
+    Carry | TooLarge | TooLarge1000,
+    // ____1___ ________
+    Carry | TooLarge | TooLarge1000,
+    Carry | TooLarge | TooLarge1000,
+    Carry | TooLarge | TooLarge1000,
+    Carry | TooLarge | TooLarge1000,
+    Carry | TooLarge | TooLarge1000,
+    // ____1101 ________
+    Carry | TooLarge | TooLarge1000 | Surrogate,
+    Carry | TooLarge | TooLarge1000,
+    Carry | TooLarge | TooLarge1000
+};
+static const uint8_t byte2HighTable[16] = {
+    // ________ 0_______ <ASCII in byte 2>
+    TooShort, TooShort, TooShort, TooShort, TooShort, TooShort, TooShort, TooShort,
+    // ________ 1000____
+    TooLong | Overlong2 | TwoConts | Overlong3 | TooLarge1000 | Overlong4,
+    // ________ 1001____
+    TooLong | Overlong2 | TwoConts | Overlong3 | TooLarge,
+    // ________ 101_____
+    TooLong | Overlong2 | TwoConts | Surrogate | TooLarge,
+    TooLong | Overlong2 | TwoConts | Surrogate | TooLarge,
+    // ________ 11______ <lead byte in byte 2>
+    TooShort, TooShort, TooShort, TooShort
+};
+/// a block is incomplete if one of the last 3 bytes starts a sequence which continues in the next block
+static const uint8_t maxComplete[16] = {
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xF0 - 1, 0xE0 - 1, 0xC0 - 1
+};
+#endif
+
+//------------------------------------------------------------------------------
+//  SSE code paths
+//------------------------------------------------------------------------------
+#if ORYOL_HAS_SSE2
+static bool
+cpuHasSSSE3() {
+    #if defined(__SSSE3__)
+    return true;
+    #elif defined(_MSC_VER)
+    int info[4];
+    __cpuid(info, 1);
+    return 0 != (info[2] & (1<<9));
+    #else
+    return __builtin_cpu_supports("ssse3");
+    #endif
+}
+
+//------------------------------------------------------------------------------
+ORYOL_UTF8_SSSE3_FUNC static inline __m128i
+checkUTF8Block(__m128i input, __m128i prevInput) {
+    const __m128i nibbleMask = _mm_set1_epi8(0x0F);
+    const __m128i prev1 = _mm_alignr_epi8(input, prevInput, 15);
+    const __m128i byte1High = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)byte1HighTable),
+        _mm_and_si128(_mm_srli_epi16(prev1, 4), nibbleMask));
+    const __m128i byte1Low = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)byte1LowTable),
+        _mm_and_si128(prev1, nibbleMask));
+    const __m128i byte2High = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)byte2HighTable),
+        _mm_and_si128(_mm_srli_epi16(input, 4), nibbleMask));
+    const __m128i specialCases = _mm_and_si128(_mm_and_si128(byte1High, byte1Low), byte2High);
+
+    // 3rd and 4th bytes of a sequence must be continuations, this is where the
+    // 2-byte lookup above reports a false TwoConts error which is flipped back here
+    const __m128i prev2 = _mm_alignr_epi8(input, prevInput, 14);
+    const __m128i prev3 = _mm_alignr_epi8(input, prevInput, 13);
+    const __m128i isThirdByte = _mm_subs_epu8(prev2, _mm_set1_epi8(char(0xE0 - 0x80)));
+    const __m128i isFourthByte = _mm_subs_epu8(prev3, _mm_set1_epi8(char(0xF0 - 0x80)));
+    const __m128i must23 = _mm_and_si128(_mm_or_si128(isThirdByte, isFourthByte), _mm_set1_epi8(char(0x80)));
+    return _mm_xor_si128(must23, specialCases);
+}
+
+//------------------------------------------------------------------------------
+ORYOL_UTF8_SSSE3_FUNC static bool
+validateSSSE3(const unsigned char* src, int numBytes) {
+    const __m128i maxCompleteVec = _mm_loadu_si128((const __m128i*)maxComplete);
+    __m128i error = _mm_setzero_si128();
+    __m128i prevInput = _mm_setzero_si128();
+    __m128i prevIncomplete = _mm_setzero_si128();
+    int i = 0;
+    for (;;) {
+        __m128i input;
+        if ((i + 16) <= numBytes) {
+            input = _mm_loadu_si128((const __m128i*)(src + i));
+        }
+        else if (i < numBytes) {
+            // zero-padded tail
+            unsigned char tail[16] = { };
+            std::memcpy(tail, src + i, numBytes - i);
+            input = _mm_loadu_si128((const __m128i*)tail);
+        }
+        else {
+            break;
+        }
+        if (0 == _mm_movemask_epi8(input)) {
+            // all ASCII, only need to check that the previous block was complete
+            error = _mm_or_si128(error, prevIncomplete);
+            prevIncomplete = _mm_setzero_si128();
+        }
+        else {
+            error = _mm_or_si128(error, checkUTF8Block(input, prevInput));
+            prevIncomplete = _mm_subs_epu8(input, maxCompleteVec);
+        }
+        prevInput = input;
+        i += 16;
+    }
+    error = _mm_or_si128(error, prevIncomplete);
+    return 0xFFFF == _mm_movemask_epi8(_mm_cmpeq_epi8(error, _mm_setzero_si128()));
+}
+
+//------------------------------------------------------------------------------
+static inline bool
+isAscii16(const unsigned char* src) {
+    return 0 == _mm_movemask_epi8(_mm_loadu_si128((const __m128i*)src));
+}
+
+//------------------------------------------------------------------------------
+static inline void
+widenAscii16(const unsigned char* src, wchar_t* dst) {
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i bytes = _mm_loadu_si128((const __m128i*)src);
+    const __m128i lo16 = _mm_unpacklo_epi8(bytes, zero);
+    const __m128i hi16 = _mm_unpackhi_epi8(bytes, zero);
+    if (sizeof(wchar_t) == 2) {
+        _mm_storeu_si128((__m128i*)dst, lo16);
+        _mm_storeu_si128((__m128i*)(dst + 8), hi16);
+    }
+    else {
+        _mm_storeu_si128((__m128i*)dst, _mm_unpacklo_epi16(lo16, zero));
+        _mm_storeu_si128((__m128i*)(dst + 4), _mm_unpackhi_epi16(lo16, zero));
+        _mm_storeu_si128((__m128i*)(dst + 8), _mm_unpacklo_epi16(hi16, zero));
+        _mm_storeu_si128((__m128i*)(dst + 12), _mm_unpackhi_epi16(hi16, zero));
+    }
+}
+
+//------------------------------------------------------------------------------
+/// narrow 16 wide chars to bytes if they are all ASCII
+static inline bool
+narrowAscii16(const wchar_t* src, unsigned char* dst) {
+    const __m128i zero = _mm_setzero_si128();
+    if (sizeof(wchar_t) == 2) {
+        const __m128i a = _mm_loadu_si128((const __m128i*)src);
+        const __m128i b = _mm_loadu_si128((const __m128i*)(src + 8));
+        const __m128i nonAscii = _mm_and_si128(_mm_or_si128(a, b), _mm_set1_epi16(short(0xFF80)));
+        if (0xFFFF != _mm_movemask_epi8(_mm_cmpeq_epi8(nonAscii, zero))) {
+            return false;
+        }
+        _mm_storeu_si128((__m128i*)dst, _mm_packus_epi16(a, b));
+    }
+    else {
+        const __m128i a = _mm_loadu_si128((const __m128i*)src);
+        const __m128i b = _mm_loadu_si128((const __m128i*)(src + 4));
+        const __m128i c = _mm_loadu_si128((const __m128i*)(src + 8));
+        const __m128i d = _mm_loadu_si128((const __m128i*)(src + 12));
+        const __m128i all = _mm_or_si128(_mm_or_si128(a, b), _mm_or_si128(c, d));
+        const __m128i nonAscii = _mm_and_si128(all, _mm_set1_epi32(int(0xFFFFFF80)));
+        if (0xFFFF != _mm_movemask_epi8(_mm_cmpeq_epi8(nonAscii, zero))) {
+            return false;
+        }
+        const __m128i ab = _mm_packs_epi32(a, b);
+        const __m128i cd = _mm_packs_epi32(c, d);
+        _mm_storeu_si128((__m128i*)dst, _mm_packus_epi16(ab, cd));
+    }
+    return true;
+}
+#endif
+
+//------------------------------------------------------------------------------
+//  NEON code paths
+//------------------------------------------------------------------------------
+#if ORYOL_HAS_NEON
+static inline uint8x16_t
+checkUTF8Block(uint8x16_t input, uint8x16_t prevInput) {
+    const uint8x16_t nibbleMask = vdupq_n_u8(0x0F);
+    const uint8x16_t prev1 = vextq_u8(prevInput, input, 15);
+    const uint8x16_t byte1High = vqtbl1q_u8(vld1q_u8(byte1HighTable), vshrq_n_u8(prev1, 4));
+    const uint8x16_t byte1Low = vqtbl1q_u8(vld1q_u8(byte1LowTable), vandq_u8(prev1, nibbleMask));
+    const uint8x16_t byte2High = vqtbl1q_u8(vld1q_u8(byte2HighTable), vshrq_n_u8(input, 4));
+    const uint8x16_t specialCases = vandq_u8(vandq_u8(byte1High, byte1Low), byte2High);
+
+    const uint8x16_t prev2 = vextq_u8(prevInput, input, 14);
+    const uint8x16_t prev3 = vextq_u8(prevInput, input, 13);
+    const uint8x16_t isThirdByte = vqsubq_u8(prev2, vdupq_n_u8(0xE0 - 0x80));
+    const uint8x16_t isFourthByte = vqsubq_u8(prev3, vdupq_n_u8(0xF0 - 0x80));
+    const uint8x16_t must23 = vandq_u8(vorrq_u8(isThirdByte, isFourthByte), vdupq_n_u8(0x80));
+    return veorq_u8(must23, specialCases);
+}
+
+//------------------------------------------------------------------------------
+static bool
+validateNEON(const unsigned char* src, int numBytes) {
+    const uint8x16_t maxCompleteVec = vld1q_u8(maxComplete);
+    uint8x16_t error = vdupq_n_u8(0);
+    uint8x16_t prevInput = vdupq_n_u8(0);
+    uint8x16_t prevIncomplete = vdupq_n_u8(0);
+    int i = 0;
+    for (;;) {
+        uint8x16_t input;
+        if ((i + 16) <= numBytes) {
+            input = vld1q_u8(src + i);
+        }
+        else if (i < numBytes) {
+            unsigned char tail[16] = { };
+            std::memcpy(tail, src + i, numBytes - i);
+            input = vld1q_u8(tail);
+        }
+        else {
+            break;
+        }
+        if (vmaxvq_u8(input) < 0x80) {
+            error = vorrq_u8(error, prevIncomplete);
+            prevIncomplete = vdupq_n_u8(0);
+        }
+        else {
+            error = vorrq_u8(error, checkUTF8Block(input, prevInput));
+            prevIncomplete = vqsubq_u8(input, maxCompleteVec);
+        }
+        prevInput = input;
+        i += 16;
+    }
+    error = vorrq_u8(error, prevIncomplete);
+    return 0 == vmaxvq_u8(error);
+}
+
+//------------------------------------------------------------------------------
+static inline bool
+isAscii16(const unsigned char* src) {
+    return vmaxvq_u8(vld1q_u8(src)) < 0x80;
+}
+
+//------------------------------------------------------------------------------
+static inline void
+widenAscii16(const unsigned char* src, wchar_t* dst) {
+    const uint8x16_t bytes = vld1q_u8(src);
+    const uint16x8_t lo16 = vmovl_u8(vget_low_u8(bytes));
+    const uint16x8_t hi16 = vmovl_u8(vget_high_u8(bytes));
+    if (sizeof(wchar_t) == 2) {
+        vst1q_u16((uint16_t*)dst, lo16);
+        vst1q_u16((uint16_t*)(dst + 8), hi16);
+    }
+    else {
+        vst1q_u32((uint32_t*)dst, vmovl_u16(vget_low_u16(lo16)));
+        vst1q_u32((uint32_t*)(dst + 4), vmovl_u16(vget_high_u16(lo16)));
+        vst1q_u32((uint32_t*)(dst + 8), vmovl_u16(vget_low_u16(hi16)));
+        vst1q_u32((uint32_t*)(dst + 12), vmovl_u16(vget_high_u16(hi16)));
+    }
+}
+
+//------------------------------------------------------------------------------
+static inline bool
+narrowAscii16(const wchar_t* src, unsigned char* dst) {
+    if (sizeof(wchar_t) == 2) {
+        const uint16x8_t a = vld1q_u16((const uint16_t*)src);
+        const uint16x8_t b = vld1q_u16((const uint16_t*)(src + 8));
+        if (vmaxvq_u16(vorrq_u16(a, b)) >= 0x80) {
+            return false;
+        }
+        vst1q_u8(dst, vcombine_u8(vmovn_u16(a), vmovn_u16(b)));
+    }
+    else {
+        const uint32x4_t a = vld1q_u32((const uint32_t*)src);
+        const uint32x4_t b = vld1q_u32((const uint32_t*)(src + 4));
+        const uint32x4_t c = vld1q_u32((const uint32_t*)(src + 8));
+        const uint32x4_t d = vld1q_u32((const uint32_t*)(src + 12));
+        if (vmaxvq_u32(vorrq_u32(vorrq_u32(a, b), vorrq_u32(c, d))) >= 0x80) {
+            return false;
+        }
+        const uint16x8_t ab = vcombine_u16(vmovn_u32(a), vmovn_u32(b));
+        const uint16x8_t cd = vcombine_u16(vmovn_u32(c), vmovn_u32(d));
+        vst1q_u8(dst, vcombine_u8(vmovn_u16(ab), vmovn_u16(cd)));
+    }
+    return true;
+}
+#endif
+
+//------------------------------------------------------------------------------
+bool
+utf8Codec::HasSIMD() {
+    #if ORYOL_HAS_SSE2
+    static const bool hasSSSE3 = cpuHasSSSE3();
+    return hasSSSE3;
+    #elif ORYOL_HAS_NEON
+    return true;
+    #else
+    return false;
+    #endif
+}
+
+//------------------------------------------------------------------------------
+bool
+utf8Codec::ValidateScalar(const unsigned char* src, int numBytes) {
+    o_assert_dbg(src || (0 == numBytes));
+    int i = 0;
+    while (i < numBytes) {
+        // skip ASCII 8 bytes at a time
+        if ((i + 8) <= numBytes) {
+            uint64_t chunk;
+            std::memcpy(&chunk, src + i, sizeof(chunk));
+            if (0 == (chunk & 0x8080808080808080ull)) {
+                i += 8;
+                continue;
+            }
+        }
+        const unsigned char c = src[i];
+        if (c < 0x80) {
+            i++;
+        }
+        else if (c < 0xC2) {
+            // continuation byte without lead, or overlong 2-byte sequence
+            return false;
+        }
+        else if (c < 0xE0) {
+            if (((i + 1) >= numBytes) || ((src[i + 1] & 0xC0) != 0x80)) {
+                return false;
+            }
+            i += 2;
+        }
+        else if (c < 0xF0) {
+            if (((i + 2) >= numBytes) || ((src[i + 1] & 0xC0) != 0x80) || ((src[i + 2] & 0xC0) != 0x80)) {
+                return false;
+            }
+            // overlong and surrogates
+            if (((0xE0 == c) && (src[i + 1] < 0xA0)) || ((0xED == c) && (src[i + 1] >= 0xA0))) {
+                return false;
+            }
+            i += 3;
+        }
+        else if (c < 0xF5) {
+            if (((i + 3) >= numBytes) || ((src[i + 1] & 0xC0) != 0x80) ||
+                ((src[i + 2] & 0xC0) != 0x80) || ((src[i + 3] & 0xC0) != 0x80)) {
+                return false;
+            }
+            // overlong and > 0x10FFFF
+            if (((0xF0 == c) && (src[i + 1] < 0x90)) || ((0xF4 == c) && (src[i + 1] >= 0x90))) {
+                return false;
+            }
+            i += 4;
+        }
+        else {
+            return false;
+        }
+    }
+    return true;
+}
+
+//------------------------------------------------------------------------------
+bool
+utf8Codec::Validate(const unsigned char* src, int numBytes) {
+    o_assert_dbg(src || (0 == numBytes));
+    #if ORYOL_HAS_SSE2
+    if (HasSIMD()) {
+        return validateSSSE3(src, numBytes);
+    }
+    #elif ORYOL_HAS_NEON
+    return validateNEON(src, numBytes);
+    #endif
+    return ValidateScalar(src, numBytes);
+}
+
+//------------------------------------------------------------------------------
+int
+utf8Codec::UTF8ToWide(const unsigned char* src, int srcNumBytes, wchar_t* dst, int dstMaxChars) {
+    o_assert_dbg(src && dst);
+    if (!Validate(src, srcNumBytes)) {
+        return InvalidSource;
+    }
+    // the input is valid from here on, so the decoder doesn't need any checks
+    int i = 0;
+    int n = 0;
+    while (i < srcNumBytes) {
+        #if ORYOL_HAS_SSE2 || ORYOL_HAS_NEON
+        while (((i + 16) <= srcNumBytes) && (src[i + 15] < 0x80) && isAscii16(src + i)) {
+            if ((n + 16) > dstMaxChars) {
+                return TargetExhausted;
+            }
+            widenAscii16(src + i, dst + n);
+            i += 16;
+            n += 16;
+        }
+        if (i >= srcNumBytes) {
+            break;
+        }
+        #endif
+        // decode characters until the next ASCII character
+        do {
+            const unsigned char c = src[i];
+            uint32_t cp;
+            if (c < 0x80) {
+                cp = c;
+                i += 1;
+            }
+            else if (c < 0xE0) {
+                cp = (uint32_t(c & 0x1F) << 6) | (src[i + 1] & 0x3F);
+                i += 2;
+            }
+            else if (c < 0xF0) {
+                cp = (uint32_t(c & 0x0F) << 12) | (uint32_t(src[i + 1] & 0x3F) << 6) | (src[i + 2] & 0x3F);
+                i += 3;
+            }
+            else {
+                cp = (uint32_t(c & 0x07) << 18) | (uint32_t(src[i + 1] & 0x3F) << 12) |
+                     (uint32_t(src[i + 2] & 0x3F) << 6) | (src[i + 3] & 0x3F);
+                i += 4;
+            }
+            if ((sizeof(wchar_t) == 2) && (cp >= 0x10000)) {
+                if ((n + 2) > dstMaxChars) {
+                    return TargetExhausted;
+                }
+                cp -= 0x10000;
+                dst[n++] = wchar_t(0xD800 + (cp >> 10));
+                dst[n++] = wchar_t(0xDC00 + (cp & 0x3FF));
+            }
+            else {
+                if (n >= dstMaxChars) {
+                    return TargetExhausted;
+                }
+                dst[n++] = wchar_t(cp);
+            }
+        }
+        while ((i < srcNumBytes) && (src[i] >= 0x80));
+    }
+    return n;
+}
+
+//------------------------------------------------------------------------------
+int
+utf8Codec::WideToUTF8(const wchar_t* src, int srcNumChars, unsigned char* dst, int dstMaxBytes) {
+    o_assert_dbg(src && dst);
+    int i = 0;
+    int n = 0;
+    while (i < srcNumChars) {
+        #if ORYOL_HAS_SSE2 || ORYOL_HAS_NEON
+        // cheap check of the last char first, to skip the SIMD test in non-ASCII text
+        while (((i + 16) <= srcNumChars) && ((n + 16) <= dstMaxBytes) &&
+               (uint32_t(src[i + 15]) < 0x80) && narrowAscii16(src + i, dst + n)) {
+            i += 16;
+            n += 16;
+        }
+        if (i >= srcNumChars) {
+            break;
+        }
+        #endif
+        // encode characters until the next ASCII character
+        do {
+            uint32_t cp = uint32_t(src[i++]);
+            if (sizeof(wchar_t) == 2) {
+                cp &= 0xFFFF;
+                if ((cp >= 0xD800) && (cp < 0xDC00)) {
+                    // high surrogate, must be followed by a low surrogate
+                    if (i >= srcNumChars) {
+                        return InvalidSource;
+                    }
+                    const uint32_t low = uint32_t(src[i]) & 0xFFFF;
+                    if ((low < 0xDC00) || (low >= 0xE000)) {
+                        return InvalidSource;
+                    }
+                    cp = 0x10000 + ((cp - 0xD800) << 10) + (low - 0xDC00);
+                    i++;
+                }
+            }
+            if (((cp >= 0xD800) && (cp < 0xE000)) || (cp >= 0x110000)) {
+                // lone surrogate or out of range
+                return InvalidSource;
+            }
+            const int len = (cp < 0x80) ? 1 : ((cp < 0x800) ? 2 : ((cp < 0x10000) ? 3 : 4));
+            if ((n + len) > dstMaxBytes) {
+                return TargetExhausted;
+            }
+            switch (len) {
+                case 1:
+                    dst[n] = (unsigned char) cp;
+                    break;
+                case 2:
+                    dst[n]     = (unsigned char) (0xC0 | (cp >> 6));
+                    dst[n + 1] = (unsigned char) (0x80 | (cp & 0x3F));
+                    break;
+                case 3:
+                    dst[n]     = (unsigned char) (0xE0 | (cp >> 12));
+                    dst[n + 1] = (unsigned char) (0x80 | ((cp >> 6) & 0x3F));
+                    dst[n + 2] = (unsigned char) (0x80 | (cp & 0x3F));
+                    break;
+                default:
+                    dst[n]     = (unsigned char) (0xF0 | (cp >> 18));
+                    dst[n + 1] = (unsigned char) (0x80 | ((cp >> 12) & 0x3F));
+                    dst[n + 2] = (unsigned char) (0x80 | ((cp >> 6) & 0x3F));
+                    dst[n + 3] = (unsigned char) (0x80 | (cp & 0x3F));
+                    break;
+            }
+            n += len;
+        }
+        while ((i < srcNumChars) && (uint32_t(src[i]) >= 0x80));
+    }
+    return n;
+}
+
+} // namespace Oryol
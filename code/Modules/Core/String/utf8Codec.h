@@ -0,0 +1,44 @@
+#pragma once
+//------------------------------------------------------------------------------
+/*
+    private class, do not use
+
+    UTF-8 validation and UTF-8 <=> wide-string (UTF-16 or UTF-32,
+    depending on sizeof(wchar_t)) conversion used by StringConverter.
+
+    Validation checks 16 bytes at a time with SIMD (SSSE3 on x86-64 if the
+    CPU supports it, NEON on ARM64) using the table lookup algorithm from
+    John Keiser and Daniel Lemire, "Validating UTF-8 In Less Than One
+    Instruction Per Byte" (2021). Other platforms use a scalar validator
+    which skips over ASCII 8 bytes at a time.
+
+    Conversion validates the whole input first, converts runs of ASCII
+    characters 16 at a time with SIMD, and decodes the remaining
+    characters with a scalar decoder which doesn't need to check its input.
+*/
+#include "Core/Types.h"
+
+namespace Oryol {
+
+class utf8Codec {
+public:
+    /// conversion error codes (conversion functions return a negative value on error)
+    enum Error {
+        InvalidSource = -1,
+        TargetExhausted = -2,
+    };
+
+    /// return true if the byte range is valid UTF-8 (no overlong forms, surrogates or code points > 0x10FFFF)
+    static bool Validate(const unsigned char* src, int numBytes);
+    /// same as Validate, but always uses the scalar code path
+    static bool ValidateScalar(const unsigned char* src, int numBytes);
+    /// return true if SIMD validation is used on this CPU
+    static bool HasSIMD();
+
+    /// convert UTF-8 to wide chars, return number of written wide chars (no 0-terminator), or an Error
+    static int UTF8ToWide(const unsigned char* src, int srcNumBytes, wchar_t* dst, int dstMaxChars);
+    /// convert wide chars to UTF-8, return number of written bytes (no 0-terminator), or an Error
+    static int WideToUTF8(const wchar_t* src, int srcNumChars, unsigned char* dst, int dstMaxBytes);
+};
+
+} // namespace Oryol
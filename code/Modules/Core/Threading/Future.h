@@ -0,0 +1,419 @@
+#pragma once
+//------------------------------------------------------------------------------
+/**
+    @class Oryol::Future
+    @ingroup Core
+    @brief a value which is produced later, with continuations
+
+    A Promise is the producer side of a Future, it is resolved with a
+    value (or failed) once, from any thread. The continuation which is
+    attached to a Future with Then() is called on the RunLoop of the
+    thread which called Then() (by default the thread's 'before-frame'
+    RunLoop) at the start of its next Run() after the Promise has
+    been resolved, so there's no need to poll for the result:
+
+    ```cpp
+    Promise<int> promise;
+    promise.GetFuture().Then([](int val) {
+        return val * 2;
+    }).Then([](int val) {
+        Log::Info("result: %d\n", val);
+    });
+    ...
+    // on a worker thread
+    promise.Resolve(21);
+    ```
+
+    Then() returns a new Future which is resolved with the return value
+    of the continuation (a Future<void> if the continuation doesn't return
+    a value). Continuations on the same RunLoop are called in the same
+    Run() along the chain. If a Promise fails, the continuation isn't
+    called, but the optional failed-callback, and the failure is passed
+    down the chain. A Promise which is destroyed before it has been
+    resolved fails.
+
+    Cancel() detaches the continuation from a Future, this must be called
+    before objects which are referenced by the continuation go away.
+    Each Future can only have one continuation. TYPE must be
+    default-constructible and movable.
+*/
+#include "Core/Core.h"
+#include "Core/RefCounted.h"
+#include "Core/Assertion.h"
+#include <functional>
+#include <utility>
+#if ORYOL_HAS_THREADS
+#include <mutex>
+#define ORYOL_FUTURE_LOCK std::lock_guard<std::mutex> lock(this->mutex)
+#else
+#define ORYOL_FUTURE_LOCK
+#endif
+
+namespace Oryol {
+
+template<class TYPE> class Future;
+template<class TYPE> class Promise;
+
+namespace _priv {
+
+/// the value of a Future<void>
+struct futureVoid { };
+template<class TYPE> struct futureValue {
+    typedef TYPE type;
+};
+template<> struct futureValue<void> {
+    typedef futureVoid type;
+};
+
+/// the result type of a continuation
+template<class TYPE, class FUNC> struct futureResult {
+    typedef decltype(std::declval<FUNC&>()(std::declval<TYPE>())) type;
+};
+template<class FUNC> struct futureResult<void, FUNC> {
+    typedef decltype(std::declval<FUNC&>()()) type;
+};
+
+/// the state which is shared by a Promise and its Future
+template<class TYPE> class futureState : public RefCounted {
+    OryolClassDecl(futureState);
+public:
+    typedef typename futureValue<TYPE>::type valueType;
+    enum status {
+        pending,
+        resolved,
+        failed,
+    };
+    typedef std::function<void(status, valueType&&)> continuation;
+
+    /// resolve or fail, curRunLoop is the RunLoop the caller runs on (if known)
+    void complete(status s, valueType&& val, RunLoop* curRunLoop=nullptr);
+    /// set the continuation and the RunLoop it is called on
+    void setContinuation(continuation func, RunLoop* runLoop);
+    /// detach the continuation
+    void cancel();
+    /// get current status
+    status getStatus();
+
+private:
+    /// call the continuation (called on the RunLoop's thread)
+    void dispatch();
+    /// post dispatch() to the RunLoop
+    void post();
+
+    #if ORYOL_HAS_THREADS
+    std::mutex mutex;
+    #endif
+    status stat = pending;
+    bool cancelled = false;
+    bool hasContinuation = false;
+    valueType value;
+    continuation func;
+    RunLoop* runLoop = nullptr;
+};
+
+} // namespace _priv
+
+template<class TYPE> class Future {
+public:
+    /// failed-callback
+    typedef std::function<void()> FailedFunc;
+
+    /// default constructor (invalid Future)
+    Future() { };
+    /// return true if the Future is valid
+    bool IsValid() const;
+    /// return true if the Promise hasn't been resolved or failed yet
+    bool IsPending() const;
+    /// return true if the Promise has been resolved
+    bool IsResolved() const;
+    /// return true if the Promise has failed
+    bool IsFailed() const;
+
+    /// attach a continuation, called on runLoop (default is the thread's PreRunLoop)
+    template<class FUNC> Future<typename _priv::futureResult<TYPE, FUNC>::type>
+    Then(FUNC onResolved, FailedFunc onFailed=FailedFunc(), RunLoop* runLoop=nullptr);
+    /// detach the continuation, it won't be called anymore
+    void Cancel();
+
+private:
+    template<class> friend class Future;
+    friend class Promise<TYPE>;
+    /// construct from state
+    Future(const Ptr<_priv::futureState<TYPE>>& s) : state(s) { };
+
+    Ptr<_priv::futureState<TYPE>> state;
+};
+
+template<class TYPE> class Promise {
+public:
+    /// constructor
+    Promise();
+    /// move constructor
+    Promise(Promise&& rhs);
+    /// destructor, fails the Future if not resolved yet
+    ~Promise();
+    /// move-assignment
+    void operator=(Promise&& rhs);
+
+    /// Promises can't be copied
+    Promise(const Promise& rhs) = delete;
+    /// Promises can't be copied
+    void operator=(const Promise& rhs) = delete;
+
+    /// get the Future of this Promise
+    Future<TYPE> GetFuture() const;
+    /// resolve with a value (no arguments for Promise<void>)
+    template<class... ARGS> void Resolve(ARGS&&... args);
+    /// resolve as failed
+    void Fail();
+    /// return true if the Promise hasn't been resolved or failed yet
+    bool IsPending() const;
+
+private:
+    Ptr<_priv::futureState<TYPE>> state;
+};
+
+namespace _priv {
+
+/// call a continuation and complete the next state in the chain
+template<class TYPE, class RESULT> struct futureCall {
+    template<class FUNC> static void call(FUNC& func, typename futureValue<TYPE>::type&& val, futureState<RESULT>* next, RunLoop* runLoop) {
+        next->complete(futureState<RESULT>::resolved, func(std::move(val)), runLoop);
+    };
+};
+template<class TYPE> struct futureCall<TYPE, void> {
+    template<class FUNC> static void call(FUNC& func, typename futureValue<TYPE>::type&& val, futureState<void>* next, RunLoop* runLoop) {
+        func(std::move(val));
+        next->complete(futureState<void>::resolved, futureVoid(), runLoop);
+    };
+};
+template<class RESULT> struct futureCall<void, RESULT> {
+    template<class FUNC> static void call(FUNC& func, futureVoid&& /*val*/, futureState<RESULT>* next, RunLoop* runLoop) {
+        next->complete(futureState<RESULT>::resolved, func(), runLoop);
+    };
+};
+template<> struct futureCall<void, void> {
+    template<class FUNC> static void call(FUNC& func, futureVoid&& /*val*/, futureState<void>* next, RunLoop* runLoop) {
+        func();
+        next->complete(futureState<void>::resolved, futureVoid(), runLoop);
+    };
+};
+
+//------------------------------------------------------------------------------
+/**
+ NOTE: a continuation which is attached to the same RunLoop that the
+ caller runs on is called immediately, this way a chain of continuations
+ is called in a single Run().
+*/
+template<class TYPE> void
+futureState<TYPE>::complete(status s, valueType&& val, RunLoop* curRunLoop) {
+    o_assert_dbg(pending != s);
+    bool callNow = false;
+    {
+        ORYOL_FUTURE_LOCK;
+        o_assert2(pending == this->stat, "Future: promise resolved twice!\n");
+        this->stat = s;
+        this->value = std::move(val);
+        if (this->hasContinuation && !this->cancelled) {
+            if (curRunLoop && (curRunLoop == this->runLoop)) {
+                callNow = true;
+            }
+            else {
+                this->post();
+            }
+        }
+    }
+    if (callNow) {
+        this->dispatch();
+    }
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE> void
+futureState<TYPE>::setContinuation(continuation f, RunLoop* rl) {
+    o_assert_dbg(f && rl);
+    ORYOL_FUTURE_LOCK;
+    o_assert2(!this->hasContinuation, "Future: only one continuation allowed!\n");
+    this->hasContinuation = true;
+    this->func = std::move(f);
+    this->runLoop = rl;
+    if ((pending != this->stat) && !this->cancelled) {
+        this->post();
+    }
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE> void
+futureState<TYPE>::cancel() {
+    continuation f;
+    {
+        ORYOL_FUTURE_LOCK;
+        this->cancelled = true;
+        f = std::move(this->func);
+        this->func = nullptr;
+    }
+    // NOTE: the continuation is destroyed outside the lock
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE> typename futureState<TYPE>::status
+futureState<TYPE>::getStatus() {
+    ORYOL_FUTURE_LOCK;
+    return this->stat;
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE> void
+futureState<TYPE>::post() {
+    Ptr<futureState> self(this);
+    this->runLoop->Post([self] {
+        self->dispatch();
+    });
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE> void
+futureState<TYPE>::dispatch() {
+    continuation f;
+    status s;
+    valueType val;
+    {
+        ORYOL_FUTURE_LOCK;
+        if (this->cancelled || !this->func) {
+            return;
+        }
+        f = std::move(this->func);
+        this->func = nullptr;
+        s = this->stat;
+        val = std::move(this->value);
+    }
+    f(s, std::move(val));
+}
+
+} // namespace _priv
+
+//------------------------------------------------------------------------------
+template<class TYPE> bool
+Future<TYPE>::IsValid() const {
+    return this->state.isValid();
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE> bool
+Future<TYPE>::IsPending() const {
+    o_assert_dbg(this->state);
+    return _priv::futureState<TYPE>::pending == this->state->getStatus();
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE> bool
+Future<TYPE>::IsResolved() const {
+    o_assert_dbg(this->state);
+    return _priv::futureState<TYPE>::resolved == this->state->getStatus();
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE> bool
+Future<TYPE>::IsFailed() const {
+    o_assert_dbg(this->state);
+    return _priv::futureState<TYPE>::failed == this->state->getStatus();
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE> template<class FUNC> Future<typename _priv::futureResult<TYPE, FUNC>::type>
+Future<TYPE>::Then(FUNC onResolved, FailedFunc onFailed, RunLoop* runLoop) {
+    o_assert_dbg(this->state);
+    typedef typename _priv::futureResult<TYPE, FUNC>::type resultType;
+    typedef _priv::futureState<TYPE> stateType;
+    if (nullptr == runLoop) {
+        runLoop = Core::PreRunLoop();
+    }
+    // the next state is completed by the continuation
+    Ptr<_priv::futureState<resultType>> nextState = _priv::futureState<resultType>::Create();
+    this->state->setContinuation([onResolved, onFailed, nextState, runLoop]
+        (typename stateType::status s, typename stateType::valueType&& val) mutable {
+            if (stateType::resolved == s) {
+                _priv::futureCall<TYPE, resultType>::call(onResolved, std::move(val), nextState.get(), runLoop);
+            }
+            else {
+                if (onFailed) {
+                    onFailed();
+                }
+                nextState->complete(_priv::futureState<resultType>::failed,
+                    typename _priv::futureState<resultType>::valueType(), runLoop);
+            }
+        }, runLoop);
+    return Future<resultType>(nextState);
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE> void
+Future<TYPE>::Cancel() {
+    if (this->state) {
+        this->state->cancel();
+    }
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE>
+Promise<TYPE>::Promise() :
+state(_priv::futureState<TYPE>::Create()) {
+    // empty
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE>
+Promise<TYPE>::Promise(Promise&& rhs) :
+state(std::move(rhs.state)) {
+    // empty
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE>
+Promise<TYPE>::~Promise() {
+    if (this->IsPending()) {
+        this->Fail();
+    }
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE> void
+Promise<TYPE>::operator=(Promise&& rhs) {
+    if (this->IsPending()) {
+        this->Fail();
+    }
+    this->state = std::move(rhs.state);
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE> Future<TYPE>
+Promise<TYPE>::GetFuture() const {
+    o_assert_dbg(this->state);
+    return Future<TYPE>(this->state);
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE> template<class... ARGS> void
+Promise<TYPE>::Resolve(ARGS&&... args) {
+    o_assert_dbg(this->state);
+    this->state->complete(_priv::futureState<TYPE>::resolved,
+        typename _priv::futureState<TYPE>::valueType(std::forward<ARGS>(args)...));
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE> void
+Promise<TYPE>::Fail() {
+    o_assert_dbg(this->state);
+    this->state->complete(_priv::futureState<TYPE>::failed,
+        typename _priv::futureState<TYPE>::valueType());
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE> bool
+Promise<TYPE>::IsPending() const {
+    return this->state && (_priv::futureState<TYPE>::pending == this->state->getStatus());
+}
+
+} // namespace Oryol
+
+#undef ORYOL_FUTURE_LOCK
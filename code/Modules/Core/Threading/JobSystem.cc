@@ -0,0 +1,442 @@
+//------------------------------------------------------------------------------
+//  JobSystem.cc
+//------------------------------------------------------------------------------
+#include "Pre.h"
+#include "JobSystem.h"
+#include "Core/Containers/WorkStealingDeque.h"
+#include "Core/Threading/ThreadLocalPtr.h"
+#include "Core/Trace.h"
+#if ORYOL_HAS_THREADS
+#include "Core/Containers/MPMCQueue.h"
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#endif
+
+namespace Oryol {
+
+namespace {
+    // per-thread job deque and job pool
+    struct context {
+        context(int index_, int maxJobs) :
+            index(index_),
+            deque(maxJobs),
+            poolIndex(0) {
+            const int poolSize = this->deque.Capacity();
+            this->poolMask = uint32_t(poolSize - 1);
+            this->pool = (_priv::job*) Memory::Alloc(poolSize * int(sizeof(_priv::job)));
+            for (int i = 0; i < poolSize; i++) {
+                new(&this->pool[i]) _priv::job();
+                this->pool[i].inUse.store(0, std::memory_order_relaxed);
+            }
+        };
+        ~context() {
+            Memory::Free(this->pool);
+        };
+        int index;
+        WorkStealingDeque<_priv::job*> deque;
+        _priv::job* pool;
+        uint32_t poolMask;
+        uint32_t poolIndex;
+    };
+    struct _state {
+        _state(int maxJobs) :
+            #if ORYOL_HAS_THREADS
+            injectQueue(maxJobs),
+            running(false),
+            numSleeping(0),
+            wakeEpoch(0),
+            #endif
+            numWorkers(0),
+            numContexts(0) {
+            (void)maxJobs;
+        };
+        #if ORYOL_HAS_THREADS
+        // jobs started from threads without a context
+        MPMCQueue<_priv::job*> injectQueue;
+        std::atomic<bool> running;
+        std::atomic<int> numSleeping;
+        std::atomic<uint32_t> wakeEpoch;
+        std::mutex wakeMutex;
+        std::condition_variable wakeCond;
+        std::thread threads[JobSystem::MaxNumWorkers];
+        #endif
+        int numWorkers;
+        int numContexts;
+        // context 0 belongs to the main thread, followed by the workers
+        context* contexts[JobSystem::MaxNumWorkers + 1];
+    };
+    _state* state = nullptr;
+    ORYOL_THREADLOCAL_PTR(context) curContext = nullptr;
+
+    //--------------------------------------------------------------------------
+    inline void
+    yieldThread() {
+        #if ORYOL_HAS_THREADS
+        std::this_thread::yield();
+        #endif
+    }
+
+    //--------------------------------------------------------------------------
+    void
+    freeJob(_priv::job* j) {
+        if (j->fromHeap) {
+            Memory::Delete(j);
+        }
+        else {
+            j->inUse.store(0, std::memory_order_release);
+        }
+    }
+
+    //--------------------------------------------------------------------------
+    bool
+    findJob(context* ctx, _priv::job*& outJob) {
+        if (ctx && ctx->deque.Pop(outJob)) {
+            return true;
+        }
+        #if ORYOL_HAS_THREADS
+        if (state->injectQueue.Dequeue(outJob)) {
+            return true;
+        }
+        const int num = state->numContexts;
+        const int start = ctx ? ctx->index + 1 : 0;
+        for (int i = 0; i < num; i++) {
+            context* victim = state->contexts[(start + i) % num];
+            if ((victim != ctx) && victim->deque.Steal(outJob)) {
+                return true;
+            }
+        }
+        #endif
+        return false;
+    }
+
+    #if ORYOL_HAS_THREADS
+    //--------------------------------------------------------------------------
+    void
+    wakeWorker() {
+        // pairs with the fence in JobSystem::workerLoop(), either the sleeping worker
+        // sees the new job, or we see the sleeping worker
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (state->numSleeping.load(std::memory_order_relaxed) > 0) {
+            {
+                std::lock_guard<std::mutex> lock(state->wakeMutex);
+                state->wakeEpoch.fetch_add(1, std::memory_order_relaxed);
+            }
+            state->wakeCond.notify_one();
+        }
+    }
+    #endif
+} // anonymous namespace
+
+//------------------------------------------------------------------------------
+JobCounter::JobCounter() :
+count(0),
+lock(0),
+dependents(nullptr) {
+    // empty
+}
+
+//------------------------------------------------------------------------------
+JobCounter::~JobCounter() {
+    o_assert2(this->Done(), "JobCounter destroyed while jobs are still running!\n");
+    o_assert_dbg(nullptr == this->dependents);
+}
+
+//------------------------------------------------------------------------------
+bool
+JobCounter::Done() const {
+    if (0 == this->count.load(std::memory_order_acquire)) {
+        this->sync();
+        return true;
+    }
+    else {
+        return false;
+    }
+}
+
+//------------------------------------------------------------------------------
+int
+JobCounter::Value() const {
+    return this->count.load(std::memory_order_relaxed);
+}
+
+//------------------------------------------------------------------------------
+void
+JobCounter::add(int num) {
+    this->count.fetch_add(num, std::memory_order_relaxed);
+}
+
+//------------------------------------------------------------------------------
+void
+JobCounter::sync() const {
+    while (0 != this->lock.load(std::memory_order_acquire)) {
+        yieldThread();
+    }
+}
+
+//------------------------------------------------------------------------------
+_priv::job*
+JobCounter::finish() {
+    // fast path, the counter doesn't drop to zero
+    int c = this->count.load(std::memory_order_relaxed);
+    while (c > 1) {
+        if (this->count.compare_exchange_weak(c, c - 1, std::memory_order_acq_rel, std::memory_order_relaxed)) {
+            return nullptr;
+        }
+    }
+    // might drop to zero, this must happen under the lock so that
+    // addDependent() doesn't miss it, and sync() can wait for us
+    // to leave the counter alone
+    while (0 != this->lock.exchange(1, std::memory_order_acquire)) {
+        yieldThread();
+    }
+    _priv::job* released = nullptr;
+    const int prev = this->count.fetch_sub(1, std::memory_order_acq_rel);
+    o_assert_dbg(prev > 0);
+    if (1 == prev) {
+        released = this->dependents;
+        this->dependents = nullptr;
+    }
+    this->lock.store(0, std::memory_order_release);
+    return released;
+}
+
+//------------------------------------------------------------------------------
+bool
+JobCounter::addDependent(_priv::job* j) {
+    while (0 != this->lock.exchange(1, std::memory_order_acquire)) {
+        yieldThread();
+    }
+    bool added = false;
+    if (this->count.load(std::memory_order_acquire) > 0) {
+        j->nextDependent = this->dependents;
+        this->dependents = j;
+        added = true;
+    }
+    this->lock.store(0, std::memory_order_release);
+    return added;
+}
+
+//------------------------------------------------------------------------------
+void
+JobSystem::Setup(const JobSetup& setup) {
+    o_assert(!IsValid());
+    o_assert(nullptr == curContext);
+    o_assert(setup.MaxJobsPerThread > 0);
+    int numWorkers = 0;
+    #if ORYOL_HAS_THREADS
+    numWorkers = setup.NumWorkers;
+    if (numWorkers < 0) {
+        numWorkers = int(std::thread::hardware_concurrency()) - 1;
+    }
+    if (numWorkers < 0) {
+        numWorkers = 0;
+    }
+    else if (numWorkers > MaxNumWorkers) {
+        numWorkers = MaxNumWorkers;
+    }
+    #endif
+    state = Memory::New<_state>(setup.MaxJobsPerThread);
+    state->numWorkers = numWorkers;
+    state->numContexts = numWorkers + 1;
+    for (int i = 0; i < state->numContexts; i++) {
+        state->contexts[i] = Memory::New<context>(i, setup.MaxJobsPerThread);
+    }
+    curContext = state->contexts[0];
+    #if ORYOL_HAS_THREADS
+    state->running.store(true, std::memory_order_release);
+    for (int i = 0; i < numWorkers; i++) {
+        state->threads[i] = std::thread(&JobSystem::workerLoop, i + 1);
+    }
+    #endif
+}
+
+//------------------------------------------------------------------------------
+void
+JobSystem::Discard() {
+    o_assert(IsValid());
+    o_assert(curContext == state->contexts[0]);
+    #if ORYOL_HAS_THREADS
+    {
+        std::lock_guard<std::mutex> lock(state->wakeMutex);
+        state->running.store(false, std::memory_order_release);
+        state->wakeEpoch.fetch_add(1, std::memory_order_relaxed);
+    }
+    state->wakeCond.notify_all();
+    for (int i = 0; i < state->numWorkers; i++) {
+        state->threads[i].join();
+    }
+    o_assert2(state->injectQueue.Empty(), "JobSystem::Discard(): jobs still pending!\n");
+    #endif
+    for (int i = 0; i < state->numContexts; i++) {
+        o_assert2(state->contexts[i]->deque.Empty(), "JobSystem::Discard(): jobs still pending!\n");
+        Memory::Delete(state->contexts[i]);
+    }
+    Memory::Delete(state);
+    state = nullptr;
+    curContext = nullptr;
+}
+
+//------------------------------------------------------------------------------
+bool
+JobSystem::IsValid() {
+    return nullptr != state;
+}
+
+//------------------------------------------------------------------------------
+int
+JobSystem::NumWorkers() {
+    o_assert_dbg(IsValid());
+    return state->numWorkers;
+}
+
+//------------------------------------------------------------------------------
+int
+JobSystem::NumThreads() {
+    o_assert_dbg(IsValid());
+    return state->numWorkers + 1;
+}
+
+//------------------------------------------------------------------------------
+bool
+JobSystem::runsInline() {
+    return 0 == state->numWorkers;
+}
+
+//------------------------------------------------------------------------------
+_priv::job*
+JobSystem::allocJob() {
+    context* ctx = curContext;
+    if (ctx) {
+        _priv::job* j = &ctx->pool[ctx->poolIndex++ & ctx->poolMask];
+        if (0 == j->inUse.load(std::memory_order_acquire)) {
+            j->inUse.store(1, std::memory_order_relaxed);
+            j->fromHeap = false;
+            return j;
+        }
+    }
+    // no context on this thread, or the pool slot is still in flight
+    _priv::job* j = Memory::New<_priv::job>();
+    j->fromHeap = true;
+    return j;
+}
+
+//------------------------------------------------------------------------------
+void
+JobSystem::submit(_priv::job* j, JobCounter* dependency) {
+    if (dependency && dependency->addDependent(j)) {
+        // will be pushed when the dependency has finished
+        return;
+    }
+    push(j);
+}
+
+//------------------------------------------------------------------------------
+void
+JobSystem::push(_priv::job* j) {
+    if (runsInline()) {
+        execute(j);
+        return;
+    }
+    #if ORYOL_HAS_THREADS
+    context* ctx = curContext;
+    const bool queued = ctx ? ctx->deque.Push(j) : state->injectQueue.Enqueue(j);
+    if (!queued) {
+        // queue is full, run the job right here
+        execute(j);
+        return;
+    }
+    wakeWorker();
+    #endif
+}
+
+//------------------------------------------------------------------------------
+void
+JobSystem::execute(_priv::job* j) {
+    JobCounter* counter = j->counter;
+    {
+        o_trace_scoped(JobSystem_Job);
+        j->run(j);
+    }
+    freeJob(j);
+    if (counter) {
+        finish(counter);
+    }
+}
+
+//------------------------------------------------------------------------------
+void
+JobSystem::finish(JobCounter* counter) {
+    _priv::job* j = counter->finish();
+    while (j) {
+        _priv::job* next = j->nextDependent;
+        j->nextDependent = nullptr;
+        push(j);
+        j = next;
+    }
+}
+
+//------------------------------------------------------------------------------
+void
+JobSystem::Wait(const JobCounter& counter) {
+    o_assert_dbg(IsValid());
+    context* ctx = curContext;
+    while (counter.count.load(std::memory_order_acquire) > 0) {
+        _priv::job* j = nullptr;
+        if (findJob(ctx, j)) {
+            execute(j);
+        }
+        else {
+            yieldThread();
+        }
+    }
+    counter.sync();
+}
+
+//------------------------------------------------------------------------------
+void
+JobSystem::workerLoop(int contextIndex) {
+    #if ORYOL_HAS_THREADS
+    context* ctx = state->contexts[contextIndex];
+    curContext = ctx;
+    o_trace_thread_name("JobWorker");
+    int numIdle = 0;
+    while (state->running.load(std::memory_order_acquire)) {
+        _priv::job* j = nullptr;
+        if (findJob(ctx, j)) {
+            execute(j);
+            numIdle = 0;
+            continue;
+        }
+        if (++numIdle < 64) {
+            yieldThread();
+            continue;
+        }
+        // nothing to do for a while, go to sleep, announce this before
+        // looking for work a last time so that wakeWorker() can't miss us
+        const uint32_t epoch = state->wakeEpoch.load(std::memory_order_acquire);
+        state->numSleeping.fetch_add(1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (findJob(ctx, j)) {
+            state->numSleeping.fetch_sub(1, std::memory_order_relaxed);
+            execute(j);
+            numIdle = 0;
+            continue;
+        }
+        {
+            std::unique_lock<std::mutex> lock(state->wakeMutex);
+            while (state->running.load(std::memory_order_relaxed) &&
+                   (epoch == state->wakeEpoch.load(std::memory_order_relaxed))) {
+                state->wakeCond.wait(lock);
+            }
+        }
+        state->numSleeping.fetch_sub(1, std::memory_order_relaxed);
+        numIdle = 0;
+    }
+    curContext = nullptr;
+    #else
+    (void)contextIndex;
+    #endif
+}
+
+} // namespace Oryol
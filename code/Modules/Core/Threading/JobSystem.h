@@ -0,0 +1,223 @@
+#pragma once
+//------------------------------------------------------------------------------
+/**
+    @class Oryol::JobSystem
+    @ingroup Core
+    @brief work-stealing job system
+
+    The JobSystem runs small jobs (any callable with a void() signature)
+    on a pool of worker threads. Each worker, and the thread which called
+    Setup(), owns a WorkStealingDeque: new jobs are pushed onto the
+    deque of the calling thread, and idle workers steal jobs from the
+    other deques. Jobs started from other threads go through a shared
+    injection queue.
+
+    Completion is tracked with JobCounters: each job started with a
+    counter increments it, and decrements it once the job has finished.
+    A job can also depend on a counter, it will only be started after
+    the counter has dropped to zero. JobSystem::Wait() doesn't block
+    the calling thread, instead it executes pending jobs until the
+    counter has dropped to zero, so it's fine to wait from inside a job.
+
+    The number of worker threads defaults to the number of hardware
+    threads minus one (the main thread also executes jobs while it
+    waits). With zero workers (a single-core machine, NumWorkers = 0, or
+    ORYOL_HAS_THREADS=0) jobs are executed right away on the calling
+    thread, or when their dependency has finished.
+
+    Captured state of up to JobSystem::MaxInlineSize bytes is stored in
+    the job itself, larger callables are moved to the heap.
+
+    @code
+    JobCounter counter;
+    for (int i = 0; i < 16; i++) {
+        JobSystem::Run([i, &results] { results[i] = compute(i); }, &counter);
+    }
+    JobSystem::Wait(counter);
+    @endcode
+*/
+#include "Core/Config.h"
+#include "Core/Assertion.h"
+#include "Core/Memory/Memory.h"
+#include <atomic>
+#include <type_traits>
+#include <utility>
+
+namespace Oryol {
+
+class JobCounter;
+
+namespace _priv {
+/// a job, private struct, do not use
+struct job {
+    /// calls and destroys the stored callable
+    void (*run)(job*);
+    /// counter to decrement after the job has finished (can be nullptr)
+    JobCounter* counter;
+    /// next job waiting on the same dependency
+    job* nextDependent;
+    /// set while a pooled job is in flight
+    std::atomic<int> inUse;
+    /// true if the job was allocated from the heap instead of a pool
+    bool fromHeap;
+    /// storage for the callable (or a pointer to it)
+    alignas(16) uint8_t payload[64];
+};
+} // namespace _priv
+
+//------------------------------------------------------------------------------
+/**
+    @class Oryol::JobSetup
+    @ingroup Core
+    @brief setup parameters for JobSystem::Setup()
+*/
+class JobSetup {
+public:
+    /// number of worker threads, -1 for number of hardware threads minus one
+    int NumWorkers = -1;
+    /// max number of queued jobs per thread (rounded up to a power of 2)
+    int MaxJobsPerThread = 4096;
+};
+
+//------------------------------------------------------------------------------
+/**
+    @class Oryol::JobCounter
+    @ingroup Core
+    @brief track completion of a group of jobs
+
+    A JobCounter must outlive all jobs which were started with it or
+    depend on it, call JobSystem::Wait() before destroying it.
+*/
+class JobCounter {
+public:
+    /// constructor
+    JobCounter();
+    /// destructor
+    ~JobCounter();
+
+    /// not copyable
+    JobCounter(const JobCounter& rhs) = delete;
+    /// not copyable
+    void operator=(const JobCounter& rhs) = delete;
+
+    /// return true if all jobs started with this counter have finished
+    bool Done() const;
+    /// get the number of unfinished jobs (only a snapshot)
+    int Value() const;
+
+private:
+    friend class JobSystem;
+    /// add to the counter
+    void add(int num);
+    /// decrement the counter, return the list of released dependents
+    _priv::job* finish();
+    /// add a job to run when the counter drops to zero, return false if already zero
+    bool addDependent(_priv::job* j);
+    /// wait until a concurrent finish() has left the counter alone
+    void sync() const;
+
+    std::atomic<int> count;
+    mutable std::atomic<int> lock;
+    _priv::job* dependents;
+};
+
+//------------------------------------------------------------------------------
+class JobSystem {
+public:
+    /// max size of a callable which is stored inline in the job
+    static const int MaxInlineSize = sizeof(_priv::job::payload);
+    /// upper limit for the number of worker threads
+    static const int MaxNumWorkers = 64;
+
+    /// setup the job system, the calling thread becomes the main job thread
+    static void Setup(const JobSetup& setup = JobSetup());
+    /// discard the job system (wait for all jobs first!)
+    static void Discard();
+    /// return true if the job system has been setup
+    static bool IsValid();
+    /// get the number of worker threads (may be 0)
+    static int NumWorkers();
+    /// get the number of threads executing jobs (workers plus the main thread)
+    static int NumThreads();
+
+    /// start a job, optionally tracked by a counter and/or depending on another counter
+    template<class FUNC> static void Run(FUNC&& func, JobCounter* counter = nullptr, JobCounter* dependency = nullptr);
+    /// execute pending jobs until a counter has dropped to zero
+    static void Wait(const JobCounter& counter);
+
+private:
+    typedef std::integral_constant<bool, true> inlineTag;
+    typedef std::integral_constant<bool, false> heapTag;
+
+    template<class FUNC> static void runInline(_priv::job* j);
+    template<class FUNC> static void runHeap(_priv::job* j);
+    template<class FUNC, class ARG> static void store(_priv::job* j, ARG&& func, inlineTag);
+    template<class FUNC, class ARG> static void store(_priv::job* j, ARG&& func, heapTag);
+
+    /// return true if jobs are executed right away on the calling thread
+    static bool runsInline();
+    /// get a free job from the calling thread's pool or the heap
+    static _priv::job* allocJob();
+    /// hand a new job over to the scheduler, or attach it to its dependency
+    static void submit(_priv::job* j, JobCounter* dependency);
+    /// schedule a job which is ready to run
+    static void push(_priv::job* j);
+    /// execute a job and finish its counter
+    static void execute(_priv::job* j);
+    /// finish a counter and schedule the jobs which depended on it
+    static void finish(JobCounter* counter);
+    /// worker thread main loop
+    static void workerLoop(int contextIndex);
+};
+
+//------------------------------------------------------------------------------
+template<class FUNC> void
+JobSystem::runInline(_priv::job* j) {
+    FUNC* func = (FUNC*) j->payload;
+    (*func)();
+    func->~FUNC();
+}
+
+//------------------------------------------------------------------------------
+template<class FUNC> void
+JobSystem::runHeap(_priv::job* j) {
+    FUNC* func = *(FUNC**) j->payload;
+    (*func)();
+    Memory::Delete(func);
+}
+
+//------------------------------------------------------------------------------
+template<class FUNC, class ARG> void
+JobSystem::store(_priv::job* j, ARG&& func, inlineTag) {
+    new(j->payload) FUNC(std::forward<ARG>(func));
+    j->run = &runInline<FUNC>;
+}
+
+//------------------------------------------------------------------------------
+template<class FUNC, class ARG> void
+JobSystem::store(_priv::job* j, ARG&& func, heapTag) {
+    *(FUNC**) j->payload = Memory::New<FUNC>(std::forward<ARG>(func));
+    j->run = &runHeap<FUNC>;
+}
+
+//------------------------------------------------------------------------------
+template<class FUNC> void
+JobSystem::Run(FUNC&& func, JobCounter* counter, JobCounter* dependency) {
+    o_assert_dbg(IsValid());
+    typedef typename std::decay<FUNC>::type funcType;
+    if (!dependency && runsInline()) {
+        func();
+        return;
+    }
+    if (counter) {
+        counter->add(1);
+    }
+    _priv::job* j = allocJob();
+    j->counter = counter;
+    j->nextDependent = nullptr;
+    store<funcType>(j, std::forward<FUNC>(func), std::integral_constant<bool,
+        (sizeof(funcType) <= sizeof(_priv::job::payload)) && (alignof(funcType) <= 16)>());
+    submit(j, dependency);
+}
+
+} // namespace Oryol
@@ -0,0 +1,193 @@
+#pragma once
+//------------------------------------------------------------------------------
+/**
+    @class Oryol::Parallel
+    @ingroup Core
+    @brief data-parallel for-loops and reductions on the JobSystem
+
+    Parallel::For() splits an index range into chunks and processes the
+    chunks on the JobSystem worker threads and the calling thread.
+    Instead of one job per chunk, up to NumWorkers() helper jobs are
+    started which pull chunk indices from a shared atomic counter, so
+    uneven chunks balance themselves, and the calling thread works on
+    chunks too until all are done.
+
+    Parallel::Reduce() computes one partial result per chunk and combines
+    the partial results in chunk order on the calling thread, so the
+    result doesn't depend on which thread processed which chunk (for a
+    fixed grain size). The combine function must be associative.
+
+    If no grain size is given, the range is split into about 4 chunks
+    per thread. If the JobSystem isn't setup or has no worker threads
+    (for instance with ORYOL_HAS_THREADS=0), everything runs serially
+    on the calling thread as a single chunk.
+
+    @code
+    Parallel::ForEach(particles.MakeSlice(), [dt](particle& p) {
+        p.pos += p.vel * dt;
+    });
+    int64_t sum = Parallel::Reduce(values.MakeSlice(), int64_t(0),
+        [](int64_t acc, const int& val) { return acc + val; },
+        [](int64_t a, int64_t b) { return a + b; });
+    @endcode
+*/
+#include "Core/Config.h"
+#include "Core/Containers/Array.h"
+#include "Core/Containers/Slice.h"
+#include "Core/Threading/JobSystem.h"
+#include <atomic>
+
+namespace Oryol {
+
+class Parallel {
+public:
+    /// number of chunks per thread used for the automatic grain size
+    static const int ChunksPerThread = 4;
+
+    /// call func(begin, end) for consecutive sub-ranges of [0, num)
+    template<class FUNC> static void For(int num, FUNC&& func, int grainSize=0);
+    /// call func(TYPE&) for each item of a slice
+    template<class TYPE, class FUNC> static void ForEach(Slice<TYPE> items, FUNC&& func, int grainSize=0);
+    /// call func(TYPE&) for each item of an array
+    template<class TYPE, class FUNC> static void ForEach(Array<TYPE>& items, FUNC&& func, int grainSize=0);
+
+    /// reduce [0, num), func(begin, end) returns the result of a sub-range, combine(RESULT, RESULT) merges two results
+    template<class RESULT, class FUNC, class COMBINE> static RESULT Reduce(int num, const RESULT& identity, FUNC&& func, COMBINE&& combine, int grainSize=0);
+    /// reduce a slice, func(RESULT, const TYPE&) folds an item into a result, combine(RESULT, RESULT) merges two results
+    template<class TYPE, class RESULT, class FUNC, class COMBINE> static RESULT Reduce(Slice<TYPE> items, const RESULT& identity, FUNC&& func, COMBINE&& combine, int grainSize=0);
+    /// reduce an array, see above
+    template<class TYPE, class RESULT, class FUNC, class COMBINE> static RESULT Reduce(Array<TYPE>& items, const RESULT& identity, FUNC&& func, COMBINE&& combine, int grainSize=0);
+
+    /// get the chunk size which would be used for a range of num items
+    static int ChunkSize(int num, int grainSize=0);
+
+private:
+    /// call chunkFunc(chunkIndex, begin, end) for all chunks of [0, num)
+    template<class CHUNKFUNC> static void forChunks(int num, int chunkSize, CHUNKFUNC& chunkFunc);
+};
+
+//------------------------------------------------------------------------------
+inline int
+Parallel::ChunkSize(int num, int grainSize) {
+    if ((num <= 0) || !JobSystem::IsValid() || (0 == JobSystem::NumWorkers())) {
+        return num > 0 ? num : 1;
+    }
+    if (grainSize > 0) {
+        return grainSize;
+    }
+    const int numChunks = JobSystem::NumThreads() * ChunksPerThread;
+    return (num / numChunks) + (((num % numChunks) != 0) ? 1 : 0);
+}
+
+//------------------------------------------------------------------------------
+template<class CHUNKFUNC> void
+Parallel::forChunks(int num, int chunkSize, CHUNKFUNC& chunkFunc) {
+    const int numChunks = (num / chunkSize) + (((num % chunkSize) != 0) ? 1 : 0);
+    if (numChunks <= 1) {
+        chunkFunc(0, 0, num);
+        return;
+    }
+    std::atomic<int> nextChunk(0);
+    auto work = [&nextChunk, &chunkFunc, numChunks, chunkSize, num] {
+        int chunk;
+        while ((chunk = nextChunk.fetch_add(1, std::memory_order_relaxed)) < numChunks) {
+            const int begin = chunk * chunkSize;
+            const int end = ((num - begin) > chunkSize) ? (begin + chunkSize) : num;
+            chunkFunc(chunk, begin, end);
+        }
+    };
+    int numHelpers = JobSystem::NumWorkers();
+    if (numHelpers > (numChunks - 1)) {
+        numHelpers = numChunks - 1;
+    }
+    JobCounter counter;
+    for (int i = 0; i < numHelpers; i++) {
+        JobSystem::Run([&work] { work(); }, &counter);
+    }
+    work();
+    JobSystem::Wait(counter);
+}
+
+//------------------------------------------------------------------------------
+template<class FUNC> void
+Parallel::For(int num, FUNC&& func, int grainSize) {
+    if (num <= 0) {
+        return;
+    }
+    auto chunkFunc = [&func](int /*chunk*/, int begin, int end) {
+        func(begin, end);
+    };
+    forChunks(num, ChunkSize(num, grainSize), chunkFunc);
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE, class FUNC> void
+Parallel::ForEach(Slice<TYPE> items, FUNC&& func, int grainSize) {
+    if (items.Empty()) {
+        return;
+    }
+    TYPE* ptr = items.begin();
+    For(items.Size(), [ptr, &func](int begin, int end) {
+        for (int i = begin; i < end; i++) {
+            func(ptr[i]);
+        }
+    }, grainSize);
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE, class FUNC> void
+Parallel::ForEach(Array<TYPE>& items, FUNC&& func, int grainSize) {
+    ForEach(items.MakeSlice(), std::forward<FUNC>(func), grainSize);
+}
+
+//------------------------------------------------------------------------------
+template<class RESULT, class FUNC, class COMBINE> RESULT
+Parallel::Reduce(int num, const RESULT& identity, FUNC&& func, COMBINE&& combine, int grainSize) {
+    if (num <= 0) {
+        return identity;
+    }
+    const int chunkSize = ChunkSize(num, grainSize);
+    const int numChunks = (num / chunkSize) + (((num % chunkSize) != 0) ? 1 : 0);
+    if (numChunks <= 1) {
+        return combine(identity, func(0, num));
+    }
+    Array<RESULT> partials;
+    partials.Reserve(numChunks);
+    for (int i = 0; i < numChunks; i++) {
+        partials.Add(identity);
+    }
+    RESULT* partialsPtr = &partials[0];
+    auto chunkFunc = [partialsPtr, &func](int chunk, int begin, int end) {
+        partialsPtr[chunk] = func(begin, end);
+    };
+    forChunks(num, chunkSize, chunkFunc);
+    RESULT result = identity;
+    for (const RESULT& partial : partials) {
+        result = combine(result, partial);
+    }
+    return result;
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE, class RESULT, class FUNC, class COMBINE> RESULT
+Parallel::Reduce(Slice<TYPE> items, const RESULT& identity, FUNC&& func, COMBINE&& combine, int grainSize) {
+    if (items.Empty()) {
+        return identity;
+    }
+    const TYPE* ptr = items.begin();
+    return Reduce(items.Size(), identity, [ptr, &identity, &func](int begin, int end) {
+        RESULT result = identity;
+        for (int i = begin; i < end; i++) {
+            result = func(result, ptr[i]);
+        }
+        return result;
+    }, std::forward<COMBINE>(combine), grainSize);
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE, class RESULT, class FUNC, class COMBINE> RESULT
+Parallel::Reduce(Array<TYPE>& items, const RESULT& identity, FUNC&& func, COMBINE&& combine, int grainSize) {
+    return Reduce(items.MakeSlice(), identity, std::forward<FUNC>(func), std::forward<COMBINE>(combine), grainSize);
+}
+
+} // namespace Oryol
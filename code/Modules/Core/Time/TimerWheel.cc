@@ -0,0 +1,300 @@
+//------------------------------------------------------------------------------
+//  TimerWheel.cc
+//------------------------------------------------------------------------------
+#include "Pre.h"
+#include "TimerWheel.h"
+#include "Core/Assertion.h"
+
+namespace Oryol {
+
+//------------------------------------------------------------------------------
+TimerWheel::TimerWheel(Duration tickDuration) :
+tickUs(tickDuration.AsTicks()) {
+    o_assert(this->tickUs > 0);
+    for (int i = 0; i < NumSlotLists; i++) {
+        this->slots[i] = InvalidIndex;
+    }
+}
+
+//------------------------------------------------------------------------------
+TimerWheel::~TimerWheel() {
+    o_assert_dbg(!this->inTick);
+}
+
+//------------------------------------------------------------------------------
+uint64_t
+TimerWheel::toTicks(Duration d, bool fromNow) const {
+    int64_t us = d.AsTicks();
+    if (us < 0) {
+        us = 0;
+    }
+    if (fromNow) {
+        // include the fraction of the current tick which has already
+        // passed, so that timers never fire early
+        us += this->remainderUs;
+    }
+    const uint64_t ticks = uint64_t((us + this->tickUs - 1) / this->tickUs);
+    return ticks > 0 ? ticks : 1;
+}
+
+//------------------------------------------------------------------------------
+TimerWheel::Id
+TimerWheel::Add(Duration delay, Func func) {
+    return this->add(this->toTicks(delay, true), 0, std::move(func));
+}
+
+//------------------------------------------------------------------------------
+TimerWheel::Id
+TimerWheel::AddPeriodic(Duration interval, Func func) {
+    return this->add(this->toTicks(interval, true), this->toTicks(interval, false), std::move(func));
+}
+
+//------------------------------------------------------------------------------
+TimerWheel::Id
+TimerWheel::add(uint64_t delayTicks, uint64_t intervalTicks, Func&& func) {
+    o_assert_dbg(func);
+    int32_t index;
+    if (InvalidIndex != this->freeList) {
+        index = this->freeList;
+        this->freeList = this->timers[index].next;
+    }
+    else {
+        index = this->timers.Size();
+        this->timers.Add(timer());
+    }
+    timer& t = this->timers[index];
+    t.expire = this->curTick + delayTicks;
+    t.interval = intervalTicks;
+    t.func = std::move(func);
+    this->insert(index);
+    this->numTimers++;
+    return (Id(t.generation) << 32) | Id(uint32_t(index));
+}
+
+//------------------------------------------------------------------------------
+int32_t
+TimerWheel::lookup(Id id) const {
+    const int32_t index = int32_t(id & 0xFFFFFFFF);
+    const uint32_t generation = uint32_t(id >> 32);
+    if ((index >= 0) && (index < this->timers.Size())) {
+        const timer& t = this->timers[index];
+        if ((t.generation == generation) && (InvalidIndex != t.slot)) {
+            return index;
+        }
+    }
+    return InvalidIndex;
+}
+
+//------------------------------------------------------------------------------
+bool
+TimerWheel::IsActive(Id id) const {
+    return InvalidIndex != this->lookup(id);
+}
+
+//------------------------------------------------------------------------------
+bool
+TimerWheel::Cancel(Id id) {
+    const int32_t index = this->lookup(id);
+    if (InvalidIndex == index) {
+        return false;
+    }
+    this->unlink(index);
+    this->release(index);
+    return true;
+}
+
+//------------------------------------------------------------------------------
+void
+TimerWheel::Clear() {
+    for (int i = 0; i < NumSlotLists; i++) {
+        while (InvalidIndex != this->slots[i]) {
+            const int32_t index = this->slots[i];
+            this->unlink(index);
+            this->release(index);
+        }
+    }
+    o_assert_dbg(0 == this->numTimers);
+}
+
+//------------------------------------------------------------------------------
+void
+TimerWheel::insert(int32_t index) {
+    timer& t = this->timers[index];
+    // NOTE: timers which are due in the current tick go into the
+    // current level-0 slot, this happens when a coarser slot
+    // is cascaded right before the current slot is processed
+    uint64_t expire = t.expire;
+    if (expire < this->curTick) {
+        expire = this->curTick;
+    }
+    const uint64_t delta = expire - this->curTick;
+    int level = 0;
+    while ((level < (NumLevels - 1)) && (delta >= (uint64_t(1) << ((level + 1) * SlotBits)))) {
+        level++;
+    }
+    if (delta >= (uint64_t(1) << (NumLevels * SlotBits))) {
+        // beyond the range of the wheel, park it in the farthest slot,
+        // it will be re-inserted when that slot is cascaded
+        expire = this->curTick + (uint64_t(1) << (NumLevels * SlotBits)) - 1;
+    }
+    const int slot = (level * NumSlots) + int((expire >> (level * SlotBits)) & SlotMask);
+    t.slot = slot;
+    t.prev = InvalidIndex;
+    t.next = this->slots[slot];
+    if (InvalidIndex != t.next) {
+        this->timers[t.next].prev = index;
+    }
+    this->slots[slot] = index;
+}
+
+//------------------------------------------------------------------------------
+void
+TimerWheel::unlink(int32_t index) {
+    timer& t = this->timers[index];
+    o_assert_dbg(InvalidIndex != t.slot);
+    if (InvalidIndex != t.prev) {
+        this->timers[t.prev].next = t.next;
+    }
+    else {
+        this->slots[t.slot] = t.next;
+    }
+    if (InvalidIndex != t.next) {
+        this->timers[t.next].prev = t.prev;
+    }
+    t.prev = t.next = t.slot = InvalidIndex;
+}
+
+//------------------------------------------------------------------------------
+void
+TimerWheel::release(int32_t index) {
+    timer& t = this->timers[index];
+    t.func = nullptr;
+    t.generation++;
+    if (0 == t.generation) {
+        t.generation = 1;
+    }
+    t.next = this->freeList;
+    this->freeList = index;
+    this->numTimers--;
+}
+
+//------------------------------------------------------------------------------
+void
+TimerWheel::cascade(int level, int slot) {
+    int32_t index = this->slots[level * NumSlots + slot];
+    this->slots[level * NumSlots + slot] = InvalidIndex;
+    while (InvalidIndex != index) {
+        const int32_t next = this->timers[index].next;
+        this->insert(index);
+        index = next;
+    }
+}
+
+//------------------------------------------------------------------------------
+void
+TimerWheel::tick() {
+    this->curTick++;
+
+    // refill the finer levels when a coarser slot comes into range
+    for (int level = 1; level < NumLevels; level++) {
+        if (0 != (this->curTick & ((uint64_t(1) << (level * SlotBits)) - 1))) {
+            break;
+        }
+        this->cascade(level, int((this->curTick >> (level * SlotBits)) & SlotMask));
+    }
+
+    // move the current slot into the due list, timer functions may
+    // add new timers into the same slot (to be called one wheel
+    // revolution later), or cancel timers in the due list
+    const int slot = int(this->curTick & SlotMask);
+    this->slots[DueList] = this->slots[slot];
+    this->slots[slot] = InvalidIndex;
+    for (int32_t i = this->slots[DueList]; InvalidIndex != i; i = this->timers[i].next) {
+        this->timers[i].slot = DueList;
+    }
+    while (InvalidIndex != this->slots[DueList]) {
+        const int32_t index = this->slots[DueList];
+        this->unlink(index);
+        timer& t = this->timers[index];
+        if (t.expire > this->curTick) {
+            // was parked beyond the range of the wheel
+            this->insert(index);
+            continue;
+        }
+        // move the function out, the timers array may grow while it is called
+        Func func = std::move(t.func);
+        const uint32_t generation = t.generation;
+        if (t.interval > 0) {
+            t.expire += t.interval;
+            this->insert(index);
+            func();
+            // put the function back unless the timer has been cancelled
+            timer& t1 = this->timers[index];
+            if ((t1.generation == generation) && (InvalidIndex != t1.slot)) {
+                t1.func = std::move(func);
+            }
+        }
+        else {
+            this->release(index);
+            func();
+        }
+    }
+}
+
+//------------------------------------------------------------------------------
+void
+TimerWheel::AdvanceTicks(int64_t numTicks) {
+    o_assert2(!this->inTick, "TimerWheel: can't advance from inside a timer function!\n");
+    this->inTick = true;
+    for (int64_t i = 0; i < numTicks; i++) {
+        if (0 == this->numTimers) {
+            // nothing to do, jump ahead
+            this->curTick += uint64_t(numTicks - i);
+            break;
+        }
+        this->tick();
+    }
+    this->inTick = false;
+}
+
+//------------------------------------------------------------------------------
+void
+TimerWheel::Advance(Duration dt) {
+    int64_t us = dt.AsTicks();
+    if (us <= 0) {
+        return;
+    }
+    us += this->remainderUs;
+    this->remainderUs = us % this->tickUs;
+    this->AdvanceTicks(us / this->tickUs);
+}
+
+//------------------------------------------------------------------------------
+void
+TimerWheel::Update(TimePoint now) {
+    if (this->hasLastUpdate) {
+        this->Advance(now - this->lastUpdate);
+    }
+    this->lastUpdate = now;
+    this->hasLastUpdate = true;
+}
+
+//------------------------------------------------------------------------------
+Duration
+TimerWheel::TickDuration() const {
+    return Duration(this->tickUs);
+}
+
+//------------------------------------------------------------------------------
+uint64_t
+TimerWheel::CurrentTick() const {
+    return this->curTick;
+}
+
+//------------------------------------------------------------------------------
+int
+TimerWheel::NumTimers() const {
+    return this->numTimers;
+}
+
+} // namespace Oryol
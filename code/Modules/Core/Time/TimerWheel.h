@@ -0,0 +1,128 @@
+#pragma once
+//------------------------------------------------------------------------------
+/**
+    @class Oryol::TimerWheel
+    @ingroup Core
+    @brief hierarchical timer wheel for delayed and periodic callbacks
+
+    A TimerWheel calls functions after a delay (one-shot timers) or
+    repeatedly at an interval (periodic timers). Time advances in
+    ticks of a fixed duration (1 millisecond by default), the wheel
+    must be driven by calling Update() or Advance() regularly. Core
+    creates one TimerWheel per thread which is driven by the thread's
+    'before-frame' RunLoop, see Core::Timers().
+
+    Adding and cancelling a timer is O(1), advancing by one tick only
+    touches the timers which are due (plus an occasional cascade
+    of a bucket of far-away timers into the finer wheel levels).
+    The wheel has 4 levels of 64 slots, timers with delays beyond
+    2^24 ticks are rescheduled when they reach the end of the wheel.
+
+    Timers due in the same tick are called in no particular order,
+    a timer is never called before its delay has passed. If Advance()
+    covers several ticks, a periodic timer is called once per interval
+    which has passed. Timer functions may add and cancel timers,
+    including themselves.
+*/
+#include "Core/Types.h"
+#include "Core/Containers/Array.h"
+#include "Core/Time/Duration.h"
+#include "Core/Time/TimePoint.h"
+#include <functional>
+
+namespace Oryol {
+
+class TimerWheel {
+public:
+    /// timer id
+    typedef uint64_t Id;
+    /// invalid timer id
+    static const Id InvalidId = 0;
+    /// timer function
+    typedef std::function<void()> Func;
+
+    /// constructor with tick duration
+    explicit TimerWheel(Duration tickDuration=Duration::FromMilliSeconds(1.0));
+    /// destructor
+    ~TimerWheel();
+
+    /// not copyable
+    TimerWheel(const TimerWheel& rhs) = delete;
+    /// not copyable
+    void operator=(const TimerWheel& rhs) = delete;
+
+    /// add a one-shot timer
+    Id Add(Duration delay, Func func);
+    /// add a periodic timer, called first after one interval
+    Id AddPeriodic(Duration interval, Func func);
+    /// cancel a timer, return false if the timer has already expired or was cancelled
+    bool Cancel(Id id);
+    /// return true if a timer is still pending
+    bool IsActive(Id id) const;
+    /// cancel all timers
+    void Clear();
+
+    /// advance the wheel to a point in time (the first call only sets the start time)
+    void Update(TimePoint now);
+    /// advance the wheel by a duration
+    void Advance(Duration dt);
+    /// advance the wheel by a number of ticks
+    void AdvanceTicks(int64_t numTicks);
+
+    /// get the tick duration
+    Duration TickDuration() const;
+    /// get the current tick
+    uint64_t CurrentTick() const;
+    /// get the number of pending timers
+    int NumTimers() const;
+
+private:
+    static const int NumLevels = 4;
+    static const int SlotBits = 6;
+    static const int NumSlots = 1 << SlotBits;
+    static const int SlotMask = NumSlots - 1;
+    static const int32_t InvalidIndex = -1;
+    /// slot list of timers being called in the current tick
+    static const int DueList = NumLevels * NumSlots;
+    static const int NumSlotLists = DueList + 1;
+
+    struct timer {
+        uint64_t expire = 0;
+        uint64_t interval = 0;
+        uint32_t generation = 1;
+        int32_t prev = InvalidIndex;
+        int32_t next = InvalidIndex;
+        int32_t slot = InvalidIndex;
+        Func func;
+    };
+
+    /// convert a duration into a number of ticks (rounded up, at least 1)
+    uint64_t toTicks(Duration d, bool fromNow) const;
+    /// allocate a timer and schedule it
+    Id add(uint64_t delayTicks, uint64_t intervalTicks, Func&& func);
+    /// insert a timer into its wheel slot
+    void insert(int32_t index);
+    /// remove a timer from its wheel slot
+    void unlink(int32_t index);
+    /// release a timer into the free list
+    void release(int32_t index);
+    /// move all timers of a slot down into the finer levels
+    void cascade(int level, int slot);
+    /// process one tick
+    void tick();
+    /// get index of a pending timer by id, or InvalidIndex
+    int32_t lookup(Id id) const;
+
+    int64_t tickUs;
+    int64_t remainderUs = 0;
+    uint64_t curTick = 0;
+    TimePoint lastUpdate;
+    bool hasLastUpdate = false;
+    bool inTick = false;
+    int numTimers = 0;
+    int32_t freeList = InvalidIndex;
+    Array<timer> timers;
+    int32_t slots[NumSlotLists];
+};
+
+} // namespace Oryol
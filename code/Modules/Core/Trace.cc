@@ -4,12 +4,23 @@
 #if ORYOL_PROFILING
 #include "Pre.h"
 #include "Trace.h"
+#if ORYOL_USE_TRACERECORDER
+#include "Core/Log.h"
+#endif
 
 namespace Oryol {
 
+#if ORYOL_USE_TRACERECORDER
+// written when the Trace object is destroyed in Core::Discard()
+static const char* TraceFile = "oryol_trace.json";
+#endif
+
 //------------------------------------------------------------------------------
 Trace::Trace() {
-    #if ORYOL_USE_REMOTERY
+    #if ORYOL_USE_TRACERECORDER
+    TraceRecorder::Start();
+    TraceRecorder::SetThreadName("MainThread");
+    #elif ORYOL_USE_REMOTERY
     rmt_CreateGlobalInstance(&this->rmt);
     rmt_SetCurrentThreadName("MainThread");
     #elif ORYOL_USE_EMSCTRACE
@@ -19,7 +30,15 @@ Trace::Trace() {
 
 //------------------------------------------------------------------------------
 Trace::~Trace() {
-    #if ORYOL_USE_REMOTERY
+    #if ORYOL_USE_TRACERECORDER
+    TraceRecorder::Stop();
+    if (TraceRecorder::WriteChromeTrace(TraceFile)) {
+        Log::Info("Trace: trace written to '%s'\n", TraceFile);
+    }
+    else {
+        Log::Warn("Trace: failed to write trace file '%s'\n", TraceFile);
+    }
+    #elif ORYOL_USE_REMOTERY
     rmt_DestroyGlobalInstance(this->rmt);
     this->rmt = nullptr;
     #elif ORYOL_USE_EMSCTRACE
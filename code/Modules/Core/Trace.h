@@ -6,16 +6,23 @@
     @brief tracing support when ORYOL_PROFILING is enabled
 
     This file implements various macros that hook Oryol into
-    profiling/tracing tools.
+    profiling/tracing tools. With the cmake option ORYOL_TRACE_RECORDER,
+    the built-in TraceRecorder is used instead of Remotery, which
+    writes a Chrome trace file (see TraceRecorder).
  */
 #include "Core/Types.h"
-#if ORYOL_LINUX || ORYOL_MACOS || ORYOL_WINDOWS
+#if ORYOL_TRACE_RECORDER
+#define ORYOL_USE_TRACERECORDER (1)
+#elif ORYOL_LINUX || ORYOL_MACOS || ORYOL_WINDOWS
 #define ORYOL_USE_REMOTERY (1)
 #endif
-#if ORYOL_EMSCRIPTEN
+#if ORYOL_EMSCRIPTEN && !ORYOL_TRACE_RECORDER
 #define ORYOL_USE_EMSCTRACE (1)
 #endif
 
+#if ORYOL_USE_TRACERECORDER
+#include "Core/TraceRecorder.h"
+#endif
 #if ORYOL_USE_REMOTERY
 #include "Remotery.h"
 #endif
@@ -50,24 +57,38 @@ struct emscScopedTrace {
 #endif
     
 // trace macros
-#if ORYOL_USE_REMOTERY
+#if ORYOL_USE_TRACERECORDER
+#define o_trace_begin_frame() Oryol::TraceRecorder::Instant("Frame")
+#define o_trace_end_frame() ((void)0)
+#define o_trace_begin(name) Oryol::TraceRecorder::Begin(#name)
+#define o_trace_end() Oryol::TraceRecorder::End()
+#define o_trace_scoped(name) Oryol::TraceRecorder::Scope traceRecorderScope##name(#name)
+#define o_trace_counter(name, value) Oryol::TraceRecorder::Counter(#name, double(value))
+#define o_trace_thread_name(name) Oryol::TraceRecorder::SetThreadName(name)
+#elif ORYOL_USE_REMOTERY
 #define o_trace_begin_frame() ((void)0)
 #define o_trace_end_frame() ((void)0)
 #define o_trace_begin(name) rmt_BeginCPUSample(name)
 #define o_trace_end() rmt_EndCPUSample()
 #define o_trace_scoped(name) rmt_ScopedCPUSample(name)
+#define o_trace_counter(name, value) ((void)0)
+#define o_trace_thread_name(name) rmt_SetCurrentThreadName(name)
 #elif ORYOL_USE_EMSCTRACE
 #define o_trace_begin_frame() emscripten_trace_record_frame_start()
 #define o_trace_end_frame() emscripten_trace_record_frame_end()
 #define o_trace_begin(name) emscripten_trace_enter_context(#name)
 #define o_trace_end(name) emscripten_trace_exit_context()
 #define o_trace_scoped(name) emscScopedTrace emscScopedTrace##name(#name)
+#define o_trace_counter(name, value) ((void)0)
+#define o_trace_thread_name(name) ((void)0)
 #else
 #define o_trace_begin_frame() ((void)0)
 #define o_trace_end_frame() ((void)0)
 #define o_trace_begin(name) ((void)0)
 #define o_trace_end() ((void)0)
 #define o_trace_scoped(name) ((void)0)
+#define o_trace_counter(name, value) ((void)0)
+#define o_trace_thread_name(name) ((void)0)
 #endif
 
 } // namespace Oryol
@@ -77,4 +98,6 @@ struct emscScopedTrace {
 #define o_trace_begin(name) ((void)0)
 #define o_trace_end() ((void)0)
 #define o_trace_scoped(name) ((void)0)
+#define o_trace_counter(name, value) ((void)0)
+#define o_trace_thread_name(name) ((void)0)
 #endif
@@ -0,0 +1,346 @@
+//------------------------------------------------------------------------------
+//  TraceRecorder.cc
+//------------------------------------------------------------------------------
+#include "Pre.h"
+#include "TraceRecorder.h"
+#include "Core/Assertion.h"
+#include "Core/Memory/Memory.h"
+#include "Core/Threading/ThreadLocalPtr.h"
+#include "Core/Time/Clock.h"
+#include <cstdio>
+#include <cstring>
+#include <cmath>
+#if ORYOL_HAS_THREADS
+#include <mutex>
+#endif
+
+namespace Oryol {
+
+std::atomic<bool> TraceRecorder::recording{false};
+
+namespace {
+
+#if ORYOL_HAS_THREADS
+typedef std::mutex traceMutex;
+#define SCOPED_LOCK(m) std::lock_guard<std::mutex> lock(m)
+#else
+struct traceMutex { };
+#define SCOPED_LOCK(m)
+#endif
+
+enum eventType : int {
+    completeEvent,
+    counterEvent,
+    instantEvent,
+};
+
+struct traceEvent {
+    const char* name;
+    int64_t time;
+    int64_t dur;
+    double value;
+    eventType type;
+};
+
+/// per-thread event ring buffer
+struct threadBuffer {
+    /// locked by the owner thread for each event, and while writing the trace
+    traceMutex mutex;
+    traceEvent* events = nullptr;
+    int capacity = 0;
+    int64_t numEvents = 0;
+    int tid = 0;
+    char name[64] = { };
+    // stack of open scopes, only accessed by the owner thread
+    static const int MaxDepth = 64;
+    struct {
+        const char* name;
+        int64_t start;
+    } scopes[MaxDepth];
+    int depth = 0;
+};
+
+const int MaxThreads = 256;
+/// approximate size of one event in the JSON output
+const int EventJsonSize = 100;
+
+struct recorderState {
+    traceMutex mutex;
+    threadBuffer* buffers[MaxThreads] = { };
+    int numBuffers = 0;
+    int capacity = TraceSetup().MaxEventsPerThread;
+    int64_t startTime = 0;
+};
+ORYOL_THREADLOCAL_PTR(threadBuffer) threadTraceBuffer = nullptr;
+
+//------------------------------------------------------------------------------
+/**
+ NOTE: thread buffers are never freed since threads keep pointers to them.
+*/
+recorderState&
+getState() {
+    static recorderState state;
+    return state;
+}
+
+//------------------------------------------------------------------------------
+void
+resetBuffer(threadBuffer* buf, int capacity) {
+    if (buf->capacity != capacity) {
+        if (buf->events) {
+            Memory::Free(buf->events);
+        }
+        buf->events = (traceEvent*) Memory::Alloc(capacity * sizeof(traceEvent));
+        buf->capacity = capacity;
+    }
+    buf->numEvents = 0;
+}
+
+//------------------------------------------------------------------------------
+/**
+ Get or create the calling thread's buffer, returns nullptr if there
+ are too many threads.
+*/
+threadBuffer*
+threadBuf() {
+    threadBuffer* buf = threadTraceBuffer;
+    if (nullptr == buf) {
+        recorderState& state = getState();
+        SCOPED_LOCK(state.mutex);
+        if (state.numBuffers >= MaxThreads) {
+            return nullptr;
+        }
+        buf = Memory::New<threadBuffer>();
+        resetBuffer(buf, state.capacity);
+        buf->tid = state.numBuffers + 1;
+        std::snprintf(buf->name, sizeof(buf->name), "Thread %d", buf->tid);
+        state.buffers[state.numBuffers++] = buf;
+        threadTraceBuffer = buf;
+    }
+    return buf;
+}
+
+//------------------------------------------------------------------------------
+void
+record(threadBuffer* buf, eventType type, const char* name, int64_t time, int64_t dur, double value) {
+    SCOPED_LOCK(buf->mutex);
+    traceEvent& e = buf->events[buf->numEvents % buf->capacity];
+    e.name = name;
+    e.time = time;
+    e.dur = dur;
+    e.value = value;
+    e.type = type;
+    buf->numEvents++;
+}
+
+//------------------------------------------------------------------------------
+void
+appendJsonString(StringBuilder& json, const char* str) {
+    json.Append('"');
+    for (const char* c = str; *c; c++) {
+        if (('"' == *c) || ('\\' == *c)) {
+            json.Append('\\');
+            json.Append(*c);
+        }
+        else if (uint8_t(*c) < 0x20) {
+            json.AppendFormat(16, "\\u%04x", unsigned(uint8_t(*c)));
+        }
+        else {
+            json.Append(*c);
+        }
+    }
+    json.Append('"');
+}
+
+} // anonymous namespace
+
+//------------------------------------------------------------------------------
+/**
+ NOTE: Start() must not be called while other threads are recording
+ events from a previous Start().
+*/
+void
+TraceRecorder::Start(const TraceSetup& setup) {
+    o_assert(!IsRecording());
+    o_assert(setup.MaxEventsPerThread > 0);
+    {
+        recorderState& state = getState();
+        SCOPED_LOCK(state.mutex);
+        state.capacity = setup.MaxEventsPerThread;
+        state.startTime = Clock::Now().getRaw();
+        for (int i = 0; i < state.numBuffers; i++) {
+            threadBuffer* buf = state.buffers[i];
+            SCOPED_LOCK(buf->mutex);
+            resetBuffer(buf, state.capacity);
+        }
+    }
+    recording.store(true, std::memory_order_release);
+}
+
+//------------------------------------------------------------------------------
+void
+TraceRecorder::Stop() {
+    o_assert(IsRecording());
+    recording.store(false, std::memory_order_release);
+}
+
+//------------------------------------------------------------------------------
+void
+TraceRecorder::Begin(const char* name) {
+    if (!IsRecording()) {
+        return;
+    }
+    threadBuffer* buf = threadBuf();
+    if (buf) {
+        // scopes which are nested too deep are only counted
+        if (buf->depth < threadBuffer::MaxDepth) {
+            buf->scopes[buf->depth].name = name;
+            buf->scopes[buf->depth].start = Clock::Now().getRaw();
+        }
+        buf->depth++;
+    }
+}
+
+//------------------------------------------------------------------------------
+void
+TraceRecorder::End() {
+    // scopes which have begun before recording started are ignored
+    threadBuffer* buf = threadTraceBuffer;
+    if ((nullptr == buf) || (0 == buf->depth)) {
+        return;
+    }
+    buf->depth--;
+    if (IsRecording() && (buf->depth < threadBuffer::MaxDepth)) {
+        const int64_t now = Clock::Now().getRaw();
+        const auto& scope = buf->scopes[buf->depth];
+        record(buf, completeEvent, scope.name, scope.start, now - scope.start, 0.0);
+    }
+}
+
+//------------------------------------------------------------------------------
+void
+TraceRecorder::Counter(const char* name, double value) {
+    if (IsRecording()) {
+        threadBuffer* buf = threadBuf();
+        if (buf) {
+            record(buf, counterEvent, name, Clock::Now().getRaw(), 0, value);
+        }
+    }
+}
+
+//------------------------------------------------------------------------------
+void
+TraceRecorder::Instant(const char* name) {
+    if (IsRecording()) {
+        threadBuffer* buf = threadBuf();
+        if (buf) {
+            record(buf, instantEvent, name, Clock::Now().getRaw(), 0, 0.0);
+        }
+    }
+}
+
+//------------------------------------------------------------------------------
+void
+TraceRecorder::SetThreadName(const char* name) {
+    o_assert_dbg(name);
+    threadBuffer* buf = threadBuf();
+    if (buf) {
+        SCOPED_LOCK(buf->mutex);
+        std::snprintf(buf->name, sizeof(buf->name), "%s", name);
+    }
+}
+
+//------------------------------------------------------------------------------
+/**
+ Writes the Chrome trace event format, with one complete ("X") event
+ per scope, timestamps are in microseconds since Start().
+*/
+void
+TraceRecorder::WriteChromeTrace(StringBuilder& json) {
+    json.Append("{\"traceEvents\":[\n");
+    bool first = true;
+    auto beginEvent = [&json, &first] {
+        if (!first) {
+            json.Append(",\n");
+        }
+        first = false;
+    };
+    {
+        recorderState& state = getState();
+        SCOPED_LOCK(state.mutex);
+        const int64_t startTime = state.startTime;
+        // StringBuilder grows in small steps, reserve room for all events
+        // up front so that writing a full ring doesn't become quadratic
+        int64_t numEvents = 0;
+        for (int i = 0; i < state.numBuffers; i++) {
+            threadBuffer* buf = state.buffers[i];
+            SCOPED_LOCK(buf->mutex);
+            numEvents += 1 + (buf->numEvents < buf->capacity ? buf->numEvents : buf->capacity);
+        }
+        json.Reserve(int(numEvents * EventJsonSize));
+        for (int i = 0; i < state.numBuffers; i++) {
+            threadBuffer* buf = state.buffers[i];
+            SCOPED_LOCK(buf->mutex);
+            beginEvent();
+            json.AppendFormat(128, "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%d,\"args\":{\"name\":", buf->tid);
+            appendJsonString(json, buf->name);
+            json.Append("}}");
+            const int64_t num = buf->numEvents < buf->capacity ? buf->numEvents : buf->capacity;
+            for (int64_t e = buf->numEvents - num; e < buf->numEvents; e++) {
+                const traceEvent& ev = buf->events[e % buf->capacity];
+                beginEvent();
+                json.Append("{\"name\":");
+                appendJsonString(json, ev.name);
+                switch (ev.type) {
+                    case completeEvent:
+                        json.AppendFormat(128, ",\"ph\":\"X\",\"ts\":%lld,\"dur\":%lld",
+                            (long long) (ev.time - startTime), (long long) ev.dur);
+                        break;
+                    case counterEvent:
+                        json.AppendFormat(128, ",\"ph\":\"C\",\"ts\":%lld,\"args\":{\"value\":%.17g}",
+                            (long long) (ev.time - startTime), std::isfinite(ev.value) ? ev.value : 0.0);
+                        break;
+                    case instantEvent:
+                        json.AppendFormat(128, ",\"ph\":\"i\",\"s\":\"t\",\"ts\":%lld",
+                            (long long) (ev.time - startTime));
+                        break;
+                }
+                json.AppendFormat(64, ",\"pid\":1,\"tid\":%d}", buf->tid);
+            }
+        }
+    }
+    json.Append("\n],\"displayTimeUnit\":\"ms\"}\n");
+}
+
+//------------------------------------------------------------------------------
+bool
+TraceRecorder::WriteChromeTrace(const char* path) {
+    o_assert_dbg(path);
+    std::FILE* fp = std::fopen(path, "wb");
+    if (nullptr == fp) {
+        return false;
+    }
+    StringBuilder json;
+    WriteChromeTrace(json);
+    const bool success = 1 == std::fwrite(json.AsCStr(), json.Length(), 1, fp);
+    std::fclose(fp);
+    return success;
+}
+
+//------------------------------------------------------------------------------
+int64_t
+TraceRecorder::NumOverwritten() {
+    int64_t num = 0;
+    recorderState& state = getState();
+    SCOPED_LOCK(state.mutex);
+    for (int i = 0; i < state.numBuffers; i++) {
+        threadBuffer* buf = state.buffers[i];
+        SCOPED_LOCK(buf->mutex);
+        if (buf->numEvents > buf->capacity) {
+            num += buf->numEvents - buf->capacity;
+        }
+    }
+    return num;
+}
+
+} // namespace Oryol
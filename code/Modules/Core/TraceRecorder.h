@@ -0,0 +1,88 @@
+#pragma once
+//------------------------------------------------------------------------------
+/**
+    @class Oryol::TraceRecorder
+    @ingroup Core
+    @brief record trace events and write Chrome trace files
+
+    The TraceRecorder records scoped events, counters and instant events
+    into per-thread ring buffers, and writes them as Chrome trace
+    event JSON on demand, which can be loaded into chrome://tracing or
+    ui.perfetto.dev. This allows offline profiling of headless builds.
+
+    In profiling builds with the cmake option ORYOL_TRACE_RECORDER,
+    the o_trace macros (see Core/Trace.h) record into the TraceRecorder
+    instead of Remotery, recording starts in Core::Setup() and the
+    trace is written to oryol_trace.json in Core::Discard(). The
+    TraceRecorder can also be used directly in any build.
+
+    Each thread keeps the most recent TraceSetup::MaxEventsPerThread
+    events. Scopes are recorded as complete events when they end, so
+    scopes which are still open when the trace is written are missing.
+    Event and counter names are referenced by address, so they must
+    be string literals. Timestamps have microsecond resolution (see
+    Clock).
+*/
+#include "Core/Types.h"
+#include "Core/String/StringBuilder.h"
+#include <atomic>
+
+namespace Oryol {
+
+/// trace recorder setup params
+struct TraceSetup {
+    /// number of events each thread keeps, older events are overwritten
+    int MaxEventsPerThread = 64 * 1024;
+};
+
+class TraceRecorder {
+public:
+    /// start recording (discards previously recorded events)
+    static void Start(const TraceSetup& setup=TraceSetup());
+    /// stop recording (recorded events can still be written)
+    static void Stop();
+    /// return true if recording
+    static bool IsRecording();
+
+    /// begin a scope on the calling thread
+    static void Begin(const char* name);
+    /// end the most recent scope on the calling thread
+    static void End();
+    /// record a counter value
+    static void Counter(const char* name, double value);
+    /// record an instant event
+    static void Instant(const char* name);
+    /// set the calling thread's name (copied)
+    static void SetThreadName(const char* name);
+
+    /// write recorded events as Chrome trace JSON
+    static void WriteChromeTrace(StringBuilder& json);
+    /// write recorded events as Chrome trace JSON file
+    static bool WriteChromeTrace(const char* path);
+    /// get number of events which have been overwritten since Start()
+    static int64_t NumOverwritten();
+
+    /// helper class for scoped events
+    class Scope {
+    public:
+        /// constructor, begins scope
+        Scope(const char* name) {
+            TraceRecorder::Begin(name);
+        };
+        /// destructor, ends scope
+        ~Scope() {
+            TraceRecorder::End();
+        };
+    };
+
+private:
+    static std::atomic<bool> recording;
+};
+
+//------------------------------------------------------------------------------
+inline bool
+TraceRecorder::IsRecording() {
+    return recording.load(std::memory_order_relaxed);
+}
+
+} // namespace Oryol
@@ -5,6 +5,7 @@
     @brief defines basic data types for Oryol
 */
 #include <stdint.h>
+#include <type_traits>
 
 namespace Oryol {
 
@@ -28,5 +29,19 @@ static const int32_t EndOfString = -1;
 static const int32_t EndOfFile = -1;
 static const int32_t EndOfRange = -1;
 
+/**
+    @brief true if TYPE objects can be moved in memory with memcpy
+
+    A trivially relocatable object can be moved to another address by
+    copying its bytes, without running the move-constructor and
+    destructor. This is always the case for trivially copyable types,
+    other types (for instance smart pointers which don't point back
+    into themselves) can opt in by specializing this template.
+    The Oryol containers use this to move elements in bulk.
+*/
+template<class TYPE> struct IsTriviallyRelocatable {
+    static const bool value = std::is_trivially_copyable<TYPE>::value;
+};
+
 } // namespace Oryol
 
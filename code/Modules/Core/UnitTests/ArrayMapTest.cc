@@ -152,6 +152,17 @@ TEST(ArrayMapTest) {
     CHECK(map.ValueAtIndex(4) == 4);
     CHECK(map.ValueAtIndex(5) == 7);
     CHECK(map.ValueAtIndex(6) == 2);
-}
-
 
+    // bulk add keeps the value order
+    ArrayMap<int, int> bulkMap;
+    bulkMap.BeginBulk();
+    for (int i = 0; i < 16; i++) {
+        bulkMap.AddBulk(15 - i, i);
+    }
+    bulkMap.EndBulk();
+    CHECK(bulkMap.Size() == 16);
+    for (int i = 0; i < 16; i++) {
+        CHECK(bulkMap.ValueAtIndex(i) == i);
+        CHECK(bulkMap[i] == 15 - i);
+    }
+}
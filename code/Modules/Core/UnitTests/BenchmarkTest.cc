@@ -0,0 +1,107 @@
+//------------------------------------------------------------------------------
+//  BenchmarkTest.cc
+//  Test Benchmark harness.
+//------------------------------------------------------------------------------
+#include "Pre.h"
+#include "UnitTest++/src/UnitTest++.h"
+#include "Core/Benchmark.h"
+#include "Core/Time/Clock.h"
+
+using namespace Oryol;
+
+static int64_t numBenchmarkIterations = 0;
+static int numBenchmarkCalls = 0;
+
+o_benchmark(BenchmarkTestSpin) {
+    numBenchmarkCalls++;
+    int64_t sum = 0;
+    for (int64_t i = 0; i < state.NumIterations(); i++) {
+        for (int j = 0; j < 100; j++) {
+            sum += j;
+        }
+        Benchmark::DoNotOptimize(sum);
+    }
+    numBenchmarkIterations += state.NumIterations();
+}
+
+o_benchmark(BenchmarkTestPaused) {
+    for (int64_t i = 0; i < state.NumIterations(); i++) {
+        state.PauseTiming();
+        const TimePoint start = Clock::Now();
+        while (Clock::Since(start).AsMicroSeconds() < 20.0) { }
+        state.ResumeTiming();
+    }
+}
+
+TEST(BenchmarkSummarizeTest) {
+    Array<double> values;
+    BenchmarkResult res = Benchmark::Summarize("Empty", 10, values);
+    CHECK(res.Name == "Empty");
+    CHECK(res.NumRepetitions == 0);
+    CHECK(res.Mean == 0.0);
+
+    values.Add(4.0);
+    values.Add(1.0);
+    values.Add(3.0);
+    values.Add(2.0);
+    res = Benchmark::Summarize("Test", 10, values);
+    CHECK(res.NumIterations == 10);
+    CHECK(res.NumRepetitions == 4);
+    CHECK_CLOSE(1.0, res.Min, 0.0001);
+    CHECK_CLOSE(4.0, res.Max, 0.0001);
+    CHECK_CLOSE(2.5, res.Median, 0.0001);
+    CHECK_CLOSE(2.5, res.Mean, 0.0001);
+    CHECK_CLOSE(1.2910, res.StdDev, 0.0001);
+    // the input is not modified
+    CHECK(values[0] == 4.0);
+
+    values.Add(100.0);
+    res = Benchmark::Summarize("Test", 10, values);
+    CHECK_CLOSE(3.0, res.Median, 0.0001);
+    CHECK_CLOSE(22.0, res.Mean, 0.0001);
+}
+
+TEST(BenchmarkTest) {
+    Array<String> names = Benchmark::Names();
+    CHECK(names.FindIndexLinear("BenchmarkTestSpin") != InvalidIndex);
+    CHECK(names.FindIndexLinear("BenchmarkTestPaused") != InvalidIndex);
+
+    BenchmarkSetup setup;
+    setup.Filter = "BenchmarkTestSpin";
+    setup.NumWarmups = 2;
+    setup.NumRepetitions = 5;
+    setup.MinRepetitionTime = Duration::FromMilliSeconds(2.0);
+    Array<BenchmarkResult> results = Benchmark::RunAll(setup);
+    CHECK(results.Size() == 1);
+    const BenchmarkResult& res = results[0];
+    CHECK(res.Name == "BenchmarkTestSpin");
+    CHECK(res.NumRepetitions == 5);
+    CHECK(res.NumIterations > 1);
+    CHECK((res.Min > 0.0) && (res.Min <= res.Median) && (res.Median <= res.Max));
+    CHECK((res.Min <= res.Mean) && (res.Mean <= res.Max));
+    // calibration runs + warmups + repetitions
+    CHECK(numBenchmarkCalls > 7);
+    CHECK(numBenchmarkIterations >= 7 * res.NumIterations);
+
+    // paused time isn't measured
+    setup.Filter = "BenchmarkTestPaused";
+    setup.NumWarmups = 0;
+    setup.NumRepetitions = 2;
+    setup.MinRepetitionTime = Duration::FromMilliSeconds(0.1);
+    results = Benchmark::RunAll(setup);
+    CHECK(results.Size() == 1);
+    // each iteration is paused for at least 20us, if that was measured
+    // even the fastest repetition would take longer
+    CHECK(results[0].Min < 20000.0);
+
+    StringBuilder str;
+    Benchmark::WriteText(results, str);
+    CHECK(str.Contains("BenchmarkTestPaused"));
+    str.Clear();
+    Benchmark::WriteJson(results, str);
+    CHECK(str.Contains("{\"benchmarks\":[\n{\"name\":\"BenchmarkTestPaused\",\"iterations\":"));
+    CHECK(str.Contains("\"repetitions\":2,\"unit\":\"ns\",\"min\":"));
+
+    setup.Filter = "NoSuchBenchmark";
+    CHECK(Benchmark::RunAll(setup).Empty());
+}
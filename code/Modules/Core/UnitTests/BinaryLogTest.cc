@@ -0,0 +1,252 @@
+//------------------------------------------------------------------------------
+//  BinaryLogTest.cc
+//  Test BinaryLog class and binary asynchronous logging.
+//------------------------------------------------------------------------------
+#include "Pre.h"
+#include "UnitTest++/src/UnitTest++.h"
+#include "Core/BinaryLog.h"
+#include "Core/Logger.h"
+#include "Core/Containers/Array.h"
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <cstdint>
+#include <cstddef>
+#if ORYOL_HAS_THREADS
+#include <thread>
+#endif
+
+using namespace Oryol;
+
+// encode args, format them again and compare with vsnprintf
+static bool checkFormat(const char* fmt, ...) {
+    va_list args;
+    va_start(args, fmt);
+    va_list argsCopy;
+    va_copy(argsCopy, args);
+    char expected[1024];
+    std::vsnprintf(expected, sizeof(expected), fmt, argsCopy);
+    va_end(argsCopy);
+    uint8_t buf[1024];
+    const int size = BinaryLog::EncodeArgs(fmt, args, buf, sizeof(buf));
+    va_end(args);
+    if (InvalidIndex == size) {
+        return false;
+    }
+    StringBuilder str;
+    if (!BinaryLog::FormatArgs(fmt, buf, size, str)) {
+        return false;
+    }
+    if (str.GetString() != expected) {
+        Log::Warn("BinaryLogFormatTest: '%s' != '%s'\n", str.AsCStr(), expected);
+        return false;
+    }
+    return true;
+}
+
+// encode a message with a small buffer
+static int encodeMessage(uint8_t* buf, int maxSize, const char* fmt, ...) {
+    va_list args;
+    va_start(args, fmt);
+    const int size = BinaryLog::EncodeMessage(fmt, args, buf, maxSize);
+    va_end(args);
+    return size;
+}
+
+TEST(BinaryLogFormatTest) {
+    CHECK(checkFormat("no args\n"));
+    CHECK(checkFormat("%d %i %u %x %X %o", -123, 456, 789u, 0xABCu, 0xDEFu, 8u));
+    CHECK(checkFormat("%5d|%-5d|%05d|%+d|% d", 1, 2, 3, 4, 5));
+    CHECK(checkFormat("%hhd %hd %hu", 300, 70000, 65535));
+    CHECK(checkFormat("%ld %lld %llu %llx", -1234567890l, -12345678901234ll, 18446744073709551615ull, 0x123456789ABCDEFull));
+    CHECK(checkFormat("%zu %jd %td", size_t(123456789012ull), intmax_t(-42), ptrdiff_t(-7)));
+    CHECK(checkFormat("%f %.3f %10.2e %g %G %a", 0.5, 3.14159, 12345.678, 1e-10, 2e20, 1.0));
+    CHECK(checkFormat("%Lf %8.2Lf", (long double) 1.25, (long double) -2.5));
+    CHECK(checkFormat("%c%c%c", 'a', 'b', 'c'));
+    CHECK(checkFormat("%s|%10s|%-10s|%.3s|%s|", "abc", "right", "left", "truncated", ""));
+    CHECK(checkFormat("%p", (void*) &checkFormat));
+    CHECK(checkFormat("%*d|%-*d|%.*f|%*.*s|", 6, 1, 6, 2, 2, 3.14159, 8, 2, "xyz"));
+    CHECK(checkFormat("100%% %d%%", 5));
+    CHECK(checkFormat("%s %d %s %f", "mixed", 1, "args", 2.0));
+
+    // null strings
+    uint8_t buf[256];
+    const char* nullStr = nullptr;
+    int size = encodeMessage(buf, sizeof(buf), "%s", nullStr);
+    CHECK(size > 0);
+    StringBuilder str;
+    CHECK(BinaryLog::FormatArgs("%s", buf + 16, size - 16, str));
+    CHECK(str.GetString() == "(null)");
+
+    // arguments which don't fit
+    CHECK(InvalidIndex == encodeMessage(buf, 8, "no args"));
+    CHECK(16 == encodeMessage(buf, 16, "no args"));
+    CHECK(InvalidIndex == encodeMessage(buf, 20, "%f", 1.0));
+    CHECK(24 == encodeMessage(buf, 24, "%f", 1.0));
+
+    // malformed data
+    str.Clear();
+    CHECK(!BinaryLog::FormatArgs("%d %d", buf + 16, 4, str));
+    CHECK(!BinaryLog::Decode((const uint8_t*) "NOTABLOG\1\0\0\0", 12, str));
+}
+
+#if ORYOL_HAS_THREADS
+class BinaryLogCaptureLogger : public Logger {
+    OryolClassDecl(BinaryLogCaptureLogger);
+public:
+    /// store messages (called with the log lock held)
+    virtual void VPrint(Log::Level /*l*/, const char* msg, va_list args) override {
+        char buf[1024];
+        vsnprintf(buf, sizeof(buf), msg, args);
+        this->Msgs.Add(String(buf));
+    };
+    Array<String> Msgs;
+};
+
+// temporarily replace the attached loggers
+static Array<Ptr<Logger>> replaceLoggers(const Array<Ptr<Logger>>& loggers) {
+    Array<Ptr<Logger>> prevLoggers;
+    while (Log::GetNumLoggers() > 0) {
+        prevLoggers.Add(Log::GetLogger(0));
+        Log::RemoveLogger(prevLoggers.Back());
+    }
+    for (const auto& l : loggers) {
+        Log::AddLogger(l);
+    }
+    return prevLoggers;
+}
+
+// load a whole file
+static Array<uint8_t> loadFile(const char* path) {
+    Array<uint8_t> data;
+    std::FILE* fp = std::fopen(path, "rb");
+    if (fp) {
+        uint8_t buf[4096];
+        size_t num;
+        while ((num = std::fread(buf, 1, sizeof(buf), fp)) > 0) {
+            for (size_t i = 0; i < num; i++) {
+                data.Add(buf[i]);
+            }
+        }
+        std::fclose(fp);
+    }
+    return data;
+}
+
+TEST(BinaryLogAsyncTest) {
+    const char* path = "BinaryLogTest.oblog";
+    Ptr<BinaryLogCaptureLogger> capture = BinaryLogCaptureLogger::Create();
+    const Array<Ptr<Logger>> savedLoggers = replaceLoggers({ capture });
+
+    AsyncLogSetup setup;
+    setup.BufferSize = 4096;
+    setup.Overflow = AsyncLogOverflow::Block;
+    setup.BinaryLogPath = path;
+    Log::StartAsync(setup);
+    CHECK(Log::IsAsync());
+    Log::Info("first %s %d %f\n", "message", 1, 2.5);
+    const int numThreads = 4;
+    const int numMsgs = 2000;
+    std::thread threads[numThreads];
+    for (int t = 0; t < numThreads; t++) {
+        threads[t] = std::thread([t, numMsgs] {
+            for (int i = 0; i < numMsgs; i++) {
+                Log::Dbg("thread %d msg %d %s\n", t, i, (i & 1) ? "odd" : "even");
+            }
+        });
+    }
+    for (int t = 0; t < numThreads; t++) {
+        threads[t].join();
+    }
+    // errors are also written as text
+    Log::Error("error %d\n", 7);
+    Log::StopAsync();
+    CHECK(Log::NumDropped() == 0);
+    CHECK(capture->Msgs.Size() == 1);
+    CHECK(capture->Msgs[0] == "error 7\n");
+
+    // decode the log file
+    Array<uint8_t> data = loadFile(path);
+    std::remove(path);
+    StringBuilder str;
+    CHECK(BinaryLog::Decode(data.Empty() ? nullptr : &data[0], data.Size(), str));
+    Array<String> lines;
+    const String text = str.GetString();
+    const char* cur = text.AsCStr();
+    while (*cur) {
+        const char* end = std::strchr(cur, '\n');
+        lines.Add(String(cur, 0, int(end - cur)));
+        cur = end + 1;
+    }
+    CHECK(lines.Size() == numThreads * numMsgs + 2);
+    CHECK(lines[0] == "first message 1 2.500000");
+    CHECK(lines.Back() == "error 7");
+    int nextMsg[numThreads] = { };
+    int numBad = 0;
+    for (int l = 1; l < lines.Size() - 1; l++) {
+        int t = -1, i = -1;
+        char parity[8] = { };
+        if ((3 == sscanf(lines[l].AsCStr(), "thread %d msg %d %7s", &t, &i, parity)) &&
+            (t >= 0) && (t < numThreads) && (i == nextMsg[t]) &&
+            (0 == std::strcmp(parity, (i & 1) ? "odd" : "even"))) {
+            nextMsg[t]++;
+        }
+        else {
+            numBad++;
+        }
+    }
+    CHECK(numBad == 0);
+
+    // the format strings are only written once
+    CHECK(data.Size() < (numThreads * numMsgs * 48));
+
+    // a file which can't be opened falls back to text
+    capture->Msgs.Clear();
+    setup.BinaryLogPath = "nonexisting_dir/BinaryLogTest.oblog";
+    Log::StartAsync(setup);
+    Log::Info("text %d\n", 1);
+    Log::StopAsync();
+    CHECK(capture->Msgs.Size() == 2);
+    CHECK(capture->Msgs.Back() == "text 1\n");
+
+    replaceLoggers(savedLoggers);
+}
+
+class BinaryLogCountLogger : public Logger {
+    OryolClassDecl(BinaryLogCountLogger);
+public:
+    /// format and count messages
+    virtual void VPrint(Log::Level /*l*/, const char* msg, va_list args) override {
+        char buf[256];
+        vsnprintf(buf, sizeof(buf), msg, args);
+        this->Count++;
+    };
+    int Count = 0;
+};
+
+TEST(BinaryLogPerformance) {
+    const char* path = "BinaryLogPerformance.oblog";
+    Ptr<BinaryLogCountLogger> counter = BinaryLogCountLogger::Create();
+    const Array<Ptr<Logger>> savedLoggers = replaceLoggers({ counter });
+    const int numMsgs = 200000;
+    StringBuilder results;
+    for (int binary = 0; binary < 2; binary++) {
+        AsyncLogSetup setup;
+        setup.BufferSize = 1024 * 1024;
+        setup.Overflow = AsyncLogOverflow::Block;
+        setup.BinaryLogPath = binary ? path : nullptr;
+        Log::StartAsync(setup);
+        std::chrono::time_point<std::chrono::system_clock> start = std::chrono::system_clock::now();
+        for (int i = 0; i < numMsgs; i++) {
+            Log::Info("message %d, value %f, name %s\n", i, i * 0.5f, "bla");
+        }
+        std::chrono::duration<double> dur = std::chrono::system_clock::now() - start;
+        Log::StopAsync();
+        results.AppendFormat(256, "Log async %s: %d calls: %f sec (%.1f ns/call)\n",
+            binary ? "binary" : "text", numMsgs, dur.count(), (dur.count() * 1e9) / numMsgs);
+    }
+    std::remove(path);
+    replaceLoggers(savedLoggers);
+    Log::Info("%s", results.AsCStr());
+}
+#endif
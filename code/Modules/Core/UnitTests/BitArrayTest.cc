@@ -0,0 +1,197 @@
+//------------------------------------------------------------------------------
+//  BitArrayTest.cc
+//  Test BitArray class.
+//------------------------------------------------------------------------------
+#include "Pre.h"
+#include "UnitTest++/src/UnitTest++.h"
+#include "Core/Containers/BitArray.h"
+#include "Core/Containers/Array.h"
+#include "Core/Log.h"
+#include <chrono>
+
+using namespace Oryol;
+
+TEST(BitArrayTest) {
+    BitArray bits0;
+    CHECK(bits0.Size() == 0);
+    CHECK(bits0.Empty());
+    CHECK(bits0.None());
+    CHECK(bits0.All());
+    CHECK(bits0.PopCount() == 0);
+    CHECK(bits0.FindFirstSet() == InvalidIndex);
+    CHECK(bits0.FindFirstClear() == InvalidIndex);
+    CHECK(bits0.FindLastSet() == InvalidIndex);
+
+    // single bits across word boundaries
+    BitArray bits1(130);
+    CHECK(bits1.Size() == 130);
+    CHECK(!bits1.Empty());
+    CHECK(bits1.None());
+    CHECK(bits1.FindFirstClear() == 0);
+    bits1.Set(0);
+    bits1.Set(63);
+    bits1.Set(64);
+    bits1.Set(129);
+    CHECK(bits1.Test(0));
+    CHECK(!bits1.Test(1));
+    CHECK(bits1[63]);
+    CHECK(bits1[64]);
+    CHECK(bits1[129]);
+    CHECK(bits1.Any());
+    CHECK(bits1.PopCount() == 4);
+    CHECK(bits1.FindFirstSet() == 0);
+    CHECK(bits1.FindFirstSet(1) == 63);
+    CHECK(bits1.FindFirstSet(64) == 64);
+    CHECK(bits1.FindFirstSet(65) == 129);
+    CHECK(bits1.FindFirstSet(130) == InvalidIndex);
+    CHECK(bits1.FindLastSet() == 129);
+    CHECK(bits1.FindFirstClear() == 1);
+    bits1.Clear(129);
+    CHECK(bits1.FindLastSet() == 64);
+    bits1.Flip(64);
+    CHECK(!bits1[64]);
+    bits1.Assign(100, true);
+    CHECK(bits1[100]);
+    bits1.Assign(100, false);
+    CHECK(!bits1[100]);
+
+    // iterate over set bits
+    Array<int> indices;
+    for (int i = bits1.FindFirstSet(); i != InvalidIndex; i = bits1.FindFirstSet(i + 1)) {
+        indices.Add(i);
+    }
+    CHECK(indices.Size() == 2);
+    CHECK(indices[0] == 0);
+    CHECK(indices[1] == 63);
+    indices.Clear();
+    bits1.ForEachSet([&indices](int i) {
+        indices.Add(i);
+    });
+    CHECK(indices.Size() == 2);
+    CHECK(indices[0] == 0);
+    CHECK(indices[1] == 63);
+
+    // ranges
+    bits1.ClearAll();
+    bits1.SetRange(60, 10);
+    CHECK(bits1.PopCount() == 10);
+    CHECK(bits1.FindFirstSet() == 60);
+    CHECK(bits1.FindLastSet() == 69);
+    CHECK(bits1.FindFirstClear(60) == 70);
+    bits1.ClearRange(62, 4);
+    CHECK(bits1.PopCount() == 6);
+    CHECK(bits1.FindFirstClear(60) == 62);
+    CHECK(bits1.FindFirstSet(62) == 66);
+    bits1.SetRange(0, 130);
+    CHECK(bits1.All());
+    CHECK(bits1.PopCount() == 130);
+    CHECK(bits1.FindFirstClear() == InvalidIndex);
+    bits1.ClearRange(0, 64);
+    CHECK(bits1.PopCount() == 66);
+    CHECK(bits1.FindFirstSet() == 64);
+
+    // SetAll must not set bits beyond the end
+    bits1.ClearAll();
+    CHECK(bits1.None());
+    bits1.SetAll();
+    CHECK(bits1.All());
+    CHECK(bits1.PopCount() == 130);
+    CHECK(bits1.FindLastSet() == 129);
+
+    // resize keeps content, new bits are cleared
+    bits1.Resize(200);
+    CHECK(bits1.Size() == 200);
+    CHECK(bits1.PopCount() == 130);
+    CHECK(bits1.FindFirstClear() == 130);
+    bits1.Resize(70);
+    CHECK(bits1.PopCount() == 70);
+    CHECK(bits1.All());
+    bits1.Resize(100);
+    CHECK(bits1.PopCount() == 70);
+    CHECK(bits1.FindFirstClear() == 70);
+
+    // copy and move
+    BitArray bits2(bits1);
+    CHECK(bits2.Size() == 100);
+    CHECK(bits2.PopCount() == 70);
+    BitArray bits3(std::move(bits2));
+    CHECK(bits2.Empty());
+    CHECK(bits3.Size() == 100);
+    CHECK(bits3.PopCount() == 70);
+    bits2 = bits3;
+    CHECK(bits2.Size() == 100);
+    bits2.Clear(0);
+    CHECK(bits3[0]);
+    bits0 = std::move(bits2);
+    CHECK(bits0.Size() == 100);
+    CHECK(bits0.PopCount() == 69);
+    CHECK(bits2.Empty());
+}
+
+TEST(BitArrayPerformance) {
+    const int num = 1<<20;
+    const int numRuns = 100;
+
+    // sparse occupancy, one flag in 100
+    Array<uint8_t> flags;
+    flags.Reserve(num);
+    BitArray bits(num);
+    for (int i = 0; i < num; i++) {
+        const bool set = (i % 100) == 0;
+        flags.Add(set ? 1 : 0);
+        if (set) {
+            bits.Set(i);
+        }
+    }
+
+    std::chrono::time_point<std::chrono::system_clock> start, end;
+    std::chrono::duration<double> dur;
+    int64_t sum = 0;
+
+    start = std::chrono::system_clock::now();
+    for (int run = 0; run < numRuns; run++) {
+        for (int i = 0; i < num; i++) {
+            if (flags[i]) {
+                sum += i;
+            }
+        }
+    }
+    end = std::chrono::system_clock::now();
+    dur = end - start;
+    Log::Info("Array<uint8_t>: %d x iterate %d sparse flags: %f sec\n", numRuns, num, dur.count());
+    const int64_t refSum = sum;
+
+    sum = 0;
+    start = std::chrono::system_clock::now();
+    for (int run = 0; run < numRuns; run++) {
+        bits.ForEachSet([&sum](int i) {
+            sum += i;
+        });
+    }
+    end = std::chrono::system_clock::now();
+    dur = end - start;
+    Log::Info("BitArray: %d x iterate %d sparse flags: %f sec\n", numRuns, num, dur.count());
+    CHECK(sum == refSum);
+
+    int count = 0;
+    start = std::chrono::system_clock::now();
+    for (int run = 0; run < numRuns; run++) {
+        for (int i = 0; i < num; i++) {
+            count += flags[i];
+        }
+    }
+    end = std::chrono::system_clock::now();
+    dur = end - start;
+    Log::Info("Array<uint8_t>: %d x count %d flags: %f sec\n", numRuns, num, dur.count());
+    const int refCount = count;
+
+    count = 0;
+    start = std::chrono::system_clock::now();
+    for (int run = 0; run < numRuns; run++) {
+        count += bits.PopCount();
+    }
+    end = std::chrono::system_clock::now();
+    dur = end - start;
+    Log::Info("BitArray: %d x count %d flags: %f sec\n", numRuns, num, dur.count());
+    CHECK(count == refCount);
+}
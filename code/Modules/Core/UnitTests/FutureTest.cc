@@ -0,0 +1,200 @@
+//------------------------------------------------------------------------------
+//  FutureTest.cc
+//  Test Future and Promise classes.
+//------------------------------------------------------------------------------
+#include "Pre.h"
+#include "UnitTest++/src/UnitTest++.h"
+#include "Core/Threading/Future.h"
+#include "Core/Containers/Buffer.h"
+#include "Core/String/String.h"
+#if ORYOL_HAS_THREADS
+#include <thread>
+#endif
+
+using namespace Oryol;
+
+TEST(FutureTest) {
+    RunLoop runLoop;
+
+    // continuations are called in the next Run() after resolving
+    Promise<int> promise;
+    Future<int> future = promise.GetFuture();
+    CHECK(future.IsValid());
+    CHECK(future.IsPending());
+    int result = 0;
+    future.Then([&result](int val) {
+        result = val;
+    }, nullptr, &runLoop);
+    runLoop.Run();
+    CHECK(result == 0);
+    promise.Resolve(23);
+    CHECK(future.IsResolved());
+    CHECK(result == 0);
+    runLoop.Run();
+    CHECK(result == 23);
+    runLoop.Run();
+    CHECK(result == 23);
+
+    // a continuation attached after resolving is called in the next Run()
+    Promise<int> promise1;
+    promise1.Resolve(5);
+    result = 0;
+    promise1.GetFuture().Then([&result](int val) {
+        result = val;
+    }, nullptr, &runLoop);
+    CHECK(result == 0);
+    runLoop.Run();
+    CHECK(result == 5);
+
+    // a chain of continuations is called in one Run()
+    Promise<int> promise2;
+    Array<String> order;
+    Future<void> last = promise2.GetFuture().Then([&order](int val) {
+        order.Add("first");
+        return val * 2;
+    }, nullptr, &runLoop).Then([&order](int val) {
+        order.Add("second");
+        return String(val == 42 ? "yes" : "no");
+    }, nullptr, &runLoop).Then([&order](String str) {
+        order.Add(str);
+    }, nullptr, &runLoop);
+    int numVoid = 0;
+    last.Then([&numVoid] {
+        numVoid++;
+    }, nullptr, &runLoop);
+    promise2.Resolve(21);
+    runLoop.Run();
+    CHECK(order.Size() == 3);
+    CHECK(order[0] == "first");
+    CHECK(order[1] == "second");
+    CHECK(order[2] == "yes");
+    CHECK(last.IsResolved());
+    CHECK(numVoid == 1);
+
+    // move-only values
+    Promise<Buffer> promise3;
+    int numBytes = 0;
+    promise3.GetFuture().Then([&numBytes](Buffer buf) {
+        numBytes = buf.Size();
+    }, nullptr, &runLoop);
+    Buffer buf;
+    buf.Add(16);
+    promise3.Resolve(std::move(buf));
+    runLoop.Run();
+    CHECK(numBytes == 16);
+}
+
+TEST(FutureFailTest) {
+    RunLoop runLoop;
+
+    // failures are passed down the chain
+    Promise<int> promise;
+    int numResolved = 0;
+    int numFailed = 0;
+    Future<int> next = promise.GetFuture().Then([&numResolved](int val) {
+        numResolved++;
+        return val;
+    }, [&numFailed] {
+        numFailed++;
+    }, &runLoop);
+    int numNextFailed = 0;
+    Future<void> last = next.Then([&numResolved](int) {
+        numResolved++;
+    }, [&numNextFailed] {
+        numNextFailed++;
+    }, &runLoop);
+    promise.Fail();
+    CHECK(!promise.IsPending());
+    runLoop.Run();
+    CHECK(numResolved == 0);
+    CHECK(numFailed == 1);
+    CHECK(numNextFailed == 1);
+    CHECK(next.IsFailed());
+    CHECK(last.IsFailed());
+
+    // a Promise which goes away fails
+    Future<int> future;
+    numFailed = 0;
+    {
+        Promise<int> brokenPromise;
+        future = brokenPromise.GetFuture();
+        future.Then([](int) { }, [&numFailed] { numFailed++; }, &runLoop);
+    }
+    CHECK(future.IsFailed());
+    runLoop.Run();
+    CHECK(numFailed == 1);
+
+    // cancelled continuations aren't called
+    Promise<int> promise1;
+    Future<int> future1 = promise1.GetFuture();
+    numResolved = 0;
+    future1.Then([&numResolved](int) { numResolved++; }, nullptr, &runLoop);
+    future1.Cancel();
+    promise1.Resolve(1);
+    runLoop.Run();
+    CHECK(numResolved == 0);
+
+    // cancel after resolving, before the RunLoop runs
+    Promise<int> promise2;
+    Future<int> future2 = promise2.GetFuture();
+    future2.Then([&numResolved](int) { numResolved++; }, nullptr, &runLoop);
+    promise2.Resolve(1);
+    future2.Cancel();
+    runLoop.Run();
+    CHECK(numResolved == 0);
+}
+
+TEST(FutureRunLoopTest) {
+    // the default RunLoop is the thread's PreRunLoop
+    Core::Setup();
+    Promise<void> promise;
+    int num = 0;
+    promise.GetFuture().Then([&num] {
+        num++;
+    });
+    promise.Resolve();
+    CHECK(num == 0);
+    Core::PreRunLoop()->Run();
+    CHECK(num == 1);
+    Core::Discard();
+}
+
+#if ORYOL_HAS_THREADS
+TEST(FutureThreadTest) {
+    // resolve on worker threads, continuations are called on the owner thread
+    RunLoop runLoop;
+    const int numPromises = 64;
+    Promise<int> promises[numPromises];
+    const std::thread::id ownerThread = std::this_thread::get_id();
+    int sum = 0;
+    int numDone = 0;
+    bool allOnOwnerThread = true;
+    for (int i = 0; i < numPromises; i++) {
+        promises[i].GetFuture().Then([](int val) {
+            return val * 2;
+        }, nullptr, &runLoop).Then([&sum, &numDone, &allOnOwnerThread, ownerThread](int val) {
+            allOnOwnerThread &= ownerThread == std::this_thread::get_id();
+            sum += val;
+            numDone++;
+        }, nullptr, &runLoop);
+    }
+    std::thread worker0([&promises] {
+        for (int i = 0; i < numPromises; i += 2) {
+            promises[i].Resolve(i);
+        }
+    });
+    std::thread worker1([&promises] {
+        for (int i = 1; i < numPromises; i += 2) {
+            promises[i].Resolve(i);
+        }
+    });
+    while (numDone < numPromises) {
+        runLoop.Run();
+        std::this_thread::yield();
+    }
+    worker0.join();
+    worker1.join();
+    CHECK(allOnOwnerThread);
+    CHECK(sum == numPromises * (numPromises - 1));
+}
+#endif
@@ -137,3 +137,57 @@ TEST(HashSetTest) {
     CHECK(hashSet4.Size() == 0);
     CHECK(!hashSet4.Contains(10));
 }
+
+TEST(HashSetGrowTest) {
+
+    // add enough elements to trigger several incremental rehashes
+    HashSet<int, IntHasher, 4> hashSet;
+    const int maxLoad = HashSet<int, IntHasher, 4>::MaxLoad;
+    CHECK(hashSet.NumBuckets() == 4);
+    const int num = 10000;
+    for (int i = 0; i < num; i++) {
+        hashSet.Add(i * 7);
+        CHECK(hashSet.Contains(i * 7));
+    }
+    CHECK(hashSet.Size() == num);
+    CHECK(hashSet.NumBuckets() > 4);
+    CHECK(hashSet.NumBuckets() * maxLoad >= num);
+    for (int i = 0; i < num; i++) {
+        CHECK(hashSet.Contains(i * 7));
+        CHECK(!hashSet.Contains(i * 7 + 1));
+    }
+
+    // copy in the middle of a rehash
+    HashSet<int, IntHasher, 4> hashSet1(hashSet);
+    CHECK(hashSet1.Size() == num);
+    CHECK(hashSet1.Contains(7 * 1234));
+
+    // erase every other element, erasing non-existing elements is a no-op
+    for (int i = 0; i < num; i += 2) {
+        hashSet.Erase(i * 7);
+        hashSet.Erase(i * 7 + 1);
+    }
+    CHECK(hashSet.Size() == num / 2);
+    CHECK(!hashSet.IsRehashing());
+    for (int i = 0; i < num; i++) {
+        CHECK(hashSet.Contains(i * 7) == ((i & 1) == 1));
+    }
+    CHECK(hashSet1.Size() == num);
+
+    // reserve upfront, no rehash must happen while adding
+    HashSet<int, IntHasher, 4> hashSet2;
+    hashSet2.Reserve(num);
+    const int numBuckets = hashSet2.NumBuckets();
+    CHECK(numBuckets * maxLoad >= num);
+    for (int i = 0; i < num; i++) {
+        hashSet2.Add(i);
+    }
+    CHECK(hashSet2.NumBuckets() == numBuckets);
+    CHECK(!hashSet2.IsRehashing());
+
+    // clear keeps the bucket table
+    hashSet2.Clear();
+    CHECK(hashSet2.Empty());
+    CHECK(hashSet2.NumBuckets() == numBuckets);
+    CHECK(!hashSet2.Contains(0));
+}
@@ -0,0 +1,336 @@
+//------------------------------------------------------------------------------
+//  JobSystemTest.cc
+//  Test WorkStealingDeque and JobSystem.
+//------------------------------------------------------------------------------
+#include "Pre.h"
+#include "UnitTest++/src/UnitTest++.h"
+#include "Core/Containers/WorkStealingDeque.h"
+#include "Core/Threading/JobSystem.h"
+#include "Core/Containers/Array.h"
+#include "Core/Log.h"
+#include <atomic>
+#include <chrono>
+#if ORYOL_HAS_THREADS
+#include <thread>
+#endif
+
+using namespace Oryol;
+
+namespace {
+
+//------------------------------------------------------------------------------
+// recursively split a range into jobs, wait for the children from
+// inside the job (this only works because Wait() executes jobs)
+void
+sumRange(const int* values, int num, std::atomic<int64_t>* sum) {
+    if (num <= 64) {
+        int64_t localSum = 0;
+        for (int i = 0; i < num; i++) {
+            localSum += values[i];
+        }
+        sum->fetch_add(localSum);
+        return;
+    }
+    JobCounter counter;
+    const int half = num / 2;
+    JobSystem::Run([values, half, sum] { sumRange(values, half, sum); }, &counter);
+    JobSystem::Run([values, half, num, sum] { sumRange(values + half, num - half, sum); }, &counter);
+    JobSystem::Wait(counter);
+}
+
+//------------------------------------------------------------------------------
+void
+testJobs(int numWorkers) {
+    JobSetup setup;
+    setup.NumWorkers = numWorkers;
+    setup.MaxJobsPerThread = 256;
+    JobSystem::Setup(setup);
+    CHECK(JobSystem::IsValid());
+    #if ORYOL_HAS_THREADS
+    CHECK(JobSystem::NumWorkers() == numWorkers);
+    #else
+    CHECK(JobSystem::NumWorkers() == 0);
+    #endif
+    CHECK(JobSystem::NumThreads() == JobSystem::NumWorkers() + 1);
+
+    // many small jobs, more than fit into the deque
+    {
+        JobCounter counter;
+        CHECK(counter.Done());
+        std::atomic<int> num(0);
+        for (int i = 0; i < 1000; i++) {
+            JobSystem::Run([&num] { num++; }, &counter);
+        }
+        JobSystem::Wait(counter);
+        CHECK(counter.Done());
+        CHECK(counter.Value() == 0);
+        CHECK(num == 1000);
+
+        // counters can be reused after Wait()
+        JobSystem::Run([&num] { num++; }, &counter);
+        JobSystem::Wait(counter);
+        CHECK(num == 1001);
+    }
+
+    // nested jobs waiting for their children
+    {
+        Array<int> values;
+        int64_t expected = 0;
+        for (int i = 0; i < 100000; i++) {
+            values.Add(i);
+            expected += i;
+        }
+        std::atomic<int64_t> sum(0);
+        JobCounter counter;
+        const int* ptr = &values[0];
+        JobSystem::Run([ptr, &sum] { sumRange(ptr, 100000, &sum); }, &counter);
+        JobSystem::Wait(counter);
+        CHECK(sum == expected);
+    }
+
+    // dependencies: each stage must only start after the previous stage
+    {
+        const int numStages = 8;
+        const int numJobsPerStage = 16;
+        JobCounter counters[numStages];
+        std::atomic<int> stageDone[numStages];
+        std::atomic<int> numOrderErrors(0);
+        for (int i = 0; i < numStages; i++) {
+            stageDone[i] = 0;
+        }
+        for (int stage = 0; stage < numStages; stage++) {
+            JobCounter* dep = stage > 0 ? &counters[stage - 1] : nullptr;
+            for (int i = 0; i < numJobsPerStage; i++) {
+                JobSystem::Run([stage, &stageDone, &numOrderErrors] {
+                    if ((stage > 0) && (stageDone[stage - 1] != numJobsPerStage)) {
+                        numOrderErrors++;
+                    }
+                    stageDone[stage]++;
+                }, &counters[stage], dep);
+            }
+        }
+        JobSystem::Wait(counters[numStages - 1]);
+        CHECK(numOrderErrors == 0);
+        for (int i = 0; i < numStages; i++) {
+            CHECK(counters[i].Done());
+            CHECK(stageDone[i] == numJobsPerStage);
+        }
+        // depending on a finished counter starts the job right away
+        std::atomic<int> num(0);
+        JobCounter counter;
+        JobSystem::Run([&num] { num++; }, &counter, &counters[0]);
+        JobSystem::Wait(counter);
+        CHECK(num == 1);
+    }
+
+    // large captures go to the heap
+    {
+        struct bigData {
+            int values[64];
+        };
+        bigData data;
+        for (int i = 0; i < 64; i++) {
+            data.values[i] = i;
+        }
+        std::atomic<int> sum(0);
+        JobCounter counter;
+        for (int i = 0; i < 16; i++) {
+            JobSystem::Run([data, &sum] {
+                int localSum = 0;
+                for (int i = 0; i < 64; i++) {
+                    localSum += data.values[i];
+                }
+                sum += localSum;
+            }, &counter);
+        }
+        JobSystem::Wait(counter);
+        CHECK(sum == 16 * ((63 * 64) / 2));
+    }
+
+    #if ORYOL_HAS_THREADS
+    // jobs started from a thread which isn't known to the job system
+    {
+        std::atomic<int> num(0);
+        JobCounter counter;
+        std::thread thread([&num, &counter] {
+            for (int i = 0; i < 100; i++) {
+                JobSystem::Run([&num] { num++; }, &counter);
+            }
+            JobSystem::Wait(counter);
+        });
+        thread.join();
+        CHECK(num == 100);
+        CHECK(counter.Done());
+    }
+    #endif
+
+    JobSystem::Discard();
+    CHECK(!JobSystem::IsValid());
+}
+
+//------------------------------------------------------------------------------
+float
+busyWork(int seed) {
+    float f = float(seed);
+    for (int i = 0; i < 2000; i++) {
+        f = f * 0.999f + 1.0f;
+    }
+    return f;
+}
+
+} // anonymous namespace
+
+//------------------------------------------------------------------------------
+TEST(WorkStealingDequeTest) {
+    WorkStealingDeque<int> deque(5);
+    CHECK(deque.Capacity() == 8);
+    CHECK(deque.Empty());
+    int val = 0;
+    CHECK(!deque.Pop(val));
+    CHECK(!deque.Steal(val));
+    for (int i = 0; i < 8; i++) {
+        CHECK(deque.Push(i));
+    }
+    CHECK(!deque.Push(8));
+    CHECK(deque.Size() == 8);
+
+    // owner pops LIFO, thieves steal FIFO
+    CHECK(deque.Pop(val));
+    CHECK(val == 7);
+    CHECK(deque.Steal(val));
+    CHECK(val == 0);
+    CHECK(deque.Steal(val));
+    CHECK(val == 1);
+    CHECK(deque.Pop(val));
+    CHECK(val == 6);
+    CHECK(deque.Size() == 4);
+    for (int i = 5; i >= 2; i--) {
+        CHECK(deque.Pop(val));
+        CHECK(val == i);
+    }
+    CHECK(!deque.Pop(val));
+    CHECK(!deque.Steal(val));
+    CHECK(deque.Empty());
+
+    // wrap around
+    for (int i = 0; i < 100; i++) {
+        CHECK(deque.Push(i));
+        CHECK(deque.Push(i + 1000));
+        CHECK(deque.Steal(val));
+        CHECK(val == i);
+        CHECK(deque.Pop(val));
+        CHECK(val == i + 1000);
+    }
+    CHECK(deque.Empty());
+}
+
+#if ORYOL_HAS_THREADS
+//------------------------------------------------------------------------------
+TEST(WorkStealingDequeStressTest) {
+    // the owner pushes and pops, thieves steal, every element
+    // must come out exactly once
+    const int numItems = 200000;
+    const int numThieves = 3;
+    WorkStealingDeque<int> deque(64);
+    std::atomic<bool> ownerDone(false);
+    std::atomic<int64_t> sum(0);
+    std::atomic<int> count(0);
+    Array<std::thread> thieves;
+    for (int t = 0; t < numThieves; t++) {
+        thieves.Add(std::thread([&deque, &ownerDone, &sum, &count] {
+            int64_t localSum = 0;
+            int localCount = 0;
+            int val = 0;
+            while (!ownerDone.load() || !deque.Empty()) {
+                if (deque.Steal(val)) {
+                    localSum += val;
+                    localCount++;
+                }
+                else {
+                    std::this_thread::yield();
+                }
+            }
+            sum += localSum;
+            count += localCount;
+        }));
+    }
+    int64_t localSum = 0;
+    int localCount = 0;
+    int val = 0;
+    for (int i = 1; i <= numItems; i++) {
+        while (!deque.Push(i)) {
+            if (deque.Pop(val)) {
+                localSum += val;
+                localCount++;
+            }
+        }
+        if ((i % 3) == 0 && deque.Pop(val)) {
+            localSum += val;
+            localCount++;
+        }
+    }
+    while (deque.Pop(val)) {
+        localSum += val;
+        localCount++;
+    }
+    ownerDone = true;
+    for (auto& t : thieves) {
+        t.join();
+    }
+    sum += localSum;
+    count += localCount;
+    CHECK(count == numItems);
+    CHECK(sum == (int64_t(numItems) * (numItems + 1)) / 2);
+}
+#endif
+
+//------------------------------------------------------------------------------
+TEST(JobSystemTest) {
+    testJobs(0);
+    #if ORYOL_HAS_THREADS
+    testJobs(1);
+    testJobs(3);
+    #endif
+}
+
+//------------------------------------------------------------------------------
+TEST(JobSystemPerformance) {
+    const int numJobs = 100000;
+    int maxWorkers = 0;
+    #if ORYOL_HAS_THREADS
+    maxWorkers = int(std::thread::hardware_concurrency()) - 1;
+    if (maxWorkers < 1) {
+        maxWorkers = 1;
+    }
+    #endif
+    std::chrono::time_point<std::chrono::system_clock> start, end;
+    std::chrono::duration<double> dur;
+
+    // baseline: the same work without jobs
+    start = std::chrono::system_clock::now();
+    Array<float> results;
+    results.Reserve(numJobs);
+    for (int i = 0; i < numJobs; i++) {
+        results.Add(busyWork(i));
+    }
+    end = std::chrono::system_clock::now();
+    dur = end - start;
+    Log::Info("JobSystem baseline: %d work items: %f sec\n", numJobs, dur.count());
+
+    for (int numWorkers = 0; numWorkers <= maxWorkers; numWorkers++) {
+        JobSetup setup;
+        setup.NumWorkers = numWorkers;
+        JobSystem::Setup(setup);
+        start = std::chrono::system_clock::now();
+        JobCounter counter;
+        for (int i = 0; i < numJobs; i++) {
+            float* result = &results[i];
+            JobSystem::Run([i, result] { *result = busyWork(i); }, &counter);
+        }
+        JobSystem::Wait(counter);
+        end = std::chrono::system_clock::now();
+        dur = end - start;
+        Log::Info("JobSystem %d threads: %d jobs: %f sec\n", JobSystem::NumThreads(), numJobs, dur.count());
+        JobSystem::Discard();
+    }
+}
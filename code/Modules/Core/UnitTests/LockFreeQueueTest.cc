@@ -0,0 +1,236 @@
+//------------------------------------------------------------------------------
+//  LockFreeQueueTest.cc
+//  Test SPSCQueue and MPMCQueue.
+//------------------------------------------------------------------------------
+#include "Pre.h"
+#include "UnitTest++/src/UnitTest++.h"
+#include "Core/Containers/SPSCQueue.h"
+#include "Core/Containers/MPMCQueue.h"
+#include "Core/Containers/Array.h"
+#include "Core/RefCounted.h"
+#include "Core/Ptr.h"
+#include "Core/Log.h"
+#include <chrono>
+#if ORYOL_HAS_THREADS
+#include <thread>
+#include <atomic>
+#endif
+
+using namespace Oryol;
+
+namespace {
+
+class queueItem : public RefCounted {
+    OryolClassDecl(queueItem);
+public:
+    queueItem(int v) : value(v) { };
+    int value;
+};
+
+struct moveOnly {
+    moveOnly() : value(0) { };
+    moveOnly(int v) : value(v) { };
+    moveOnly(const moveOnly& rhs) = delete;
+    void operator=(const moveOnly& rhs) = delete;
+    moveOnly(moveOnly&& rhs) : value(rhs.value) { rhs.value = 0; };
+    void operator=(moveOnly&& rhs) { value = rhs.value; rhs.value = 0; };
+    int value;
+};
+
+//------------------------------------------------------------------------------
+template<class QUEUE> void
+testSingleThreaded() {
+    QUEUE queue(5);
+    CHECK(queue.Capacity() == 8);
+    CHECK(queue.Size() == 0);
+    CHECK(queue.Empty());
+
+    int val = 0;
+    CHECK(!queue.Dequeue(val));
+    for (int i = 0; i < 8; i++) {
+        CHECK(queue.Enqueue(i));
+    }
+    CHECK(queue.Size() == 8);
+    CHECK(!queue.Empty());
+    CHECK(!queue.Enqueue(8));
+    for (int i = 0; i < 8; i++) {
+        CHECK(queue.Dequeue(val));
+        CHECK(val == i);
+    }
+    CHECK(!queue.Dequeue(val));
+    CHECK(queue.Empty());
+
+    // wrap around several times
+    int next = 0;
+    for (int i = 0; i < 100; i++) {
+        CHECK(queue.Enqueue(i * 2));
+        CHECK(queue.Enqueue(i * 2 + 1));
+        CHECK(queue.Dequeue(val));
+        CHECK(val == next++);
+        CHECK(queue.Dequeue(val));
+        CHECK(val == next++);
+    }
+    CHECK(queue.Empty());
+}
+
+//------------------------------------------------------------------------------
+template<template<class> class QUEUE> void
+testMoveOnly() {
+    {
+        QUEUE<moveOnly> queue(4);
+        CHECK(queue.Enqueue(moveOnly(1)));
+        moveOnly m(2);
+        CHECK(queue.Enqueue(std::move(m)));
+        CHECK(m.value == 0);
+        moveOnly out;
+        CHECK(queue.Dequeue(out));
+        CHECK(out.value == 1);
+        CHECK(queue.Dequeue(out));
+        CHECK(out.value == 2);
+    }
+    {
+        Ptr<queueItem> item = queueItem::Create(3);
+        {
+            QUEUE<Ptr<queueItem>> queue(4);
+            CHECK(queue.Enqueue(item));
+            CHECK(item->GetRefCount() == 2);
+            CHECK(queue.Enqueue(queueItem::Create(4)));
+            Ptr<queueItem> out;
+            CHECK(queue.Dequeue(out));
+            CHECK(out->value == 3);
+            CHECK(item->GetRefCount() == 2);
+            out = nullptr;
+            CHECK(item->GetRefCount() == 1);
+            // the remaining element must be released by the destructor
+            CHECK(queue.Enqueue(std::move(item)));
+            CHECK(!item);
+            CHECK(queue.Dequeue(item));
+            CHECK(item->GetRefCount() == 1);
+            CHECK(queue.Enqueue(item));
+        }
+        CHECK(item->GetRefCount() == 1);
+    }
+}
+
+#if ORYOL_HAS_THREADS
+//------------------------------------------------------------------------------
+// push numItems per producer through the queue, each consumer sums up
+// what it receives, returns the total sum over all consumers
+template<class QUEUE> int64_t
+runThreads(QUEUE& queue, int numProducers, int numConsumers, int numItems) {
+    std::atomic<int> numProducersDone(0);
+    std::atomic<int64_t> sum(0);
+    Array<std::thread> threads;
+    for (int p = 0; p < numProducers; p++) {
+        threads.Add(std::thread([&queue, &numProducersDone, numItems, p] {
+            for (int i = 0; i < numItems; i++) {
+                const int val = p * numItems + i + 1;
+                while (!queue.Enqueue(val)) {
+                    std::this_thread::yield();
+                }
+            }
+            numProducersDone++;
+        }));
+    }
+    for (int c = 0; c < numConsumers; c++) {
+        threads.Add(std::thread([&queue, &numProducersDone, &sum, numProducers] {
+            int64_t localSum = 0;
+            int val = 0;
+            for (;;) {
+                if (queue.Dequeue(val)) {
+                    localSum += val;
+                }
+                else if (numProducersDone.load() == numProducers) {
+                    // producers are done, drain what's left
+                    while (queue.Dequeue(val)) {
+                        localSum += val;
+                    }
+                    break;
+                }
+                else {
+                    std::this_thread::yield();
+                }
+            }
+            sum += localSum;
+        }));
+    }
+    for (auto& t : threads) {
+        t.join();
+    }
+    return sum.load();
+}
+
+//------------------------------------------------------------------------------
+int64_t
+expectedSum(int numProducers, int numItems) {
+    const int64_t n = int64_t(numProducers) * numItems;
+    return (n * (n + 1)) / 2;
+}
+#endif
+
+} // anonymous namespace
+
+//------------------------------------------------------------------------------
+TEST(SPSCQueueTest) {
+    testSingleThreaded<SPSCQueue<int>>();
+    testMoveOnly<SPSCQueue>();
+    SPSCQueue<int> queue(1);
+    CHECK(queue.Capacity() == 1);
+}
+
+//------------------------------------------------------------------------------
+TEST(MPMCQueueTest) {
+    testSingleThreaded<MPMCQueue<int>>();
+    testMoveOnly<MPMCQueue>();
+    MPMCQueue<int> queue(1);
+    CHECK(queue.Capacity() == 2);
+}
+
+#if ORYOL_HAS_THREADS
+//------------------------------------------------------------------------------
+TEST(LockFreeQueueStressTest) {
+    const int numItems = 100000;
+    {
+        SPSCQueue<int> queue(64);
+        CHECK(runThreads(queue, 1, 1, numItems) == expectedSum(1, numItems));
+        CHECK(queue.Empty());
+    }
+    {
+        MPMCQueue<int> queue(64);
+        CHECK(runThreads(queue, 4, 4, numItems) == expectedSum(4, numItems));
+        CHECK(queue.Empty());
+    }
+    {
+        MPMCQueue<int> queue(2);
+        CHECK(runThreads(queue, 3, 1, numItems) == expectedSum(3, numItems));
+        CHECK(queue.Empty());
+    }
+}
+
+//------------------------------------------------------------------------------
+TEST(LockFreeQueuePerformance) {
+    const int numItems = 1000000;
+    const int maxThreads = 4;
+    std::chrono::time_point<std::chrono::system_clock> start, end;
+    std::chrono::duration<double> dur;
+
+    {
+        SPSCQueue<int> queue(1024);
+        start = std::chrono::system_clock::now();
+        const int64_t sum = runThreads(queue, 1, 1, numItems);
+        end = std::chrono::system_clock::now();
+        dur = end - start;
+        CHECK(sum == expectedSum(1, numItems));
+        Log::Info("SPSCQueue 1x1: %d items: %f sec\n", numItems, dur.count());
+    }
+    for (int num = 1; num <= maxThreads; num *= 2) {
+        MPMCQueue<int> queue(1024);
+        start = std::chrono::system_clock::now();
+        const int64_t sum = runThreads(queue, num, num, numItems);
+        end = std::chrono::system_clock::now();
+        dur = end - start;
+        CHECK(sum == expectedSum(num, numItems));
+        Log::Info("MPMCQueue %dx%d: %d items: %f sec\n", num, num, num * numItems, dur.count());
+    }
+}
+#endif
@@ -6,6 +6,11 @@
 #include "UnitTest++/src/UnitTest++.h"
 #include "Core/Log.h"
 #include "Core/Logger.h"
+#include "Core/String/StringBuilder.h"
+#include <chrono>
+#if ORYOL_HAS_THREADS
+#include <thread>
+#endif
 
 using namespace Oryol;
 
@@ -55,3 +60,222 @@ TEST(LogTest) {
 }
 
 
+
+#if ORYOL_HAS_THREADS
+class CaptureLogger : public Logger {
+    OryolClassDecl(CaptureLogger);
+public:
+    /// store messages (called with the log lock held)
+    virtual void VPrint(Log::Level l, const char* msg, va_list args) override {
+        char buf[4096];
+        vsnprintf(buf, sizeof(buf), msg, args);
+        this->Levels.Add(l);
+        this->Msgs.Add(String(buf));
+    };
+    /// clear captured messages
+    void Clear() {
+        this->Levels.Clear();
+        this->Msgs.Clear();
+    };
+    Array<Log::Level> Levels;
+    Array<String> Msgs;
+};
+
+class CountLogger : public Logger {
+    OryolClassDecl(CountLogger);
+public:
+    /// format and count messages
+    virtual void VPrint(Log::Level /*l*/, const char* msg, va_list args) override {
+        char buf[256];
+        vsnprintf(buf, sizeof(buf), msg, args);
+        this->Count++;
+    };
+    int Count = 0;
+};
+
+// temporarily replace the attached loggers
+Array<Ptr<Logger>> detachLoggers() {
+    Array<Ptr<Logger>> loggers;
+    while (Log::GetNumLoggers() > 0) {
+        loggers.Add(Log::GetLogger(0));
+        Log::RemoveLogger(loggers.Back());
+    }
+    return loggers;
+}
+
+void attachLoggers(const Array<Ptr<Logger>>& loggers) {
+    while (Log::GetNumLoggers() > 0) {
+        Log::RemoveLogger(Log::GetLogger(0));
+    }
+    for (const auto& l : loggers) {
+        Log::AddLogger(l);
+    }
+}
+
+TEST(LogAsyncTest) {
+    const Array<Ptr<Logger>> savedLoggers = detachLoggers();
+    Ptr<CaptureLogger> capture = CaptureLogger::Create();
+    Log::AddLogger(capture);
+    Log::AddLogger(capture);
+    Log::RemoveLogger(capture);
+    CHECK(Log::GetNumLoggers() == 1);
+
+    // messages from a single thread arrive in order
+    CHECK(!Log::IsAsync());
+    Log::StartAsync();
+    CHECK(Log::IsAsync());
+    for (int i = 0; i < 100; i++) {
+        Log::Info("msg %d\n", i);
+    }
+    Log::Warn("warn\n");
+    Log::Flush();
+    CHECK(capture->Msgs.Size() == 101);
+    bool allOk = true;
+    for (int i = 0; i < 100; i++) {
+        char buf[32];
+        snprintf(buf, sizeof(buf), "msg %d\n", i);
+        allOk &= capture->Levels[i] == Log::Level::Info;
+        allOk &= capture->Msgs[i] == buf;
+    }
+    CHECK(allOk);
+    CHECK(capture->Levels[100] == Log::Level::Warn);
+
+    // errors are written right away, after the pending messages
+    capture->Clear();
+    Log::Info("before error\n");
+    Log::Error("error %d\n", 1);
+    CHECK(capture->Msgs.Size() == 2);
+    CHECK(capture->Msgs[0] == "before error\n");
+    CHECK(capture->Msgs[1] == "error 1\n");
+    CHECK(capture->Levels[1] == Log::Level::Error);
+
+    Log::StopAsync();
+    CHECK(!Log::IsAsync());
+
+    // long messages are truncated to a quarter of the buffer size
+    capture->Clear();
+    AsyncLogSetup setup;
+    setup.BufferSize = 4096;
+    Log::StartAsync(setup);
+    String longMsg;
+    {
+        StringBuilder strBuilder;
+        for (int i = 0; i < 200; i++) {
+            strBuilder.Append("0123456789");
+        }
+        longMsg = strBuilder.GetString();
+    }
+    Log::Info("%s\n", longMsg.AsCStr());
+    Log::StopAsync();
+    CHECK(capture->Msgs.Size() == 1);
+    CHECK(capture->Msgs[0].Length() == 1007);
+
+    // many threads logging into small buffers, waiting for space
+    capture->Clear();
+    setup.Overflow = AsyncLogOverflow::Block;
+    Log::StartAsync(setup);
+    const int numThreads = 4;
+    const int numMsgs = 2000;
+    std::thread threads[numThreads];
+    for (int t = 0; t < numThreads; t++) {
+        threads[t] = std::thread([t, numMsgs] {
+            for (int i = 0; i < numMsgs; i++) {
+                Log::Dbg("thread %d msg %d\n", t, i);
+            }
+        });
+    }
+    for (int t = 0; t < numThreads; t++) {
+        threads[t].join();
+    }
+    Log::StopAsync();
+    CHECK(Log::NumDropped() == 0);
+    CHECK(capture->Msgs.Size() == numThreads * numMsgs);
+    int nextMsg[numThreads] = { };
+    int numBad = 0;
+    for (const String& msg : capture->Msgs) {
+        int t = -1, i = -1;
+        if ((2 == sscanf(msg.AsCStr(), "thread %d msg %d", &t, &i)) && (t >= 0) && (t < numThreads) && (i == nextMsg[t])) {
+            nextMsg[t]++;
+        }
+        else {
+            numBad++;
+        }
+    }
+    CHECK(numBad == 0);
+
+    // dropping messages when the buffer is full, the number of
+    // dropped messages is reported by a warning
+    capture->Clear();
+    setup.Overflow = AsyncLogOverflow::Drop;
+    setup.FlushIntervalMs = 1000;
+    Log::StartAsync(setup);
+    CHECK(Log::NumDropped() == 0);
+    for (int i = 0; i < 1000; i++) {
+        Log::Info("msg %d\n", i);
+    }
+    Log::StopAsync();
+    int numReceived = 0;
+    int numReportedDropped = 0;
+    for (const String& msg : capture->Msgs) {
+        int num = 0;
+        if (1 == sscanf(msg.AsCStr(), "Log: %d messages dropped", &num)) {
+            numReportedDropped += num;
+        }
+        else {
+            numReceived++;
+        }
+    }
+    Log::Info("LogAsyncTest: %d messages received, %d dropped\n", numReceived, int(Log::NumDropped()));
+    CHECK(numReceived + Log::NumDropped() == 1000);
+    CHECK(numReportedDropped == Log::NumDropped());
+
+    // synchronous again
+    capture->Clear();
+    Log::Info("sync\n");
+    CHECK(capture->Msgs.Size() == 1);
+
+    attachLoggers(savedLoggers);
+}
+
+TEST(LogAsyncPerformance) {
+    const Array<Ptr<Logger>> savedLoggers = detachLoggers();
+    Ptr<CountLogger> counter = CountLogger::Create();
+    Log::AddLogger(counter);
+    const int numMsgs = 100000;
+    const int threadCounts[] = { 1, 2, 4 };
+    const char* modes[] = { "sync", "async-drop", "async-block" };
+    StringBuilder results;
+    for (int numThreads : threadCounts) {
+        for (int mode = 0; mode < 3; mode++) {
+            if (mode > 0) {
+                AsyncLogSetup setup;
+                setup.Overflow = (1 == mode) ? AsyncLogOverflow::Drop : AsyncLogOverflow::Block;
+                Log::StartAsync(setup);
+            }
+            counter->Count = 0;
+            std::chrono::time_point<std::chrono::system_clock> start = std::chrono::system_clock::now();
+            std::thread threads[4];
+            for (int t = 0; t < numThreads; t++) {
+                threads[t] = std::thread([t, numMsgs, numThreads] {
+                    for (int i = 0; i < numMsgs / numThreads; i++) {
+                        Log::Info("thread %d: message %d, value %f\n", t, i, i * 0.5f);
+                    }
+                });
+            }
+            for (int t = 0; t < numThreads; t++) {
+                threads[t].join();
+            }
+            std::chrono::duration<double> dur = std::chrono::system_clock::now() - start;
+            int64_t numDropped = 0;
+            if (mode > 0) {
+                Log::StopAsync();
+                numDropped = Log::NumDropped();
+            }
+            results.AppendFormat(256, "Log %s, %d threads: %d calls: %f sec (%.0f calls/sec, %d written, %d dropped)\n",
+                modes[mode], numThreads, numMsgs, dur.count(), numMsgs / dur.count(), counter->Count, int(numDropped));
+        }
+    }
+    attachLoggers(savedLoggers);
+    Log::Info("%s", results.AsCStr());
+}
+#endif
@@ -6,6 +6,10 @@
 #include "UnitTest++/src/UnitTest++.h"
 #include "Core/Containers/Map.h"
 #include "Core/String/String.h"
+#include "Core/Containers/Array.h"
+#include "Core/Log.h"
+#include <algorithm>
+#include <chrono>
 
 using namespace Oryol;
 
@@ -156,3 +160,55 @@ TEST(MapTest) {
         testMap.Erase(counter);
     }
 }
+
+//------------------------------------------------------------------------------
+// compare Map lookups against std::lower_bound on the same sorted keys
+TEST(MapLookupPerformance) {
+    const int num = 1000000;
+    const int numLookups = 4000000;
+
+    // build a big map with random keys in bulk mode
+    Map<int, int> map;
+    map.Reserve(num);
+    map.BeginBulk();
+    uint32_t key = 1;
+    for (int i = 0; i < num; i++) {
+        key = key * 1664525 + 1013904223;
+        map.AddBulk(int(key >> 1), i);
+    }
+    map.EndBulk();
+    CHECK(map.Size() == num);
+
+    Array<int> lookupKeys;
+    lookupKeys.Reserve(numLookups);
+    for (int i = 0; i < numLookups; i++) {
+        // every second key doesn't exist
+        const int k = map.KeyAtIndex(int((uint32_t(i) * 7919u) % uint32_t(num)));
+        lookupKeys.Add((i & 1) ? k + 1 : k);
+    }
+
+    std::chrono::time_point<std::chrono::system_clock> start, end;
+    std::chrono::duration<double> dur;
+    int found = 0;
+    start = std::chrono::system_clock::now();
+    for (int k : lookupKeys) {
+        auto ptr = std::lower_bound(map.begin(), map.end(), k);
+        if ((ptr != map.end()) && (ptr->key == k)) {
+            found++;
+        }
+    }
+    end = std::chrono::system_clock::now();
+    dur = end - start;
+    Log::Info("std::lower_bound: %d lookups in %d keys: %f sec\n", numLookups, num, dur.count());
+
+    start = std::chrono::system_clock::now();
+    for (int k : lookupKeys) {
+        if (InvalidIndex != map.FindIndex(k)) {
+            found--;
+        }
+    }
+    end = std::chrono::system_clock::now();
+    dur = end - start;
+    Log::Info("Map::FindIndex: %d lookups in %d keys: %f sec\n", numLookups, num, dur.count());
+    CHECK(found == 0);
+}
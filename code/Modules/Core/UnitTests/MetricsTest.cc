@@ -0,0 +1,191 @@
+//------------------------------------------------------------------------------
+//  MetricsTest.cc
+//  Test Metrics registry, counters, gauges and histograms.
+//------------------------------------------------------------------------------
+#include "Pre.h"
+#include "UnitTest++/src/UnitTest++.h"
+#include "Core/Metrics.h"
+#include "Core/RunLoop.h"
+#include <chrono>
+#include <cstring>
+#if ORYOL_HAS_THREADS
+#include <thread>
+#endif
+
+using namespace Oryol;
+
+TEST(MetricHistogramBucketTest) {
+    // small values are exact
+    for (int64_t v = 0; v < 64; v++) {
+        CHECK(MetricHistogram::BucketIndex(v) == int(v));
+        CHECK(MetricHistogram::BucketMin(int(v)) == v);
+        CHECK(MetricHistogram::BucketMax(int(v)) == v);
+    }
+    // larger values are in a bucket with a relative width of max 1/32
+    bool allOk = true;
+    int lastIndex = 0;
+    for (int64_t v = 64; v < (int64_t(1) << MetricHistogram::MaxValueBits); v += 1 + v / 37) {
+        const int index = MetricHistogram::BucketIndex(v);
+        const int64_t min = MetricHistogram::BucketMin(index);
+        const int64_t max = MetricHistogram::BucketMax(index);
+        allOk &= (index >= lastIndex) && (index < MetricHistogram::NumBuckets);
+        allOk &= (min <= v) && (v <= max);
+        allOk &= ((max - min + 1) * 32) <= min;
+        allOk &= MetricHistogram::BucketIndex(min) == index;
+        allOk &= MetricHistogram::BucketIndex(max) == index;
+        if (index < (MetricHistogram::NumBuckets - 1)) {
+            allOk &= MetricHistogram::BucketIndex(max + 1) == index + 1;
+        }
+        lastIndex = index;
+    }
+    CHECK(allOk);
+    // out of range values are clamped
+    CHECK(MetricHistogram::BucketIndex(-5) == 0);
+    CHECK(MetricHistogram::BucketIndex(int64_t(1) << 62) == MetricHistogram::NumBuckets - 1);
+    CHECK(MetricHistogram::BucketMax(MetricHistogram::NumBuckets - 1) == (int64_t(1) << MetricHistogram::MaxValueBits) - 1);
+}
+
+TEST(MetricHistogramTest) {
+    MetricHistogram h;
+    MetricHistogram::Summary s = h.Summarize();
+    CHECK(s.Count == 0);
+    CHECK(s.P50 == 0);
+
+    for (int i = 1; i <= 1000; i++) {
+        h.Record(i);
+    }
+    s = h.Summarize();
+    CHECK(s.Count == 1000);
+    CHECK(s.Sum == 500500);
+    CHECK(s.Min == 1);
+    CHECK(s.Max == 1000);
+    CHECK_CLOSE(500.5, s.Mean, 0.001);
+    CHECK((s.P50 >= 500) && (s.P50 <= 500 + 500 / 32));
+    CHECK((s.P90 >= 900) && (s.P90 <= 900 + 900 / 32));
+    CHECK((s.P99 >= 990) && (s.P99 <= 1000));
+    CHECK(s.P999 == 1000);
+
+    // a single outlier
+    h.Reset();
+    for (int i = 0; i < 999; i++) {
+        h.Record(10);
+    }
+    h.Record(1000000);
+    s = h.Summarize();
+    CHECK(s.P50 == 10);
+    CHECK(s.P99 == 10);
+    CHECK(s.P999 == 10);
+    CHECK(s.Max == 1000000);
+
+    // durations are recorded in microseconds
+    h.Reset();
+    h.RecordDuration(Duration::FromMilliSeconds(2.0));
+    s = h.Summarize();
+    CHECK(s.Min == 2000);
+    CHECK(s.P50 == 2000);
+}
+
+TEST(MetricsTest) {
+    MetricCounter* counter = Metrics::Counter("Test.Counter");
+    MetricGauge* gauge = Metrics::Gauge("Test.Gauge");
+    MetricHistogram* histogram = Metrics::Histogram("Test.Histogram");
+    CHECK(counter == Metrics::Counter("Test.Counter"));
+    CHECK(gauge == Metrics::Gauge("Test.Gauge"));
+    CHECK(histogram == Metrics::Histogram("Test.Histogram"));
+
+    counter->Add();
+    counter->Add(9);
+    CHECK(counter->Value() == 10);
+    gauge->Set(5);
+    gauge->Add(-7);
+    CHECK(gauge->Value() == -2);
+    {
+        MetricTimer timer(histogram);
+    }
+    CHECK(histogram->Summarize().Count == 1);
+
+    MetricsSnapshot snapshot = Metrics::Snapshot();
+    const MetricsSnapshot::Entry* entry = snapshot.Find("Test.Counter");
+    CHECK(entry && (entry->MetricType == MetricsSnapshot::CounterType) && (entry->Value == 10));
+    entry = snapshot.Find("Test.Gauge");
+    CHECK(entry && (entry->MetricType == MetricsSnapshot::GaugeType) && (entry->Value == -2));
+    entry = snapshot.Find("Test.Histogram");
+    CHECK(entry && (entry->MetricType == MetricsSnapshot::HistogramType) && (entry->Histogram.Count == 1));
+    CHECK(nullptr == snapshot.Find("Test.Bla"));
+    // entries are sorted by name
+    bool sorted = true;
+    for (int i = 1; i < snapshot.Entries.Size(); i++) {
+        sorted &= std::strcmp(snapshot.Entries[i-1].Name.AsCStr(), snapshot.Entries[i].Name.AsCStr()) < 0;
+    }
+    CHECK(sorted);
+    StringBuilder str;
+    snapshot.ToText(str);
+    CHECK(str.Contains("counter   Test.Counter"));
+    CHECK(str.Contains("histogram Test.Histogram"));
+    Metrics::LogSnapshot();
+
+    // RunLoop callbacks are measured
+    const int64_t numCallbacks = Metrics::Histogram("RunLoop.CallbackTime")->Summarize().Count;
+    RunLoop runLoop;
+    runLoop.Add([] { });
+    runLoop.Run();
+    runLoop.Run();
+    CHECK(Metrics::Histogram("RunLoop.CallbackTime")->Summarize().Count == numCallbacks + 2);
+
+    Metrics::Reset();
+    CHECK(counter->Value() == 0);
+    CHECK(gauge->Value() == 0);
+    CHECK(histogram->Summarize().Count == 0);
+
+    #if ORYOL_HAS_THREADS
+    // update from many threads
+    const int numThreads = 4;
+    const int num = 100000;
+    std::thread threads[numThreads];
+    for (int t = 0; t < numThreads; t++) {
+        threads[t] = std::thread([counter, gauge, histogram, num, t] {
+            for (int i = 0; i < num; i++) {
+                counter->Add();
+                gauge->Add(t);
+                histogram->Record(i);
+            }
+        });
+    }
+    for (int t = 0; t < numThreads; t++) {
+        threads[t].join();
+    }
+    CHECK(counter->Value() == numThreads * num);
+    CHECK(gauge->Value() == num * (0 + 1 + 2 + 3));
+    const MetricHistogram::Summary s = histogram->Summarize();
+    CHECK(s.Count == numThreads * num);
+    CHECK(s.Min == 0);
+    CHECK(s.Max == num - 1);
+    CHECK(s.Sum == int64_t(numThreads) * (int64_t(num) * (num - 1) / 2));
+    #endif
+}
+
+TEST(MetricsPerformance) {
+    MetricCounter* counter = Metrics::Counter("Test.PerfCounter");
+    MetricHistogram* histogram = Metrics::Histogram("Test.PerfHistogram");
+    const int num = 1000000;
+    std::chrono::time_point<std::chrono::system_clock> start = std::chrono::system_clock::now();
+    for (int i = 0; i < num; i++) {
+        counter->Add();
+    }
+    std::chrono::duration<double> dur = std::chrono::system_clock::now() - start;
+    Log::Info("MetricCounter::Add(): %d calls: %f sec (%.1f ns/call)\n", num, dur.count(), (dur.count() * 1e9) / num);
+    start = std::chrono::system_clock::now();
+    for (int i = 0; i < num; i++) {
+        histogram->Record(i & 0xFFFF);
+    }
+    dur = std::chrono::system_clock::now() - start;
+    Log::Info("MetricHistogram::Record(): %d calls: %f sec (%.1f ns/call)\n", num, dur.count(), (dur.count() * 1e9) / num);
+    start = std::chrono::system_clock::now();
+    MetricHistogram::Summary s;
+    for (int i = 0; i < 1000; i++) {
+        s = histogram->Summarize();
+    }
+    dur = std::chrono::system_clock::now() - start;
+    CHECK(s.Count == num);
+    Log::Info("MetricHistogram::Summarize(): 1000 calls: %f sec\n", dur.count());
+}
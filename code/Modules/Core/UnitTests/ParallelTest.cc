@@ -0,0 +1,249 @@
+//------------------------------------------------------------------------------
+//  ParallelTest.cc
+//  Test Parallel::For and Parallel::Reduce.
+//------------------------------------------------------------------------------
+#include "Pre.h"
+#include "UnitTest++/src/UnitTest++.h"
+#include "Core/Threading/Parallel.h"
+#include "Core/Log.h"
+#include <atomic>
+#include <chrono>
+#if ORYOL_HAS_THREADS
+#include <thread>
+#endif
+
+using namespace Oryol;
+
+namespace {
+
+struct particle {
+    float pos[4];
+    float vec[4];
+};
+
+//------------------------------------------------------------------------------
+void
+updateParticles(particle* particles, int begin, int end) {
+    const float frameTime = 1.0f / 60.0f;
+    for (int i = begin; i < end; i++) {
+        particle& p = particles[i];
+        p.vec[1] -= 1.0f * frameTime;
+        for (int j = 0; j < 4; j++) {
+            p.pos[j] += p.vec[j] * frameTime;
+        }
+        if (p.pos[1] < -2.0f) {
+            p.pos[1] = -1.8f;
+            p.vec[1] = -p.vec[1];
+            for (int j = 0; j < 4; j++) {
+                p.vec[j] *= 0.8f;
+            }
+        }
+    }
+}
+
+//------------------------------------------------------------------------------
+void
+testParallel() {
+    // every index must be visited exactly once, for all kinds of grain sizes
+    const int nums[] = { 0, 1, 2, 100, 1000, 12345 };
+    const int grains[] = { 0, 1, 7, 64, 100000 };
+    for (int num : nums) {
+        for (int grain : grains) {
+            Array<int> visits;
+            for (int i = 0; i < num; i++) {
+                visits.Add(0);
+            }
+            std::atomic<int> numBadRanges(0);
+            Parallel::For(num, [&visits, &numBadRanges, num](int begin, int end) {
+                if ((begin < 0) || (end > num) || (begin >= end)) {
+                    numBadRanges++;
+                    return;
+                }
+                for (int i = begin; i < end; i++) {
+                    visits[i]++;
+                }
+            }, grain);
+            CHECK(numBadRanges == 0);
+            int numBadVisits = 0;
+            for (int i = 0; i < num; i++) {
+                if (visits[i] != 1) {
+                    numBadVisits++;
+                }
+            }
+            CHECK(numBadVisits == 0);
+        }
+    }
+
+    // ForEach over an Array and a Slice
+    Array<int> values;
+    for (int i = 0; i < 10000; i++) {
+        values.Add(i);
+    }
+    Parallel::ForEach(values, [](int& val) {
+        val *= 2;
+    });
+    Parallel::ForEach(values.MakeSlice(5000), [](int& val) {
+        val += 1;
+    }, 16);
+    bool allOk = true;
+    for (int i = 0; i < 10000; i++) {
+        allOk &= values[i] == ((i * 2) + ((i >= 5000) ? 1 : 0));
+    }
+    CHECK(allOk);
+
+    // reductions
+    const int64_t sum = Parallel::Reduce(values, int64_t(0),
+        [](int64_t acc, const int& val) { return acc + val; },
+        [](int64_t a, int64_t b) { return a + b; });
+    CHECK(sum == (9999 * 10000) + 5000);
+    const int maxVal = Parallel::Reduce(values.MakeSlice(0, 5000), -1,
+        [](int acc, const int& val) { return val > acc ? val : acc; },
+        [](int a, int b) { return a > b ? a : b; }, 3);
+    CHECK(maxVal == 9998);
+    const int64_t rangeSum = Parallel::Reduce(1000, int64_t(0), [](int begin, int end) {
+        int64_t result = 0;
+        for (int i = begin; i < end; i++) {
+            result += i;
+        }
+        return result;
+    }, [](int64_t a, int64_t b) { return a + b; });
+    CHECK(rangeSum == (999 * 1000) / 2);
+    CHECK(Parallel::Reduce(0, 42, [](int, int) { return 0; }, [](int a, int b) { return a + b; }) == 42);
+
+    // partial results are combined in chunk order, so non-commutative
+    // (but associative) combine functions work
+    Array<int> order;
+    for (int i = 0; i < 100; i++) {
+        order.Add(i);
+    }
+    struct seq {
+        int first = -1;
+        int last = -1;
+        bool ok = true;
+    };
+    const seq result = Parallel::Reduce(order, seq(),
+        [](seq acc, const int& val) {
+            if ((acc.last != -1) && (val != acc.last + 1)) {
+                acc.ok = false;
+            }
+            if (acc.first == -1) {
+                acc.first = val;
+            }
+            acc.last = val;
+            return acc;
+        },
+        [](seq a, seq b) {
+            if (a.first == -1) {
+                return b;
+            }
+            if (b.first == -1) {
+                return a;
+            }
+            a.ok = a.ok && b.ok && (b.first == a.last + 1);
+            a.last = b.last;
+            return a;
+        }, 3);
+    CHECK(result.ok && (result.first == 0) && (result.last == 99));
+
+    // nested parallel loops
+    std::atomic<int> nestedCount(0);
+    Parallel::For(16, [&nestedCount](int begin, int end) {
+        for (int i = begin; i < end; i++) {
+            Parallel::For(100, [&nestedCount](int b, int e) {
+                nestedCount += e - b;
+            }, 10);
+        }
+    }, 1);
+    CHECK(nestedCount == 1600);
+}
+
+} // anonymous namespace
+
+//------------------------------------------------------------------------------
+TEST(ParallelTest) {
+    // without the JobSystem everything runs serially
+    CHECK(Parallel::ChunkSize(1000) == 1000);
+    testParallel();
+
+    JobSetup setup;
+    setup.NumWorkers = 0;
+    JobSystem::Setup(setup);
+    CHECK(Parallel::ChunkSize(1000, 10) == 1000);
+    testParallel();
+    JobSystem::Discard();
+
+    #if ORYOL_HAS_THREADS
+    setup.NumWorkers = 3;
+    JobSystem::Setup(setup);
+    CHECK(Parallel::ChunkSize(1000) == 63);
+    CHECK(Parallel::ChunkSize(1000, 10) == 10);
+    testParallel();
+    JobSystem::Discard();
+    #endif
+}
+
+//------------------------------------------------------------------------------
+TEST(ParallelPerformance) {
+    const int numParticles = 1024 * 1024;
+    const int numFrames = 10;
+    int maxWorkers = 0;
+    #if ORYOL_HAS_THREADS
+    maxWorkers = int(std::thread::hardware_concurrency()) - 1;
+    if (maxWorkers < 1) {
+        maxWorkers = 1;
+    }
+    #endif
+    std::chrono::time_point<std::chrono::system_clock> start, end;
+    std::chrono::duration<double> dur;
+
+    Array<particle> particles;
+    particles.Reserve(numParticles);
+    for (int i = 0; i < numParticles; i++) {
+        particle p;
+        for (int j = 0; j < 4; j++) {
+            p.pos[j] = 0.0f;
+            p.vec[j] = float((i * (j + 7)) % 101) * 0.01f;
+        }
+        particles.Add(p);
+    }
+    particle* ptr = &particles[0];
+
+    start = std::chrono::system_clock::now();
+    for (int frame = 0; frame < numFrames; frame++) {
+        updateParticles(ptr, 0, numParticles);
+    }
+    end = std::chrono::system_clock::now();
+    dur = end - start;
+    Log::Info("Parallel::For baseline: %d particles x %d frames: %f sec\n", numParticles, numFrames, dur.count());
+
+    for (int numWorkers = 0; numWorkers <= maxWorkers; numWorkers++) {
+        JobSetup setup;
+        setup.NumWorkers = numWorkers;
+        JobSystem::Setup(setup);
+
+        start = std::chrono::system_clock::now();
+        for (int frame = 0; frame < numFrames; frame++) {
+            Parallel::For(numParticles, [ptr](int begin, int end) {
+                updateParticles(ptr, begin, end);
+            });
+        }
+        end = std::chrono::system_clock::now();
+        dur = end - start;
+        Log::Info("Parallel::For %d threads: %d particles x %d frames: %f sec\n",
+            JobSystem::NumThreads(), numParticles, numFrames, dur.count());
+
+        start = std::chrono::system_clock::now();
+        float sum = 0.0f;
+        for (int frame = 0; frame < numFrames; frame++) {
+            sum += Parallel::Reduce(particles, 0.0f,
+                [](float acc, const particle& p) { return acc + p.pos[1]; },
+                [](float a, float b) { return a + b; });
+        }
+        end = std::chrono::system_clock::now();
+        dur = end - start;
+        Log::Info("Parallel::Reduce %d threads: %d particles x %d frames: %f sec (%f)\n",
+            JobSystem::NumThreads(), numParticles, numFrames, dur.count(), sum);
+
+        JobSystem::Discard();
+    }
+}
@@ -0,0 +1,204 @@
+//------------------------------------------------------------------------------
+//  RadixSortTest.cc
+//  Test RadixSort class.
+//------------------------------------------------------------------------------
+#include "Pre.h"
+#include "UnitTest++/src/UnitTest++.h"
+#include "Core/Containers/RadixSort.h"
+#include "Core/Containers/Array.h"
+#include "Core/Containers/Map.h"
+#include "Core/String/String.h"
+#include "Core/Log.h"
+#include <algorithm>
+#include <chrono>
+
+using namespace Oryol;
+
+static uint64_t xorshift(uint64_t& state) {
+    state ^= state << 13;
+    state ^= state >> 7;
+    state ^= state << 17;
+    return state;
+}
+
+TEST(RadixSortTest) {
+    static_assert(RadixSort::IsSortable<uint64_t>::value, "uint64_t must be sortable");
+    static_assert(RadixSort::IsSortable<float>::value, "float must be sortable");
+    static_assert(RadixSort::IsSortable<KeyValuePair<int, int>>::value, "KeyValuePair<int,int> must be sortable");
+    static_assert(!RadixSort::IsSortable<KeyValuePair<String, int>>::value, "KeyValuePair<String,int> must not be sortable");
+
+    uint64_t rnd = 0x1234567;
+    const int num = 10000;
+
+    // unsigned 64-bit
+    Array<uint64_t> u64, u64Scratch, u64Ref;
+    u64.Reserve(num); u64Scratch.Reserve(num);
+    for (int i = 0; i < num; i++) {
+        u64.Add(xorshift(rnd));
+    }
+    u64Ref = u64;
+    std::sort(u64Ref.begin(), u64Ref.end());
+    RadixSort::Sort(u64.begin(), u64Scratch.begin(), num);
+    CHECK(std::equal(u64.begin(), u64.end(), u64Ref.begin()));
+
+    // signed 32-bit with negative values
+    Array<int32_t> i32, i32Scratch, i32Ref;
+    i32.Reserve(num + 4);
+    for (int i = 0; i < num; i++) {
+        i32.Add(int32_t(xorshift(rnd)));
+    }
+    i32.Add(-1); i32.Add(0); i32.Add(INT32_MIN); i32.Add(INT32_MAX);
+    i32Scratch.Reserve(i32.Size());
+    i32Ref = i32;
+    std::sort(i32Ref.begin(), i32Ref.end());
+    RadixSort::Sort(i32.begin(), i32Scratch.begin(), i32.Size());
+    CHECK(std::equal(i32.begin(), i32.end(), i32Ref.begin()));
+
+    // small range keys (skips the upper passes)
+    Array<int16_t> i16, i16Scratch, i16Ref;
+    for (int i = 0; i < 1000; i++) {
+        i16.Add(int16_t(int(xorshift(rnd) % 200) - 100));
+    }
+    i16Scratch.Reserve(i16.Size());
+    i16Ref = i16;
+    std::sort(i16Ref.begin(), i16Ref.end());
+    RadixSort::Sort(i16.begin(), i16Scratch.begin(), i16.Size());
+    CHECK(std::equal(i16.begin(), i16.end(), i16Ref.begin()));
+
+    // floats and doubles
+    Array<float> f32, f32Scratch, f32Ref;
+    Array<double> f64, f64Scratch, f64Ref;
+    f32.Reserve(num); f32Scratch.Reserve(num);
+    f64.Reserve(num); f64Scratch.Reserve(num);
+    for (int i = 0; i < num; i++) {
+        const double val = (double(int64_t(xorshift(rnd))) / double(INT64_MAX)) * 1000.0;
+        f32.Add(float(val));
+        f64.Add(val);
+    }
+    f32Ref = f32;
+    f64Ref = f64;
+    std::sort(f32Ref.begin(), f32Ref.end());
+    std::sort(f64Ref.begin(), f64Ref.end());
+    RadixSort::Sort(f32.begin(), f32Scratch.begin(), num);
+    RadixSort::Sort(f64.begin(), f64Scratch.begin(), num);
+    CHECK(std::equal(f32.begin(), f32.end(), f32Ref.begin()));
+    CHECK(std::equal(f64.begin(), f64.end(), f64Ref.begin()));
+
+    // key-value pairs, the sort must be stable
+    Array<KeyValuePair<uint32_t, int>> kvp, kvpScratch;
+    kvp.Reserve(num); kvpScratch.Reserve(num);
+    for (int i = 0; i < num; i++) {
+        kvp.Add(KeyValuePair<uint32_t, int>(uint32_t(xorshift(rnd) % 100), i));
+    }
+    RadixSort::Sort(kvp.begin(), kvpScratch.begin(), num);
+    bool sorted = true;
+    for (int i = 1; i < num; i++) {
+        if ((kvp[i-1].key > kvp[i].key) ||
+            ((kvp[i-1].key == kvp[i].key) && (kvp[i-1].value > kvp[i].value))) {
+            sorted = false;
+        }
+    }
+    CHECK(sorted);
+
+    // empty and single-element arrays
+    uint32_t single = 5, singleScratch = 0;
+    RadixSort::Sort(&single, &singleScratch, 0);
+    RadixSort::Sort(&single, &singleScratch, 1);
+    CHECK(single == 5);
+
+    // SortAuto falls back to std::sort for non-radix types
+    Array<String> strings({ "Two", "One", "Three" });
+    RadixSort::SortAuto(strings.begin(), strings.Size());
+    CHECK(strings[0] == "One");
+    CHECK(strings[1] == "Three");
+    CHECK(strings[2] == "Two");
+
+    // Map::EndBulk() sorts with RadixSort
+    Map<int, int> map;
+    map.BeginBulk();
+    for (int i = 0; i < 1000; i++) {
+        map.AddBulk(int(xorshift(rnd) % 50) - 25, i);
+    }
+    map.EndBulk();
+    sorted = true;
+    for (int i = 1; i < map.Size(); i++) {
+        if (map.KeyAtIndex(i-1) > map.KeyAtIndex(i)) {
+            sorted = false;
+        }
+    }
+    CHECK(sorted);
+}
+
+TEST(RadixSortParallelTest) {
+    uint64_t rnd = 0x7654321;
+    const int num = 1000000;
+    Array<KeyValuePair<uint64_t, int>> kvp, kvpScratch;
+    kvp.Reserve(num); kvpScratch.Reserve(num);
+    for (int i = 0; i < num; i++) {
+        kvp.Add(KeyValuePair<uint64_t, int>(xorshift(rnd) % 100000, i));
+    }
+    RadixSort::SortParallel(kvp.begin(), kvpScratch.begin(), num, 4);
+    bool sorted = true;
+    for (int i = 1; i < num; i++) {
+        if ((kvp[i-1].key > kvp[i].key) ||
+            ((kvp[i-1].key == kvp[i].key) && (kvp[i-1].value > kvp[i].value))) {
+            sorted = false;
+        }
+    }
+    CHECK(sorted);
+}
+
+TEST(RadixSortPerformance) {
+    const int maxNum = 10000000;
+    uint64_t* values = (uint64_t*) Memory::Alloc(maxNum * sizeof(uint64_t));
+    uint64_t* src = (uint64_t*) Memory::Alloc(maxNum * sizeof(uint64_t));
+    uint64_t* scratch = (uint64_t*) Memory::Alloc(maxNum * sizeof(uint64_t));
+    uint64_t rnd = 0xABCDEF;
+    for (int i = 0; i < maxNum; i++) {
+        src[i] = xorshift(rnd);
+    }
+
+    std::chrono::time_point<std::chrono::system_clock> start, end;
+    std::chrono::duration<double> dur;
+    for (int num = 1000; num <= maxNum; num *= 10) {
+        // sort the same total number of elements for each array size
+        const int numRuns = maxNum / num;
+
+        dur = std::chrono::duration<double>::zero();
+        for (int run = 0; run < numRuns; run++) {
+            Memory::Copy(src, values, num * sizeof(uint64_t));
+            start = std::chrono::system_clock::now();
+            std::sort(values, values + num);
+            end = std::chrono::system_clock::now();
+            dur += end - start;
+        }
+        Log::Info("std::sort: %d x %d uint64: %f sec\n", numRuns, num, dur.count());
+
+        dur = std::chrono::duration<double>::zero();
+        for (int run = 0; run < numRuns; run++) {
+            Memory::Copy(src, values, num * sizeof(uint64_t));
+            start = std::chrono::system_clock::now();
+            RadixSort::Sort(values, scratch, num);
+            end = std::chrono::system_clock::now();
+            dur += end - start;
+        }
+        Log::Info("RadixSort::Sort: %d x %d uint64: %f sec\n", numRuns, num, dur.count());
+        CHECK(std::is_sorted(values, values + num));
+
+        #if ORYOL_HAS_THREADS
+        dur = std::chrono::duration<double>::zero();
+        for (int run = 0; run < numRuns; run++) {
+            Memory::Copy(src, values, num * sizeof(uint64_t));
+            start = std::chrono::system_clock::now();
+            RadixSort::SortParallel(values, scratch, num, 4);
+            end = std::chrono::system_clock::now();
+            dur += end - start;
+        }
+        Log::Info("RadixSort::SortParallel(4): %d x %d uint64: %f sec\n", numRuns, num, dur.count());
+        CHECK(std::is_sorted(values, values + num));
+        #endif
+    }
+    Memory::Free(values);
+    Memory::Free(src);
+    Memory::Free(scratch);
+}
@@ -5,6 +5,11 @@
 #include "Pre.h"
 #include "UnitTest++/src/UnitTest++.h"
 #include "Core/RunLoop.h"
+#include "Core/Containers/Array.h"
+#include "Core/Time/Clock.h"
+#if ORYOL_HAS_THREADS
+#include <thread>
+#endif
 
 using namespace Oryol;
 
@@ -29,3 +34,136 @@ TEST(RunLoopTest) {
     CHECK(x == 2);
     CHECK(y == 4);
 }
+
+//------------------------------------------------------------------------------
+TEST(RunLoopPriorityTest) {
+    RunLoop runLoop;
+    Array<int> order;
+    runLoop.Add([&order]() { order.Add(3); }, RunLoop::Low);
+    runLoop.Add([&order]() { order.Add(1); }, RunLoop::High);
+    runLoop.Add([&order]() { order.Add(0); });
+    runLoop.Add([&order]() { order.Add(2); }, RunLoop::Normal, "normal");
+    runLoop.Run();
+    CHECK(order.Size() == 4);
+    for (int i = 0; i < order.Size(); i++) {
+        CHECK(order[i] == i);
+    }
+    CHECK(runLoop.NumCallbacks() == 4);
+    CHECK(runLoop.CallbackStats(runLoop.CallbackIdAt(2)).Name == "normal");
+    CHECK(runLoop.CallbackStats(runLoop.CallbackIdAt(2)).Pri == RunLoop::Normal);
+    CHECK(runLoop.LastNumDeferred() == 0);
+}
+
+//------------------------------------------------------------------------------
+TEST(RunLoopBudgetTest) {
+    // a slow critical callback uses up the budget, deferrable
+    // callbacks are spread across frames
+    RunLoop runLoop;
+    runLoop.SetBudget(Duration::FromMilliSeconds(1.0));
+    runLoop.SetMaxDeferredFrames(3);
+    CHECK(runLoop.MaxDeferredFrames() == 3);
+    bool slow = true;
+    auto critId = runLoop.Add([&slow]() {
+        if (slow) {
+            const TimePoint start = Clock::Now();
+            while (Clock::Since(start) < Duration::FromMilliSeconds(2.0)) { }
+        }
+    }, RunLoop::Critical, "slow");
+    int numLow = 0;
+    auto lowId = runLoop.Add([&numLow]() { numLow++; }, RunLoop::Low);
+    int numHigh = 0;
+    auto highId = runLoop.Add([&numHigh]() { numHigh++; }, RunLoop::High);
+
+    // deferred 3 times in a row, then called once
+    for (int i = 0; i < 3; i++) {
+        runLoop.Run();
+        CHECK(runLoop.LastNumDeferred() == 2);
+    }
+    CHECK(numLow == 0);
+    CHECK(numHigh == 0);
+    runLoop.Run();
+    CHECK(numLow == 1);
+    CHECK(numHigh == 1);
+    CHECK(runLoop.LastNumDeferred() == 0);
+    CHECK(runLoop.LastRunTime() >= Duration::FromMilliSeconds(2.0));
+
+    // within budget everything is called
+    slow = false;
+    runLoop.Run();
+    CHECK(numLow == 2);
+    CHECK(numHigh == 2);
+
+    const RunLoop::Stats& critStats = runLoop.CallbackStats(critId);
+    CHECK(critStats.NumCalls == 5);
+    CHECK(critStats.NumDeferred == 0);
+    CHECK(critStats.MaxTime >= Duration::FromMilliSeconds(2.0));
+    CHECK(critStats.TotalTime >= critStats.MaxTime);
+    CHECK(runLoop.CallbackStats(lowId).NumCalls == 2);
+    CHECK(runLoop.CallbackStats(lowId).NumDeferred == 3);
+    CHECK(runLoop.CallbackStats(highId).NumDeferred == 3);
+    runLoop.ResetStats();
+    CHECK(runLoop.CallbackStats(critId).NumCalls == 0);
+    CHECK(runLoop.CallbackStats(critId).Name == "slow");
+
+    // a slow deferrable callback only blocks the ones after it,
+    // the deferred ones go first in the next frame
+    RunLoop runLoop2;
+    runLoop2.SetBudget(Duration::FromMilliSeconds(1.0));
+    Array<int> order;
+    runLoop2.Add([&order]() {
+        order.Add(0);
+        const TimePoint start = Clock::Now();
+        while (Clock::Since(start) < Duration::FromMilliSeconds(2.0)) { }
+    }, RunLoop::Normal);
+    runLoop2.Add([&order]() { order.Add(1); }, RunLoop::Normal);
+    runLoop2.Run();
+    CHECK(order.Size() == 1);
+    CHECK(order[0] == 0);
+    runLoop2.Run();
+    CHECK(order.Size() == 3);
+    CHECK(order[1] == 1);
+    CHECK(order[2] == 0);
+}
+
+TEST(RunLoopPostTest) {
+    RunLoop runLoop;
+    Array<int> order;
+    runLoop.Add([&order]() { order.Add(0); });
+    runLoop.Post([&order, &runLoop]() {
+        order.Add(1);
+        // posted while calling posted functions, called in next Run()
+        runLoop.Post([&order]() { order.Add(2); });
+    });
+    CHECK(order.Empty());
+    runLoop.Run();
+    // posted functions are called before the callbacks, and only once
+    CHECK(order.Size() == 2);
+    CHECK(order[0] == 1);
+    CHECK(order[1] == 0);
+    runLoop.Run();
+    CHECK(order.Size() == 4);
+    CHECK(order[2] == 2);
+    CHECK(order[3] == 0);
+    runLoop.Run();
+    CHECK(order.Size() == 5);
+
+    #if ORYOL_HAS_THREADS
+    // post from other threads
+    const int numThreads = 4;
+    const int numPosts = 1000;
+    int num = 0;
+    std::thread threads[numThreads];
+    for (int t = 0; t < numThreads; t++) {
+        threads[t] = std::thread([&runLoop, &num] {
+            for (int i = 0; i < numPosts; i++) {
+                runLoop.Post([&num] { num++; });
+            }
+        });
+    }
+    for (int t = 0; t < numThreads; t++) {
+        threads[t].join();
+    }
+    runLoop.Run();
+    CHECK(num == numThreads * numPosts);
+    #endif
+}
@@ -91,4 +91,20 @@ TEST(SetTest) {
     CHECK(set2.ValueAtIndex(0) == 0);
     CHECK(set2.ValueAtIndex(1) == 1);
     CHECK(set2.ValueAtIndex(2) == 2);
+
+    // bulk add
+    Set<int> set3;
+    set3.BeginBulk();
+    for (int i = 31; i >= 0; i--) {
+        set3.AddBulk(i * 2);
+    }
+    set3.EndBulk();
+    CHECK(set3.Size() == 32);
+    for (int i = 0; i < 32; i++) {
+        CHECK(set3.ValueAtIndex(i) == i * 2);
+        CHECK(set3.Contains(i * 2));
+        CHECK(!set3.Contains(i * 2 + 1));
+    }
+    set3.Add(5);
+    CHECK(set3.ValueAtIndex(3) == 5);
 }
@@ -0,0 +1,180 @@
+//------------------------------------------------------------------------------
+//  SlotMapTest.cc
+//  Test SlotMap functionality.
+//------------------------------------------------------------------------------
+#include "Pre.h"
+#include "UnitTest++/src/UnitTest++.h"
+#include "Core/Containers/SlotMap.h"
+#include "Core/Containers/Map.h"
+#include "Core/String/String.h"
+#include "Core/Log.h"
+#include <chrono>
+
+using namespace Oryol;
+
+TEST(SlotMapTest) {
+
+    SlotMap<String> slotMap;
+    CHECK(slotMap.GetMinGrow() == ORYOL_CONTAINER_DEFAULT_MIN_GROW);
+    CHECK(slotMap.GetMaxGrow() == ORYOL_CONTAINER_DEFAULT_MAX_GROW);
+    CHECK(slotMap.Size() == 0);
+    CHECK(slotMap.Empty());
+    CHECK(slotMap.NumSlots() == 0);
+
+    SlotMap<String>::Handle invalid;
+    CHECK(!invalid.IsValid());
+    CHECK(!slotMap.Contains(invalid));
+    CHECK(nullptr == slotMap.Find(invalid));
+    CHECK(!slotMap.Erase(invalid));
+
+    // add values
+    auto h0 = slotMap.Add(String("Zero"));
+    auto h1 = slotMap.Add("One");
+    String two("Two");
+    auto h2 = slotMap.Add(two);
+    CHECK(h0.IsValid() && h1.IsValid() && h2.IsValid());
+    CHECK(h0 != h1);
+    CHECK(slotMap.Size() == 3);
+    CHECK(!slotMap.Empty());
+    CHECK(slotMap.NumSlots() == 3);
+    CHECK(slotMap.Contains(h0));
+    CHECK(slotMap.Contains(h1));
+    CHECK(slotMap.Contains(h2));
+    CHECK(slotMap[h0] == "Zero");
+    CHECK(slotMap[h1] == "One");
+    CHECK(slotMap[h2] == "Two");
+    CHECK(*slotMap.Find(h1) == "One");
+    for (int i = 0; i < slotMap.Size(); i++) {
+        CHECK(slotMap[slotMap.HandleAtIndex(i)] == slotMap.ValueAtIndex(i));
+    }
+
+    // erase from the middle, the last value is swapped in
+    CHECK(slotMap.Erase(h0));
+    CHECK(slotMap.Size() == 2);
+    CHECK(!slotMap.Contains(h0));
+    CHECK(nullptr == slotMap.Find(h0));
+    CHECK(!slotMap.Erase(h0));
+    CHECK(slotMap[h1] == "One");
+    CHECK(slotMap[h2] == "Two");
+    CHECK(slotMap.ValueAtIndex(0) == "Two");
+    CHECK(slotMap.HandleAtIndex(0) == h2);
+
+    // the freed slot is recycled with a new generation
+    auto h3 = slotMap.Add("Three");
+    CHECK(h3.index == h0.index);
+    CHECK(h3.generation != h0.generation);
+    CHECK(h3 != h0);
+    CHECK(!slotMap.Contains(h0));
+    CHECK(slotMap[h3] == "Three");
+    CHECK(slotMap.NumSlots() == 3);
+
+    // iteration
+    int num = 0;
+    for (const String& str : slotMap) {
+        CHECK(!str.Empty());
+        num++;
+    }
+    CHECK(num == 3);
+
+    // copy and move
+    SlotMap<String> slotMap1(slotMap);
+    CHECK(slotMap1.Size() == 3);
+    CHECK(slotMap1[h1] == "One");
+    CHECK(slotMap1[h3] == "Three");
+    SlotMap<String> slotMap2(std::move(slotMap1));
+    CHECK(slotMap1.Empty());
+    CHECK(!slotMap1.Contains(h1));
+    CHECK(slotMap2.Size() == 3);
+    CHECK(slotMap2[h2] == "Two");
+    SlotMap<String> slotMap3;
+    slotMap3 = slotMap2;
+    CHECK(slotMap3[h2] == "Two");
+    slotMap1 = std::move(slotMap3);
+    CHECK(slotMap3.Empty());
+    CHECK(slotMap1[h3] == "Three");
+
+    // clear invalidates all handles
+    slotMap.Clear();
+    CHECK(slotMap.Empty());
+    CHECK(!slotMap.Contains(h1));
+    CHECK(!slotMap.Contains(h2));
+    CHECK(!slotMap.Contains(h3));
+    CHECK(slotMap.NumSlots() == 3);
+    auto h4 = slotMap.Add("Four");
+    CHECK(slotMap.Contains(h4));
+    CHECK(!slotMap.Contains(h1) && !slotMap.Contains(h2) && !slotMap.Contains(h3));
+    CHECK(slotMap.NumSlots() == 3);
+}
+
+// compare SlotMap against a Map with monotonically increasing int keys
+TEST(SlotMapPerformance) {
+
+    // NOTE: Map erase is O(N), so keep the number of elements moderate
+    const int num = 20000;
+    const int numRuns = 3;
+    for (int run = 0; run < numRuns; run++) {
+        std::chrono::time_point<std::chrono::system_clock> start, end;
+        std::chrono::duration<double> dur;
+
+        // SlotMap: add, lookup, erase half, re-add
+        {
+            SlotMap<int> slotMap;
+            Array<SlotMap<int>::Handle> handles;
+            handles.Reserve(num);
+            start = std::chrono::system_clock::now();
+            for (int i = 0; i < num; i++) {
+                handles.Add(slotMap.Add(i));
+            }
+            int sum = 0;
+            for (int i = 0; i < num; i++) {
+                sum += slotMap[handles[i]];
+            }
+            for (int i = 0; i < num; i += 2) {
+                slotMap.Erase(handles[i]);
+            }
+            for (int i = 0; i < num; i += 2) {
+                handles[i] = slotMap.Add(i);
+            }
+            for (const int& val : slotMap) {
+                sum += val;
+            }
+            end = std::chrono::system_clock::now();
+            dur = end - start;
+            CHECK(slotMap.Size() == num);
+            CHECK(sum != 0);
+            Log::Info("run %d: SlotMap<int> %d add/lookup/erase: %f sec\n", run, num, dur.count());
+        }
+
+        // Map<int,int>: same workload with increasing keys
+        {
+            Map<int, int> map;
+            Array<int> keys;
+            keys.Reserve(num);
+            int uniqueKey = 0;
+            start = std::chrono::system_clock::now();
+            for (int i = 0; i < num; i++) {
+                keys.Add(uniqueKey);
+                map.Add(uniqueKey++, i);
+            }
+            int sum = 0;
+            for (int i = 0; i < num; i++) {
+                sum += map[keys[i]];
+            }
+            for (int i = 0; i < num; i += 2) {
+                map.Erase(keys[i]);
+            }
+            for (int i = 0; i < num; i += 2) {
+                keys[i] = uniqueKey;
+                map.Add(uniqueKey++, i);
+            }
+            for (const auto& kvp : map) {
+                sum += kvp.value;
+            }
+            end = std::chrono::system_clock::now();
+            dur = end - start;
+            CHECK(map.Size() == num);
+            CHECK(sum != 0);
+            Log::Info("run %d: Map<int,int> %d add/lookup/erase: %f sec\n", run, num, dur.count());
+        }
+    }
+}
@@ -0,0 +1,206 @@
+//------------------------------------------------------------------------------
+//  SmallArrayTest.cc
+//  Test SmallArray class.
+//------------------------------------------------------------------------------
+#include "Pre.h"
+#include "UnitTest++/src/UnitTest++.h"
+#include "Core/Containers/SmallArray.h"
+#include "Core/Containers/Array.h"
+#include "Core/Containers/InlineArray.h"
+#include "Core/String/String.h"
+#include "Core/Log.h"
+#include <chrono>
+
+using namespace Oryol;
+
+TEST(SmallArrayTest) {
+
+    // create empty array, capacity is the inline capacity
+    SmallArray<String, 4> array0;
+    CHECK(array0.GetMinGrow() == ORYOL_CONTAINER_DEFAULT_MIN_GROW);
+    CHECK(array0.GetMaxGrow() == ORYOL_CONTAINER_DEFAULT_MAX_GROW);
+    CHECK(array0.Size() == 0);
+    CHECK(array0.Capacity() == 4);
+    CHECK(array0.Spare() == 4);
+    CHECK(array0.Empty());
+    CHECK(array0.IsInline());
+
+    // add elements to the inline storage
+    CHECK(array0.Add("Zero") == "Zero");
+    const String one("One");
+    CHECK(array0.Add(one) == "One");
+    CHECK(array0.Add(String("Two")) == "Two");
+    CHECK(array0.Size() == 3);
+    CHECK(array0.Capacity() == 4);
+    CHECK(array0.IsInline());
+    CHECK(array0.Front() == "Zero");
+    CHECK(array0.Back() == "Two");
+    CHECK(array0.FindIndexLinear("One") == 1);
+    CHECK(array0.FindIndexLinear("Three") == InvalidIndex);
+
+    // copy and move while inline
+    SmallArray<String, 4> array1(array0);
+    CHECK(array1.IsInline());
+    CHECK(array1.Size() == 3);
+    CHECK(array1[1] == "One");
+    SmallArray<String, 4> array2(std::move(array1));
+    CHECK(array1.Empty());
+    CHECK(array1.IsInline());
+    CHECK(array2.Size() == 3);
+    CHECK(array2[2] == "Two");
+    array1 = array2;
+    CHECK(array1.Size() == 3);
+    CHECK(array1[0] == "Zero");
+
+    // spill to the heap
+    array0.Add("Three");
+    CHECK(array0.IsInline());
+    array0.Add("Four");
+    CHECK(!array0.IsInline());
+    CHECK(array0.Size() == 5);
+    CHECK(array0.Capacity() == 4 + ORYOL_CONTAINER_DEFAULT_MIN_GROW);
+    CHECK(array0[0] == "Zero");
+    CHECK(array0[3] == "Three");
+    CHECK(array0[4] == "Four");
+
+    // copy from heap array is trimmed, move takes over the heap buffer
+    SmallArray<String, 4> array3(array0);
+    CHECK(!array3.IsInline());
+    CHECK(array3.Size() == 5);
+    CHECK(array3.Capacity() == 5);
+    const String* ptr = &array3[0];
+    SmallArray<String, 4> array4(std::move(array3));
+    CHECK(array3.Empty());
+    CHECK(array3.IsInline());
+    CHECK(array3.Capacity() == 4);
+    CHECK(&array4[0] == ptr);
+    CHECK(array4[4] == "Four");
+    array3 = std::move(array4);
+    CHECK(array4.Empty());
+    CHECK(&array3[0] == ptr);
+
+    // insert and erase
+    array0.Insert(0, "Start");
+    array0.Insert(3, String("Middle"));
+    CHECK(array0.Size() == 7);
+    CHECK(array0[0] == "Start");
+    CHECK(array0[1] == "Zero");
+    CHECK(array0[3] == "Middle");
+    CHECK(array0[6] == "Four");
+    array0.Erase(3);
+    array0.Erase(0);
+    CHECK(array0.Size() == 5);
+    CHECK(array0[0] == "Zero");
+    CHECK(array0[2] == "Two");
+    array0.EraseSwapBack(0);
+    CHECK(array0[0] == "Four");
+    array0.EraseRange(1, 2);
+    CHECK(array0.Size() == 2);
+    CHECK(array0[0] == "Four");
+    CHECK(array0[1] == "Three");
+    CHECK(array0.PopBack() == "Three");
+    CHECK(array0.PopFront() == "Four");
+    CHECK(array0.Empty());
+
+    // trim moves back into the inline storage
+    array0.Add("A");
+    array0.Add("B");
+    CHECK(!array0.IsInline());
+    array0.Trim();
+    CHECK(array0.IsInline());
+    CHECK(array0.Capacity() == 4);
+    CHECK(array0[0] == "A");
+    CHECK(array0[1] == "B");
+
+    // reserve spills directly
+    SmallArray<int, 8> array5 = { 1, 2, 3 };
+    CHECK(array5.IsInline());
+    array5.Reserve(5);
+    CHECK(array5.IsInline());
+    array5.Reserve(6);
+    CHECK(!array5.IsInline());
+    CHECK(array5.Capacity() == 9);
+    int sum = 0;
+    for (int i : array5) {
+        sum += i;
+    }
+    CHECK(sum == 6);
+    CHECK(array5.MakeSlice(1).Size() == 2);
+
+    // clear keeps the heap buffer
+    array5.Clear();
+    CHECK(array5.Empty());
+    CHECK(array5.Capacity() == 9);
+}
+
+//------------------------------------------------------------------------------
+// create, fill, iterate and destroy many small arrays
+template<class ARRAY> static double
+smallArrayWorkload(ARRAY& array, int numRuns, int& outSum) {
+    std::chrono::time_point<std::chrono::system_clock> start, end;
+    start = std::chrono::system_clock::now();
+    for (int run = 0; run < numRuns; run++) {
+        ARRAY a;
+        const int num = run & 7;
+        for (int i = 0; i < num; i++) {
+            a.Add(i);
+        }
+        for (int i : a) {
+            outSum += i;
+        }
+        if (num == 7) {
+            array = a;
+        }
+    }
+    end = std::chrono::system_clock::now();
+    std::chrono::duration<double> dur = end - start;
+    return dur.count();
+}
+
+TEST(SmallArrayPerformance) {
+    const int numRuns = 1000000;
+    int sum = 0;
+    Array<int> array;
+    double t = smallArrayWorkload(array, numRuns, sum);
+    Log::Info("Array<int>: %d small arrays: %f sec\n", numRuns, t);
+    SmallArray<int, 8> smallArray;
+    t = smallArrayWorkload(smallArray, numRuns, sum);
+    Log::Info("SmallArray<int,8>: %d small arrays: %f sec\n", numRuns, t);
+    InlineArray<int, 8> inlineArray;
+    t = smallArrayWorkload(inlineArray, numRuns, sum);
+    Log::Info("InlineArray<int,8>: %d small arrays: %f sec\n", numRuns, t);
+    CHECK(sum != 0);
+    CHECK(array.Size() == 7);
+    CHECK(smallArray.Size() == 7);
+    CHECK(inlineArray.Size() == 7);
+
+    // same with strings which spill to the heap now and then
+    const int numStringRuns = numRuns / 10;
+    std::chrono::time_point<std::chrono::system_clock> start, end;
+    std::chrono::duration<double> dur;
+    String str("Bla");
+    int num = 0;
+    start = std::chrono::system_clock::now();
+    for (int run = 0; run < numStringRuns; run++) {
+        Array<String> a;
+        for (int i = 0; i < (run & 15); i++) {
+            a.Add(str);
+        }
+        num += a.Size();
+    }
+    end = std::chrono::system_clock::now();
+    dur = end - start;
+    Log::Info("Array<String>: %d arrays with 0..15 elements: %f sec\n", numStringRuns, dur.count());
+    start = std::chrono::system_clock::now();
+    for (int run = 0; run < numStringRuns; run++) {
+        SmallArray<String, 8> a;
+        for (int i = 0; i < (run & 15); i++) {
+            a.Add(str);
+        }
+        num -= a.Size();
+    }
+    end = std::chrono::system_clock::now();
+    dur = end - start;
+    Log::Info("SmallArray<String,8>: %d arrays with 0..15 elements: %f sec\n", numStringRuns, dur.count());
+    CHECK(num == 0);
+}
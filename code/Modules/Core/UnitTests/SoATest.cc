@@ -0,0 +1,185 @@
+//------------------------------------------------------------------------------
+//  SoATest.cc
+//  Test SoA (structure-of-arrays) container.
+//------------------------------------------------------------------------------
+#include "Pre.h"
+#include "UnitTest++/src/UnitTest++.h"
+#include "Core/Containers/SoA.h"
+#include "Core/Containers/Array.h"
+#include "Core/String/String.h"
+#include "Core/Log.h"
+#include <chrono>
+
+using namespace Oryol;
+
+TEST(SoATest) {
+
+    SoA<int, float, String> soa;
+    CHECK(soa.NumFields == 3);
+    CHECK(soa.GetMinGrow() == ORYOL_CONTAINER_DEFAULT_MIN_GROW);
+    CHECK(soa.GetMaxGrow() == ORYOL_CONTAINER_DEFAULT_MAX_GROW);
+    CHECK(soa.Size() == 0);
+    CHECK(soa.Empty());
+    CHECK(soa.Capacity() == 0);
+    CHECK(soa.Data<0>() == nullptr);
+    CHECK(soa.MakeSlice<0>().Empty());
+
+    // add elements
+    CHECK(soa.Add(0, 0.0f, "Zero") == 0);
+    CHECK(soa.Add(1, 1.0f, "One") == 1);
+    CHECK(soa.Add() == 2);
+    soa.Get<0>(2) = 2;
+    soa.Get<1>(2) = 2.0f;
+    soa.Get<2>(2) = "Two";
+    CHECK(soa.Size() == 3);
+    CHECK(!soa.Empty());
+    CHECK(soa.Capacity() == ORYOL_CONTAINER_DEFAULT_MIN_GROW);
+    for (int i = 0; i < 3; i++) {
+        CHECK(soa.Get<0>(i) == i);
+        CHECK(soa.Get<1>(i) == float(i));
+    }
+    CHECK(soa.Get<2>(0) == "Zero");
+    CHECK(soa.Get<2>(1) == "One");
+    CHECK(soa.Get<2>(2) == "Two");
+
+    // columns are aligned
+    CHECK((intptr_t(soa.Data<0>()) & (soa.Alignment - 1)) == 0);
+    CHECK((intptr_t(soa.Data<1>()) & (soa.Alignment - 1)) == 0);
+    CHECK((intptr_t(soa.Data<2>()) & (soa.Alignment - 1)) == 0);
+
+    // slices
+    Slice<float> floats = soa.MakeSlice<1>();
+    CHECK(floats.Size() == 3);
+    for (float& f : floats) {
+        f *= 2.0f;
+    }
+    CHECK(soa.Get<1>(2) == 4.0f);
+    Slice<int> ints = soa.MakeSlice<0>(1, 2);
+    CHECK(ints.Size() == 2);
+    CHECK(ints[0] == 1);
+
+    // grow beyond initial capacity
+    for (int i = 3; i < 100; i++) {
+        soa.Add(i, float(i), "Bla");
+    }
+    CHECK(soa.Size() == 100);
+    CHECK(soa.Capacity() >= 100);
+    for (int i = 0; i < 100; i++) {
+        CHECK(soa.Get<0>(i) == i);
+    }
+    CHECK(soa.Get<2>(1) == "One");
+
+    // copy and move
+    SoA<int, float, String> soa1(soa);
+    CHECK(soa1.Size() == 100);
+    CHECK(soa1.Capacity() == 100);
+    CHECK(soa1.Get<2>(2) == "Two");
+    SoA<int, float, String> soa2(std::move(soa1));
+    CHECK(soa1.Empty());
+    CHECK(soa1.Capacity() == 0);
+    CHECK(soa2.Size() == 100);
+    CHECK(soa2.Get<0>(99) == 99);
+    SoA<int, float, String> soa3;
+    soa3 = soa2;
+    CHECK(soa3.Size() == 100);
+    CHECK(soa3.Get<2>(0) == "Zero");
+    soa1 = std::move(soa3);
+    CHECK(soa3.Empty());
+    CHECK(soa1.Size() == 100);
+
+    // erase keeps order
+    soa.Erase(1);
+    CHECK(soa.Size() == 99);
+    CHECK(soa.Get<0>(0) == 0);
+    CHECK(soa.Get<0>(1) == 2);
+    CHECK(soa.Get<2>(1) == "Two");
+    CHECK(soa.Get<0>(98) == 99);
+
+    // erase-swap moves last element into gap
+    soa.EraseSwap(0);
+    CHECK(soa.Size() == 98);
+    CHECK(soa.Get<0>(0) == 99);
+    CHECK(soa.Get<0>(1) == 2);
+    soa.EraseSwap(97);
+    CHECK(soa.Size() == 97);
+    CHECK(soa.Get<0>(96) == 97);
+
+    // clear keeps capacity
+    const int cap = soa.Capacity();
+    soa.Clear();
+    CHECK(soa.Empty());
+    CHECK(soa.Capacity() == cap);
+
+    // reserve
+    SoA<uint8_t> soa4;
+    soa4.Reserve(10);
+    CHECK(soa4.Capacity() == 10);
+    CHECK(soa4.Size() == 0);
+}
+
+//------------------------------------------------------------------------------
+// particle update, SoA versus array-of-structs
+struct testParticle {
+    float pos[4];
+    float vec[4];
+    float color[4];
+    float age;
+    float size;
+    uint32_t flags;
+    uint32_t pad;
+};
+
+TEST(SoAPerformance) {
+
+    const int numParticles = 1000000;
+    const int numFrames = 10;
+    const float dt = 1.0f / 60.0f;
+
+    Array<testParticle> aos;
+    aos.Reserve(numParticles);
+    SoA<float, float, float, float, float, float, float, float> soa;
+    soa.Reserve(numParticles);
+    for (int i = 0; i < numParticles; i++) {
+        testParticle p = { };
+        p.vec[0] = 1.0f; p.vec[1] = 2.0f; p.vec[2] = 3.0f;
+        aos.Add(p);
+        soa.Add(0.0f, 0.0f, 0.0f, 1.0f, 2.0f, 3.0f, 0.0f, 1.0f);
+    }
+
+    std::chrono::time_point<std::chrono::system_clock> start, end;
+    start = std::chrono::system_clock::now();
+    for (int frame = 0; frame < numFrames; frame++) {
+        for (testParticle& p : aos) {
+            p.pos[0] += p.vec[0] * dt;
+            p.pos[1] += p.vec[1] * dt;
+            p.pos[2] += p.vec[2] * dt;
+            p.age += dt;
+        }
+    }
+    end = std::chrono::system_clock::now();
+    std::chrono::duration<double> dur = end - start;
+    Log::Info("Array<struct>: %d frames x %d particles updated: %f sec\n", numFrames, numParticles, dur.count());
+
+    start = std::chrono::system_clock::now();
+    for (int frame = 0; frame < numFrames; frame++) {
+        float* px = soa.Data<0>();
+        float* py = soa.Data<1>();
+        float* pz = soa.Data<2>();
+        const float* vx = soa.Data<3>();
+        const float* vy = soa.Data<4>();
+        const float* vz = soa.Data<5>();
+        float* age = soa.Data<6>();
+        const int num = soa.Size();
+        for (int i = 0; i < num; i++) {
+            px[i] += vx[i] * dt;
+            py[i] += vy[i] * dt;
+            pz[i] += vz[i] * dt;
+            age[i] += dt;
+        }
+    }
+    end = std::chrono::system_clock::now();
+    dur = end - start;
+    Log::Info("SoA: %d frames x %d particles updated: %f sec\n", numFrames, numParticles, dur.count());
+
+    CHECK(aos[numParticles - 1].pos[2] == soa.Get<2>(numParticles - 1));
+}
@@ -11,6 +11,7 @@
 #include <cstring>
 #include <thread>
 #include <array>
+#include <cstdio>
 
 using namespace std;
 using namespace Oryol;
@@ -56,17 +57,16 @@ TEST(StringAtomSingleThreaded) {
 }
 
 #if ORYOL_HAS_THREADS
-// must use reference, the copy would fail since there is no thread-local
-// string-atom table yet
 static void threadFunc(const StringAtom& a0) {
     
     Oryol::Core::EnterThread();
     
-    // transfer into a thread-local string atom
+    // atoms are shared between threads
     StringAtom a1(a0);
-    StringAtom a2(a0);
+    StringAtom a2("BLOB");
     CHECK(a0 == a1);
     CHECK(a1 == a2);
+    CHECK(a2.AsCStr() == a0.AsCStr());
     CHECK(a1.AsString() == "BLOB");
     CHECK(a0.AsString() == "BLOB");
     CHECK(a2.AsString() == "BLOB");
@@ -81,6 +81,87 @@ TEST(StringAtomMultiThreaded) {
     std::thread t1(threadFunc, std::ref(atom0));
     t1.join();
 }
+
+// intern the same strings from several threads at the same time,
+// all threads must end up with identical atoms
+TEST(StringAtomConcurrentIntern) {
+
+    const int numThreads = 4;
+    const int num = 20000;
+    Array<StringAtom> atoms[numThreads];
+    std::thread threads[numThreads];
+    for (int t = 0; t < numThreads; t++) {
+        threads[t] = std::thread([t, &atoms] {
+            char buf[32];
+            atoms[t].Reserve(num);
+            for (int i = 0; i < num; i++) {
+                // each thread walks the strings in a different order
+                const int index = (t & 1) ? (num - 1 - i) : i;
+                std::snprintf(buf, sizeof(buf), "concurrent_%d", index);
+                atoms[t].Add(StringAtom(buf));
+            }
+        });
+    }
+    for (int t = 0; t < numThreads; t++) {
+        threads[t].join();
+    }
+    bool identical = true;
+    for (int t = 1; t < numThreads; t++) {
+        for (int i = 0; i < num; i++) {
+            const int index = (t & 1) ? (num - 1 - i) : i;
+            if (atoms[t][i].AsCStr() != atoms[0][index].AsCStr()) {
+                identical = false;
+            }
+        }
+    }
+    CHECK(identical);
+    CHECK(atoms[1][0] == "concurrent_19999");
+}
+
+// test string atom creation and comparison from multiple threads
+TEST(StringAtomMultiThreadedPerformance) {
+
+    const int num = 100000;
+    Array<String> strings;
+    strings.Reserve(num);
+    char buf[32];
+    for (int i = 0; i < num; i++) {
+        std::snprintf(buf, sizeof(buf), "mt_%d", i);
+        strings.Add(buf);
+    }
+    // the atoms to compare against are created on the main thread
+    Array<StringAtom> mainAtoms;
+    mainAtoms.Reserve(num);
+    for (const String& str : strings) {
+        mainAtoms.Add(str);
+    }
+
+    for (int numThreads = 1; numThreads <= 4; numThreads *= 2) {
+        chrono::time_point<chrono::system_clock> start, end;
+        start = chrono::system_clock::now();
+        std::thread threads[4];
+        int numEqual[4] = { };
+        for (int t = 0; t < numThreads; t++) {
+            threads[t] = std::thread([t, &strings, &mainAtoms, &numEqual] {
+                for (int i = 0; i < num; i++) {
+                    StringAtom atom(strings[i]);
+                    if (atom == mainAtoms[i]) {
+                        numEqual[t]++;
+                    }
+                }
+            });
+        }
+        for (int t = 0; t < numThreads; t++) {
+            threads[t].join();
+        }
+        end = chrono::system_clock::now();
+        chrono::duration<double> dur = end - start;
+        Log::Info("%d threads: %dx StringAtoms created and compared per thread: %f sec\n", numThreads, num, dur.count());
+        for (int t = 0; t < numThreads; t++) {
+            CHECK(numEqual[t] == num);
+        }
+    }
+}
 #endif
 
 // test string atom creation performance
@@ -109,4 +190,45 @@ TEST(StringAtomPerformance) {
         chrono::duration<double> dur = end - start;
         Log::Info("run %d: %dx StringAtoms created: %f sec\n", i, numStringAtoms, dur.count());
     }
+}
+
+// test interning performance with large numbers of unique atoms,
+// this exercises the growing of the string atom hash table
+TEST(StringAtomInternPerformance) {
+
+    const int numAtoms[] = { 10000, 100000, 1000000 };
+    int runIndex = 0;
+    for (int num : numAtoms) {
+        // build unique strings upfront so that only interning is measured
+        Array<String> strings;
+        strings.Reserve(num);
+        char buf[32];
+        for (int i = 0; i < num; i++) {
+            std::snprintf(buf, sizeof(buf), "intern_%d_%d", runIndex, i);
+            strings.Add(buf);
+        }
+        runIndex++;
+
+        Array<StringAtom> atoms;
+        atoms.Reserve(num);
+        chrono::time_point<chrono::system_clock> start, end;
+        start = chrono::system_clock::now();
+        for (const String& str : strings) {
+            atoms.Add(str);
+        }
+        end = chrono::system_clock::now();
+        chrono::duration<double> dur = end - start;
+        Log::Info("%d unique StringAtoms interned: %f sec\n", num, dur.count());
+
+        // lookup of existing atoms
+        start = chrono::system_clock::now();
+        for (const String& str : strings) {
+            StringAtom atom(str);
+            CHECK(atom.IsValid());
+        }
+        end = chrono::system_clock::now();
+        dur = end - start;
+        Log::Info("%d existing StringAtoms looked up: %f sec\n", num, dur.count());
+        CHECK(atoms[num / 2].AsString() == strings[num / 2]);
+    }
 }
\ No newline at end of file
@@ -4,6 +4,10 @@
 #include "Pre.h"
 #include "UnitTest++/src/UnitTest++.h"
 #include "Core/String/StringBuilder.h"
+#include "Core/Memory/Memory.h"
+#include "Core/Log.h"
+#include <chrono>
+#include <cstring>
 
 using namespace Oryol;
 
@@ -215,3 +219,206 @@ TEST(StringBuilderTest) {
     CHECK(builder.GetString() == "One: 1, Two: 2, Three: 3 Bla: 46");
 }
 
+//------------------------------------------------------------------------------
+// reference implementations for the search functions
+static int refFindFirstOf(const char* str, int start, int end, const char* delims, bool inSet) {
+    for (int i = start; i < end; i++) {
+        if ((nullptr != std::strchr(delims, str[i])) == inSet) {
+            return i;
+        }
+    }
+    return InvalidIndex;
+}
+static int refFindLastOf(const char* str, int start, int end, const char* delims, bool inSet) {
+    for (int i = end - 1; i >= start; i--) {
+        if ((nullptr != std::strchr(delims, str[i])) == inSet) {
+            return i - start;
+        }
+    }
+    return InvalidIndex;
+}
+static int refFindSubString(const char* str, int start, int end, const char* subStr) {
+    const char* occur = std::strstr(str + start, subStr);
+    return (occur && ((occur - str) < end)) ? int(occur - str) : InvalidIndex;
+}
+
+TEST(StringBuilderSearchTest) {
+    // random strings over a small alphabet with lengths crossing SIMD block boundaries
+    const char* alphabet = "abcd:/. ";
+    const char* delimSets[] = { "", ":", "/.", "ab", "abcd:/. ", "x", "dcba:/.", "0123456789abcdefgh" };
+    const char* subStrings[] = { "a", "ab", "abc", "d:/", "abcd", ". a", "aaaa", "b:/.c", "abcdabcdabcdabcdabcd" };
+    char str[100];
+    uint32_t x = 1;
+    for (int iter = 0; iter < 2000; iter++) {
+        x = x * 1664525 + 1013904223;
+        const int len = int((x >> 8) % (sizeof(str) - 1));
+        for (int i = 0; i < len; i++) {
+            x = x * 1664525 + 1013904223;
+            // bias towards fewer delimiter chars
+            str[i] = alphabet[((x >> 24) & 7) & (((x >> 8) & 1) ? 7 : 3)];
+        }
+        str[len] = 0;
+        x = x * 1664525 + 1013904223;
+        const int start = (len > 0) ? int((x >> 8) % len) : 0;
+        const int end = (len > 0) ? (start + int((x >> 16) % (len - start + 1))) : 0;
+        StringBuilder builder(str);
+        for (const char* delims : delimSets) {
+            CHECK(StringBuilder::FindFirstOf(str, start, end, delims) == refFindFirstOf(str, start, end, delims, true));
+            CHECK(StringBuilder::FindFirstOf(str, start, EndOfString, delims) == refFindFirstOf(str, start, len, delims, true));
+            CHECK(StringBuilder::FindFirstNotOf(str, start, end, delims) == refFindFirstOf(str, start, end, delims, false));
+            CHECK(StringBuilder::FindLastOf(str, start, end, delims) == refFindLastOf(str, start, end, delims, true));
+            CHECK(StringBuilder::FindLastNotOf(str, start, EndOfString, delims) == refFindLastOf(str, start, len, delims, false));
+            if (len > 0) {
+                CHECK(builder.FindFirstOf(start, end, delims) == refFindFirstOf(str, start, end, delims, true));
+                CHECK(builder.FindLastNotOf(start, end, delims) == refFindLastOf(str, start, end, delims, false));
+            }
+        }
+        for (const char* subStr : subStrings) {
+            CHECK(StringBuilder::FindSubString(str, start, end, subStr) == refFindSubString(str, start, end, subStr));
+            CHECK(StringBuilder::FindSubString(str, start, EndOfString, subStr) == refFindSubString(str, start, len, subStr));
+
+            // SubstituteAll, compare with repeated search and replace
+            StringBuilder ref;
+            const int subStrLen = int(std::strlen(subStr));
+            int numRef = 0;
+            const char* ptr = str;
+            const char* occur;
+            while (nullptr != (occur = std::strstr(ptr, subStr))) {
+                ref.Append(ptr, 0, int(occur - ptr));
+                ref.Append("<>");
+                ptr = occur + subStrLen;
+                numRef++;
+            }
+            ref.Append(ptr);
+            StringBuilder subst(str);
+            CHECK(subst.SubstituteAll(subStr, "<>") == numRef);
+            CHECK(subst.GetString() == ref.GetString());
+        }
+    }
+
+    // substitutions which shrink, grow, or remove the match
+    StringBuilder builder("a--b--c--");
+    CHECK(builder.SubstituteAll("--", "-") == 3);
+    CHECK(builder.GetString() == "a-b-c-");
+    CHECK(builder.SubstituteAll("-", "") == 3);
+    CHECK(builder.GetString() == "abc");
+    CHECK(builder.SubstituteAll("b", "bbb") == 1);
+    CHECK(builder.GetString() == "abbbc");
+    CHECK(builder.SubstituteAll("x", "y") == 0);
+    CHECK(builder.GetString() == "abbbc");
+    CHECK(builder.SubstituteAll("abbbc", "") == 1);
+    CHECK(builder.GetString() == "");
+    CHECK(builder.Length() == 0);
+}
+
+TEST(StringBuilderSearchPerformance) {
+    // 16 KB of text with a path separator every few words, and a rare match at the end
+    StringBuilder builder;
+    uint32_t x = 1;
+    while (builder.Length() < 16 * 1024) {
+        x = x * 1664525 + 1013904223;
+        const char* words[] = { "lorem ", "ipsum ", "dolor ", "sit ", "amet ", "consectetur ", "adipiscing ", "elit/" };
+        builder.Append(words[(x >> 16) & 7]);
+    }
+    builder.Append("needle:1234");
+    const String text = builder.GetString();
+    const char* str = text.AsCStr();
+    const int len = text.Length();
+    const int numIters = 2000;
+
+    std::chrono::time_point<std::chrono::system_clock> t0, t1;
+    std::chrono::duration<double> dur;
+    int res = 0;
+
+    // FindFirstOf vs strcspn
+    t0 = std::chrono::system_clock::now();
+    for (int i = 0; i < numIters; i++) {
+        res += int(std::strcspn(str + (i & 7), ":@"));
+    }
+    t1 = std::chrono::system_clock::now();
+    dur = t1 - t0;
+    Log::Info("strcspn(%d KB): %f sec\n", len / 1024, dur.count());
+    t0 = std::chrono::system_clock::now();
+    for (int i = 0; i < numIters; i++) {
+        res += builder.FindFirstOf(i & 7, EndOfString, ":@");
+    }
+    t1 = std::chrono::system_clock::now();
+    dur = t1 - t0;
+    Log::Info("StringBuilder::FindFirstOf(%d KB): %f sec\n", len / 1024, dur.count());
+
+    // bounded search (e.g. URL parsing), strcspn always scans to the end of the string
+    t0 = std::chrono::system_clock::now();
+    for (int i = 0; i < numIters; i++) {
+        const int index = int(std::strcspn(str + (i & 7), "@")) + (i & 7);
+        res += (index < 64) ? index : InvalidIndex;
+    }
+    t1 = std::chrono::system_clock::now();
+    dur = t1 - t0;
+    Log::Info("strcspn(%d KB), first 64 bytes: %f sec\n", len / 1024, dur.count());
+    t0 = std::chrono::system_clock::now();
+    for (int i = 0; i < numIters; i++) {
+        res += builder.FindFirstOf(i & 7, 64, "@");
+    }
+    t1 = std::chrono::system_clock::now();
+    dur = t1 - t0;
+    Log::Info("StringBuilder::FindFirstOf(%d KB), first 64 bytes: %f sec\n", len / 1024, dur.count());
+
+    // FindLastOf, scanning backwards
+    t0 = std::chrono::system_clock::now();
+    for (int i = 0; i < numIters; i++) {
+        res += refFindLastOf(str, 0, len - 16 - (i & 7), "@#", true);
+    }
+    t1 = std::chrono::system_clock::now();
+    dur = t1 - t0;
+    Log::Info("strchr loop(%d KB), backwards: %f sec\n", len / 1024, dur.count());
+    t0 = std::chrono::system_clock::now();
+    for (int i = 0; i < numIters; i++) {
+        res += builder.FindLastOf(0, len - 16 - (i & 7), "@#");
+    }
+    t1 = std::chrono::system_clock::now();
+    dur = t1 - t0;
+    Log::Info("StringBuilder::FindLastOf(%d KB): %f sec\n", len / 1024, dur.count());
+
+    // FindSubString vs strstr
+    t0 = std::chrono::system_clock::now();
+    for (int i = 0; i < numIters; i++) {
+        res += int(std::strstr(str + (i & 7), "needle:") - str);
+    }
+    t1 = std::chrono::system_clock::now();
+    dur = t1 - t0;
+    Log::Info("strstr(%d KB): %f sec\n", len / 1024, dur.count());
+    t0 = std::chrono::system_clock::now();
+    for (int i = 0; i < numIters; i++) {
+        res += builder.FindSubString(i & 7, EndOfString, "needle:");
+    }
+    t1 = std::chrono::system_clock::now();
+    dur = t1 - t0;
+    Log::Info("StringBuilder::FindSubString(%d KB): %f sec\n", len / 1024, dur.count());
+    CHECK(res != 0);
+
+    // SubstituteAll vs. substituting one match at a time
+    const int numSubstIters = 100;
+    int numAllocs = Memory::NumAllocs();
+    t0 = std::chrono::system_clock::now();
+    for (int i = 0; i < numSubstIters; i++) {
+        StringBuilder subst(text);
+        int index = 0;
+        while (InvalidIndex != (index = subst.FindSubString(index, EndOfString, "/"))) {
+            subst.SubstituteRange(index, index + 1, "\\\\");
+            index += 2;
+        }
+    }
+    t1 = std::chrono::system_clock::now();
+    dur = t1 - t0;
+    Log::Info("SubstituteRange per match(%d KB): %f sec, %d allocs\n", len / 1024, dur.count(), Memory::NumAllocs() - numAllocs);
+    numAllocs = Memory::NumAllocs();
+    t0 = std::chrono::system_clock::now();
+    for (int i = 0; i < numSubstIters; i++) {
+        StringBuilder subst(text);
+        subst.SubstituteAll("/", "\\\\");
+    }
+    t1 = std::chrono::system_clock::now();
+    dur = t1 - t0;
+    Log::Info("StringBuilder::SubstituteAll(%d KB): %f sec, %d allocs\n", len / 1024, dur.count(), Memory::NumAllocs() - numAllocs);
+    CHECK((Memory::NumAllocs() - numAllocs) <= (2 * numSubstIters));
+}
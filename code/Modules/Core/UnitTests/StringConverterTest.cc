@@ -4,6 +4,16 @@
 #include "Pre.h"
 #include "UnitTest++/src/UnitTest++.h"
 #include "Core/String/StringConverter.h"
+#include "Core/String/StringBuilder.h"
+#include "Core/String/utf8Codec.h"
+#include "Core/String/ConvertUTF.h"
+#include "Core/Containers/Array.h"
+#include "Core/Log.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
 
 using namespace Oryol;
 
@@ -37,6 +47,225 @@ TEST(StringConverterTest_UTF8) {
     CHECK(ldst == longString);
 }
 
+TEST(StringConverterTest_UTF8Characters) {
+
+    // 1..4 byte sequences and surrogate pairs on UTF-16 platforms
+    const unsigned char utf8[] = "A\xC3\xA4\xE2\x82\xAC\xF0\x9F\x98\x80Z";
+    wchar_t wide[16];
+    const int numWide = StringConverter::UTF8ToWide(utf8, int(sizeof(utf8)) - 1, wide, sizeof(wide));
+    if (sizeof(wchar_t) == 4) {
+        CHECK(numWide == 6);
+        CHECK(wide[3] == wchar_t(0x1F600));
+    }
+    else {
+        CHECK(numWide == 7);
+        CHECK((wide[3] == wchar_t(0xD83D)) && (wide[4] == wchar_t(0xDE00)));
+    }
+    CHECK((wide[0] == L'A') && (wide[1] == wchar_t(0xE4)) && (wide[2] == wchar_t(0x20AC)));
+    CHECK(wide[numWide - 2] == L'Z');
+    CHECK(wide[numWide - 1] == 0);
+    unsigned char back[16];
+    CHECK(StringConverter::WideToUTF8(wide, numWide - 1, back, sizeof(back)) == int(sizeof(utf8)));
+    CHECK(0 == std::memcmp(back, utf8, sizeof(utf8)));
+
+    // target buffer too small
+    wchar_t smallWide[4];
+    CHECK(0 == StringConverter::UTF8ToWide(utf8, int(sizeof(utf8)) - 1, smallWide, sizeof(smallWide)));
+    unsigned char smallUtf8[8];
+    CHECK(0 == StringConverter::WideToUTF8(wide, numWide - 1, smallUtf8, sizeof(smallUtf8)));
+
+    // lone surrogates in wide strings
+    const wchar_t badWide[] = { L'a', wchar_t(0xD800), L'b', 0 };
+    CHECK(0 == StringConverter::WideToUTF8(badWide, 3, back, sizeof(back)));
+    const wchar_t badWide2[] = { L'a', wchar_t(0xDC00), 0 };
+    CHECK(0 == StringConverter::WideToUTF8(badWide2, 2, back, sizeof(back)));
+}
+
+TEST(StringConverterTest_ValidateUTF8) {
+    struct testCase {
+        const char* str;
+        bool valid;
+    };
+    const testCase cases[] = {
+        { "", true },
+        { "Hello World", true },
+        { "H\xC3\xA4llo W\xC3\xB6rld", true },
+        { "\xE2\x82\xAC", true },
+        { "\xF0\x9F\x98\x80", true },
+        { "\xEF\xBF\xBF", true },                       // U+FFFF
+        { "\xF4\x8F\xBF\xBF", true },                   // U+10FFFF
+        { "\xED\x9F\xBF", true },                       // U+D7FF
+        { "\xEE\x80\x80", true },                       // U+E000
+        { "\x80", false },                              // lone continuation
+        { "a\xBF", false },
+        { "\xC3", false },                              // truncated
+        { "\xE2\x82", false },
+        { "\xF0\x9F\x98", false },
+        { "\xC3\x41", false },                          // missing continuation
+        { "\xC0\xAF", false },                          // overlong
+        { "\xC1\xBF", false },
+        { "\xE0\x9F\xBF", false },
+        { "\xF0\x8F\xBF\xBF", false },
+        { "\xED\xA0\x80", false },                      // surrogates
+        { "\xED\xBF\xBF", false },
+        { "\xF4\x90\x80\x80", false },                  // > U+10FFFF
+        { "\xF5\x80\x80\x80", false },
+        { "\xFF", false },
+        { "\xC3\xA4\xA4", false },                      // too many continuations
+        { "\xF0\x9F\x98\x80\x80", false },
+        { "\xF4\x20\xB7\x9F", false },                  // accepted by ConvertUTF
+    };
+    // place each case at every offset within and across 16-byte blocks
+    char buf[64];
+    for (const testCase& tc : cases) {
+        const int len = int(std::strlen(tc.str));
+        for (int offset = 0; offset < 40; offset++) {
+            std::memset(buf, 'x', sizeof(buf));
+            std::memcpy(buf + offset, tc.str, len);
+            for (int total : { offset + len, int(sizeof(buf)) }) {
+                const unsigned char* ptr = (const unsigned char*) buf;
+                CHECK(utf8Codec::ValidateScalar(ptr, total) == tc.valid);
+                CHECK(StringConverter::ValidateUTF8(ptr, total) == tc.valid);
+            }
+        }
+    }
+
+    // compare SIMD and scalar validation on randomly corrupted mixed-script text,
+    // and the decoded valid strings with ConvertUTF (which can't be used as reference
+    // for validation, since it accepts some invalid 4-byte sequences)
+    const char* text = "Gr\xC3\xBC\xC3\x9F" "e \xD0\x9F\xD1\x80\xD0\xB8\xD0\xB2\xD0\xB5\xD1\x82 "
+        "\xE4\xBD\xA0\xE5\xA5\xBD \xF0\x9F\x98\x80 \xCE\xB1\xCE\xB2\xCE\xB3 hello world ";
+    const int textLen = int(std::strlen(text));
+    unsigned char rnd[256];
+    UTF32 utf32[256];
+    uint32_t x = 1;
+    int numValid = 0;
+    for (int i = 0; i < 20000; i++) {
+        for (int j = 0; j < int(sizeof(rnd)); j++) {
+            rnd[j] = (unsigned char) text[j % textLen];
+        }
+        const int numMutations = i & 3;
+        for (int k = 0; k < numMutations; k++) {
+            x = x * 1664525 + 1013904223;
+            rnd[(x >> 8) % sizeof(rnd)] = (unsigned char) (x >> 24);
+        }
+        x = x * 1664525 + 1013904223;
+        const int len = int((x >> 8) % sizeof(rnd));
+        const UTF8* srcPtr = rnd;
+        UTF32* dstPtr = utf32;
+        const bool valid = StringConverter::ValidateUTF8(rnd, len);
+        CHECK(utf8Codec::ValidateScalar(rnd, len) == valid);
+        numValid += valid ? 1 : 0;
+        if (valid && (sizeof(wchar_t) == 4)) {
+            CHECK(conversionOK == ConvertUTF8toUTF32(&srcPtr, rnd + len, &dstPtr, utf32 + 256, strictConversion));
+            wchar_t wide[257];
+            const int numWide = StringConverter::UTF8ToWide(rnd, len, wide, sizeof(wide));
+            CHECK((numWide - 1) == int(dstPtr - utf32));
+            CHECK(0 == std::memcmp(wide, utf32, (numWide - 1) * sizeof(wchar_t)));
+        }
+    }
+    CHECK((numValid > 0) && (numValid < 20000));
+}
+
+TEST(StringConverterTest_UTF8Performance) {
+    // 4 MB ASCII text, and 4 MB mixed-script text (Latin, Cyrillic, CJK, emoji)
+    const int numBytes = 4 * 1024 * 1024;
+    const char* asciiLine = "The quick brown fox jumps over the lazy dog, 0123456789.\n";
+    const char* mixedLine = "Gr\xC3\xBC\xC3\x9F" "e, \xD0\x9F\xD1\x80\xD0\xB8\xD0\xB2\xD0\xB5\xD1\x82 "
+        "\xD0\xBC\xD0\xB8\xD1\x80, \xE4\xBD\xA0\xE5\xA5\xBD\xE4\xB8\x96\xE7\x95\x8C "
+        "\xF0\x9F\x98\x80 hello world.\n";
+    for (const char* line : { asciiLine, mixedLine }) {
+        const bool ascii = (line == asciiLine);
+        const int lineLen = int(std::strlen(line));
+        Array<unsigned char> src;
+        src.Reserve(numBytes + lineLen);
+        while (src.Size() < numBytes) {
+            for (int i = 0; i < lineLen; i++) {
+                src.Add((unsigned char) line[i]);
+            }
+        }
+        const int srcLen = src.Size();
+        const double mb = double(srcLen) / (1024.0 * 1024.0);
+        Array<wchar_t> wide;
+        wide.Reserve(srcLen + 1);
+        for (int i = 0; i <= srcLen; i++) {
+            wide.Add(0);
+        }
+        Array<unsigned char> utf8;
+        utf8.Reserve(srcLen + 1);
+        for (int i = 0; i <= srcLen; i++) {
+            utf8.Add(0);
+        }
+
+        std::chrono::time_point<std::chrono::system_clock> t0, t1;
+        std::chrono::duration<double> dur;
+        const char* name = ascii ? "ASCII" : "mixed";
+
+        // validation
+        t0 = std::chrono::system_clock::now();
+        bool valid = utf8Codec::ValidateScalar(&src[0], srcLen);
+        t1 = std::chrono::system_clock::now();
+        dur = t1 - t0;
+        Log::Info("ValidateUTF8 scalar (%s): %f sec, %f MB/sec\n", name, dur.count(), mb / dur.count());
+        CHECK(valid);
+        t0 = std::chrono::system_clock::now();
+        valid = StringConverter::ValidateUTF8(&src[0], srcLen);
+        t1 = std::chrono::system_clock::now();
+        dur = t1 - t0;
+        Log::Info("ValidateUTF8 (%s, SIMD: %s): %f sec, %f MB/sec\n", name, utf8Codec::HasSIMD() ? "yes" : "no", dur.count(), mb / dur.count());
+        CHECK(valid);
+
+        // UTF-8 to wide, ConvertUTF reference
+        int numRefChars = 0;
+        t0 = std::chrono::system_clock::now();
+        const UTF8* srcPtr = &src[0];
+        if (sizeof(wchar_t) == 4) {
+            UTF32* dstPtr = (UTF32*) &wide[0];
+            ConvertUTF8toUTF32(&srcPtr, &src[0] + srcLen, &dstPtr, dstPtr + srcLen, strictConversion);
+            numRefChars = int(dstPtr - (UTF32*) &wide[0]);
+        }
+        else {
+            UTF16* dstPtr = (UTF16*) &wide[0];
+            ConvertUTF8toUTF16(&srcPtr, &src[0] + srcLen, &dstPtr, dstPtr + srcLen, strictConversion);
+            numRefChars = int(dstPtr - (UTF16*) &wide[0]);
+        }
+        t1 = std::chrono::system_clock::now();
+        dur = t1 - t0;
+        Log::Info("ConvertUTF UTF-8 to wide (%s): %f sec, %f MB/sec\n", name, dur.count(), mb / dur.count());
+        t0 = std::chrono::system_clock::now();
+        const int numWideChars = StringConverter::UTF8ToWide(&src[0], srcLen, &wide[0], (srcLen + 1) * sizeof(wchar_t)) - 1;
+        t1 = std::chrono::system_clock::now();
+        dur = t1 - t0;
+        Log::Info("StringConverter::UTF8ToWide (%s): %f sec, %f MB/sec\n", name, dur.count(), mb / dur.count());
+        CHECK(numWideChars == numRefChars);
+
+        // wide to UTF-8, ConvertUTF reference
+        int numRefBytes = 0;
+        t0 = std::chrono::system_clock::now();
+        UTF8* dstPtr = &utf8[0];
+        if (sizeof(wchar_t) == 4) {
+            const UTF32* widePtr = (const UTF32*) &wide[0];
+            ConvertUTF32toUTF8(&widePtr, widePtr + numWideChars, &dstPtr, dstPtr + srcLen, strictConversion);
+        }
+        else {
+            const UTF16* widePtr = (const UTF16*) &wide[0];
+            ConvertUTF16toUTF8(&widePtr, widePtr + numWideChars, &dstPtr, dstPtr + srcLen, strictConversion);
+        }
+        numRefBytes = int(dstPtr - &utf8[0]);
+        t1 = std::chrono::system_clock::now();
+        dur = t1 - t0;
+        Log::Info("ConvertUTF wide to UTF-8 (%s): %f sec, %f MB/sec\n", name, dur.count(), mb / dur.count());
+        t0 = std::chrono::system_clock::now();
+        const int numUtf8Bytes = StringConverter::WideToUTF8(&wide[0], numWideChars, &utf8[0], srcLen + 1) - 1;
+        t1 = std::chrono::system_clock::now();
+        dur = t1 - t0;
+        Log::Info("StringConverter::WideToUTF8 (%s): %f sec, %f MB/sec\n", name, dur.count(), mb / dur.count());
+        CHECK(numUtf8Bytes == srcLen);
+        CHECK(numRefBytes == srcLen);
+        CHECK(0 == std::memcmp(&utf8[0], &src[0], srcLen));
+    }
+}
+
 TEST(StringConverterTest_FromString) {
 
     // conversion to simple types
@@ -96,3 +325,271 @@ TEST(StringConverterTest_FromString) {
     f64 = StringConverter::FromString<double>(StringAtom("6.28"));
     CHECK_CLOSE(f64, 6.28, 0.0000000001);
 }
+
+TEST(StringConverterTest_ParseNumber) {
+
+    // integers, with range checks
+    int i32 = 0;
+    CHECK(StringConverter::ParseNumber("-2147483648", 11, i32) == 11);
+    CHECK(i32 == std::numeric_limits<int>::min());
+    CHECK(StringConverter::ParseNumber("2147483648", 10, i32) == 0);
+    CHECK(i32 == std::numeric_limits<int>::min());
+    CHECK(StringConverter::ParseNumber("123abc", 6, i32) == 3);
+    CHECK(i32 == 123);
+    CHECK(StringConverter::ParseNumber("12345", 2, i32) == 2);
+    CHECK(i32 == 12);
+    CHECK(StringConverter::ParseNumber("abc", 3, i32) == 0);
+    CHECK(StringConverter::ParseNumber("-", 1, i32) == 0);
+    CHECK(StringConverter::ParseNumber("+42", 3, i32) == 3);
+    CHECK(i32 == 42);
+    uint8_t ui8 = 0;
+    CHECK(StringConverter::ParseNumber("255", 3, ui8) == 3);
+    CHECK(ui8 == 255);
+    CHECK(StringConverter::ParseNumber("256", 3, ui8) == 0);
+    CHECK(StringConverter::ParseNumber("-1", 2, ui8) == 0);
+    int64_t i64 = 0;
+    CHECK(StringConverter::ParseNumber("-9223372036854775808", 20, i64) == 20);
+    CHECK(i64 == std::numeric_limits<int64_t>::min());
+    uint64_t ui64 = 0;
+    CHECK(StringConverter::ParseNumber("18446744073709551615", 20, ui64) == 20);
+    CHECK(ui64 == std::numeric_limits<uint64_t>::max());
+    CHECK(StringConverter::ParseNumber("18446744073709551616", 20, ui64) == 0);
+    CHECK(StringConverter::ParseNumber("000000000000000000000000012", 27, ui64) == 27);
+    CHECK(ui64 == 12);
+
+    // floating point, correctly rounded
+    double f64 = 0.0;
+    CHECK(StringConverter::ParseNumber("0.1", 3, f64) == 3);
+    CHECK(f64 == 0.1);
+    CHECK(StringConverter::ParseNumber("-1.5e3,", 7, f64) == 6);
+    CHECK(f64 == -1500.0);
+    CHECK(StringConverter::ParseNumber(".5", 2, f64) == 2);
+    CHECK(f64 == 0.5);
+    CHECK(StringConverter::ParseNumber("2e", 2, f64) == 1);
+    CHECK(f64 == 2.0);
+    CHECK(StringConverter::ParseNumber("2.2250738585072014e-308", 23, f64) == 23);
+    CHECK(f64 == 2.2250738585072014e-308);
+    CHECK(StringConverter::ParseNumber("1.7976931348623157e308", 22, f64) == 22);
+    CHECK(f64 == std::numeric_limits<double>::max());
+    CHECK(StringConverter::ParseNumber("123456789012345678901234567890", 30, f64) == 30);
+    CHECK(f64 == 123456789012345678901234567890.0);
+    CHECK(StringConverter::ParseNumber("-inf", 4, f64) == 4);
+    CHECK(f64 == -std::numeric_limits<double>::infinity());
+    CHECK(StringConverter::ParseNumber("NaN", 3, f64) == 3);
+    CHECK(f64 != f64);
+    CHECK(StringConverter::ParseNumber(".", 1, f64) == 0);
+    CHECK(StringConverter::ParseNumber("e5", 2, f64) == 0);
+    float f32 = 0.0f;
+    CHECK(StringConverter::ParseNumber("3.14", 4, f32) == 4);
+    CHECK(f32 == 3.14f);
+    CHECK(StringConverter::ParseNumber("16777217", 8, f32) == 8);
+    CHECK(f32 == 16777216.0f);
+    CHECK(StringConverter::ParseNumber("1e-45", 5, f32) == 5);
+    CHECK(f32 == std::numeric_limits<float>::denorm_min());
+
+    // strict conversion of whole strings
+    CHECK(StringConverter::FromString(" 42 ", i32));
+    CHECK(i32 == 42);
+    CHECK(!StringConverter::FromString("42x", i32));
+    CHECK(!StringConverter::FromString("", i32));
+    CHECK(i32 == 42);
+    CHECK(StringConverter::FromString("\t-0.25\n", f32));
+    CHECK(f32 == -0.25f);
+    CHECK(!StringConverter::FromString("0.25.", f32));
+}
+
+TEST(StringConverterTest_ToChars) {
+    char buf[StringConverter::MaxNumberChars];
+
+    // integers
+    CHECK(StringConverter::ToChars(0, buf, sizeof(buf)) == 1);
+    CHECK(std::strcmp(buf, "0") == 0);
+    CHECK(StringConverter::ToChars(std::numeric_limits<int>::min(), buf, sizeof(buf)) == 11);
+    CHECK(std::strcmp(buf, "-2147483648") == 0);
+    CHECK(StringConverter::ToChars(std::numeric_limits<int64_t>::min(), buf, sizeof(buf)) == 20);
+    CHECK(std::strcmp(buf, "-9223372036854775808") == 0);
+    CHECK(StringConverter::ToChars(std::numeric_limits<uint64_t>::max(), buf, sizeof(buf)) == 20);
+    CHECK(std::strcmp(buf, "18446744073709551615") == 0);
+    CHECK(StringConverter::ToChars(int8_t(-128), buf, sizeof(buf)) == 4);
+    CHECK(std::strcmp(buf, "-128") == 0);
+    CHECK(StringConverter::ToChars(uint16_t(65535), buf, sizeof(buf)) == 5);
+    CHECK(std::strcmp(buf, "65535") == 0);
+
+    // buffer too small
+    CHECK(StringConverter::ToChars(12345, buf, 5) == 0);
+    CHECK(buf[0] == 0);
+    CHECK(StringConverter::ToChars(12345, buf, 6) == 5);
+
+    // shortest round-trip floating point
+    CHECK(StringConverter::ToString(0.1) == "0.1");
+    CHECK(StringConverter::ToString(0.1f) == "0.1");
+    CHECK(StringConverter::ToString(double(0.1f)) == "0.10000000149011612");
+    CHECK(StringConverter::ToString(1.0 / 3.0) == "0.3333333333333333");
+    CHECK(StringConverter::ToString(100.0) == "100");
+    CHECK(StringConverter::ToString(-1.5f) == "-1.5");
+    CHECK(StringConverter::ToString(123.456) == "123.456");
+    CHECK(StringConverter::ToString(0.000001) == "0.000001");
+    CHECK(StringConverter::ToString(1e-7) == "1e-7");
+    CHECK(StringConverter::ToString(1e21) == "1e+21");
+    CHECK(StringConverter::ToString(1e20) == "100000000000000000000");
+    CHECK(StringConverter::ToString(1.5e300) == "1.5e+300");
+    CHECK(StringConverter::ToString(5e-324) == "5e-324");
+    CHECK(StringConverter::ToString(std::numeric_limits<double>::max()) == "1.7976931348623157e+308");
+    CHECK(StringConverter::ToString(std::numeric_limits<float>::max()) == "3.4028235e+38");
+    CHECK(StringConverter::ToString(std::numeric_limits<float>::denorm_min()) == "1e-45");
+    CHECK(StringConverter::ToString(0.0) == "0");
+    CHECK(StringConverter::ToString(-0.0) == "-0");
+    CHECK(StringConverter::ToString(std::numeric_limits<double>::infinity()) == "inf");
+    CHECK(StringConverter::ToString(-std::numeric_limits<float>::infinity()) == "-inf");
+    CHECK(StringConverter::ToString(std::numeric_limits<double>::quiet_NaN()) == "nan");
+    CHECK(StringConverter::ToString(42) == "42");
+
+    // round trips of pseudo-random bit patterns
+    uint64_t x = 0x123456789ABCDEFull;
+    int numFailed = 0;
+    for (int i = 0; i < 100000; i++) {
+        x ^= x << 13; x ^= x >> 7; x ^= x << 17;
+        double d;
+        std::memcpy(&d, &x, sizeof(d));
+        float f;
+        const uint32_t x32 = uint32_t(x >> 32);
+        std::memcpy(&f, &x32, sizeof(f));
+        if ((d == d) && (d != std::numeric_limits<double>::infinity()) && (d != -std::numeric_limits<double>::infinity())) {
+            double d1 = 0.0;
+            const int len = StringConverter::ToChars(d, buf, sizeof(buf));
+            if ((StringConverter::ParseNumber(buf, len, d1) != len) || (0 != std::memcmp(&d, &d1, sizeof(d)))) {
+                numFailed++;
+            }
+        }
+        if ((f == f) && (f != std::numeric_limits<float>::infinity()) && (f != -std::numeric_limits<float>::infinity())) {
+            float f1 = 0.0f;
+            const int len = StringConverter::ToChars(f, buf, sizeof(buf));
+            if ((StringConverter::ParseNumber(buf, len, f1) != len) || (0 != std::memcmp(&f, &f1, sizeof(f)))) {
+                numFailed++;
+            }
+        }
+    }
+    CHECK(numFailed == 0);
+}
+
+// parse a text-based vertex list like a Wavefront .obj file, 'v' and 'vt'
+// lines contain floats, 'f' lines contain integer indices
+static bool useCRuntime = false;
+static const char*
+parseObjLine(const char* p, const char* end, Array<float>& floats, Array<int>& ints) {
+    const bool isFace = ('f' == p[0]);
+    while ((p < end) && (' ' != *p)) {
+        p++;
+    }
+    while ((p < end) && ('\n' != *p)) {
+        if ((' ' == *p) || ('/' == *p)) {
+            p++;
+        }
+        else if (useCRuntime) {
+            char* numEnd = nullptr;
+            if (isFace) {
+                ints.Add(int(std::strtol(p, &numEnd, 10)));
+            }
+            else {
+                floats.Add(std::strtof(p, &numEnd));
+            }
+            p = numEnd;
+        }
+        else {
+            int len = 0;
+            if (isFace) {
+                int val = 0;
+                len = StringConverter::ParseNumber(p, int(end - p), val);
+                ints.Add(val);
+            }
+            else {
+                float val = 0.0f;
+                len = StringConverter::ParseNumber(p, int(end - p), val);
+                floats.Add(val);
+            }
+            p += (len > 0) ? len : 1;
+        }
+    }
+    return p + 1;
+}
+
+TEST(StringConverterTest_NumberPerformance) {
+    const int numVertices = 200000;
+    StringBuilder builder;
+    // about 90 bytes per vertex, reserve so that building the text is linear
+    builder.Reserve(numVertices * 96);
+    uint32_t x = 12345;
+    for (int i = 0; i < numVertices; i++) {
+        x = x * 1664525 + 1013904223;
+        const float a = float(x >> 8) / float(1 << 24) * 200.0f - 100.0f;
+        const float b = float((x >> 4) & 0xFFFF) / 65536.0f;
+        builder.AppendFormat(128, "v %.6f %.6f %.4f\nvt %.6f %.6f\nf %d/%d %d/%d %d/%d\n",
+            a, b, a * b, b, 1.0f - b, i + 1, i + 1, i + 2, i + 2, i + 3, i + 3);
+    }
+    const String text = builder.GetString();
+    const char* const start = text.AsCStr();
+    const char* const end = start + text.Length();
+
+    std::chrono::time_point<std::chrono::system_clock> t0, t1;
+    std::chrono::duration<double> dur;
+
+    // C runtime (locale-dependent)
+    Array<float> crtFloats;
+    Array<int> crtInts;
+    crtFloats.Reserve(numVertices * 5);
+    crtInts.Reserve(numVertices * 6);
+    useCRuntime = true;
+    t0 = std::chrono::system_clock::now();
+    for (const char* p = start; p < end; ) {
+        p = parseObjLine(p, end, crtFloats, crtInts);
+    }
+    t1 = std::chrono::system_clock::now();
+    dur = t1 - t0;
+    Log::Info("strtof/strtol: parse %d vertices (%d KB): %f sec\n", numVertices, text.Length() / 1024, dur.count());
+
+    // StringConverter
+    Array<float> floats;
+    Array<int> ints;
+    floats.Reserve(numVertices * 5);
+    ints.Reserve(numVertices * 6);
+    useCRuntime = false;
+    t0 = std::chrono::system_clock::now();
+    for (const char* p = start; p < end; ) {
+        p = parseObjLine(p, end, floats, ints);
+    }
+    t1 = std::chrono::system_clock::now();
+    dur = t1 - t0;
+    Log::Info("StringConverter::ParseNumber: parse %d vertices (%d KB): %f sec\n", numVertices, text.Length() / 1024, dur.count());
+    CHECK(floats.Size() == numVertices * 5);
+    CHECK(ints.Size() == numVertices * 6);
+    CHECK(floats.Size() == crtFloats.Size());
+    CHECK(ints.Size() == crtInts.Size());
+    int numDiffs = 0;
+    for (int i = 0; i < floats.Size(); i++) {
+        numDiffs += (floats[i] != crtFloats[i]) ? 1 : 0;
+    }
+    for (int i = 0; i < ints.Size(); i++) {
+        numDiffs += (ints[i] != crtInts[i]) ? 1 : 0;
+    }
+    CHECK(numDiffs == 0);
+
+    // write the floats back
+    char buf[StringConverter::MaxNumberChars];
+    int numChars = 0;
+    t0 = std::chrono::system_clock::now();
+    for (float f : floats) {
+        numChars += std::snprintf(buf, sizeof(buf), "%.9g", f);
+    }
+    t1 = std::chrono::system_clock::now();
+    dur = t1 - t0;
+    Log::Info("snprintf(%%.9g): format %d floats: %f sec, %d chars\n", floats.Size(), dur.count(), numChars);
+    numChars = 0;
+    t0 = std::chrono::system_clock::now();
+    for (float f : floats) {
+        numChars += StringConverter::ToChars(f, buf, sizeof(buf));
+    }
+    t1 = std::chrono::system_clock::now();
+    dur = t1 - t0;
+    Log::Info("StringConverter::ToChars: format %d floats: %f sec, %d chars\n", floats.Size(), dur.count(), numChars);
+    CHECK(numChars > 0);
+}
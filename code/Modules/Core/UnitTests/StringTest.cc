@@ -64,13 +64,14 @@ TEST(StringTest) {
     CHECK(str4 == blob);
     CHECK(str4 == "Blob");
     
-    // copy-assignment
+    // copy-assignment of short (inline) strings copies the string
     str0 = str2;
     CHECK(str0 == "Bla");
     CHECK(str0 == str2);
-    CHECK(str0.RefCount() == 2);
-    CHECK(str2.RefCount() == 2);
-    CHECK(str0.AsCStr() == str2.AsCStr());  // tests for identical pointers!
+    CHECK(str0.IsInline());
+    CHECK(str0.RefCount() == 1);
+    CHECK(str2.RefCount() == 1);
+    CHECK(str0.AsCStr() != str2.AsCStr());
     str2.Clear();
     CHECK(str0 == "Bla");
     CHECK(str2.Empty());
@@ -78,6 +79,58 @@ TEST(StringTest) {
     CHECK(str2.RefCount() == 0);
     str0.Clear();
     CHECK(str0.Empty());
+    str2 = bla;
+
+    // copy-assignment of long strings shares the string data
+    const char* longStr = "A string which is too long to be stored inline";
+    String long0(longStr);
+    CHECK(!long0.IsInline());
+    CHECK(long0.RefCount() == 1);
+    str0 = long0;
+    CHECK(str0 == longStr);
+    CHECK(str0 == long0);
+    CHECK(str0.RefCount() == 2);
+    CHECK(long0.RefCount() == 2);
+    CHECK(str0.AsCStr() == long0.AsCStr());  // tests for identical pointers!
+    long0.Clear();
+    CHECK(str0 == longStr);
+    CHECK(long0.Empty());
+    CHECK(str0.RefCount() == 1);
+    CHECK(long0.RefCount() == 0);
+    str0.Clear();
+    CHECK(str0.Empty());
+
+    // the inline/heap boundary
+    String maxInline("0123456789012345678901");
+    CHECK(maxInline.Length() == String::MaxInlineLength);
+    CHECK(maxInline.IsInline());
+    String minHeap("01234567890123456789012");
+    CHECK(minHeap.Length() == String::MaxInlineLength + 1);
+    CHECK(!minHeap.IsInline());
+    CHECK(maxInline < minHeap);
+    CHECK(maxInline.Back() == '1');
+    CHECK(minHeap.Back() == '2');
+    String moved(std::move(minHeap));
+    CHECK(moved == "01234567890123456789012");
+    CHECK(minHeap.Empty());
+    moved = std::move(maxInline);
+    CHECK(moved == "0123456789012345678901");
+    CHECK(moved.IsInline());
+    CHECK(maxInline.Empty());
+
+    // assigning a substring of itself
+    moved.Assign(moved, 2, 5);
+    CHECK(moved == "234");
+    moved.Assign(moved.AsCStr(), 1, EndOfString);
+    CHECK(moved == "34");
+    moved = moved.AsCStr();
+    CHECK(moved == "34");
+
+    // embedded zero bytes are kept in inline strings
+    String zeroStr("a\0b", 0, 3);
+    CHECK(zeroStr.Length() == 3);
+    CHECK(zeroStr.IsInline());
+    CHECK(zeroStr.AsCStr()[2] == 'b');
     
     // move-assignment
     str2 = std::move(str3);
@@ -0,0 +1,55 @@
+//------------------------------------------------------------------------------
+//  StringViewTest.cc
+//  Test StringView class.
+//------------------------------------------------------------------------------
+#include "Pre.h"
+#include "UnitTest++/src/UnitTest++.h"
+#include "Core/String/StringView.h"
+#include "Core/String/StringAtom.h"
+
+using namespace Oryol;
+
+TEST(StringViewTest) {
+    StringView view0;
+    CHECK(view0.Empty());
+    CHECK(view0.Length() == 0);
+    CHECK(view0 == "");
+    CHECK(view0 == nullptr);
+    CHECK(view0 == StringView(""));
+    CHECK(view0.AsString().Empty());
+    CHECK(view0.begin() == view0.end());
+
+    const char* str = "Hello World";
+    StringView view1(str);
+    CHECK(!view1.Empty());
+    CHECK(view1.Length() == 11);
+    CHECK(view1.Ptr() == str);
+    CHECK(view1 == "Hello World");
+    CHECK(view1 != "Hello");
+    CHECK(view1 != "Hello World!");
+    CHECK(view1[6] == 'W');
+
+    // a view into the middle of a string isn't zero-terminated
+    StringView view2(str + 6, 5);
+    CHECK(view2 == "World");
+    CHECK(view2 != "Worl");
+    CHECK(view2 != "World Wide");
+    CHECK(view2.AsString() == "World");
+    StringView view3(str, 5);
+    CHECK(view3 == "Hello");
+    CHECK(view3 != view2);
+    CHECK(view3 == StringView("Hello"));
+    int num = 0;
+    for (char c : view3) {
+        CHECK(c == str[num++]);
+    }
+    CHECK(num == 5);
+
+    // views into StringAtoms
+    StringAtom atom("Hello");
+    StringView view4(atom.AsCStr(), atom.Length());
+    CHECK(view4 == view3);
+    StringView view5 = view4;
+    CHECK(view5.Ptr() == atom.AsCStr());
+    CHECK(view5 == view4);
+}
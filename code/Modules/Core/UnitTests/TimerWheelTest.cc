@@ -0,0 +1,357 @@
+//------------------------------------------------------------------------------
+//  TimerWheelTest.cc
+//  Test TimerWheel one-shot, periodic and cancelled timers.
+//------------------------------------------------------------------------------
+#include "Pre.h"
+#include "UnitTest++/src/UnitTest++.h"
+#include "Core/Core.h"
+#include "Core/Time/TimerWheel.h"
+#include "Core/Time/Clock.h"
+#include "Core/Log.h"
+#include <chrono>
+
+using namespace Oryol;
+
+namespace {
+Duration ms(int64_t n) {
+    return Duration(n * 1000);
+}
+}
+
+//------------------------------------------------------------------------------
+TEST(TimerWheelTest) {
+    TimerWheel wheel;
+    CHECK(wheel.TickDuration() == ms(1));
+    CHECK(wheel.CurrentTick() == 0);
+    CHECK(wheel.NumTimers() == 0);
+
+    // one-shot timers are called exactly once, never early
+    Array<uint64_t> calls;
+    TimerWheel::Id id0 = wheel.Add(ms(5), [&wheel, &calls] { calls.Add(wheel.CurrentTick()); });
+    CHECK(id0 != TimerWheel::InvalidId);
+    CHECK(wheel.IsActive(id0));
+    CHECK(wheel.NumTimers() == 1);
+    wheel.AdvanceTicks(4);
+    CHECK(calls.Empty());
+    wheel.AdvanceTicks(1);
+    CHECK(calls.Size() == 1);
+    CHECK(calls[0] == 5);
+    CHECK(!wheel.IsActive(id0));
+    CHECK(!wheel.Cancel(id0));
+    CHECK(wheel.NumTimers() == 0);
+    wheel.AdvanceTicks(100);
+    CHECK(calls.Size() == 1);
+    CHECK(wheel.CurrentTick() == 105);
+
+    // a zero delay fires on the next tick
+    calls.Clear();
+    wheel.Add(Duration(), [&wheel, &calls] { calls.Add(wheel.CurrentTick()); });
+    wheel.AdvanceTicks(1);
+    CHECK((calls.Size() == 1) && (calls[0] == 106));
+
+    // cancelled timers are not called, and their ids stay invalid
+    // when the timer slot is reused
+    calls.Clear();
+    TimerWheel::Id id1 = wheel.Add(ms(10), [&calls] { calls.Add(1); });
+    CHECK(wheel.Cancel(id1));
+    CHECK(!wheel.Cancel(id1));
+    CHECK(!wheel.IsActive(id1));
+    TimerWheel::Id id2 = wheel.Add(ms(10), [&calls] { calls.Add(2); });
+    CHECK(id2 != id1);
+    CHECK(!wheel.IsActive(id1));
+    CHECK(!wheel.Cancel(id1));
+    wheel.AdvanceTicks(20);
+    CHECK((calls.Size() == 1) && (calls[0] == 2));
+
+    // periodic timers
+    calls.Clear();
+    const uint64_t start = wheel.CurrentTick();
+    TimerWheel::Id id3 = wheel.AddPeriodic(ms(3), [&wheel, &calls] { calls.Add(wheel.CurrentTick()); });
+    wheel.AdvanceTicks(10);
+    CHECK(calls.Size() == 3);
+    CHECK(calls[0] == start + 3);
+    CHECK(calls[1] == start + 6);
+    CHECK(calls[2] == start + 9);
+    CHECK(wheel.IsActive(id3));
+    CHECK(wheel.Cancel(id3));
+    wheel.AdvanceTicks(10);
+    CHECK(calls.Size() == 3);
+    CHECK(wheel.NumTimers() == 0);
+
+    // a periodic timer cancelling itself
+    int numCalls = 0;
+    TimerWheel::Id id4 = TimerWheel::InvalidId;
+    id4 = wheel.AddPeriodic(ms(2), [&wheel, &numCalls, &id4] {
+        if (++numCalls == 3) {
+            CHECK(wheel.Cancel(id4));
+        }
+    });
+    wheel.AdvanceTicks(20);
+    CHECK(numCalls == 3);
+    CHECK(!wheel.IsActive(id4));
+
+    // timers adding timers, and cancelling other timers due in the same tick
+    calls.Clear();
+    TimerWheel::Id id6 = TimerWheel::InvalidId;
+    wheel.Add(ms(5), [&wheel, &calls, &id6] {
+        calls.Add(5);
+        wheel.Cancel(id6);
+        wheel.Add(ms(5), [&calls] { calls.Add(10); });
+    });
+    id6 = wheel.Add(ms(5), [&calls] { calls.Add(6); });
+    wheel.Add(ms(5), [&calls] { calls.Add(7); });
+    wheel.AdvanceTicks(5);
+    // the cancelled timer may only have been called before the cancel
+    const int index5 = calls.FindIndexLinear(5);
+    const int index6 = calls.FindIndexLinear(6);
+    CHECK(index5 != InvalidIndex);
+    CHECK((index6 == InvalidIndex) || (index6 < index5));
+    CHECK(calls.FindIndexLinear(7) != InvalidIndex);
+    CHECK(!wheel.IsActive(id6));
+    wheel.AdvanceTicks(5);
+    CHECK(calls.FindIndexLinear(10) != InvalidIndex);
+    CHECK(wheel.NumTimers() == 0);
+
+    // Clear
+    wheel.Add(ms(10), [&calls] { calls.Add(-1); });
+    wheel.AddPeriodic(ms(1), [&calls] { calls.Add(-1); });
+    CHECK(wheel.NumTimers() == 2);
+    wheel.Clear();
+    CHECK(wheel.NumTimers() == 0);
+    calls.Clear();
+    wheel.AdvanceTicks(20);
+    CHECK(calls.Empty());
+}
+
+//------------------------------------------------------------------------------
+TEST(TimerWheelLevelsTest) {
+    // timers far in the future are cascaded through all levels of
+    // the wheel and beyond, and must fire at the exact tick
+    TimerWheel wheel;
+    wheel.AdvanceTicks(12345);
+    const int64_t delays[] = {
+        1, 63, 64, 65, 100, 4095, 4096, 4097, 262143, 262144, 262145,
+        1000000, 16777215, 16777216, 16777217, 20000000, 40000000
+    };
+    const int numDelays = sizeof(delays) / sizeof(delays[0]);
+    Array<uint64_t> expected;
+    Array<uint64_t> fired;
+    for (int i = 0; i < numDelays; i++) {
+        expected.Add(wheel.CurrentTick() + delays[i]);
+        fired.Add(0);
+        wheel.Add(ms(delays[i]), [&wheel, &fired, i] { fired[i] = wheel.CurrentTick(); });
+    }
+    wheel.AdvanceTicks(40000000);
+    bool allOk = true;
+    for (int i = 0; i < numDelays; i++) {
+        allOk &= fired[i] == expected[i];
+    }
+    CHECK(allOk);
+    CHECK(wheel.NumTimers() == 0);
+}
+
+//------------------------------------------------------------------------------
+TEST(TimerWheelTimeTest) {
+    // a wheel with 10ms ticks, advanced by fractional durations
+    TimerWheel wheel(ms(10));
+    int numCalls = 0;
+    wheel.Add(ms(25), [&numCalls] { numCalls++; });
+    wheel.Advance(Duration(4000));      // 4ms
+    wheel.Advance(Duration(4000));      // 8ms
+    wheel.Advance(Duration(4000));      // 12ms
+    CHECK(wheel.CurrentTick() == 1);
+    wheel.Advance(ms(12));              // 24ms
+    CHECK(numCalls == 0);
+    wheel.Advance(ms(5));               // 29ms
+    CHECK(numCalls == 0);
+    wheel.Advance(ms(1));               // 30ms
+    CHECK(numCalls == 1);
+
+    // a timer added in the middle of a tick must not fire early
+    wheel.Advance(ms(7));               // 37ms
+    int64_t firedAt = 0;
+    int64_t now = 37;
+    wheel.Add(ms(10), [&firedAt, &now] { firedAt = now; });
+    while (0 == firedAt) {
+        now++;
+        wheel.Advance(ms(1));
+    }
+    CHECK(firedAt >= 47);
+    CHECK(firedAt == 50);
+
+    // periodic timer catching up after a long frame
+    numCalls = 0;
+    wheel.AddPeriodic(ms(20), [&numCalls] { numCalls++; });
+    wheel.Advance(ms(100));
+    CHECK(numCalls == 5);
+
+    // driven by time points
+    TimerWheel wheel1;
+    numCalls = 0;
+    wheel1.Add(ms(5), [&numCalls] { numCalls++; });
+    TimePoint t(1000000);
+    wheel1.Update(t);
+    CHECK(wheel1.CurrentTick() == 0);
+    t += ms(4);
+    wheel1.Update(t);
+    CHECK(numCalls == 0);
+    t += ms(1);
+    wheel1.Update(t);
+    CHECK(numCalls == 1);
+}
+
+//------------------------------------------------------------------------------
+TEST(TimerWheelRandomTest) {
+    // compare against a brute force reference
+    TimerWheel wheel;
+    struct ref {
+        TimerWheel::Id id = TimerWheel::InvalidId;
+        uint64_t expire = 0;
+        uint64_t interval = 0;
+        uint64_t numCalls = 0;
+        uint64_t expectedCalls = 0;
+        bool cancelled = false;
+        bool late = false;
+    };
+    Array<ref> refs;
+    refs.Reserve(2000);
+    uint32_t seed = 12345;
+    auto rand = [&seed]() -> uint32_t {
+        seed = seed * 1664525 + 1013904223;
+        return seed >> 8;
+    };
+    for (int round = 0; round < 200; round++) {
+        for (int i = 0; i < 10; i++) {
+            const int index = refs.Size();
+            refs.Add(ref());
+            ref& r = refs[index];
+            const uint64_t delay = 1 + (rand() % ((i & 1) ? 100 : 20000));
+            r.expire = wheel.CurrentTick() + delay;
+            auto func = [&wheel, &refs, index] {
+                ref& r = refs[index];
+                if (wheel.CurrentTick() != r.expire + r.numCalls * r.interval) {
+                    r.late = true;
+                }
+                r.numCalls++;
+            };
+            if (0 == (rand() % 8)) {
+                r.interval = delay;
+                r.id = wheel.AddPeriodic(ms(delay), func);
+            }
+            else {
+                r.id = wheel.Add(ms(delay), func);
+            }
+        }
+        for (int i = 0; i < 3; i++) {
+            ref& r = refs[rand() % refs.Size()];
+            if (wheel.Cancel(r.id)) {
+                r.cancelled = true;
+                r.expectedCalls = r.numCalls;
+            }
+        }
+        wheel.AdvanceTicks(rand() % 200);
+    }
+    const uint64_t endTick = wheel.CurrentTick() + 20001;
+    wheel.AdvanceTicks(20001);
+    int numBad = 0;
+    for (const ref& r : refs) {
+        uint64_t expectedCalls = r.expectedCalls;
+        if (!r.cancelled) {
+            if (r.interval > 0) {
+                expectedCalls = ((endTick - r.expire) / r.interval) + 1;
+            }
+            else {
+                expectedCalls = 1;
+            }
+        }
+        if (r.late || (r.numCalls != expectedCalls)) {
+            numBad++;
+        }
+    }
+    CHECK(numBad == 0);
+}
+
+//------------------------------------------------------------------------------
+TEST(TimerWheelCoreTest) {
+    // the per-thread timer wheel is driven by the pre-runloop
+    Core::Setup();
+    TimerWheel* timers = Core::Timers();
+    CHECK(nullptr != timers);
+    int numCalls = 0;
+    timers->Add(Duration(), [&numCalls] { numCalls++; });
+    const TimePoint start = Clock::Now();
+    while ((0 == numCalls) && (Clock::Since(start) < Duration::FromSeconds(1.0))) {
+        Core::PreRunLoop()->Run();
+    }
+    CHECK(numCalls == 1);
+    Core::Discard();
+}
+
+//------------------------------------------------------------------------------
+TEST(TimerWheelPerformance) {
+    const int numTimers = 100000;
+    const int numFrames = 600;
+    std::chrono::time_point<std::chrono::system_clock> start, end;
+    std::chrono::duration<double> dur;
+
+    TimerWheel wheel;
+    Array<TimerWheel::Id> ids;
+    ids.Reserve(numTimers);
+    int numCalls = 0;
+    uint32_t seed = 1;
+
+    // insert 100k timers with delays between 1ms and 60 seconds
+    start = std::chrono::system_clock::now();
+    for (int i = 0; i < numTimers; i++) {
+        seed = seed * 1664525 + 1013904223;
+        ids.Add(wheel.Add(ms(1 + ((seed >> 8) % 60000)), [&numCalls] { numCalls++; }));
+    }
+    end = std::chrono::system_clock::now();
+    dur = end - start;
+    Log::Info("TimerWheel: add %d timers: %f sec\n", numTimers, dur.count());
+
+    // cancel and re-add every other timer
+    start = std::chrono::system_clock::now();
+    for (int i = 0; i < numTimers; i += 2) {
+        wheel.Cancel(ids[i]);
+        seed = seed * 1664525 + 1013904223;
+        ids[i] = wheel.Add(ms(1 + ((seed >> 8) % 60000)), [&numCalls] { numCalls++; });
+    }
+    end = std::chrono::system_clock::now();
+    dur = end - start;
+    Log::Info("TimerWheel: cancel+add %d timers: %f sec\n", numTimers / 2, dur.count());
+    CHECK(wheel.NumTimers() == numTimers);
+
+    // advance in 16ms frames for 10 seconds
+    start = std::chrono::system_clock::now();
+    for (int frame = 0; frame < numFrames; frame++) {
+        wheel.Advance(ms(16));
+    }
+    end = std::chrono::system_clock::now();
+    dur = end - start;
+    Log::Info("TimerWheel: %d frames with %d timers (%d calls): %f sec\n", numFrames, numTimers, numCalls, dur.count());
+    CHECK(numCalls + wheel.NumTimers() == numTimers);
+
+    // the same number of timers polled per frame, for comparison
+    Array<int64_t> deadlines;
+    deadlines.Reserve(numTimers);
+    for (int i = 0; i < numTimers; i++) {
+        seed = seed * 1664525 + 1013904223;
+        deadlines.Add(1 + ((seed >> 8) % 60000));
+    }
+    int numPolled = 0;
+    start = std::chrono::system_clock::now();
+    for (int frame = 0; frame < numFrames; frame++) {
+        const int64_t now = frame * 16;
+        for (int i = 0; i < numTimers; i++) {
+            if ((deadlines[i] >= 0) && (deadlines[i] <= now)) {
+                deadlines[i] = -1;
+                numPolled++;
+            }
+        }
+    }
+    end = std::chrono::system_clock::now();
+    dur = end - start;
+    Log::Info("TimerWheel: polling baseline, %d frames with %d timers (%d calls): %f sec\n", numFrames, numTimers, numPolled, dur.count());
+    wheel.Clear();
+}
@@ -0,0 +1,131 @@
+//------------------------------------------------------------------------------
+//  TraceRecorderTest.cc
+//  Test TraceRecorder class.
+//------------------------------------------------------------------------------
+#include "Pre.h"
+#include "UnitTest++/src/UnitTest++.h"
+#include "Core/TraceRecorder.h"
+#include "Core/Log.h"
+#include <chrono>
+#include <cstring>
+#if ORYOL_HAS_THREADS
+#include <thread>
+#endif
+
+using namespace Oryol;
+
+// count occurrences of a substring
+static int countStr(const String& str, const char* sub) {
+    int num = 0;
+    const int len = int(std::strlen(sub));
+    for (const char* p = std::strstr(str.AsCStr(), sub); p; p = std::strstr(p + len, sub)) {
+        num++;
+    }
+    return num;
+}
+
+TEST(TraceRecorderTest) {
+    // nothing is recorded before Start()
+    CHECK(!TraceRecorder::IsRecording());
+    TraceRecorder::Begin("NotRecorded");
+    TraceRecorder::End();
+    TraceRecorder::Counter("NotRecorded", 1.0);
+
+    TraceRecorder::Start();
+    CHECK(TraceRecorder::IsRecording());
+    TraceRecorder::SetThreadName("Test \"Main\"");
+    {
+        TraceRecorder::Scope outer("Outer");
+        for (int i = 0; i < 3; i++) {
+            TraceRecorder::Scope inner("Inner");
+            TraceRecorder::Counter("Value", i * 0.5);
+        }
+        TraceRecorder::Instant("Marker");
+    }
+    // an End() without Begin() is ignored
+    TraceRecorder::End();
+    #if ORYOL_HAS_THREADS
+    std::thread thread([] {
+        TraceRecorder::SetThreadName("Worker");
+        TraceRecorder::Scope scope("WorkerScope");
+    });
+    thread.join();
+    #endif
+    TraceRecorder::Stop();
+    CHECK(!TraceRecorder::IsRecording());
+    TraceRecorder::Begin("NotRecorded");
+    TraceRecorder::End();
+
+    StringBuilder json;
+    TraceRecorder::WriteChromeTrace(json);
+    const String str = json.GetString();
+    CHECK(str.AsCStr()[0] == '{');
+    CHECK(countStr(str, "\"traceEvents\":[") == 1);
+    CHECK(countStr(str, "NotRecorded") == 0);
+    CHECK(countStr(str, "{\"name\":\"Outer\",\"ph\":\"X\"") == 1);
+    CHECK(countStr(str, "{\"name\":\"Inner\",\"ph\":\"X\"") == 3);
+    CHECK(countStr(str, "{\"name\":\"Value\",\"ph\":\"C\"") == 3);
+    CHECK(countStr(str, "\"args\":{\"value\":0.5}") == 1);
+    CHECK(countStr(str, "{\"name\":\"Marker\",\"ph\":\"i\"") == 1);
+    CHECK(countStr(str, "\"args\":{\"name\":\"Test \\\"Main\\\"\"}") == 1);
+    #if ORYOL_HAS_THREADS
+    CHECK(countStr(str, "\"args\":{\"name\":\"Worker\"}") == 1);
+    CHECK(countStr(str, "{\"name\":\"WorkerScope\",\"ph\":\"X\"") == 1);
+    #endif
+    // inner scopes are written before the outer scope
+    CHECK(std::strstr(str.AsCStr(), "\"Inner\"") < std::strstr(str.AsCStr(), "\"Outer\""));
+    CHECK(TraceRecorder::NumOverwritten() == 0);
+
+    // the oldest events are overwritten
+    TraceSetup setup;
+    setup.MaxEventsPerThread = 16;
+    TraceRecorder::Start(setup);
+    for (int i = 0; i < 100; i++) {
+        TraceRecorder::Scope scope("Overwritten");
+    }
+    TraceRecorder::Stop();
+    CHECK(TraceRecorder::NumOverwritten() == 84);
+    json.Clear();
+    TraceRecorder::WriteChromeTrace(json);
+    CHECK(countStr(json.GetString(), "\"Overwritten\"") == 16);
+    CHECK(countStr(json.GetString(), "\"Outer\"") == 0);
+}
+
+TEST(TraceRecorderFullRing) {
+    // write a completely filled default ring buffer
+    const TraceSetup setup;
+    TraceRecorder::Start(setup);
+    for (int i = 0; i < setup.MaxEventsPerThread + 1000; i++) {
+        TraceRecorder::Scope scope("FullRingScope");
+    }
+    TraceRecorder::Stop();
+    CHECK(TraceRecorder::NumOverwritten() == 1000);
+    std::chrono::time_point<std::chrono::system_clock> start = std::chrono::system_clock::now();
+    StringBuilder json;
+    TraceRecorder::WriteChromeTrace(json);
+    std::chrono::duration<double> dur = std::chrono::system_clock::now() - start;
+    const String str = json.GetString();
+    CHECK(countStr(str, "{\"name\":\"FullRingScope\",\"ph\":\"X\"") == setup.MaxEventsPerThread);
+    CHECK(countStr(str, "\n],\"displayTimeUnit\":\"ms\"}\n") == 1);
+    // the output must fit into the room which is reserved up front (100 bytes per event)
+    CHECK(str.Length() < setup.MaxEventsPerThread * 100);
+    Log::Info("TraceRecorder: write %d events (%d KB): %f sec\n", setup.MaxEventsPerThread, str.Length() / 1024, dur.count());
+}
+
+TEST(TraceRecorderPerformance) {
+    const int numScopes = 1000000;
+    TraceRecorder::Start();
+    std::chrono::time_point<std::chrono::system_clock> start = std::chrono::system_clock::now();
+    for (int i = 0; i < numScopes; i++) {
+        TraceRecorder::Scope scope("Scope");
+    }
+    std::chrono::duration<double> dur = std::chrono::system_clock::now() - start;
+    TraceRecorder::Stop();
+    Log::Info("TraceRecorder: %d scopes: %f sec (%.1f ns/scope)\n", numScopes, dur.count(), (dur.count() * 1e9) / numScopes);
+    start = std::chrono::system_clock::now();
+    for (int i = 0; i < numScopes; i++) {
+        TraceRecorder::Scope scope("Scope");
+    }
+    dur = std::chrono::system_clock::now() - start;
+    Log::Info("TraceRecorder not recording: %d scopes: %f sec (%.1f ns/scope)\n", numScopes, dur.count(), (dur.count() * 1e9) / numScopes);
+}
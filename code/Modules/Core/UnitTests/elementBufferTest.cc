@@ -5,6 +5,14 @@
 #include "Pre.h"
 #include "UnitTest++/src/UnitTest++.h"
 #include "Core/Containers/elementBuffer.h"
+#include "Core/Containers/Array.h"
+#include "Core/Containers/Map.h"
+#include "Core/Containers/Queue.h"
+#include "Core/String/String.h"
+#include "Core/RefCounted.h"
+#include "Core/Ptr.h"
+#include "Core/Log.h"
+#include <chrono>
 
 using namespace Oryol;
 using namespace Oryol::_priv;
@@ -592,3 +600,154 @@ TEST(elementBufferTest) {
     CHECK(buf6[6] == 12);
     CHECK(TestMemory(buf6));
 }
+
+//------------------------------------------------------------------------------
+// trivially relocatable element types are moved around with memmove
+class _reloc : public RefCounted {
+    OryolClassDecl(_reloc);
+public:
+    _reloc(int v) : value(v) { };
+    int value;
+};
+
+static bool
+TestReloc(const elementBuffer<Ptr<_reloc>>& buf, std::initializer_list<int> values) {
+    if (buf.size() != int(values.size())) {
+        return false;
+    }
+    int i = 0;
+    for (int val : values) {
+        // if anything was duplicated or lost, the refcount would be off
+        if ((buf[i]->value != val) || (buf[i]->GetRefCount() != 1)) {
+            return false;
+        }
+        i++;
+    }
+    return true;
+}
+
+TEST(elementBufferRelocatableTest) {
+    static_assert(IsTriviallyRelocatable<int>::value, "int must be relocatable");
+    static_assert(IsTriviallyRelocatable<Ptr<_reloc>>::value, "Ptr must be relocatable");
+    static_assert(IsTriviallyRelocatable<String>::value, "String must be relocatable");
+    static_assert(IsTriviallyRelocatable<KeyValuePair<int, String>>::value, "KeyValuePair must be relocatable");
+    static_assert(!IsTriviallyRelocatable<_test>::value, "_test must not be relocatable");
+    static_assert(!IsTriviallyRelocatable<KeyValuePair<int, _test>>::value, "KeyValuePair must not be relocatable");
+
+    elementBuffer<Ptr<_reloc>> buf;
+    buf.alloc(4, 2);
+    buf.pushBack(_reloc::Create(1));
+    buf.pushBack(_reloc::Create(2));
+    buf.insert(0, _reloc::Create(0));
+    buf.insert(3, _reloc::Create(3));
+    CHECK(TestReloc(buf, { 0, 1, 2, 3 }));
+    CHECK(buf.spare() == 0);
+
+    // grow, then insert with moving towards the back and the front
+    buf.alloc(8, 2);
+    CHECK(TestReloc(buf, { 0, 1, 2, 3 }));
+    buf.insert(1, _reloc::Create(10));
+    buf.insert(4, _reloc::Create(11));
+    CHECK(TestReloc(buf, { 0, 10, 1, 2, 11, 3 }));
+    buf.insert(3, _reloc::Create(12));
+    buf.insert(5, _reloc::Create(13));
+    CHECK(TestReloc(buf, { 0, 10, 1, 12, 2, 13, 11, 3 }));
+    CHECK(buf.spare() == 0);
+
+    // erase by moving front and back elements
+    buf.erase(1);
+    CHECK(TestReloc(buf, { 0, 1, 12, 2, 13, 11, 3 }));
+    buf.erase(5);
+    CHECK(TestReloc(buf, { 0, 1, 12, 2, 13, 3 }));
+    buf.eraseSwapBack(1);
+    CHECK(TestReloc(buf, { 0, 3, 12, 2, 13 }));
+    buf.eraseSwapFront(2);
+    CHECK(TestReloc(buf, { 3, 0, 2, 13 }));
+    buf.eraseRange(1, 2);
+    CHECK(TestReloc(buf, { 3, 13 }));
+
+    // an element held outside must keep its refcount
+    Ptr<_reloc> p = buf[1];
+    CHECK(p->GetRefCount() == 2);
+    buf.insert(1, _reloc::Create(14));
+    buf.erase(0);
+    CHECK(p->GetRefCount() == 2);
+    buf.destroy();
+    CHECK(p->GetRefCount() == 1);
+}
+
+//------------------------------------------------------------------------------
+// compare container performance of a relocatable and a non-relocatable type
+template<bool RELOC> struct _relocItem {
+    _relocItem() { };
+    _relocItem(int i) : val(i), str(i & 1 ? "One" : "Two") { };
+    bool operator==(const _relocItem& rhs) const { return this->val == rhs.val; };
+    bool operator<(const _relocItem& rhs) const { return this->val < rhs.val; };
+    int val = 0;
+    String str;
+};
+namespace Oryol {
+template<> struct IsTriviallyRelocatable<_relocItem<true>> {
+    static const bool value = true;
+};
+}
+
+template<bool RELOC> static void
+relocatePerformance() {
+    typedef _relocItem<RELOC> item;
+    const char* name = RELOC ? "relocatable" : "non-relocatable";
+    const int num = 20000;
+    std::chrono::time_point<std::chrono::system_clock> start, end;
+    std::chrono::duration<double> dur;
+
+    // Array: insert and erase in the middle
+    Array<item> array;
+    start = std::chrono::system_clock::now();
+    for (int i = 0; i < num; i++) {
+        array.Insert(array.Size() / 2, item(i));
+    }
+    for (int i = 0; i < num; i++) {
+        array.Erase(array.Size() / 2);
+    }
+    end = std::chrono::system_clock::now();
+    dur = end - start;
+    CHECK(array.Empty());
+    Log::Info("Array<%s> %d insert/erase: %f sec\n", name, num, dur.count());
+
+    // Map: add and erase with random keys
+    Map<int, item> map;
+    start = std::chrono::system_clock::now();
+    uint32_t key = 1;
+    for (int i = 0; i < num; i++) {
+        key = key * 1664525 + 1013904223;
+        map.AddUnique(int(key >> 1), item(i));
+    }
+    while (!map.Empty()) {
+        map.EraseIndex(map.Size() / 2);
+    }
+    end = std::chrono::system_clock::now();
+    dur = end - start;
+    Log::Info("Map<int,%s> %d add/erase: %f sec\n", name, num, dur.count());
+
+    // Queue: keep a full queue which must move its elements to the front
+    const int numQueue = num / 4;
+    Queue<item> queue;
+    queue.Reserve(numQueue);
+    start = std::chrono::system_clock::now();
+    for (int i = 0; i < numQueue; i++) {
+        queue.Enqueue(item(i));
+    }
+    for (int i = 0; i < numQueue; i++) {
+        queue.Dequeue();
+        queue.Enqueue(item(i));
+    }
+    end = std::chrono::system_clock::now();
+    dur = end - start;
+    CHECK(queue.Size() == numQueue);
+    Log::Info("Queue<%s> %d enqueue/dequeue: %f sec\n", name, numQueue, dur.count());
+}
+
+TEST(elementBufferRelocatePerformance) {
+    relocatePerformance<false>();
+    relocatePerformance<true>();
+}
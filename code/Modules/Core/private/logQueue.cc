@@ -0,0 +1,318 @@
+//------------------------------------------------------------------------------
+//  logQueue.cc
+//------------------------------------------------------------------------------
+#include "Pre.h"
+#include "logQueue.h"
+#if ORYOL_HAS_THREADS
+#include "Core/Assertion.h"
+#include "Core/Memory/Memory.h"
+#include "Core/Threading/ThreadLocalPtr.h"
+#include <chrono>
+#include <cstring>
+
+namespace Oryol {
+namespace _priv {
+
+//------------------------------------------------------------------------------
+struct logRing {
+    uint8_t* buf = nullptr;
+    uint32_t size = 0;
+    uint8_t pad0[ORYOL_CACHELINE_SIZE];
+    // written by the producer thread
+    std::atomic<uint32_t> writePos{0};
+    uint32_t cachedReadPos = 0;
+    std::atomic<int> busy{0};
+    std::atomic<int64_t> numDropped{0};
+    uint8_t pad1[ORYOL_CACHELINE_SIZE];
+    // written by the draining thread
+    std::atomic<uint32_t> readPos{0};
+    uint8_t pad2[ORYOL_CACHELINE_SIZE];
+};
+
+namespace {
+    /// message header in a ring buffer, followed by the message data
+    struct recordHeader {
+        uint32_t size;      // record size including header and padding
+        uint32_t dataSize;  // size of message data, or FillerSize
+        uint64_t seqLevel;  // global message sequence number << 8 | log level
+    };
+    // a filler record pads the end of the ring buffer when a message
+    // doesn't fit before the wrap-around
+    const uint32_t FillerSize = 0xFFFFFFFF;
+    const uint32_t RecordAlign = sizeof(recordHeader);
+    const int MinBufferSize = 4096;
+
+    ORYOL_THREADLOCAL_PTR(logRing) threadLogRing = nullptr;
+
+    //--------------------------------------------------------------------------
+    void allocRingBuffer(logRing* r, uint32_t size) {
+        if (r->buf) {
+            Memory::Free(r->buf);
+        }
+        r->buf = (uint8_t*) Memory::Alloc(size);
+        r->size = size;
+        r->writePos = 0;
+        r->cachedReadPos = 0;
+        r->readPos = 0;
+        r->numDropped = 0;
+    }
+}
+
+//------------------------------------------------------------------------------
+void
+logQueue::start(const AsyncLogSetup& setup, writeFunc writeFn, droppedFunc droppedFn) {
+    o_assert(!this->active);
+    o_assert(writeFn && droppedFn);
+    uint32_t size = MinBufferSize;
+    while (int(size) < setup.BufferSize) {
+        size <<= 1;
+    }
+    this->overflow = setup.Overflow;
+    this->flushIntervalMs = setup.FlushIntervalMs > 0 ? setup.FlushIntervalMs : 1;
+    this->func = writeFn;
+    this->dropFunc = droppedFn;
+    this->numReportedDropped = 0;
+    this->stopRequested = false;
+    {
+        // nobody is writing into or reading from the ring buffers now,
+        // so they can be resized
+        std::lock_guard<std::mutex> drainLock(this->drainMutex);
+        std::lock_guard<std::mutex> ringLock(this->ringMutex);
+        this->bufferSize = int(size);
+        const int num = this->numRings;
+        for (int i = 0; i < num; i++) {
+            allocRingBuffer(this->rings[i], size);
+        }
+    }
+    this->active = true;
+    this->thread = std::thread([this] {
+        this->threadFunc();
+    });
+}
+
+//------------------------------------------------------------------------------
+void
+logQueue::stop() {
+    o_assert(this->active);
+    this->active = false;
+
+    // wait until no thread is writing into a ring buffer, threads
+    // might wait for space in their ring buffer, so keep draining
+    const int num = this->numRings;
+    for (int i = 0; i < num; i++) {
+        while (this->rings[i]->busy) {
+            this->flush();
+            std::this_thread::yield();
+        }
+    }
+    {
+        std::lock_guard<std::mutex> lock(this->wakeMutex);
+        this->stopRequested = true;
+    }
+    this->wakeCond.notify_one();
+    this->thread.join();
+    this->flush();
+}
+
+//------------------------------------------------------------------------------
+bool
+logQueue::isActive() const {
+    return this->active.load(std::memory_order_relaxed);
+}
+
+//------------------------------------------------------------------------------
+logRing*
+logQueue::threadRing() {
+    logRing* r = threadLogRing;
+    if (nullptr == r) {
+        std::lock_guard<std::mutex> lock(this->ringMutex);
+        const int num = this->numRings;
+        if (num >= MaxRings) {
+            return nullptr;
+        }
+        r = Memory::New<logRing>();
+        allocRingBuffer(r, uint32_t(this->bufferSize));
+        this->rings[num] = r;
+        this->numRings = num + 1;
+        threadLogRing = r;
+    }
+    return r;
+}
+
+//------------------------------------------------------------------------------
+/**
+ NOTE: the busy flag and the active flag are a handshake with stop(),
+ both sides first write their own flag and then read the other
+ side's flag (with sequentially consistent ordering), so that stop()
+ knows when no thread is touching the ring buffers anymore.
+*/
+bool
+logQueue::push(Log::Level lvl, const void* data, int size) {
+    logRing* r = this->threadRing();
+    if ((nullptr == r) || (size > this->maxSize())) {
+        return false;
+    }
+    r->busy = 1;
+    if (!this->active) {
+        r->busy.store(0, std::memory_order_release);
+        return false;
+    }
+    const bool written = this->write(r, lvl, data, size);
+    r->busy.store(0, std::memory_order_release);
+    return written;
+}
+
+//------------------------------------------------------------------------------
+int
+logQueue::maxSize() const {
+    // a message may fill a quarter of the ring buffer
+    return (this->bufferSize / 4) - int(sizeof(recordHeader));
+}
+
+//------------------------------------------------------------------------------
+bool
+logQueue::write(logRing* r, Log::Level lvl, const void* data, int size) {
+    const uint32_t recSize = (uint32_t(sizeof(recordHeader) + size) + RecordAlign - 1) & ~(RecordAlign - 1);
+    const uint32_t mask = r->size - 1;
+    uint32_t pos = r->writePos.load(std::memory_order_relaxed);
+    const uint32_t contiguous = r->size - (pos & mask);
+    const uint32_t fillerSize = (contiguous < recSize) ? contiguous : 0;
+    const uint32_t needed = fillerSize + recSize;
+    while ((pos + needed - r->cachedReadPos) > r->size) {
+        r->cachedReadPos = r->readPos.load(std::memory_order_acquire);
+        if ((pos + needed - r->cachedReadPos) <= r->size) {
+            break;
+        }
+        this->wake();
+        if (AsyncLogOverflow::Drop == this->overflow) {
+            r->numDropped.fetch_add(1, std::memory_order_relaxed);
+            return true;
+        }
+        std::this_thread::yield();
+    }
+    if (fillerSize > 0) {
+        recordHeader* filler = (recordHeader*) (r->buf + (pos & mask));
+        filler->size = fillerSize;
+        filler->dataSize = FillerSize;
+        filler->seqLevel = 0;
+        pos += fillerSize;
+    }
+    recordHeader* hdr = (recordHeader*) (r->buf + (pos & mask));
+    hdr->size = recSize;
+    hdr->dataSize = uint32_t(size);
+    hdr->seqLevel = (this->seq.fetch_add(1, std::memory_order_relaxed) << 8) | uint64_t(lvl);
+    std::memcpy(hdr + 1, data, size);
+    pos += recSize;
+    r->writePos.store(pos, std::memory_order_release);
+
+    // wake the background thread early if the ring buffer is getting full
+    if (this->sleeping.load(std::memory_order_relaxed) && ((pos - r->cachedReadPos) > (r->size / 2))) {
+        r->cachedReadPos = r->readPos.load(std::memory_order_acquire);
+        if ((pos - r->cachedReadPos) > (r->size / 2)) {
+            this->wake();
+        }
+    }
+    return true;
+}
+
+//------------------------------------------------------------------------------
+void
+logQueue::wake() {
+    this->wakeCond.notify_one();
+}
+
+//------------------------------------------------------------------------------
+void
+logQueue::flush() {
+    std::lock_guard<std::mutex> lock(this->drainMutex);
+    this->drain();
+}
+
+//------------------------------------------------------------------------------
+/**
+ Merges the messages of all ring buffers by their sequence number,
+ messages which are written while draining are left for the next call.
+*/
+void
+logQueue::drain() {
+    const int num = this->numRings;
+    uint32_t readPos[MaxRings];
+    uint32_t writePos[MaxRings];
+    for (int i = 0; i < num; i++) {
+        readPos[i] = this->rings[i]->readPos.load(std::memory_order_relaxed);
+        writePos[i] = this->rings[i]->writePos.load(std::memory_order_acquire);
+    }
+    for (;;) {
+        int next = InvalidIndex;
+        uint64_t nextSeq = 0;
+        for (int i = 0; i < num; i++) {
+            const logRing* r = this->rings[i];
+            while (readPos[i] != writePos[i]) {
+                const recordHeader* hdr = (const recordHeader*) (r->buf + (readPos[i] & (r->size - 1)));
+                if (FillerSize == hdr->dataSize) {
+                    readPos[i] += hdr->size;
+                    continue;
+                }
+                if ((InvalidIndex == next) || (hdr->seqLevel < nextSeq)) {
+                    next = i;
+                    nextSeq = hdr->seqLevel;
+                }
+                break;
+            }
+        }
+        if (InvalidIndex == next) {
+            break;
+        }
+        logRing* r = this->rings[next];
+        const recordHeader* hdr = (const recordHeader*) (r->buf + (readPos[next] & (r->size - 1)));
+        this->func(Log::Level(hdr->seqLevel & 0xFF), hdr + 1, int(hdr->dataSize));
+        readPos[next] += hdr->size;
+        // give back the space right away, a producer might wait for it
+        r->readPos.store(readPos[next], std::memory_order_release);
+    }
+    int64_t dropped = 0;
+    for (int i = 0; i < num; i++) {
+        this->rings[i]->readPos.store(readPos[i], std::memory_order_release);
+        dropped += this->rings[i]->numDropped.load(std::memory_order_relaxed);
+    }
+    if (dropped > this->numReportedDropped) {
+        const int num = int(dropped - this->numReportedDropped);
+        this->numReportedDropped = dropped;
+        this->dropFunc(num);
+    }
+}
+
+//------------------------------------------------------------------------------
+int64_t
+logQueue::numDropped() const {
+    int64_t dropped = 0;
+    const int num = this->numRings;
+    for (int i = 0; i < num; i++) {
+        dropped += this->rings[i]->numDropped.load(std::memory_order_relaxed);
+    }
+    return dropped;
+}
+
+//------------------------------------------------------------------------------
+void
+logQueue::threadFunc() {
+    for (;;) {
+        {
+            std::unique_lock<std::mutex> lock(this->wakeMutex);
+            if (this->stopRequested) {
+                break;
+            }
+            this->sleeping = true;
+            this->wakeCond.wait_for(lock, std::chrono::milliseconds(this->flushIntervalMs));
+            this->sleeping = false;
+            if (this->stopRequested) {
+                break;
+            }
+        }
+        this->flush();
+    }
+}
+
+} // namespace _priv
+} // namespace Oryol
+#endif // ORYOL_HAS_THREADS
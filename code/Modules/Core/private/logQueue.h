@@ -0,0 +1,93 @@
+#pragma once
+//------------------------------------------------------------------------------
+/**
+    @class Oryol::_priv::logQueue
+    @ingroup Core
+    @brief message queue behind asynchronous logging
+
+    Each thread which logs gets its own byte ring buffer, log calls
+    copy a message record (a formatted text message, or an encoded
+    binary log message) into the ring buffer of the calling thread
+    without taking a lock. A background thread wakes up
+    periodically (or when a ring buffer is getting full), merges
+    the pending messages of all threads in the order they have been
+    logged (messages which different threads logged at the same time
+    may be swapped), and hands them to a write function.
+
+    Ring buffers are registered on the first log call of a thread, and
+    are never freed (a thread-local pointer may still point to them).
+    Since the ring buffers are per-thread, there must only be one logQueue.
+
+    The logQueue is used by the Log class, there's usually no reason
+    to use it directly. It is only available on platforms with threads.
+*/
+#include "Core/Log.h"
+#if ORYOL_HAS_THREADS
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+namespace Oryol {
+namespace _priv {
+
+struct logRing;
+
+class logQueue {
+public:
+    /// function which writes a message record (called on the background thread)
+    typedef void (*writeFunc)(Log::Level lvl, const void* data, int size);
+    /// function which reports dropped messages (called on the background thread)
+    typedef void (*droppedFunc)(int numDropped);
+
+    /// start the background thread
+    void start(const AsyncLogSetup& setup, writeFunc writeFn, droppedFunc droppedFn);
+    /// write pending messages and stop the background thread
+    void stop();
+    /// return true if between start() and stop()
+    bool isActive() const;
+    /// get max size of a message record
+    int maxSize() const;
+    /// push a message record (any thread), returns false if the caller must write the message itself
+    bool push(Log::Level lvl, const void* data, int size);
+    /// write all pending messages on the calling thread
+    void flush();
+    /// get number of messages which have been dropped since start()
+    int64_t numDropped() const;
+
+private:
+    static const int MaxRings = 128;
+
+    /// get or create the calling thread's ring buffer
+    logRing* threadRing();
+    /// try to write a message into a ring buffer
+    bool write(logRing* r, Log::Level lvl, const void* data, int size);
+    /// wake up the background thread
+    void wake();
+    /// write pending messages, drainMutex must be locked
+    void drain();
+    /// the background thread function
+    void threadFunc();
+
+    std::atomic<bool> active{false};
+    std::atomic<bool> sleeping{false};
+    std::atomic<uint64_t> seq{0};
+    std::atomic<int> numRings{0};
+    logRing* rings[MaxRings] = { };
+    int bufferSize = 0;
+    AsyncLogOverflow overflow = AsyncLogOverflow::Drop;
+    int flushIntervalMs = 0;
+    writeFunc func = nullptr;
+    droppedFunc dropFunc = nullptr;
+    int64_t numReportedDropped = 0;
+    bool stopRequested = false;
+    std::mutex ringMutex;
+    std::mutex drainMutex;
+    std::mutex wakeMutex;
+    std::condition_variable wakeCond;
+    std::thread thread;
+};
+
+} // namespace _priv
+} // namespace Oryol
+#endif // ORYOL_HAS_THREADS
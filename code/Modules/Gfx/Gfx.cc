@@ -49,7 +49,7 @@ Gfx::Setup(const class GfxSetup& setup) {
     state->resourceContainer.setup(setup, pointers);
     state->runLoopId = Core::PreRunLoop()->Add([] {
         state->displayManager.ProcessSystemEvents();
-    });
+    }, RunLoop::Critical, "Gfx");
     state->gfxFrameInfo = GfxFrameInfo();
 }
 
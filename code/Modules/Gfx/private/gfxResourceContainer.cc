@@ -24,9 +24,10 @@ gfxResourceContainer::setup(const GfxSetup& setup, const gfxPointers& ptrs) {
     this->pipelinePool.Setup(GfxResourceType::Pipeline, setup.ResourcePoolSize[GfxResourceType::Pipeline]);
     this->renderPassPool.Setup(GfxResourceType::RenderPass, setup.ResourcePoolSize[GfxResourceType::RenderPass]);
     this->factory.setup(this->pointers);
+    // resource loading can be spread over several frames
     this->runLoopId = Core::PostRunLoop()->Add([this]() {
         this->update();
-    });
+    }, RunLoop::Low, "gfxResourceContainer");
     
     ResourceContainerBase::Setup(setup.ResourceLabelStackCapacity, setup.ResourceRegistryCapacity);
 }
@@ -14,7 +14,7 @@ baseURLLoader::doRequest(const Ptr<IORead>& ioReq) {
     // in a subclass, we only handle the cancelled flag here
     if (ioReq->Cancelled) {
         ioReq->Status = IOStatus::Cancelled;
-        ioReq->Handled = true;
+        ioReq->SetHandled();
         return false;
     }
     else {
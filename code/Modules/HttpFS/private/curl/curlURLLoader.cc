@@ -103,7 +103,7 @@ bool
 curlURLLoader::doRequest(const Ptr<IORead>& req) {
     if (baseURLLoader::doRequest(req)) {
         this->doRequestInternal(req);
-        req->Handled = true;
+        req->SetHandled();
         return true;
     }
     else {
@@ -120,7 +120,7 @@ curlURLLoader::doRequestInternal(const Ptr<IORead>& req) {
 
     // set URL in curl
     const URL& url = req->Url;
-    o_assert(url.Scheme() == "http");
+    o_assert(url.SchemeView() == "http");
     curl_easy_setopt(this->curlSession, CURLOPT_URL, url.AsCStr());
     if (url.HasPort()) {
         uint16_t port = StringConverter::FromString<uint16_t>(url.Port());
@@ -48,7 +48,7 @@ emscURLLoader::onLoaded(void* userData, void* buffer, int size) {
     req->release();
     req->Status = IOStatus::OK;
     req->Data.Add((const uint8_t*)buffer, size);
-    req->Handled = true;
+    req->SetHandled();
 }
 
 //------------------------------------------------------------------------------
@@ -65,7 +65,7 @@ emscURLLoader::onFailed(void* userData) {
     // fix this somehow (looks like the wget2 functions also pass a HTTP status code)
     const IOStatus::Code ioStatus = IOStatus::NotFound;
     req->Status = ioStatus;
-    req->Handled = true;
+    req->SetHandled();
 }
 
 } // namespace _priv
@@ -42,7 +42,7 @@ winURLLoader::doRequest(const Ptr<IORead>& req) {
     bool result = false;
     if (baseURLLoader::doRequest(req)) {
         this->doRequestInternal(req);
-        req->Handled = true;
+        req->SetHandled();
     }
     this->garbageCollectConnections();
     return result;
@@ -0,0 +1,8 @@
+//------------------------------------------------------------------------------
+//  Main.cc
+//  IO module benchmarks, see Core/Benchmark.h for the arguments.
+//------------------------------------------------------------------------------
+#include "Pre.h"
+#include "Core/Benchmark.h"
+
+OryolBenchmarkMain()
@@ -24,7 +24,7 @@ public:
     virtual void init(const StringAtom& scheme);
     /// called per IO-lane
     virtual void initLane();
-    /// called when IO message should be handled
+    /// called when IO message should be handled, must call ioReq->SetHandled() when done
     virtual void onMsg(const Ptr<IORequest>& ioReq);
 
     StringAtom scheme;
@@ -48,7 +48,7 @@ IO::Setup(const IOSetup& setup) {
         RegisterFileSystem(fs.Key(), fs.Value());
     }
 
-    state->runLoopId = Core::PreRunLoop()->Add([] { doWork(); });
+    state->runLoopId = Core::PreRunLoop()->Add([] { doWork(); }, RunLoop::Normal, "IO");
 }
 
 //------------------------------------------------------------------------------
@@ -67,7 +67,6 @@ IO::doWork() {
     o_assert_dbg(IsValid());
     o_assert_dbg(Core::IsMainThread());
     state->router.doWork();
-    state->loadQueue.update();
 }
 
 //------------------------------------------------------------------------------
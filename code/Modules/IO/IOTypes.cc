@@ -75,6 +75,13 @@ URL::copyIndices(const URL& rhs) {
     }
 }
 
+//------------------------------------------------------------------------------
+StringView
+URL::view(int startIndex, int endIndex) const {
+    o_assert_dbg((startIndex >= 0) && (startIndex <= endIndex) && (endIndex <= this->content.Length()));
+    return StringView(this->content.AsCStr() + startIndex, endIndex - startIndex);
+}
+
 //------------------------------------------------------------------------------
 URL::URL() :
 valid(false) {
@@ -84,6 +91,7 @@ valid(false) {
 //------------------------------------------------------------------------------
 URL::URL(const URL& rhs) :
 content(rhs.content),
+scheme(rhs.scheme),
 valid(rhs.valid) {
     this->copyIndices(rhs);
 }
@@ -91,6 +99,7 @@ valid(rhs.valid) {
 //------------------------------------------------------------------------------
 URL::URL(URL&& rhs) {
     this->content = std::move(rhs.content);
+    this->scheme = std::move(rhs.scheme);
     this->copyIndices(rhs);
     this->valid = rhs.valid;
     rhs.clearIndices();
@@ -121,6 +130,7 @@ void
 URL::operator=(const URL& rhs) {
     if (&rhs != this) {
         this->content = rhs.content;
+        this->scheme = rhs.scheme;
         this->copyIndices(rhs);
         this->valid = rhs.valid;
     }
@@ -131,9 +141,11 @@ void
 URL::operator=(URL&& rhs) {
     if (&rhs != this) {
         this->content = rhs.content;
+        this->scheme = rhs.scheme;
         this->copyIndices(rhs);
         this->valid = rhs.valid;
         rhs.content.Clear();
+        rhs.scheme.Clear();
         rhs.clearIndices();
         rhs.valid = false;
     }
@@ -201,6 +213,7 @@ void
 URL::crack(String urlString) {
 
     this->content.Clear();
+    this->scheme.Clear();
     this->clearIndices();
     this->valid = false;
     
@@ -221,6 +234,8 @@ URL::crack(String urlString) {
             this->clearIndices();
             return;
         }
+        // the scheme is short, so this doesn't allocate once the atom exists
+        this->scheme = this->Scheme();
         
         // extract host fields
         int leftStartIndex = this->indices[schemeEnd] + 3;
@@ -322,11 +337,23 @@ URL::HasScheme() const {
 //------------------------------------------------------------------------------
 String
 URL::Scheme() const {
+    return this->SchemeView().AsString();
+}
+
+//------------------------------------------------------------------------------
+const StringAtom&
+URL::SchemeAtom() const {
+    return this->scheme;
+}
+
+//------------------------------------------------------------------------------
+StringView
+URL::SchemeView() const {
     if (this->HasScheme()) {
-        return String(this->content.AsCStr(), this->indices[schemeStart], this->indices[schemeEnd]);
+        return this->view(this->indices[schemeStart], this->indices[schemeEnd]);
     }
     else {
-        return String();
+        return StringView();
     }
 }
 
@@ -339,11 +366,17 @@ URL::HasUser() const {
 //------------------------------------------------------------------------------
 String
 URL::User() const {
+    return this->UserView().AsString();
+}
+
+//------------------------------------------------------------------------------
+StringView
+URL::UserView() const {
     if (this->HasUser()) {
-        return String(this->content.AsCStr(), this->indices[userStart], this->indices[userEnd]);
+        return this->view(this->indices[userStart], this->indices[userEnd]);
     }
     else {
-        return String();
+        return StringView();
     }
 }
 
@@ -356,11 +389,17 @@ URL::HasPassword() const {
 //------------------------------------------------------------------------------
 String
 URL::Password() const {
+    return this->PasswordView().AsString();
+}
+
+//------------------------------------------------------------------------------
+StringView
+URL::PasswordView() const {
     if (this->HasPassword()) {
-        return String(this->content.AsCStr(), this->indices[pwdStart], this->indices[pwdEnd]);
+        return this->view(this->indices[pwdStart], this->indices[pwdEnd]);
     }
     else {
-        return String();
+        return StringView();
     }
 }
 
@@ -373,11 +412,17 @@ URL::HasHost() const {
 //------------------------------------------------------------------------------
 String
 URL::Host() const {
+    return this->HostView().AsString();
+}
+
+//------------------------------------------------------------------------------
+StringView
+URL::HostView() const {
     if (this->HasHost()) {
-        return String(this->content.AsCStr(), this->indices[hostStart], this->indices[hostEnd]);
+        return this->view(this->indices[hostStart], this->indices[hostEnd]);
     }
     else {
-        return String();
+        return StringView();
     }
 }
 
@@ -390,30 +435,42 @@ URL::HasPort() const {
 //------------------------------------------------------------------------------
 String
 URL::Port() const {
+    return this->PortView().AsString();
+}
+
+//------------------------------------------------------------------------------
+StringView
+URL::PortView() const {
     if (this->HasPort()) {
-        return String(this->content.AsCStr(), this->indices[portStart], this->indices[portEnd]);
+        return this->view(this->indices[portStart], this->indices[portEnd]);
     }
     else {
-        return String();
+        return StringView();
     }
 }
 
 //------------------------------------------------------------------------------
 String
 URL::HostAndPort() const  {
+    return this->HostAndPortView().AsString();
+}
+
+//------------------------------------------------------------------------------
+StringView
+URL::HostAndPortView() const {
     if (this->HasHost()) {
         if (this->HasPort()) {
             // URL has host and port definition
-            return String(this->content.AsCStr(), this->indices[hostStart], this->indices[portEnd]);
+            return this->view(this->indices[hostStart], this->indices[portEnd]);
         }
         else {
             // URL only has host
-            return String(this->content.AsCStr(), this->indices[hostStart], this->indices[hostEnd]);
+            return this->view(this->indices[hostStart], this->indices[hostEnd]);
         }
     }
     else {
         // no host in URL
-        return String();
+        return StringView();
     }
 }
 
@@ -426,11 +483,17 @@ URL::HasPath() const {
 //------------------------------------------------------------------------------
 String
 URL::Path() const {
+    return this->PathView().AsString();
+}
+
+//------------------------------------------------------------------------------
+StringView
+URL::PathView() const {
     if (this->HasPath()) {
-        return String(this->content.AsCStr(), this->indices[pathStart], this->indices[pathEnd]);
+        return this->view(this->indices[pathStart], this->indices[pathEnd]);
     }
     else {
-        return String();
+        return StringView();
     }
 }
 
@@ -443,22 +506,34 @@ URL::HasFragment() const {
 //------------------------------------------------------------------------------
 String
 URL::Fragment() const {
+    return this->FragmentView().AsString();
+}
+
+//------------------------------------------------------------------------------
+StringView
+URL::FragmentView() const {
     if (this->HasFragment()) {
-        return String(this->content.AsCStr(), this->indices[fragStart], this->indices[fragEnd]);
+        return this->view(this->indices[fragStart], this->indices[fragEnd]);
     }
     else {
-        return String();
+        return StringView();
     }
 }
 
 //------------------------------------------------------------------------------
 String
 URL::PathToEnd() const {
+    return this->PathToEndView().AsString();
+}
+
+//------------------------------------------------------------------------------
+StringView
+URL::PathToEndView() const {
     if (this->HasPath()) {
-        return String(this->content.AsCStr(), this->indices[pathStart], EndOfString);
+        return this->view(this->indices[pathStart], this->content.Length());
     }
     else {
-        return String();
+        return StringView();
     }
 }
 
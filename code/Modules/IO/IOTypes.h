@@ -5,6 +5,7 @@
 #include "Core/String/StringAtom.h"
 #include "Core/String/String.h"
 #include "Core/String/StringBuilder.h"
+#include "Core/String/StringView.h"
 #include <functional>
 
 namespace Oryol {
@@ -112,6 +113,11 @@ public:
     Expensive String construction only happens when actually getting
     the URL parts. 
     
+    The ...View() accessors return StringViews into the URL's StringAtom
+    instead, these never allocate memory. The scheme is also kept as a
+    StringAtom (SchemeAtom()), which is what the IO system uses to find
+    the filesystem for a URL.
+    
     @see URLBuilder
 */
 class URL
@@ -159,38 +165,58 @@ public:
     bool HasScheme() const;
     /// get the scheme string
     String Scheme() const;
+    /// get the scheme as view
+    StringView SchemeView() const;
+    /// get the scheme as StringAtom (cached, no allocation)
+    const StringAtom& SchemeAtom() const;
     /// test if the URL has a user string
     bool HasUser() const;
     /// get the user string
     String User() const;
+    /// get the user as view
+    StringView UserView() const;
     /// test if the URL has a password
     bool HasPassword() const;
     /// get the password string
     String Password() const;
+    /// get the password as view
+    StringView PasswordView() const;
     /// test if the URL has a host string
     bool HasHost() const;
     /// get the host string
     String Host() const;
+    /// get the host as view
+    StringView HostView() const;
     /// test if the URL has a port string
     bool HasPort() const;
     /// get the port string
     String Port() const;
+    /// get the port as view
+    StringView PortView() const;
     /// get host and port (only host if no port was in URL)
     String HostAndPort() const;
+    /// get host and port as view
+    StringView HostAndPortView() const;
     /// test if the URL has a path string
     bool HasPath() const;
     /// get the path string
     String Path() const;
+    /// get the path as view
+    StringView PathView() const;
     /// test if the URL has a fragment
     bool HasFragment() const;
     /// get the fragment string
     String Fragment() const;
+    /// get the fragment as view
+    StringView FragmentView() const;
     /// test if the URL has a query
     bool HasQuery() const;
     /// get the query component
     Map<String, String> Query() const;
     /// get everything right of the server
     String PathToEnd() const;
+    /// get everything right of the server as view
+    StringView PathToEndView() const;
     
 private:
     /// crack URL, populates string indices
@@ -199,6 +225,8 @@ private:
     void clearIndices();
     /// copy string indices
     void copyIndices(const URL& rhs);
+    /// get a view into the URL string
+    StringView view(int startIndex, int endIndex) const;
     
     enum {
         schemeStart = 0,
@@ -222,6 +250,7 @@ private:
     };
     
     StringAtom content;
+    StringAtom scheme;
     int16_t indices[numIndices];
     bool valid;
 };
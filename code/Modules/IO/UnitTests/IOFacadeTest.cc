@@ -28,7 +28,7 @@ public:
             ioRead->Data.Add(payload, sizeof(payload));
             ioRead->Status = IOStatus::OK;
         }
-        msg->Handled = true;
+        msg->SetHandled();
     };
 };
 
@@ -67,9 +67,47 @@ TEST(IOFacadeTest) {
     CHECK(payload[2] == 'C');
     CHECK(payload[3] == 'D');
 
+    // a continuation on the handled-future is called by the runloop
+    Ptr<IORead> msg2 = IO::LoadFile(url);
+    IOStatus::Code status = IOStatus::InvalidIOStatus;
+    msg2->HandledFuture().Then([&status](IOStatus::Code s) {
+        status = s;
+    });
+    while (IOStatus::InvalidIOStatus == status) {
+        Core::PreRunLoop()->Run();
+    }
+    CHECK(msg2->Handled);
+    CHECK(status == IOStatus::OK);
+    CHECK(numRequestsHandled == 2);
+
+    // load callbacks
+    int numLoaded = 0;
+    IO::Load(url, [&numLoaded](IO::LoadResult res) {
+        CHECK(res.Data.Size() == 4);
+        numLoaded++;
+    });
+    IO::LoadGroup(Array<URL>({ url, url, url }), [&numLoaded](Array<IO::LoadResult> res) {
+        CHECK(res.Size() == 3);
+        numLoaded++;
+    });
+    CHECK(IO::NumPendingLoads() == 2);
+    while (IO::NumPendingLoads() > 0) {
+        Core::PreRunLoop()->Run();
+    }
+    CHECK(numLoaded == 2);
+    CHECK(numRequestsHandled == 6);
+
     // FIXME: dynamically add/remove/replace filesystems, ...
     
+    // callbacks of pending loads are not called after IO::Discard()
+    IO::Load(url, [&numLoaded](IO::LoadResult /*res*/) {
+        numLoaded++;
+    });
     IO::Discard();
+    for (int i = 0; i < 10; i++) {
+        Core::PreRunLoop()->Run();
+    }
+    CHECK(numLoaded == 2);
     Core::Discard();
 }
 #endif
@@ -11,6 +11,7 @@
 #include "Core/Config.h"
 #include "Core/RefCounted.h"
 #include "Core/Containers/Buffer.h"
+#include "Core/Threading/Future.h"
 #include "IO/IOTypes.h"
 
 namespace Oryol {
@@ -21,6 +22,7 @@ class ioMsg : public RefCounted {
     OryolBaseTypeDecl(ioMsg);
 public:
     ioMsg() : Handled(false), Cancelled(false) { };
+    /// NOTE: filesystems must not set Handled directly, use IORequest::SetHandled()
     #if ORYOL_HAS_ATOMIC
     std::atomic<bool> Handled;
     std::atomic<bool> Cancelled;
@@ -42,6 +44,23 @@ public:
     Buffer Data;
     IOStatus::Code Status = IOStatus::InvalidIOStatus;
     String ErrorDesc;
+
+    /// destructor
+    ~IORequest() {
+        // Handled was set directly instead of through SetHandled()
+        o_assert_dbg(!(this->Handled && this->handledPromise.IsPending()));
+    };
+    /// set Handled and resolve HandledFuture() with Status (called by filesystems when done)
+    void SetHandled() {
+        this->Handled = true;
+        this->handledPromise.Resolve(this->Status);
+    };
+    /// get a Future which is resolved with Status when the request has been handled
+    Future<IOStatus::Code> HandledFuture() const {
+        return this->handledPromise.GetFuture();
+    };
+private:
+    Promise<IOStatus::Code> handledPromise;
 };
 
 //------------------------------------------------------------------------------
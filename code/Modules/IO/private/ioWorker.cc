@@ -156,9 +156,11 @@ ioWorker::moveTransferToReadQueue() {
 //------------------------------------------------------------------------------
 Ptr<FileSystemBase>
 ioWorker::fileSystemForURL(const URL& url) {
-    StringAtom scheme = url.Scheme();
-    if (this->fileSystems.Contains(scheme)) {
-        return this->fileSystems[scheme];
+    // NOTE: use the URL's cached scheme atom, this doesn't allocate
+    const StringAtom& scheme = url.SchemeAtom();
+    const int index = this->fileSystems.FindIndex(scheme);
+    if (InvalidIndex != index) {
+        return this->fileSystems.ValueAtIndex(index);
     }
     else {
         o_warn("ioLane::fileSystemForURL: no filesystem registered for URL scheme '%s'!\n", scheme.AsCStr());
@@ -171,7 +173,7 @@ bool
 ioWorker::checkCancelled(const Ptr<IORequest>& msg) {
     if (msg->Cancelled) {
         msg->Status = IOStatus::Cancelled;
-        msg->Handled = true;
+        msg->SetHandled();
         return true;
     }
     else {
@@ -184,8 +186,8 @@ void
 ioWorker::onMsg(const Ptr<ioMsg>& msg) {
     if (msg->IsA<IORequest>()) {
         // find filesystem and forward request, NOTE:
-        // the filesystem is responsible to set the
-        // request to 'handled'!
+        // the filesystem is responsible to call
+        // ioReq->SetHandled() when done!
         Ptr<IORequest> ioReq = msg->DynamicCast<IORequest>();
         if (!this->checkCancelled(ioReq)) {
             auto fs = this->fileSystemForURL(ioReq->Url);
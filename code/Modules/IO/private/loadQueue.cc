@@ -9,14 +9,45 @@
 
 namespace Oryol {
 
+//------------------------------------------------------------------------------
+loadQueue::loadQueue() :
+loadTime(Metrics::Histogram("IO.LoadTime")),
+numLoaded(Metrics::Counter("IO.NumLoaded")),
+numFailed(Metrics::Counter("IO.NumFailed")) {
+    // empty
+}
+
+//------------------------------------------------------------------------------
+loadQueue::~loadQueue() {
+    // the continuations reference this object, make sure they aren't called
+    for (auto& curItem : this->items) {
+        curItem.future.Cancel();
+    }
+    for (auto& curItem : this->groupItems) {
+        for (auto& future : curItem.futures) {
+            future.Cancel();
+        }
+    }
+}
+
 //------------------------------------------------------------------------------
 void
 loadQueue::add(const URL& url, successFunc onSuccess, failFunc onFail) {
     o_assert_dbg(onSuccess);
+    const int id = ++this->uniqueId;
     Ptr<IORead> ioReq = IORead::Create();
     ioReq->Url = url;
+    item& newItem = this->items.Add();
+    newItem.id = id;
+    newItem.ioRequest = ioReq;
+    newItem.onSuccess = onSuccess;
+    newItem.onFail = onFail;
+    newItem.startTime = Clock::Now();
+    newItem.future = ioReq->HandledFuture();
+    newItem.future.Then([this, id](IOStatus::Code /*status*/) {
+        this->onHandled(id);
+    });
     IO::Put(ioReq);
-    this->items.Add(item{ ioReq, onSuccess, onFail });
 }
 
 //------------------------------------------------------------------------------
@@ -24,17 +55,26 @@ void
 loadQueue::addGroup(const Array<URL>& urls, groupSuccessFunc onSuccess, failFunc onFail) {
     o_assert_dbg(onSuccess);
     
-    groupItem item;
-    item.ioRequests.Reserve(urls.Size());
+    const int id = ++this->uniqueId;
+    groupItem& newItem = this->groupItems.Add();
+    newItem.id = id;
+    newItem.onSuccess = onSuccess;
+    newItem.onFail = onFail;
+    newItem.startTime = Clock::Now();
+    newItem.numPending = urls.Size();
+    newItem.ioRequests.Reserve(urls.Size());
+    newItem.futures.Reserve(urls.Size());
     for (const URL& url : urls) {
+        const int index = newItem.ioRequests.Size();
         Ptr<IORead> ioReq = IORead::Create();
         ioReq->Url = url;
+        newItem.ioRequests.Add(ioReq);
+        Future<IOStatus::Code>& future = newItem.futures.Add(ioReq->HandledFuture());
+        future.Then([this, id, index](IOStatus::Code /*status*/) {
+            this->onGroupHandled(id, index);
+        });
         IO::Put(ioReq);
-        item.ioRequests.Add(ioReq);
-        item.onSuccess = onSuccess;
-        item.onFail = onFail;
     }
-    this->groupItems.Add(item);
 }
 
 //------------------------------------------------------------------------------
@@ -43,75 +83,110 @@ loadQueue::numPending() const {
     return this->items.Size() + this->groupItems.Size();
 }
 
+//------------------------------------------------------------------------------
+int
+loadQueue::findItem(int id) const {
+    for (int i = 0; i < this->items.Size(); i++) {
+        if (this->items[i].id == id) {
+            return i;
+        }
+    }
+    return InvalidIndex;
+}
+
+//------------------------------------------------------------------------------
+int
+loadQueue::findGroupItem(int id) const {
+    for (int i = 0; i < this->groupItems.Size(); i++) {
+        if (this->groupItems[i].id == id) {
+            return i;
+        }
+    }
+    return InvalidIndex;
+}
+
 //------------------------------------------------------------------------------
 void
-loadQueue::update() {
+loadQueue::onHandled(int id) {
+    const int index = this->findItem(id);
+    o_assert_dbg(InvalidIndex != index);
 
-    // check single items
-    for (int i = this->items.Size() - 1; i >= 0; --i) {
-        const item& curItem = this->items[i];
-        const auto& ioReq = curItem.ioRequest;
-        if (ioReq->Handled) {
-            // io request has been handled
-            if (IOStatus::OK == ioReq->Status) {
-                // io request was successful
-                curItem.onSuccess(result(ioReq->Url, std::move(ioReq->Data)));
-            }
-            else {
-                // io request failed
-                if (curItem.onFail) {
-                    curItem.onFail(ioReq->Url, ioReq->Status);
-                }
-                else {
-                    // no fail handler was set, just print a warning
-                    o_warn("loadQueue:: failed to load file '%s' with '%s'\n",
-                        ioReq->Url.AsCStr(), IOStatus::ToString(ioReq->Status));
-                }
-            }
-            // remove the handled io request from the queue
-            this->items.Erase(i);
+    // remove the item before calling the callbacks, these may
+    // start new load requests
+    item curItem = std::move(this->items[index]);
+    this->items.Erase(index);
+    const auto& ioReq = curItem.ioRequest;
+    this->loadTime->RecordDuration(Clock::Since(curItem.startTime));
+    if (IOStatus::OK == ioReq->Status) {
+        // io request was successful
+        this->numLoaded->Add();
+        curItem.onSuccess(result(ioReq->Url, std::move(ioReq->Data)));
+    }
+    else {
+        // io request failed
+        this->numFailed->Add();
+        if (curItem.onFail) {
+            curItem.onFail(ioReq->Url, ioReq->Status);
+        }
+        else {
+            // no fail handler was set, just print a warning
+            o_warn("loadQueue:: failed to load file '%s' with '%s'\n",
+                ioReq->Url.AsCStr(), IOStatus::ToString(ioReq->Status));
         }
     }
-    
-    // check group items
-    for (int i = this->groupItems.Size() - 1; i >= 0; --i) {
-        const groupItem& curItem = this->groupItems[i];
-        bool allHandled = true;
-        bool anyFailed = false;
-        for (const auto& ioReq : curItem.ioRequests) {
-            if (ioReq->Handled) {
-                if (IOStatus::OK != ioReq->Status) {
-                    anyFailed = true;
-                    if (curItem.onFail) {
-                        curItem.onFail(ioReq->Url, ioReq->Status);
-                    }
-                    else {
-                        o_warn("loadQueue:: failed to load file '%s' with '%s'\n",
-                            ioReq->Url.AsCStr(), IOStatus::ToString(ioReq->Status));
-                    }
-                }
+}
+
+//------------------------------------------------------------------------------
+void
+loadQueue::onGroupHandled(int id, int index) {
+    const int itemIndex = this->findGroupItem(id);
+    o_assert_dbg(InvalidIndex != itemIndex);
+    groupItem& curItem = this->groupItems[itemIndex];
+    o_assert_dbg(curItem.numPending > 0);
+    curItem.numPending--;
+
+    const Ptr<IORead> ioReq = curItem.ioRequests[index];
+    const failFunc onFail = curItem.onFail;
+    const bool done = 0 == curItem.numPending;
+    if (IOStatus::OK != ioReq->Status) {
+        curItem.anyFailed = true;
+    }
+
+    // if all requests in this group have been handled, remove the item
+    // before calling the callbacks, these may start new load requests
+    groupItem doneItem;
+    if (done) {
+        doneItem = std::move(curItem);
+        this->groupItems.Erase(itemIndex);
+        const Duration groupLoadTime = Clock::Since(doneItem.startTime);
+        for (const auto& req : doneItem.ioRequests) {
+            this->loadTime->RecordDuration(groupLoadTime);
+            if (IOStatus::OK == req->Status) {
+                this->numLoaded->Add();
             }
             else {
-                allHandled = false;
-                break;
+                this->numFailed->Add();
             }
         }
-        
-        // if all request in this group have been handled, remove item, and
-        // if all were successful, call the success-callback
-        if (allHandled) {
-            if (!anyFailed) {
-                Array<result> result;
-                result.Reserve(curItem.ioRequests.Size());
-                for (const auto& ioReq : curItem.ioRequests) {
-                    result.Add(ioReq->Url, std::move(ioReq->Data));
-                }
-                curItem.onSuccess(std::move(result));
-            }
-            this->groupItems.Erase(i);
+    }
+    if (IOStatus::OK != ioReq->Status) {
+        if (onFail) {
+            onFail(ioReq->Url, ioReq->Status);
+        }
+        else {
+            o_warn("loadQueue:: failed to load file '%s' with '%s'\n",
+                ioReq->Url.AsCStr(), IOStatus::ToString(ioReq->Status));
         }
     }
+    // if all were successful, call the success-callback
+    if (done && !doneItem.anyFailed) {
+        Array<result> result;
+        result.Reserve(doneItem.ioRequests.Size());
+        for (const auto& req : doneItem.ioRequests) {
+            result.Add(req->Url, std::move(req->Data));
+        }
+        doneItem.onSuccess(std::move(result));
+    }
 }
 
 } // namespace Oryol
-
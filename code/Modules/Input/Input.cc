@@ -137,6 +137,13 @@ Input::Text() {
     return state->inputManager.keyboard.capturedText();
 }
 
+//------------------------------------------------------------------------------
+const char*
+Input::TextUTF8() {
+    o_assert_dbg(state);
+    return state->inputManager.keyboard.capturedTextUTF8();
+}
+
 //------------------------------------------------------------------------------
 bool
 Input::MouseAttached() {
@@ -59,6 +59,8 @@ public:
     static bool AnyKeyRepeat();
     /// get captured text
     static const wchar_t* Text();
+    /// get captured text as UTF-8
+    static const char* TextUTF8();
 
     /// return true if a mouse is attached
     static bool MouseAttached();
@@ -4,6 +4,7 @@
 #include "Pre.h"
 #include "inputDevices.h"
 #include "inputDispatcher.h"
+#include "Core/String/StringConverter.h"
 
 namespace Oryol {
 namespace _priv {
@@ -11,6 +12,7 @@ namespace _priv {
 //------------------------------------------------------------------------------
 keyboardDevice::keyboardDevice() {
     this->chars.Fill(0);
+    this->utf8Chars.Fill(0);
 }
 //------------------------------------------------------------------------------
 void
@@ -52,6 +54,7 @@ keyboardDevice::onChar(wchar_t c) {
     if (this->charIndex < MaxNumChars) {
         this->chars[this->charIndex++] = c;
         this->chars[this->charIndex] = 0;
+        this->utf8Dirty = true;
     }
     this->dispatcher->notifyEvent(InputEvent(InputEvent::WChar, c));
 }
@@ -61,6 +64,8 @@ void
 keyboardDevice::clearCapturedText() {
     this->chars[0] = 0;
     this->charIndex = 0;
+    this->utf8Chars[0] = 0;
+    this->utf8Dirty = false;
 }
 
 //------------------------------------------------------------------------------
@@ -130,6 +135,20 @@ keyboardDevice::capturedText() const {
     return this->chars.begin();
 }
 
+//------------------------------------------------------------------------------
+const char*
+keyboardDevice::capturedTextUTF8() {
+    // only convert when new characters have been captured
+    if (this->utf8Dirty) {
+        this->utf8Dirty = false;
+        if (0 == StringConverter::WideToUTF8(this->chars.begin(), this->charIndex,
+            (unsigned char*) this->utf8Chars.begin(), this->utf8Chars.Size())) {
+            this->utf8Chars[0] = 0;
+        }
+    }
+    return this->utf8Chars.begin();
+}
+
 //------------------------------------------------------------------------------
 mouseDevice::mouseDevice() {
     this->buttonState.Fill(0);
@@ -31,6 +31,7 @@ public:
     bool anyKeyUp() const;
     bool anyKeyRepeat() const;
     const wchar_t* capturedText() const;
+    const char* capturedTextUTF8();
     void onKeyDown(Key::Code key);
     void onKeyUp(Key::Code key);
     void onKeyRepeat(Key::Code key);
@@ -47,6 +48,8 @@ public:
     static const int MaxNumChars = 128;
     int charIndex = 0;
     StaticArray<wchar_t, MaxNumChars+1> chars;
+    bool utf8Dirty = false;
+    StaticArray<char, MaxNumChars*4+1> utf8Chars;
 };
 
 
@@ -137,6 +137,11 @@ Id::Invalidate() {
     this->Value = invalidId;
 }
 
+//------------------------------------------------------------------------------
+template<> struct IsTriviallyRelocatable<Id> {
+    static const bool value = true;
+};
+
 } // namespace Oryol
     
  
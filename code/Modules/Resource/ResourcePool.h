@@ -5,9 +5,14 @@
     @ingroup Resource
     @brief generic resource pool
     @todo ResourcePool description
+
+    Allocated slots are tracked in a BitArray, so iterating over
+    the used slots with ForEachUsedSlot() only touches one word per
+    64 slots for the empty parts of the pool.
 */
 #include "Core/Containers/Queue.h"
 #include "Core/Containers/Array.h"
+#include "Core/Containers/BitArray.h"
 #include "Resource/Id.h"
 #include "Resource/ResourceInfo.h"
 #include "Resource/ResourcePoolInfo.h"
@@ -61,6 +66,8 @@ public:
     int GetNumUsedSlots() const;
     /// get number of free slots
     int GetNumFreeSlots() const;
+    /// call func(RESOURCE&) for each slot with an allocated id
+    template<class FUNC> void ForEachUsedSlot(FUNC func);
     
     /// there will be no allocated slots beyond this (but there may be holes!)
     Id::SlotIndexT LastAllocSlot = 0;
@@ -72,6 +79,7 @@ public:
     
     Array<RESOURCE> slots;
     Queue<uint16_t> freeSlots;
+    BitArray usedSlots;
 };
     
 //------------------------------------------------------------------------------
@@ -90,6 +98,7 @@ ResourcePool<RESOURCE>::Setup(Id::TypeT resType, int poolSize) {
     this->resourceType = resType;
     this->slots.SetFixedCapacity(poolSize);
     this->freeSlots.SetFixedCapacity(poolSize);
+    this->usedSlots.Resize(poolSize);
     this->LastAllocSlot = 0;
     
     // setup empty slots
@@ -115,6 +124,7 @@ ResourcePool<RESOURCE>::Discard() {
     this->LastAllocSlot = 0;    
     this->slots.Clear();
     this->freeSlots.Clear();
+    this->usedSlots.Resize(0);
 }
 
 //------------------------------------------------------------------------------
@@ -140,6 +150,7 @@ ResourcePool<RESOURCE>::AllocId() {
         const auto& slot = this->slots[newId.SlotIndex];
         o_assert_dbg(ResourceState::Initial == slot.State);
     #endif
+    this->usedSlots.Set(newId.SlotIndex);
     if (newId.SlotIndex > this->LastAllocSlot) {
         this->LastAllocSlot = newId.SlotIndex;
     }
@@ -153,10 +164,11 @@ ResourcePool<RESOURCE>::FreeId(const Id& id) {
     o_assert_dbg(!this->slots[id.SlotIndex].Id.IsValid());
     o_assert_dbg(ResourceState::Initial == this->slots[id.SlotIndex].State);
     o_assert_dbg(id.SlotIndex <= this->LastAllocSlot);
-    // find the next highest 'last alloc slot' 
-    while ((this->LastAllocSlot > 0) && !this->slots[this->LastAllocSlot].Id.IsValid()) {
-        this->LastAllocSlot--;
-    }
+    o_assert_dbg(this->usedSlots.Test(id.SlotIndex));
+    this->usedSlots.Clear(id.SlotIndex);
+    // find the next highest 'last alloc slot'
+    const int lastUsedSlot = this->usedSlots.FindLastSet();
+    this->LastAllocSlot = (InvalidIndex != lastUsedSlot) ? lastUsedSlot : 0;
     this->freeSlots.Enqueue(id.SlotIndex);
 }
 
@@ -288,11 +300,14 @@ ResourcePool<RESOURCE>::QueryPoolInfo() const {
     poolInfo.NumSlots = this->GetNumSlots();
     poolInfo.NumUsedSlots = this->GetNumUsedSlots();
     poolInfo.NumFreeSlots = this->GetNumFreeSlots();
-    for (const auto& slot : this->slots) {
+    // free slots are always in the initial state, only look at used slots
+    poolInfo.NumSlotsByState[ResourceState::Initial] = poolInfo.NumFreeSlots;
+    this->usedSlots.ForEachSet([this, &poolInfo](int slotIndex) {
+        const auto& slot = this->slots[slotIndex];
         if (ResourceState::InvalidState != slot.State) {
             poolInfo.NumSlotsByState[slot.State]++;
         }
-    }
+    });
     return poolInfo;
 }
 
@@ -314,4 +329,13 @@ ResourcePool<RESOURCE>::GetNumFreeSlots() const {
     return this->freeSlots.Size();
 }
 
+//------------------------------------------------------------------------------
+template<class RESOURCE> template<class FUNC> void
+ResourcePool<RESOURCE>::ForEachUsedSlot(FUNC func) {
+    o_assert_dbg(this->isValid);
+    this->usedSlots.ForEachSet([this, &func](int slotIndex) {
+        func(this->slots[slotIndex]);
+    });
+}
+
 } // namespace Oryol
@@ -65,6 +65,15 @@ TEST(ResourcePoolTest) {
     CHECK(poolInfo.NumSlots == 256);
     CHECK(poolInfo.NumUsedSlots == 2);
     CHECK(poolInfo.NumFreeSlots == 254);
+    CHECK(poolInfo.NumSlotsByState[ResourceState::Valid] == 2);
+    CHECK(poolInfo.NumSlotsByState[ResourceState::Initial] == 254);
+
+    int numUsed = 0;
+    resourcePool.ForEachUsedSlot([&numUsed, resId, resId1](myResource& res) {
+        CHECK((res.Id == resId) || (res.Id == resId1));
+        numUsed++;
+    });
+    CHECK(numUsed == 2);
     
     resourcePool.Unassign(resId);
     CHECK(resourcePool.GetNumFreeSlots() == 255);
@@ -4,6 +4,7 @@
 #include "Pre.h"
 #include "Core/Main.h"
 #include "Core/Time/Clock.h"
+#include "Core/Threading/Parallel.h"
 #include "Gfx/Gfx.h"
 #include "Assets/Gfx/ShapeBuilder.h"
 #include "Dbg/Dbg.h"
@@ -53,6 +54,7 @@ DrawCallPerfApp::OnInit() {
     Gfx::Setup(gfxSetup);
     Dbg::Setup();
     Input::Setup();
+    JobSystem::Setup();
 
     // create resources
     const glm::mat4 rot90 = glm::rotate(glm::mat4(), glm::radians(90.0f), glm::vec3(1.0f, 0.0f, 0.0f));
@@ -162,21 +164,24 @@ DrawCallPerfApp::emitParticles() {
 void
 DrawCallPerfApp::updateParticles() {
     const float frameTime = 1.0f / 60.0f;
-    for (int i = 0; i < this->curNumParticles; i++) {
-        auto& curParticle = this->particles[i];
-        curParticle.vec.y -= 1.0f * frameTime;
-        curParticle.pos += curParticle.vec * frameTime;
-        if (curParticle.pos.y < -2.0f) {
-            curParticle.pos.y = -1.8f;
-            curParticle.vec.y = -curParticle.vec.y;
-            curParticle.vec *= 0.8f;
+    Parallel::For(this->curNumParticles, [this, frameTime](int begin, int end) {
+        for (int i = begin; i < end; i++) {
+            auto& curParticle = this->particles[i];
+            curParticle.vec.y -= 1.0f * frameTime;
+            curParticle.pos += curParticle.vec * frameTime;
+            if (curParticle.pos.y < -2.0f) {
+                curParticle.pos.y = -1.8f;
+                curParticle.vec.y = -curParticle.vec.y;
+                curParticle.vec *= 0.8f;
+            }
         }
-    }
+    });
 }
 
 //------------------------------------------------------------------------------
 AppState::Code
 DrawCallPerfApp::OnCleanup() {
+    JobSystem::Discard();
     Dbg::Discard();
     Input::Discard();
     Gfx::Discard();
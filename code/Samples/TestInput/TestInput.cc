@@ -196,7 +196,7 @@ TestInputApp::printKeyboardState() {
             this->testKey((Key::Code)key, Key::ToString((Key::Code)key));
         }
         if (Input::Text()[0]) {
-            this->lastCaptured = StringConverter::WideToUTF8(Input::Text());
+            this->lastCaptured = Input::TextUTF8();
         }
         Dbg::PrintF("\n\n\r last char: %s\n\r", this->lastCaptured.AsCStr());
     }
@@ -0,0 +1,82 @@
+//------------------------------------------------------------------------------
+//  BlogDump.cc
+//
+//  Convert a binary log file (see Core/BinaryLog.h) into text.
+//
+//  blogdump -in file.oblog [-out file.txt] [-time]
+//
+//  -in     the binary log file
+//  -out    write text to a file instead of stdout
+//  -time   prefix each message with its time in seconds since the first message
+//------------------------------------------------------------------------------
+#include "Pre.h"
+#include "Core/Main.h"
+#include "Core/BinaryLog.h"
+#include "Core/Containers/Array.h"
+#include <cstdio>
+
+using namespace Oryol;
+
+class BlogDumpApp : public App {
+public:
+    BlogDumpApp() {
+        // only the decoded messages should go to stdout
+        Log::SetLogLevel(Log::Level::Warn);
+    };
+    virtual AppState::Code OnRunning() override;
+private:
+    void dump(const String& inPath);
+};
+OryolMain(BlogDumpApp);
+
+//------------------------------------------------------------------------------
+AppState::Code
+BlogDumpApp::OnRunning() {
+    const String inPath = OryolArgs.GetString("-in");
+    if (inPath.Empty()) {
+        Log::Warn("usage: blogdump -in file.oblog [-out file.txt] [-time]\n");
+    }
+    else {
+        this->dump(inPath);
+    }
+    return AppState::Cleanup;
+}
+
+//------------------------------------------------------------------------------
+void
+BlogDumpApp::dump(const String& inPath) {
+    std::FILE* in = std::fopen(inPath.AsCStr(), "rb");
+    if (nullptr == in) {
+        Log::Warn("blogdump: failed to open '%s'\n", inPath.AsCStr());
+        return;
+    }
+    Array<uint8_t> data;
+    uint8_t buf[64 * 1024];
+    size_t num;
+    while ((num = std::fread(buf, 1, sizeof(buf), in)) > 0) {
+        data.Reserve(int(num));
+        for (size_t i = 0; i < num; i++) {
+            data.Add(buf[i]);
+        }
+    }
+    std::fclose(in);
+
+    // decode as much as possible, also for truncated files
+    StringBuilder str;
+    if (!BinaryLog::Decode(data.Empty() ? nullptr : &data[0], data.Size(), str, OryolArgs.HasArg("-time"))) {
+        Log::Warn("blogdump: '%s' is not a valid binary log file, or is truncated\n", inPath.AsCStr());
+    }
+    std::FILE* out = stdout;
+    if (OryolArgs.HasArg("-out")) {
+        const String outPath = OryolArgs.GetString("-out");
+        out = std::fopen(outPath.AsCStr(), "wb");
+        if (nullptr == out) {
+            Log::Warn("blogdump: failed to open '%s'\n", outPath.AsCStr());
+            return;
+        }
+    }
+    std::fwrite(str.AsCStr(), 1, str.Length(), out);
+    if (out != stdout) {
+        std::fclose(out);
+    }
+}
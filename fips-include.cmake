@@ -22,9 +22,18 @@ if (ORYOL_USE_LIBCURL)
     add_definitions(-DORYOL_USE_LIBCURL=1)
 endif()
 
+# module benchmark apps (see Core/Benchmark.h)
+if (NOT (FIPS_EMSCRIPTEN OR FIPS_ANDROID OR FIPS_IOS))
+    option(ORYOL_BENCHMARKS "Build the module benchmark apps" OFF)
+endif()
+
 # profiling enabled?
 if (FIPS_PROFILING)
     add_definitions(-DORYOL_PROFILING=1)
+    option(ORYOL_TRACE_RECORDER "Record profiling traces into a Chrome trace file instead of using Remotery" OFF)
+    if (ORYOL_TRACE_RECORDER)
+        add_definitions(-DORYOL_TRACE_RECORDER=1)
+    endif()
 endif()
 
 # use Visual Leak Detector?